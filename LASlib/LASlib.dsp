@@ -105,6 +105,30 @@ SOURCE=..\LASzip\src\arithmeticmodel.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\bytestreamin_uring.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\lastrace.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\lascounters.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\bytestreamin_compressed.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\ransdecoder.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\ransencoder.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\fopen_compressed.cpp
 # End Source File
 # Begin Source File
@@ -185,6 +209,18 @@ SOURCE=..\LASzip\src\lasreaditemcompressed_v2.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\lasreaditemcompressed_v3.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\lasreaditemcompressed_v4.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\lasreaditemcompressed_v5.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\LASzip\src\lasreadpoint.cpp
 # End Source File
 # Begin Source File
@@ -193,6 +229,30 @@ SOURCE=.\src\lastransform.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\lasneighbors.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lascatalog.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\laspolygon.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lasgrid.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lasdataset.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\laspipeline.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\lasutility.cpp
 # End Source File
 # Begin Source File
@@ -213,10 +273,26 @@ SOURCE=..\LASzip\src\laswriteitemcompressed_v2.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\laswriteitemcompressed_v3.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\laswriteitemcompressed_v4.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\laswriteitemcompressed_v5.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\LASzip\src\laswritepoint.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\laswritepointasync.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\laswriter.cpp
 # End Source File
 # Begin Source File
@@ -265,6 +341,22 @@ SOURCE=..\LASzip\src\arithmeticmodel.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\entropydecoder.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\entropyencoder.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\ransdecoder.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\ransencoder.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\LASzip\src\bytestreamin.hpp
 # End Source File
 # Begin Source File
@@ -277,6 +369,22 @@ SOURCE=..\LASzip\src\bytestreamin_file.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\bytestreamin_uring.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\lastrace.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\lascounters.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\inc\bytestreamin_compressed.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\LASzip\src\bytestreamin_istream.hpp
 # End Source File
 # Begin Source File
@@ -397,6 +505,18 @@ SOURCE=..\LASzip\src\lasreaditemcompressed_v2.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\lasreaditemcompressed_v3.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\lasreaditemcompressed_v4.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\lasreaditemcompressed_v5.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\LASzip\src\lasreaditemraw.hpp
 # End Source File
 # Begin Source File
@@ -409,6 +529,30 @@ SOURCE=.\inc\lastransform.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\inc\lasneighbors.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\inc\lascatalog.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\inc\laspolygon.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\inc\lasgrid.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\inc\lasdataset.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\inc\laspipeline.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\inc\lasutility.hpp
 # End Source File
 # Begin Source File
@@ -433,6 +577,18 @@ SOURCE=..\LASzip\src\laswriteitemcompressed_v2.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\laswriteitemcompressed_v3.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\laswriteitemcompressed_v4.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\LASzip\src\laswriteitemcompressed_v5.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\LASzip\src\laswriteitemraw.hpp
 # End Source File
 # Begin Source File
@@ -441,6 +597,10 @@ SOURCE=..\LASzip\src\laswritepoint.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\laswritepointasync.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\inc\laswriter.hpp
 # End Source File
 # Begin Source File
@@ -481,6 +641,10 @@ SOURCE=..\LASzip\src\laszip_common_v2.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\LASzip\src\laszip_common_v5.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\LASzip\src\mydefs.hpp
 # End Source File
 # End Group
@@ -0,0 +1,153 @@
+/*
+===============================================================================
+
+  FILE:  bytestreamin_compressed.hpp
+
+  CONTENTS:
+
+    Class for reading a gzipped (*.las.gz) or a zstd compressed (*.las.zst)
+    file as if it was the uncompressed file.
+
+    When the container consists of many independently compressed blocks
+    whose uncompressed sizes can be found without decompressing them (BGZF
+    as written by 'bgzip' or zstd frames that store their content size as
+    written by 'zstd' for each piece of a split file or by 'pzstd') a block
+    table is built from the headers. Then seek() goes straight to the block
+    and a batch of the following blocks is decompressed by several threads
+    at once, which also lets every process of p_laszip decompress only the
+    blocks of its own points. Otherwise the file is decompressed as one
+    stream, seeking forward decompresses and skips, and seeking back starts
+    over from the beginning.
+
+    gzip needs the zlib library (-DHAVE_ZLIB) and zstd needs the zstd library
+    (-DHAVE_ZSTD). Without them init() fails with an error.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created to convert gzipped and zstd archives to LAZ
+
+===============================================================================
+*/
+#ifndef BYTE_STREAM_IN_COMPRESSED_HPP
+#define BYTE_STREAM_IN_COMPRESSED_HPP
+
+#ifndef _WIN32
+
+#include "bytestreamin.hpp"
+
+#include <stdio.h>
+
+#define BYTE_STREAM_IN_COMPRESSED_NONE 0
+#define BYTE_STREAM_IN_COMPRESSED_GZIP 1
+#define BYTE_STREAM_IN_COMPRESSED_ZSTD 2
+
+class ByteStreamInCompressed : public ByteStreamIn
+{
+public:
+  ByteStreamInCompressed(FILE* file, U32 threads=1);
+/* looks at the magic number at the start of the file        */
+  static I32 get_format(FILE* file);
+/* finds the blocks or prepares the decompression stream     */
+  BOOL init();
+/* read a single byte                                        */
+  U32 getByte();
+/* read an array of bytes                                    */
+  void getBytes(U8* bytes, const U32 num_bytes);
+/* read 16 bit low-endian field                              */
+  void get16bitsLE(U8* bytes);
+/* read 32 bit low-endian field                              */
+  void get32bitsLE(U8* bytes);
+/* read 64 bit low-endian field                              */
+  void get64bitsLE(U8* bytes);
+/* read 16 bit big-endian field                              */
+  void get16bitsBE(U8* bytes);
+/* read 32 bit big-endian field                              */
+  void get32bitsBE(U8* bytes);
+/* read 64 bit big-endian field                              */
+  void get64bitsBE(U8* bytes);
+/* seeking works but may need to decompress from the start   */
+  BOOL isSeekable() const;
+/* get current position of the uncompressed stream           */
+  I64 tell() const;
+/* seek to this position in the uncompressed stream          */
+  BOOL seek(const I64 position);
+/* seek to the end of the uncompressed stream                */
+  BOOL seekEnd(const I64 distance=0);
+/* destructor                                                */
+  ~ByteStreamInCompressed();
+private:
+  struct Block
+  {
+    I64 offset;   // in the file
+    I64 size;     // compressed
+    I64 start;    // in the uncompressed stream
+    I64 length;   // uncompressed
+  };
+  struct Job
+  {
+    ByteStreamInCompressed* stream;
+    U32 first;
+    U32 last;
+    BOOL ok;
+    U8* scratch;
+    I64 alloced;
+  };
+  static void* run(void* job);
+  BOOL scan_gzip();
+  BOOL scan_zstd();
+  BOOL add_block(const I64 offset, const I64 size, const I64 length);
+  BOOL load(const U32 block);
+  void decode(Job* job);
+  BOOL restart();
+  BOOL more();
+  BOOL next();
+
+  FILE* file;
+  int fd;
+  I64 file_size;
+  I32 format;
+  U32 threads;
+
+  // blocks (when number_blocks is not zero)
+  Block* blocks;
+  U32 number_blocks;
+  U32 alloced_blocks;
+  U32 batch_first;
+  U32 batch_end;
+  Job* jobs;
+
+  // one stream
+  void* decompressor;
+  U8* in_buffer;
+  U8* in_next;
+  U32 in_avail;
+  I64 in_offset;
+
+  // the uncompressed bytes [buffer_start, buffer_start + (end - buffer))
+  U8* buffer;
+  I64 alloced_buffer;
+  U8* current;
+  U8* end;
+  I64 buffer_start;
+  I64 size;       // uncompressed size or -1 while unknown
+  U8 swapped[8];
+};
+
+#endif
+
+#endif
@@ -0,0 +1,119 @@
+/*
+===============================================================================
+
+  FILE:  lascatalog.hpp
+
+  CONTENTS:
+
+    A catalog of a collection of LAS/LAZ files (e.g. the tiles of a statewide
+    survey) that is stored in a single sidecar file so that a query needs to
+    open only the files whose bounding box intersects it. p_laszip builds it
+    in parallel with '-build_catalog tiles.lac' and LASreadOpener uses it with
+    '-catalog tiles.lac' together with '-inside', '-inside_tile', or
+    '-inside_circle'.
+
+    The catalog file is little-endian:
+      CHAR signature "LASC"                   4 bytes
+      U32  version                            4 bytes
+      U32  number_of_files                    4 bytes
+      for each file
+        U16  file_name_length                 2 bytes
+        CHAR file_name[file_name_length]      (not zero-terminated)
+        I64  number_of_point_records          8 bytes
+        U8   point_data_format                1 byte
+        U16  point_data_record_length         2 bytes
+        F64  x, y, z scale_factor            24 bytes
+        F64  x, y, z offset                  24 bytes
+        F64  min_x, min_y, min_z             24 bytes
+        F64  max_x, max_y, max_z             24 bytes
+        U32  lax_cells                        4 bytes (zero without LAX)
+        U32  lax_intervals                    4 bytes
+    File names are stored as they were given when the catalog was built.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for area-of-interest queries on tile collections
+
+===============================================================================
+*/
+#ifndef LAS_CATALOG_HPP
+#define LAS_CATALOG_HPP
+
+#include "lasdefinitions.hpp"
+
+#define LAS_CATALOG_VERSION 1
+
+class ByteStreamIn;
+class ByteStreamOut;
+
+struct LAScatalogEntry
+{
+  CHAR* file_name;
+  I64 number_of_point_records;
+  U8 point_data_format;
+  U16 point_data_record_length;
+  F64 scale_factor[3];
+  F64 offset[3];
+  F64 min[3];
+  F64 max[3];
+  U32 lax_cells;
+  U32 lax_intervals;
+};
+
+class LASLIB_DLL LAScatalog
+{
+public:
+  // add a LAS/LAZ file by peeking at its header and its LAX file
+  BOOL add(const CHAR* file_name);
+  BOOL add(const LAScatalogEntry* entry);
+
+  // read from file or write to file
+  BOOL read(const CHAR* file_name);
+  BOOL write(const CHAR* file_name) const;
+  BOOL read(ByteStreamIn* stream);
+  BOOL write(ByteStreamOut* stream) const;
+
+  // select the files whose bounding box intersects
+  U32 intersect_rectangle(const F64 r_min_x, const F64 r_min_y, const F64 r_max_x, const F64 r_max_y);
+  U32 intersect_tile(const F32 ll_x, const F32 ll_y, const F32 size);
+  U32 intersect_circle(const F64 center_x, const F64 center_y, const F64 radius);
+  U32 select_all();
+
+  inline U32 get_number_selected() const { return number_selected; };
+  inline const LAScatalogEntry* get_selected(const U32 i) const { return entries + selected[i]; };
+  inline U32 get_number_entries() const { return number_entries; };
+  inline const LAScatalogEntry* get_entry(const U32 i) const { return entries + i; };
+  I64 get_number_of_point_records() const;
+
+  void clean();
+
+  LAScatalog();
+  ~LAScatalog();
+
+private:
+  LAScatalogEntry* next_entry();
+  void select(const U32 i);
+
+  LAScatalogEntry* entries;
+  U32 number_entries;
+  U32 alloced_entries;
+  U32* selected;
+  U32 number_selected;
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*
+===============================================================================
+
+  FILE:  lasdataset.hpp
+
+  CONTENTS:
+
+    A LAS or LAZ file that is opened once and then read by many threads at
+    the same time. The LASdataset parses the header with its VLRs, decodes
+    the chunk table, and loads the spatial index (LAX) when there is one.
+    After open() it is never modified, so its const functions can be called
+    from any thread.
+
+    Every thread creates its own LAScursor. A cursor fetches the bytes of
+    one chunk with a single positioned read (pread) that does not move any
+    shared file position and decodes them with its own decoder and its own
+    item readers. As the chunks of LASzip are compressed independently of
+    each other, any cursor can start at any chunk. Uncompressed LAS files
+    are divided into chunks of LAS_DATASET_CHUNK_SIZE points.
+
+    LASdataset dataset;
+    dataset.open("lidar.laz");
+    // in every thread
+    LAScursor* cursor = dataset.create_cursor();
+    for (chunk = first; chunk < last; chunk++)
+    {
+      cursor->seek_chunk(chunk);
+      for (i = 0; i < dataset.get_chunk_points(chunk); i++)
+      {
+        cursor->read_point();
+        ... cursor->point ...
+      }
+    }
+    delete cursor;
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for reading one file with many threads
+
+===============================================================================
+*/
+#ifndef LAS_DATASET_HPP
+#define LAS_DATASET_HPP
+
+#include "lasdefinitions.hpp"
+
+#define LAS_DATASET_CHUNK_SIZE 50000
+
+class LASreaderLAS;
+class LASreadPoint;
+class ByteStreamIn;
+class LASindex;
+class LAScursor;
+
+class LASLIB_DLL LASdataset
+{
+public:
+  BOOL open(const CHAR* file_name);
+  void close();
+
+  inline const LASheader* get_header() const { return header; };
+  inline I64 get_npoints() const { return npoints; };
+  inline BOOL is_compressed() const { return compressed; };
+  inline const LASindex* get_index() const { return index; };
+
+  inline U32 get_number_chunks() const { return number_chunks; };
+  // the index of the first point of a chunk and its number of points
+  inline I64 get_chunk_start(const U32 chunk) const { return chunk_firsts[chunk]; };
+  inline I64 get_chunk_points(const U32 chunk) const { return chunk_firsts[chunk+1] - chunk_firsts[chunk]; };
+  // the chunk that holds the point with this index
+  U32 get_chunk(const I64 p_index) const;
+
+  // reads the bytes [start, start+size) without moving a file position
+  BOOL read_bytes(U8* bytes, const I64 start, const I64 size) const;
+
+  // every thread needs its own cursor. delete it before closing the dataset
+  LAScursor* create_cursor() const;
+
+  LASdataset();
+  ~LASdataset();
+
+private:
+  friend class LAScursor;
+
+  LASreaderLAS* lasreader;  // owns the header
+  const LASheader* header;
+  LASzip* laszip;           // the items of the file compressed pointwise
+  FILE* file;
+  I64 npoints;
+  BOOL compressed;
+  U32 number_chunks;
+  I64* chunk_firsts;        // number_chunks+1 point indices
+  I64* chunk_bytes;         // number_chunks+1 file offsets
+  I64 max_chunk_bytes;
+  LASindex* index;
+};
+
+class LASLIB_DLL LAScursor
+{
+public:
+  LASpoint point;
+  I64 p_count;              // the index of the next point
+
+  // fetches and starts decoding a chunk
+  BOOL seek_chunk(const U32 chunk);
+  // fetches the chunk of the point and skips the points before it
+  BOOL seek(const I64 p_index);
+  // reads the next point. at the end of a chunk the next one is fetched
+  BOOL read_point();
+
+  ~LAScursor();
+
+private:
+  friend class LASdataset;
+  LAScursor(const LASdataset* dataset);
+
+  const LASdataset* dataset;
+  LASreadPoint* reader;
+  ByteStreamIn* stream;
+  U8* buffer;
+  U32 current_chunk;
+  I64 chunk_end;            // the index after the last point of the current chunk
+};
+
+#endif
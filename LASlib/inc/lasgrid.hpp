@@ -0,0 +1,112 @@
+/*
+===============================================================================
+
+  FILE:  lasgrid.hpp
+
+  CONTENTS:
+
+    A raster of square cells that accumulates the elevations of the points
+    falling into each cell in order to produce DEM or DSM grids. Per cell it
+    can keep the lowest, the highest, and the mean elevation, the number of
+    points, and an inverse distance weighted (IDW) elevation where each point
+    is weighted by its inverse squared distance to the cell center. Only the
+    accumulators of the requested methods are allocated.
+
+    All accumulators are sums, minima, or maxima so that the partial grids
+    of several processes can be combined cell by cell. The merged grid is
+    written either as an ESRI ASCII grid (*.asc) or as a single-band 32 bit
+    float BIL raster (*.bil with an *.hdr file).
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for producing DEM/DSM rasters while compressing
+
+===============================================================================
+*/
+#ifndef LAS_GRID_HPP
+#define LAS_GRID_HPP
+
+#include "lasdefinitions.hpp"
+
+#define LAS_GRID_MIN    0x01
+#define LAS_GRID_MAX    0x02
+#define LAS_GRID_MEAN   0x04
+#define LAS_GRID_COUNT  0x08
+#define LAS_GRID_IDW    0x10
+
+#define LAS_GRID_NODATA -9999.0f
+
+class LASLIB_DLL LASgrid
+{
+public:
+  // the raster covers the bounding box with cells aligned to multiples of step
+  BOOL setup(const F64 min_x, const F64 min_y, const F64 max_x, const F64 max_y, const F32 step, const U32 methods);
+
+  // restrict to a set of classifications (all points are used if none is set)
+  void add_class(const U32 classification);
+
+  void add(const LASpoint* point);
+
+  // the value of one cell for one method or LAS_GRID_NODATA for empty cells
+  F32 get_value(const U32 method, const U32 col, const U32 row) const;
+
+  // writes *.asc or *.bil (with *.hdr) depending on the extension
+  BOOL write(const CHAR* file_name, const U32 method) const;
+
+  // parses "min", "max", "mean", "count", or "idw"
+  static U32 parse_method(const CHAR* name);
+  static const CHAR* get_method_name(const U32 method);
+
+  inline U32 get_methods() const { return methods; };
+  inline U32 get_cols() const { return cols; };
+  inline U32 get_rows() const { return rows; };
+  inline U32 get_number_cells() const { return cols*rows; };
+  inline F32 get_step() const { return step; };
+
+  // the accumulators in row-major order starting at the lowest row
+  inline U32* get_count() { return count; };
+  inline F32* get_min() { return min; };
+  inline F32* get_max() { return max; };
+  inline F64* get_sum() { return sum; };
+  inline F64* get_idw_sum() { return idw_sum; };
+  inline F64* get_idw_weight() { return idw_weight; };
+
+  void clean();
+
+  LASgrid();
+  ~LASgrid();
+
+private:
+  BOOL write_asc(const CHAR* file_name, const U32 method) const;
+  BOOL write_bil(const CHAR* file_name, const U32 method) const;
+
+  U32 methods;
+  U32 class_mask;
+  F32 step;
+  F64 orig_x, orig_y;   // lower left corner of the raster
+  U32 cols, rows;
+
+  U32* count;
+  F32* min;
+  F32* max;
+  F64* sum;
+  F64* idw_sum;
+  F64* idw_weight;
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+===============================================================================
+
+  FILE:  laslod.hpp
+
+  CONTENTS:
+
+    Describes the coarse-to-fine level-of-detail (LOD) layout that p_laszip
+    can write into a LAZ file. The points are assigned to the nodes of a
+    quadtree by subsampling. Each level keeps at most one point per cell of
+    a sampling grid that is 'spacing' levels finer than the node itself and
+    the last level takes all remaining points. Every node is stored as its
+    own variable-sized chunk and the chunks follow each other level by level
+    (and within a level in the Morton order of LASquadtree::get_level_index)
+    so that the first get_number_of_points(level) points of the file are an
+    overview of the entire point cloud.
+
+    The hierarchy is stored in a VLR with user ID "p_laszip" and record ID 1:
+      U32  version                       4 bytes
+      U32  levels                        4 bytes
+      U32  spacing                       4 bytes
+      F32  min_x, max_x, min_y, max_y   16 bytes
+      for each level
+        U32  number_of_nodes             4 bytes
+        I64  number_of_points            8 bytes
+      for each node (in chunk order)
+        U32  level_index                 4 bytes
+    which totals 28 + 12*levels + 4*nodes
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the hierarchical LOD output of p_laszip
+
+===============================================================================
+*/
+#ifndef LAS_LOD_HPP
+#define LAS_LOD_HPP
+
+#include "lasdefinitions.hpp"
+#include "lasquadtree.hpp"
+
+#define LAS_LOD_USER_ID          "p_laszip"
+#define LAS_LOD_RECORD_ID        1
+#define LAS_LOD_VERSION          1
+#define LAS_LOD_MAX_DEPTH        16
+#define LAS_LOD_SPACING_DEFAULT  7
+
+class LASLIB_DLL LASlod
+{
+public:
+  // for building the hierarchy
+  BOOL setup(const F64 min_x, const F64 max_x, const F64 min_y, const F64 max_y, const U32 levels, const U32 spacing=LAS_LOD_SPACING_DEFAULT);
+  static U32 auto_levels(const I64 npoints, const U32 spacing=LAS_LOD_SPACING_DEFAULT);
+
+  // morton index of a point in the finest sampling grid
+  inline U32 get_deep_index(const F64 x, const F64 y) const { return quadtree.get_level_index(x, y, depth); };
+  // index of the node containing the point at this level
+  inline U32 get_node_index(const U32 deep_index, const U32 level) const { return (U32)(((U64)deep_index) >> (2*(depth-level))); };
+  // index of the sampling cell containing the point at this level
+  inline U32 get_sample_index(const U32 deep_index, const U32 level) const { return (U32)(((U64)deep_index) >> (2*(depth-level-spacing))); };
+
+  // nodes must be added level by level in chunk order
+  BOOL add_level(const U32 level, const U32 number_of_nodes, const U32* level_indices, const I64 number_of_points);
+
+  // how many of the first points of the file make up all levels up to this one
+  I64 get_number_of_points(const U32 level) const;
+  U32 get_number_of_nodes(const U32 level) const;
+  const U32* get_level_indices(const U32 level) const;
+
+  // pack to and unpack from VLR
+  BOOL pack(U8** data, U16* record_length) const;
+  BOOL unpack(const U8* data, const U16 record_length);
+  BOOL unpack(const LASheader* header);
+
+  LASquadtree quadtree;
+  U32 levels;
+  U32 spacing;
+  U32 depth;
+
+  LASlod();
+  ~LASlod();
+
+private:
+  void clean();
+  U32* level_nodes;
+  I64* level_points;
+  U32** level_indices;
+};
+
+#endif
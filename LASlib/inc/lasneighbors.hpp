@@ -0,0 +1,122 @@
+/*
+===============================================================================
+
+  FILE:  lasneighbors.hpp
+
+  CONTENTS:
+
+    Answers batches of k-nearest-neighbor and fixed-radius queries on a
+    LAS/LAZ file that has a spatial index (LAX) without decompressing all of
+    it. The bounding box is split into square tiles. The first query that
+    needs a tile reads its points with one indexed inside_rectangle() query
+    and sorts them into a small grid of buckets. Tiles stay cached until more
+    than 'max_points' points are held, then the least recently used ones are
+    dropped. The queries of a batch are answered in tile order so that every
+    tile, and with it the chunks holding its points, is usually decompressed
+    only once. The search visits the buckets in growing rings around the
+    query point, so distances can be 2D (x and y) or 3D (x, y, and z).
+
+    Each neighbor reports the index of the point in the file so that other
+    attributes can be read with LASreader::seek().
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for normal estimation and outlier detection
+
+===============================================================================
+*/
+#ifndef LAS_NEIGHBORS_HPP
+#define LAS_NEIGHBORS_HPP
+
+#include "lasreader.hpp"
+
+#define LAS_NEIGHBORS_TILE_POINTS    262144
+#define LAS_NEIGHBORS_BUCKET_POINTS  8
+#define LAS_NEIGHBORS_MAX_POINTS     16777216
+
+struct LASneighbor
+{
+  I64 index;        // of the point in the file
+  F64 x, y, z;
+  F64 distance;
+};
+
+class LASneighborsTile;
+
+class LASLIB_DLL LASneighbors
+{
+public:
+  // the reader must have a spatial index. it is used for nothing else while
+  // the queries run. tile_size zero picks tiles of about 262144 points
+  BOOL open(LASreader* lasreader, const BOOL use_z=TRUE, const F64 tile_size=0.0, const I64 max_points=LAS_NEIGHBORS_MAX_POINTS);
+
+  // the k nearest points of each query point (x, y, z triples) sorted by
+  // distance. those of query i are neighbors[i*k] to neighbors[i*k+found[i]-1]
+  BOOL knn(const U32 number, const F64* queries, const U32 k, LASneighbor* neighbors, U32* found);
+
+  // all points within the radius of each query point in no particular order.
+  // those of query i are (*neighbors)[offsets[i]] to (*neighbors)[offsets[i+1]-1].
+  // the array is grown with realloc() and *alloced is its size
+  BOOL radius(const U32 number, const F64* queries, const F64 radius, LASneighbor** neighbors, I64* alloced, I64* offsets);
+
+  // statistics
+  inline U32 get_tiles_loaded() const { return tiles_loaded; };
+  inline I64 get_points_loaded() const { return points_loaded; };
+
+  void close();
+
+  LASneighbors();
+  ~LASneighbors();
+
+private:
+  inline I32 get_bucket_x(const F64 x) const;
+  inline I32 get_bucket_y(const F64 y) const;
+  inline F64 get_distance(const F64* query, const I32* xyz) const;
+  LASneighborsTile* get_tile(const I32 tile_x, const I32 tile_y);
+  BOOL load_tile(LASneighborsTile* tile, const I32 tile_x, const I32 tile_y);
+  void evict_tiles();
+  BOOL add_knn(const F64* query, const U32 k, LASneighbor* neighbors, U32* count, const I32 bx, const I32 by);
+  BOOL search_knn(const F64* query, const U32 k, LASneighbor* neighbors, U32* found);
+  BOOL order(const U32 number, const F64* queries);
+
+  LASreader* lasreader;
+  BOOL use_z;
+  F64 min_x, min_y, max_x, max_y;
+  F64 tile_size;
+  F64 bucket_size;
+  I32 tiles_x, tiles_y;
+  I32 buckets;          // per tile in x and y
+  I32 buckets_x, buckets_y;
+  I64 max_points;
+  I64 cached_points;
+  U32 clock;
+  void* tiles;
+  U32 tiles_loaded;
+  I64 points_loaded;
+
+  U32* sorted;
+  U32 alloced_sorted;
+
+  // scratch for reading a tile
+  I32* read_xyz;
+  I64* read_index;
+  U32* read_bucket;
+  U32 alloced_read;
+};
+
+#endif
@@ -0,0 +1,201 @@
+/*
+===============================================================================
+
+  FILE:  laspipeline.hpp
+
+  CONTENTS:
+
+    Moves the points of a LASreader through a chain of stages in blocks.
+    Each stage (clip, grid, index, statistics, write, or one of its own)
+    gets a block of points at a time and may remove points from it. The
+    stages are added in the order they are to run.
+
+    Without threads, run() reads a block and passes it through all stages
+    before it reads the next one. With threads, every stage runs on its own
+    thread and the blocks are passed along through bounded queues, so that
+    reading, clipping, and compressing overlap. A stage that can clone()
+    itself may process several blocks at once on multiple threads. Blocks
+    always leave a stage in the order in which they were read, so a writer
+    stage writes the same bytes either way. The copies of a stage are given
+    back to it with merge() after the last block.
+
+    LASpipeline pipeline;
+    pipeline.add(new LASpipelineClip(polygon), 2);
+    pipeline.add(new LASpipelineWriter(laswriter, TRUE));
+    pipeline.set_threaded(TRUE);
+    pipeline.run(lasreader);
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for composing the steps of p_laszip
+
+===============================================================================
+*/
+#ifndef LAS_PIPELINE_HPP
+#define LAS_PIPELINE_HPP
+
+#include "lasdefinitions.hpp"
+
+#define LAS_PIPELINE_BLOCK_SIZE 4096
+#define LAS_PIPELINE_QUEUE_SIZE 4
+
+class LASreader;
+class LASwriter;
+class LASpolygon;
+class LASgrid;
+class LASindex;
+class LASpipelineRun;
+
+class LASLIB_DLL LASpipelineBlock
+{
+public:
+  LASpoint* points;
+  U32 number;
+  U32 capacity;
+  I64 sequence;   // of the block in the run
+  I64 first;      // number of points read before this block
+
+  // moves the points for which keep[i] is TRUE to the front
+  void compact(const BOOL* keep);
+
+  LASpipelineBlock();
+  ~LASpipelineBlock();
+};
+
+class LASLIB_DLL LASpipelineStage
+{
+public:
+  virtual const CHAR* name() const = 0;
+  virtual BOOL open(const LASheader* header) { return TRUE; };
+  virtual BOOL process(LASpipelineBlock* block) = 0;
+  virtual BOOL close() { return TRUE; };
+  // a stage that may process several blocks at the same time returns a
+  // new copy of itself for every additional thread and later takes back
+  // the results of each copy with merge()
+  virtual LASpipelineStage* clone() const { return 0; };
+  virtual BOOL merge(const LASpipelineStage* copy) { return TRUE; };
+  virtual ~LASpipelineStage() {};
+};
+
+// removes the points outside the polygon
+class LASLIB_DLL LASpipelineClip : public LASpipelineStage
+{
+public:
+  const CHAR* name() const { return "clip"; };
+  BOOL process(LASpipelineBlock* block);
+  LASpipelineStage* clone() const;
+  LASpipelineClip(const LASpolygon* polygon);
+  ~LASpipelineClip();
+private:
+  const LASpolygon* polygon;
+  BOOL* keep;
+  U32 alloc;
+};
+
+// accumulates the points into a raster
+class LASLIB_DLL LASpipelineGrid : public LASpipelineStage
+{
+public:
+  const CHAR* name() const { return "grid"; };
+  BOOL process(LASpipelineBlock* block);
+  LASpipelineGrid(LASgrid* grid);
+private:
+  LASgrid* grid;
+};
+
+// adds the points to a spatial index in the order in which they arrive,
+// which is the order in which a writer stage after it writes them
+class LASLIB_DLL LASpipelineIndex : public LASpipelineStage
+{
+public:
+  const CHAR* name() const { return "index"; };
+  BOOL process(LASpipelineBlock* block);
+  LASpipelineIndex(LASindex* index);
+private:
+  LASindex* index;
+  U32 count;
+};
+
+// counts points, returns, and classifications and keeps the bounding box
+class LASLIB_DLL LASpipelineStats : public LASpipelineStage
+{
+public:
+  I64 number_of_point_records;
+  I64 number_of_points_by_return[16];
+  I64 classification[256];
+  I32 min_X, max_X, min_Y, max_Y, min_Z, max_Z;
+
+  const CHAR* name() const { return "stats"; };
+  BOOL process(LASpipelineBlock* block);
+  LASpipelineStage* clone() const;
+  BOOL merge(const LASpipelineStage* copy);
+  void print(FILE* file, const LASheader* header) const;
+  LASpipelineStats();
+};
+
+// writes the points and maybe updates the inventory of the writer
+class LASLIB_DLL LASpipelineWriter : public LASpipelineStage
+{
+public:
+  const CHAR* name() const { return "write"; };
+  BOOL process(LASpipelineBlock* block);
+  LASpipelineWriter(LASwriter* writer, const BOOL inventory=FALSE);
+private:
+  LASwriter* writer;
+  BOOL inventory;
+};
+
+class LASLIB_DLL LASpipeline
+{
+public:
+  // the pipeline deletes the stage and its copies. 'threads' above one is
+  // only used for stages that can clone() themselves
+  BOOL add(LASpipelineStage* stage, const U32 threads=1);
+
+  void set_threaded(const BOOL threaded);
+  void set_block_size(const U32 block_size);
+  void set_queue_size(const U32 queue_size);
+
+  // reads up to 'number' points (all if negative) from where the reader is
+  // and moves them through the stages. returns the number of points read
+  // or -1 if reading or a stage failed
+  I64 run(LASreader* lasreader, const I64 number=-1);
+
+  inline U32 get_number_stages() const { return number_stages; };
+  inline LASpipelineStage* get_stage(const U32 s) const { return (s < number_stages ? stages[s] : 0); };
+  inline const CHAR* get_error() const { return error; };
+
+  LASpipeline();
+  ~LASpipeline();
+
+private:
+  I64 run_serial(LASreader* lasreader, const I64 number);
+  I64 run_threaded(LASreader* lasreader, const I64 number);
+  BOOL open_stages(const LASheader* header);
+  BOOL close_stages();
+
+  U32 number_stages;
+  LASpipelineStage** stages;
+  U32* threads;
+  BOOL threaded;
+  U32 block_size;
+  U32 queue_size;
+  CHAR error[256];
+};
+
+#endif
@@ -0,0 +1,115 @@
+/*
+===============================================================================
+
+  FILE:  laspolygon.hpp
+
+  CONTENTS:
+
+    Polygons (for example project boundaries read from an ESRI shapefile of
+    type Polygon, PolygonZ, or PolygonM) to clip points against. All rings
+    of all polygons are combined with the even-odd rule so that holes work
+    without knowing the orientation of the rings.
+
+    prepare() lays a raster of square cells over the bounding box and marks
+    every cell that an edge passes through as a boundary cell. The other
+    cells are entirely inside or entirely outside and are classified once by
+    the parity of the edge crossings at their center. The edges are also
+    sorted into the rows of the raster. A point in an inside or outside cell
+    is decided by a lookup, and only a point in a boundary cell is tested
+    against the edges of its row. The batch version of the test runs a
+    branch-free loop over these edges that the compiler can vectorize.
+
+    classify() tells whether an axis-aligned box (e.g. a cell of the LAX
+    quadtree) is inside, outside, or on the boundary, so that whole cells
+    of a spatial index can be skipped before their points are read.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for clipping to project boundaries in p_laszip
+
+===============================================================================
+*/
+#ifndef LAS_POLYGON_HPP
+#define LAS_POLYGON_HPP
+
+#include "lasdefinitions.hpp"
+
+#define LAS_POLYGON_OUTSIDE   0
+#define LAS_POLYGON_INSIDE    1
+#define LAS_POLYGON_BOUNDARY  2
+
+#define LAS_POLYGON_RASTER_SIZE 512
+
+class LASLIB_DLL LASpolygon
+{
+public:
+  // add all rings of the polygons of a shapefile
+  BOOL read_shp(const CHAR* file_name);
+
+  // add one ring of 'number' x/y pairs. it is closed implicitly
+  BOOL add_ring(const U32 number, const F64* xy);
+
+  // builds the raster. cell_size zero uses about 512 cells along the longer side
+  BOOL prepare(const F64 cell_size=0.0);
+
+  // inside, outside, or boundary
+  I32 classify(const F64 min_x, const F64 min_y, const F64 max_x, const F64 max_y) const;
+
+  // test one point or a batch of points (result is 1 for inside and 0 for outside)
+  BOOL inside(const F64 x, const F64 y) const;
+  void inside(const U32 number, const F64* x, const F64* y, U8* result) const;
+
+  inline U32 get_number_rings() const { return number_rings; };
+  inline U32 get_number_edges() const { return number_edges; };
+  inline F64 get_min_x() const { return min_x; };
+  inline F64 get_min_y() const { return min_y; };
+  inline F64 get_max_x() const { return max_x; };
+  inline F64 get_max_y() const { return max_y; };
+  inline F64 get_cell_size() const { return cell_size; };
+
+  void clean();
+
+  LASpolygon();
+  ~LASpolygon();
+
+private:
+  inline I32 get_col(const F64 x) const;
+  inline I32 get_row(const F64 y) const;
+  BOOL inside_row(const F64 x, const F64 y, const I32 row) const;
+
+  // edges as added
+  F64* edges;           // x0, y0, x1, y1 per edge
+  U32 number_edges;
+  U32 alloced_edges;
+  U32 number_rings;
+  F64 min_x, min_y, max_x, max_y;
+
+  // raster
+  F64 cell_size;
+  I32 cols, rows;
+  U8* cells;
+
+  // edges of each row. row r has entries [row_start[r], row_start[r+1])
+  U32* row_start;
+  F64* row_x0;
+  F64* row_y0;
+  F64* row_y1;
+  F64* row_slope;       // dx/dy
+};
+
+#endif
@@ -25,6 +25,11 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- added '-clip_polygon boundary.shp' to clip to the polygons of a shapefile
+    18 October 2026 -- added '-catalog tiles.lac' to only open the tiles of an AOI
+    18 October 2026 -- added '-decompress_threads n' for gzipped or zstd input
+    18 October 2026 -- prefetch() the chunks of the intervals of a spatial index query
+    18 October 2026 -- read LAS or LAZ from a buffer in memory with set_memory()
      7 February 2014 -- added option '-apply_file_source_ID' when reading LAS/LAZ
     22 August 2012 -- added the '-pipe_on' option for a multi-stage LAStools pipeline
     11 August 2012 -- added on-the-fly buffered reading of LiDAR files (efficient with LAX)
@@ -47,6 +52,8 @@
 class LASindex;
 class LASfilter;
 class LAStransform;
+class LAScatalog;
+class LASpolygon;
 class ByteStreamIn;
 
 class LASLIB_DLL LASreader
@@ -85,6 +92,8 @@ public:
   inline F64 get_r_max_y() const { return r_max_y; };
 
   virtual BOOL seek(const I64 p_index) = 0;
+  // the points in [starts[i], ends[i]] will be read next so the reader may fetch them ahead
+  virtual BOOL prefetch(const U32 number_intervals, const I64* starts, const I64* ends) { return FALSE; };
   BOOL read_point() { return (this->*read_simple)(); };
 
   inline void compute_coordinates() { point.compute_coordinates(); };
@@ -143,6 +152,8 @@ private:
   BOOL read_point_inside_circle_indexed();
   BOOL read_point_inside_rectangle();
   BOOL read_point_inside_rectangle_indexed();
+
+  void prefetch_index();
 };
 
 #include "laswaveform13reader.hpp"
@@ -152,6 +163,8 @@ class LASLIB_DLL LASreadOpener
 public:
   void set_io_ibuffer_size(I32 io_ibuffer_size);
   inline I32 get_io_ibuffer_size() const { return io_ibuffer_size; };
+  void set_decompress_threads(U32 decompress_threads);
+  inline U32 get_decompress_threads() const { return decompress_threads; };
   U32 get_file_name_number() const;
   U32 get_file_name_current() const;
   const CHAR* get_file_name() const;
@@ -159,6 +172,10 @@ public:
   void set_file_name(const CHAR* file_name, BOOL unique=FALSE);
   BOOL add_file_name(const CHAR* file_name, BOOL unique=FALSE);
   BOOL add_list_of_files(const CHAR* list_of_files, BOOL unique=FALSE);
+  BOOL set_catalog(const CHAR* catalog_name);
+  inline const LAScatalog* get_catalog() const { return catalog; };
+  BOOL set_clip_polygon(const CHAR* shp_file_name);
+  inline const LASpolygon* get_clip_polygon() const { return polygon; };
   void delete_file_name(U32 file_name_id);
   BOOL set_file_name_current(U32 file_name_id);
   I32 get_file_format(U32 number) const;
@@ -188,6 +205,7 @@ public:
   void set_populate_header(BOOL populate_header);
   void set_keep_lastiling(BOOL keep_lastiling);
   void set_pipe_on(BOOL pipe_on);
+  void set_memory(const U8* data, const I64 size);
   const CHAR* get_parse_string() const;
   void usage() const;
   void set_inside_tile(const F32 ll_x, const F32 ll_y, const F32 size);
@@ -215,7 +233,9 @@ private:
   BOOL add_file_name_single(const CHAR* file_name, BOOL unique=FALSE);
   BOOL add_neighbor_file_name_single(const CHAR* neighbor_file_name, BOOL unique=FALSE);
 #endif
+  void add_catalog_file_names();
   I32 io_ibuffer_size;
+  U32 decompress_threads;
   CHAR** file_names;
   const CHAR* file_name;
   BOOL merged;
@@ -253,6 +273,9 @@ private:
   BOOL keep_lastiling;
   BOOL pipe_on;
   BOOL use_stdin;
+  BOOL use_memory;
+  const U8* memory_data;
+  I64 memory_size;
   BOOL unique;
 
   // optional extras
@@ -260,6 +283,13 @@ private:
   LASfilter* filter;
   LAStransform* transform;
 
+  // optional catalog of tiles whose files are added once the query is known
+  LAScatalog* catalog;
+  BOOL catalog_pending;
+
+  // optional polygons to clip to
+  LASpolygon* polygon;
+
   // optional area-of-interest query (spatially indexed) 
   F32* inside_tile;
   F64* inside_circle;
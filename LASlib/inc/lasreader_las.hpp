@@ -24,6 +24,9 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- read gzipped and zstd compressed LAS or LAZ files directly
+    18 October 2026 -- on Linux files are read with io_uring once chunks are prefetched
+    18 October 2026 -- open LAS or LAZ directly from a buffer in memory
     13 October 2014 -- changed default IO buffer size with setvbuf() to 262144
     27 August 2014 -- peek bounding box to open many file with lasreadermerged
      9 July 2012 -- fixed crash that occured when input had a corrupt VLRs
@@ -56,13 +59,18 @@ class LASreaderLAS : public LASreader
 {
 public:
 
+  // gzipped or zstd compressed files are decompressed with this many threads
+  void set_decompress_threads(U32 decompress_threads);
   BOOL open(const char* file_name, I32 io_buffer_size=LAS_TOOLS_IO_IBUFFER_SIZE, BOOL peek_only=FALSE);
   BOOL open(FILE* file, BOOL peek_only=FALSE);
   BOOL open(istream& stream, BOOL peek_only=FALSE);
+  // reads from the buffer without copying it. it must stay valid until close()
+  BOOL open(const U8* data, const I64 size, BOOL peek_only=FALSE);
 
   I32 get_format() const;
 
   BOOL seek(const I64 p_index);
+  BOOL prefetch(const U32 number_intervals, const I64* starts, const I64* ends);
 
   ByteStreamIn* get_stream() const;
   void close(BOOL close_stream=TRUE);
@@ -75,6 +83,7 @@ protected:
   virtual BOOL read_point_default();
 
 private:
+  U32 decompress_threads;
   FILE* file;
   ByteStreamIn* stream;
   LASreadPoint* reader;
@@ -8,6 +8,10 @@
     Reads LIDAR points from another LASreader and writes them also to the stdout
     before returning them to the instance that is reading the points.
 
+    The points for the stdout are copied in batches into a single-producer,
+    single-consumer ring buffer and compressed by a background writer thread
+    so that the reading instance does not wait on the compression.
+
   PROGRAMMERS:
 
     martin.isenburg@rapidlasso.com  -  http://rapidlasso.com
@@ -25,6 +29,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- tee to stdout with a background writer thread
     21 August 2012 -- created after swimming in the Main river 3 days in a row
   
 ===============================================================================
@@ -35,6 +40,8 @@
 #include "lasreader.hpp"
 #include "laswriter.hpp"
 
+class LASteeRing;
+
 class LASreaderPipeOn : public LASreader
 {
 public:
@@ -65,8 +72,11 @@ protected:
   BOOL read_point_default();
 
 private:
+  BOOL tee_start();
+  void tee_finish();
   LASreader* lasreader;
   LASwriter* laswriter;
+  LASteeRing* tee;
 };
 
 #endif
@@ -8,6 +8,12 @@
     Interface to read the Waveform Data Packets that are associated with points
     of type 4 and 5 in LAS 1.3.
 
+    read_waveforms() fetches the waveforms of a whole block of points at once.
+    It sorts their packets by offset, reads packets that lie close together
+    with one large read (plus read-ahead that the next block may use), and
+    decodes them from memory. select_waveform() then makes the waveform of
+    the i-th point of the block current as if read_waveform() had read it.
+
   PROGRAMMERS:
 
     martin.isenburg@rapidlasso.com  -  http://rapidlasso.com
@@ -25,6 +31,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- batched reading of waveforms sorted by their offsets
     17 October 2011 -- created after bauarbeiter on the roof next door woke me
   
 ===============================================================================
@@ -33,11 +40,12 @@
 #define LAS_WAVEFORM_13_READER_HPP
 
 #include "lasdefinitions.hpp"
+#include "integercompressor.hpp"
 
 class ByteStreamIn;
 class LASwaveformDescription;
 class ArithmeticDecoder;
-class IntegerCompressor;
+struct LASwaveform13packet;
 
 class LASwaveform13reader
 {
@@ -64,6 +72,12 @@ public:
 
   BOOL read_waveform(const LASpoint* point);
 
+  // reads the waveforms of 'number' points in file order. returns FALSE only
+  // if reading fails. points without a waveform are skipped quietly
+  BOOL read_waveforms(const U32 number, const LASpoint * const * points);
+  // FALSE if the i-th point of the last block had no (readable) waveform
+  BOOL select_waveform(const U32 i);
+
   BOOL get_samples();
   BOOL has_samples();
 
@@ -86,6 +100,20 @@ private:
   ArithmeticDecoder* dec;
   IntegerCompressor* ic8;
   IntegerCompressor* ic16;
+
+  BOOL set_waveform(const LASpoint* point, U32* index);
+  BOOL read_samples(ByteStreamIn* in, const U32 index, U8* out);
+
+  U32 batch_number;
+  U32 batch_alloc;
+  LASwaveform13packet* batch;
+  LASwaveform13packet* batch_sorted;
+  U8* batch_samples;
+  U32 batch_samples_alloc;
+  U8* buffer;
+  U32 buffer_alloc;
+  I64 buffer_start;
+  I64 buffer_end;
 };
 
 #endif
@@ -33,11 +33,11 @@
 #define LAS_WAVEFORM_13_WRITER_HPP
 
 #include "lasdefinitions.hpp"
+#include "integercompressor.hpp"
 
 class ByteStreamOut;
 class LASwaveformDescription;
 class ArithmeticEncoder;
-class IntegerCompressor;
 
 class LASwaveform13writer
 {
@@ -25,6 +25,11 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- '-profile scanline' for scan line aware LAZ compression
+    18 October 2026 -- '-profile fast|default|max' selects the LAZ item versions
+    18 October 2026 -- '-rans' compresses LAZ with the rANS instead of the arithmetic coder
+    18 October 2026 -- write LAS or LAZ into memory with set_use_memory() and take_data()
+    18 October 2026 -- rank-range contract for parallel BIN, QFIT, TXT, and WRL output
     5 September 2011 -- support for writing Terrasolid's BIN format
     11 June 2011 -- billion point support: p_count & npoints are 64 bit counters
     8 May 2011 -- DO NOT USE option for variable chunking via chunk()
@@ -70,6 +75,17 @@ public:
   virtual ByteStreamOut* get_stream(){return 0;};
   virtual LASwritePoint* get_writer(){return 0;};
 
+  // mpi, rank-range contract for writers without a LASwritePoint (BIN, QFIT,
+  // TXT, WRL). the bytes they write alternate between shared pieces that are
+  // identical on every rank (header, trailer) and ranged pieces that hold the
+  // points of one rank. after close() get_range_marks() returns the offsets
+  // at which the pieces change, starting with the end of the header.
+  virtual void set_range_start(const I64 p_start) {};
+  virtual U32 get_range_marks(const I64** marks) const { return 0; };
+
+  // in-memory output. after close() the caller owns the file and must free() it
+  virtual U8* take_data(I64* size) { if (size) *size = 0; return 0; };
+
 };
 
 #include "laswaveform13writer.hpp"
@@ -87,6 +103,10 @@ public:
   BOOL set_format(const CHAR* format);
   void set_force(BOOL force);
   void set_chunk_size(U32 chunk_size);
+  void set_coder(U16 coder);
+  inline U16 get_coder() const { return coder; };
+  BOOL set_profile(const CHAR* profile);
+  inline U16 get_version() const { return version; };
   void make_numbered_file_name(const CHAR* file_name, I32 digits);
   void make_file_name(const CHAR* file_name, I32 file_number=-1);
   const CHAR* get_directory() const;
@@ -126,6 +146,18 @@ public:
     use_nil = useNil;
   }
 
+  // write BIN, QFIT, TXT, or WRL into this file instead (rank-range writing)
+  void set_range_file(FILE* rangeFile)
+  {
+    range_file = rangeFile;
+  }
+
+  // write LAS or LAZ into a growable buffer instead of a file (see take_data())
+  void set_use_memory(BOOL useMemory)
+  {
+    use_memory = useMemory;
+  }
+
 private:
   void add_directory(const CHAR* directory=0);
   void add_appendix(const CHAR* appendix=0);
@@ -144,8 +176,12 @@ private:
   BOOL specified;
   BOOL force;
   U32 chunk_size;
+  U16 coder;
+  U16 version;
   BOOL use_stdout;
   BOOL use_nil;
+  FILE* range_file;
+  BOOL use_memory;
   BOOL buffered;
 };
 
@@ -24,6 +24,9 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- close() with the final flush is recorded with LAStrace
+    18 October 2026 -- set_coder() selects the entropy coder for LAZ output
+    18 October 2026 -- write LAS or LAZ into a growable buffer in memory
     13 October 2014 -- changed default IO buffer size with setvbuf() to 262144
     5 November 2011 -- changed default IO buffer size with setvbuf() to 65536
     8 May 2011 -- added an option for variable chunking via chunk()
@@ -63,6 +66,10 @@ public:
   BOOL open(const char* file_name, const LASheader* header, U32 compressor=LASZIP_COMPRESSOR_NONE, I32 requested_version=0, I32 chunk_size=50000, I32 io_buffer_size=LAS_TOOLS_IO_OBUFFER_SIZE);
   BOOL open(FILE* file, const LASheader* header, U32 compressor=LASZIP_COMPRESSOR_NONE, I32 requested_version=0, I32 chunk_size=50000);
   BOOL open(ostream& ostream, const LASheader* header, U32 compressor=LASZIP_COMPRESSOR_NONE, I32 requested_version=0, I32 chunk_size=50000);
+  BOOL open_memory(const LASheader* header, U32 compressor=LASZIP_COMPRESSOR_NONE, I32 requested_version=0, I32 chunk_size=50000, I64 alloc=LAS_TOOLS_IO_OBUFFER_SIZE);
+
+  // LASZIP_CODER_ARITHMETIC (default) or LASZIP_CODER_RANS for the compressed points (call before open)
+  void set_coder(U16 coder) { this->coder = coder; };
 
   BOOL write_point(const LASpoint* point);
   BOOL chunk();
@@ -70,6 +77,9 @@ public:
   BOOL update_header(const LASheader* header, BOOL use_inventory=FALSE, BOOL update_extra_bytes=FALSE);
   I64 close(BOOL update_npoints=TRUE);
 
+  // after close() the caller owns the complete file written by open_memory() and must free() it
+  U8* take_data(I64* size);
+
   LASwriterLAS();
   ~LASwriterLAS();
 
@@ -82,6 +92,10 @@ private:
   ByteStreamOut* stream;
   LASwritePoint* writer;
   FILE* file;
+  BOOL memory;
+  U8* memory_data;
+  I64 memory_size;
+  U16 coder;
   I64 header_start_position;
   BOOL writing_las_1_4;
   BOOL writing_new_point_type;
@@ -53,10 +53,15 @@ public:
   BOOL update_header(const LASheader* header, BOOL use_inventory=FALSE, BOOL update_extra_bytes=FALSE);
   I64 close(BOOL update_npoints=TRUE);
 
+  // mpi, rank-range contract
+  U32 get_range_marks(const I64** marks) const { *marks = range_marks; return number_range_marks; };
+
   LASwriterQFIT();
   ~LASwriterQFIT();
 
 private:
+  I64 range_marks[4];
+  U32 number_range_marks;
   ByteStreamOut* stream;
   FILE* file;
   I32 version;
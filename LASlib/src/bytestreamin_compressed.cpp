@@ -0,0 +1,668 @@
+/*
+===============================================================================
+
+  FILE:  bytestreamin_compressed.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+#include "bytestreamin_compressed.hpp"
+
+#ifndef _WIN32
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// uncompressed bytes that each thread decompresses per batch of blocks
+#define BYTE_STREAM_IN_COMPRESSED_BATCH (4 << 20)
+// bytes read and decompressed per step when there are no blocks
+#define BYTE_STREAM_IN_COMPRESSED_PIECE (1 << 20)
+// larger blocks are not worth holding in memory as a whole
+#define BYTE_STREAM_IN_COMPRESSED_MAX_BLOCK (64 << 20)
+
+static inline U32 get_le32(const U8* bytes)
+{
+  return ((U32)bytes[0]) | ((U32)bytes[1] << 8) | ((U32)bytes[2] << 16) | ((U32)bytes[3] << 24);
+}
+
+ByteStreamInCompressed::ByteStreamInCompressed(FILE* file, U32 threads)
+{
+  this->file = file;
+  fd = fileno(file);
+  file_size = 0;
+  format = BYTE_STREAM_IN_COMPRESSED_NONE;
+  this->threads = (threads ? threads : 1);
+  blocks = 0;
+  number_blocks = 0;
+  alloced_blocks = 0;
+  batch_first = 0;
+  batch_end = 0;
+  jobs = 0;
+  decompressor = 0;
+  in_buffer = 0;
+  in_next = 0;
+  in_avail = 0;
+  in_offset = 0;
+  buffer = 0;
+  alloced_buffer = 0;
+  current = 0;
+  end = 0;
+  buffer_start = 0;
+  size = -1;
+}
+
+I32 ByteStreamInCompressed::get_format(FILE* file)
+{
+  U8 magic[4];
+  if (pread(fileno(file), magic, 4, 0) != 4) return BYTE_STREAM_IN_COMPRESSED_NONE;
+  if (magic[0] == 0x1F && magic[1] == 0x8B) return BYTE_STREAM_IN_COMPRESSED_GZIP;
+  if (get_le32(magic) == 0xFD2FB528) return BYTE_STREAM_IN_COMPRESSED_ZSTD;
+  return BYTE_STREAM_IN_COMPRESSED_NONE;
+}
+
+BOOL ByteStreamInCompressed::init()
+{
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    fprintf(stderr,"ERROR: cannot stat compressed input\n");
+    return FALSE;
+  }
+  file_size = (I64)st.st_size;
+  format = get_format(file);
+
+  BOOL scanned = FALSE;
+  if (format == BYTE_STREAM_IN_COMPRESSED_GZIP)
+  {
+#ifdef HAVE_ZLIB
+    scanned = scan_gzip();
+#else
+    fprintf(stderr,"ERROR: no support for gzipped input. build with zlib (-DHAVE_ZLIB)\n");
+    return FALSE;
+#endif
+  }
+  else if (format == BYTE_STREAM_IN_COMPRESSED_ZSTD)
+  {
+#ifdef HAVE_ZSTD
+    scanned = scan_zstd();
+#else
+    fprintf(stderr,"ERROR: no support for zstd input. build with 'make ZSTD=1' (-DHAVE_ZSTD)\n");
+    return FALSE;
+#endif
+  }
+  else
+  {
+    fprintf(stderr,"ERROR: input is neither gzipped nor zstd compressed\n");
+    return FALSE;
+  }
+
+  if (scanned && number_blocks)
+  {
+    jobs = (Job*)calloc(threads, sizeof(Job));
+    if (jobs == 0)
+    {
+      fprintf(stderr,"ERROR: allocating %u decompression jobs\n", threads);
+      return FALSE;
+    }
+    size = blocks[number_blocks-1].start + blocks[number_blocks-1].length;
+    batch_first = batch_end = 0;
+    buffer_start = 0;
+    return TRUE;
+  }
+
+  // one stream that is decompressed from the start
+  number_blocks = 0;
+  in_buffer = (U8*)malloc(BYTE_STREAM_IN_COMPRESSED_PIECE);
+  buffer = (U8*)malloc(BYTE_STREAM_IN_COMPRESSED_PIECE);
+  if (in_buffer == 0 || buffer == 0)
+  {
+    fprintf(stderr,"ERROR: allocating decompression buffers\n");
+    return FALSE;
+  }
+  alloced_buffer = BYTE_STREAM_IN_COMPRESSED_PIECE;
+#ifdef HAVE_ZLIB
+  if (format == BYTE_STREAM_IN_COMPRESSED_GZIP)
+  {
+    z_stream* z = (z_stream*)calloc(1, sizeof(z_stream));
+    if (z == 0 || inflateInit2(z, 16 + MAX_WBITS) != Z_OK)
+    {
+      fprintf(stderr,"ERROR: cannot initialize zlib\n");
+      free(z);
+      return FALSE;
+    }
+    decompressor = z;
+  }
+#endif
+#ifdef HAVE_ZSTD
+  if (format == BYTE_STREAM_IN_COMPRESSED_ZSTD)
+  {
+    ZSTD_DStream* z = ZSTD_createDStream();
+    if (z == 0)
+    {
+      fprintf(stderr,"ERROR: cannot initialize zstd\n");
+      return FALSE;
+    }
+    decompressor = z;
+  }
+#endif
+  return restart();
+}
+
+// every BGZF block is a gzip member whose size is in the 'BC' extra field
+// and whose uncompressed size is in its last four bytes
+
+BOOL ByteStreamInCompressed::scan_gzip()
+{
+  I64 offset = 0;
+  while (offset < file_size)
+  {
+    U8 header[18];
+    if (pread(fd, header, 18, offset) != 18) return FALSE;
+    if (header[0] != 0x1F || header[1] != 0x8B || header[2] != 8) return FALSE;
+    if ((header[3] & 4) == 0) return FALSE;
+    U32 xlen = header[10] | (header[11] << 8);
+    if (xlen < 6 || header[12] != 'B' || header[13] != 'C' || (header[14] | (header[15] << 8)) != 2) return FALSE;
+    I64 block_size = (header[16] | (header[17] << 8)) + 1;
+    U8 trailer[4];
+    if (block_size < 26 || pread(fd, trailer, 4, offset + block_size - 4) != 4) return FALSE;
+    if (!add_block(offset, block_size, get_le32(trailer))) return FALSE;
+    offset += block_size;
+  }
+  return TRUE;
+}
+
+// every zstd frame with a content size in its header is a block. the size
+// of the frame is found by hopping over the headers of its blocks
+
+BOOL ByteStreamInCompressed::scan_zstd()
+{
+  I64 offset = 0;
+  while (offset < file_size)
+  {
+    U8 header[18];
+    memset(header, 0, 18);
+    if (pread(fd, header, 18, offset) < 8) return FALSE;
+    U32 magic = get_le32(header);
+    if ((magic & 0xFFFFFFF0) == 0x184D2A50)
+    {
+      // skippable frame (e.g. the seek table of the seekable format)
+      offset += 8 + (I64)get_le32(header + 4);
+      continue;
+    }
+    if (magic != 0xFD2FB528) return FALSE;
+    U32 descriptor = header[4];
+    U32 content_size_flag = descriptor >> 6;
+    BOOL single_segment = (descriptor >> 5) & 1;
+    BOOL checksum = (descriptor >> 2) & 1;
+    U32 dictionary_id_flag = descriptor & 3;
+    if (content_size_flag == 0 && !single_segment) return FALSE;
+    U32 pos = 5 + (single_segment ? 0 : 1) + (dictionary_id_flag == 3 ? 4 : dictionary_id_flag);
+    U32 content_size_bytes = (content_size_flag == 0 ? 1 : (1 << content_size_flag));
+    I64 length = 0;
+    U32 i;
+    for (i = 0; i < content_size_bytes; i++) length |= ((I64)header[pos+i]) << (8*i);
+    if (content_size_bytes == 2) length += 256;
+    I64 frame = offset + pos + content_size_bytes;
+    BOOL last = FALSE;
+    while (!last)
+    {
+      U8 block[3];
+      if (pread(fd, block, 3, frame) != 3) return FALSE;
+      U32 block_header = block[0] | (block[1] << 8) | (block[2] << 16);
+      U32 block_type = (block_header >> 1) & 3;
+      if (block_type == 3) return FALSE;
+      last = block_header & 1;
+      frame += 3 + (block_type == 1 ? 1 : (block_header >> 3));
+    }
+    if (checksum) frame += 4;
+    if (!add_block(offset, frame - offset, length)) return FALSE;
+    offset = frame;
+  }
+  return TRUE;
+}
+
+BOOL ByteStreamInCompressed::add_block(const I64 offset, const I64 size, const I64 length)
+{
+  if (length > BYTE_STREAM_IN_COMPRESSED_MAX_BLOCK) return FALSE;
+  if (length == 0) return TRUE;
+  if (number_blocks == alloced_blocks)
+  {
+    alloced_blocks = (alloced_blocks ? 2*alloced_blocks : 1024);
+    blocks = (Block*)realloc(blocks, sizeof(Block)*alloced_blocks);
+    if (blocks == 0)
+    {
+      fprintf(stderr,"ERROR: allocating %u blocks\n", alloced_blocks);
+      return FALSE;
+    }
+  }
+  blocks[number_blocks].offset = offset;
+  blocks[number_blocks].size = size;
+  blocks[number_blocks].start = (number_blocks ? blocks[number_blocks-1].start + blocks[number_blocks-1].length : 0);
+  blocks[number_blocks].length = length;
+  number_blocks++;
+  return TRUE;
+}
+
+void* ByteStreamInCompressed::run(void* job)
+{
+  ((Job*)job)->stream->decode((Job*)job);
+  return 0;
+}
+
+void ByteStreamInCompressed::decode(Job* job)
+{
+  U32 b;
+  job->ok = TRUE;
+  for (b = job->first; b < job->last; b++)
+  {
+    const Block* block = blocks + b;
+    if (job->alloced < block->size)
+    {
+      free(job->scratch);
+      job->alloced = block->size;
+      job->scratch = (U8*)malloc(job->alloced);
+      if (job->scratch == 0)
+      {
+        job->alloced = 0;
+        job->ok = FALSE;
+        return;
+      }
+    }
+    if (pread(fd, job->scratch, block->size, block->offset) != block->size)
+    {
+      job->ok = FALSE;
+      return;
+    }
+    U8* output = buffer + (block->start - buffer_start);
+#ifdef HAVE_ZLIB
+    if (format == BYTE_STREAM_IN_COMPRESSED_GZIP)
+    {
+      z_stream z;
+      memset(&z, 0, sizeof(z_stream));
+      if (inflateInit2(&z, 16 + MAX_WBITS) != Z_OK)
+      {
+        job->ok = FALSE;
+        return;
+      }
+      z.next_in = job->scratch;
+      z.avail_in = (uInt)block->size;
+      z.next_out = output;
+      z.avail_out = (uInt)block->length;
+      int result = inflate(&z, Z_FINISH);
+      inflateEnd(&z);
+      if (result != Z_STREAM_END || z.avail_out != 0) job->ok = FALSE;
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if (format == BYTE_STREAM_IN_COMPRESSED_ZSTD)
+    {
+      size_t result = ZSTD_decompress(output, (size_t)block->length, job->scratch, (size_t)block->size);
+      if (ZSTD_isError(result) || result != (size_t)block->length) job->ok = FALSE;
+    }
+#endif
+    if (!job->ok) return;
+  }
+}
+
+// decompresses the batch of blocks that starts with this block
+
+BOOL ByteStreamInCompressed::load(const U32 block)
+{
+  U32 b = block;
+  I64 length = 0;
+  do
+  {
+    length += blocks[b].length;
+    b++;
+  } while ((b < number_blocks) && (length + blocks[b].length <= (I64)threads*BYTE_STREAM_IN_COMPRESSED_BATCH));
+
+  if (alloced_buffer < length)
+  {
+    free(buffer);
+    alloced_buffer = length;
+    buffer = (U8*)malloc(alloced_buffer);
+    if (buffer == 0)
+    {
+      fprintf(stderr,"ERROR: allocating %.1f MB for decompressed blocks\n", (F64)length/1024.0/1024.0);
+      alloced_buffer = 0;
+      batch_first = batch_end = number_blocks;
+      current = end = buffer;
+      return FALSE;
+    }
+  }
+  batch_first = block;
+  batch_end = b;
+  buffer_start = blocks[block].start;
+  current = buffer;
+  end = buffer + length;
+
+  // split the blocks evenly among the threads
+  U32 number = batch_end - batch_first;
+  U32 used = (number < threads ? number : threads);
+  U32 t;
+  for (t = 0; t < used; t++)
+  {
+    jobs[t].stream = this;
+    jobs[t].first = batch_first + (U32)(((U64)number*t)/used);
+    jobs[t].last = batch_first + (U32)(((U64)number*(t+1))/used);
+    jobs[t].ok = FALSE;
+  }
+  pthread_t* workers = 0;
+  U32 started = 1;
+  if (used > 1)
+  {
+    workers = new pthread_t[used];
+    for (t = 1; t < used; t++)
+    {
+      if (pthread_create(&workers[t], 0, run, &jobs[t]) != 0) break;
+    }
+    started = t;
+  }
+  decode(&jobs[0]);
+  for (t = started; t < used; t++) decode(&jobs[t]);
+  for (t = 1; t < started; t++) pthread_join(workers[t], 0);
+  if (workers) delete [] workers;
+
+  for (t = 0; t < used; t++)
+  {
+    if (!jobs[t].ok)
+    {
+      fprintf(stderr,"ERROR: cannot decompress block %u at offset %lld\n", jobs[t].first, (long long)blocks[jobs[t].first].offset);
+      batch_first = batch_end = number_blocks;
+      buffer_start = size;
+      current = end = buffer;
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+BOOL ByteStreamInCompressed::restart()
+{
+#ifdef HAVE_ZLIB
+  if (format == BYTE_STREAM_IN_COMPRESSED_GZIP)
+  {
+    if (inflateReset((z_stream*)decompressor) != Z_OK) return FALSE;
+  }
+#endif
+#ifdef HAVE_ZSTD
+  if (format == BYTE_STREAM_IN_COMPRESSED_ZSTD)
+  {
+    if (ZSTD_isError(ZSTD_initDStream((ZSTD_DStream*)decompressor))) return FALSE;
+  }
+#endif
+  in_next = in_buffer;
+  in_avail = 0;
+  in_offset = 0;
+  buffer_start = 0;
+  current = end = buffer;
+  return TRUE;
+}
+
+// decompresses the next piece of the one stream into the buffer
+
+BOOL ByteStreamInCompressed::more()
+{
+  buffer_start += (end - buffer);
+  current = end = buffer;
+  U32 produced = 0;
+  BOOL failed = FALSE;
+  while (produced < BYTE_STREAM_IN_COMPRESSED_PIECE && !failed)
+  {
+    if (in_avail == 0)
+    {
+      ssize_t read = pread(fd, in_buffer, BYTE_STREAM_IN_COMPRESSED_PIECE, in_offset);
+      if (read <= 0) break;
+      in_offset += read;
+      in_next = in_buffer;
+      in_avail = (U32)read;
+    }
+#ifdef HAVE_ZLIB
+    if (format == BYTE_STREAM_IN_COMPRESSED_GZIP)
+    {
+      z_stream* z = (z_stream*)decompressor;
+      z->next_in = in_next;
+      z->avail_in = in_avail;
+      z->next_out = buffer + produced;
+      z->avail_out = BYTE_STREAM_IN_COMPRESSED_PIECE - produced;
+      int result = inflate(z, Z_NO_FLUSH);
+      produced = BYTE_STREAM_IN_COMPRESSED_PIECE - z->avail_out;
+      in_next = z->next_in;
+      in_avail = z->avail_in;
+      if (result == Z_STREAM_END)
+      {
+        // another gzip member may follow
+        inflateReset(z);
+      }
+      else if (result != Z_OK)
+      {
+        fprintf(stderr,"ERROR: zlib error %d at uncompressed position %lld\n", result, (long long)(buffer_start + produced));
+        failed = TRUE;
+      }
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if (format == BYTE_STREAM_IN_COMPRESSED_ZSTD)
+    {
+      ZSTD_inBuffer in = { in_next, in_avail, 0 };
+      ZSTD_outBuffer out = { buffer, BYTE_STREAM_IN_COMPRESSED_PIECE, produced };
+      size_t result = ZSTD_decompressStream((ZSTD_DStream*)decompressor, &out, &in);
+      produced = (U32)out.pos;
+      in_next += in.pos;
+      in_avail -= (U32)in.pos;
+      if (ZSTD_isError(result))
+      {
+        fprintf(stderr,"ERROR: zstd error '%s' at uncompressed position %lld\n", ZSTD_getErrorName(result), (long long)(buffer_start + produced));
+        failed = TRUE;
+      }
+    }
+#endif
+  }
+  end = buffer + produced;
+  if (produced == 0 && !failed) size = buffer_start;
+  return (produced != 0);
+}
+
+// makes more bytes available when all in the buffer were used
+
+BOOL ByteStreamInCompressed::next()
+{
+  if (number_blocks)
+  {
+    if (batch_end >= number_blocks) return FALSE;
+    return load(batch_end);
+  }
+  return more();
+}
+
+U32 ByteStreamInCompressed::getByte()
+{
+  if (current == end)
+  {
+    if (!next()) throw EOF;
+  }
+  return *current++;
+}
+
+void ByteStreamInCompressed::getBytes(U8* bytes, const U32 num_bytes)
+{
+  U32 done = 0;
+  while (done < num_bytes)
+  {
+    if (current == end)
+    {
+      if (!next()) throw EOF;
+    }
+    U32 n = num_bytes - done;
+    if ((I64)n > (end - current)) n = (U32)(end - current);
+    memcpy(bytes + done, current, n);
+    current += n;
+    done += n;
+  }
+}
+
+void ByteStreamInCompressed::get16bitsLE(U8* bytes)
+{
+  getBytes(bytes, 2);
+}
+
+void ByteStreamInCompressed::get32bitsLE(U8* bytes)
+{
+  getBytes(bytes, 4);
+}
+
+void ByteStreamInCompressed::get64bitsLE(U8* bytes)
+{
+  getBytes(bytes, 8);
+}
+
+void ByteStreamInCompressed::get16bitsBE(U8* bytes)
+{
+  getBytes(swapped, 2);
+  bytes[0] = swapped[1];
+  bytes[1] = swapped[0];
+}
+
+void ByteStreamInCompressed::get32bitsBE(U8* bytes)
+{
+  getBytes(swapped, 4);
+  bytes[0] = swapped[3];
+  bytes[1] = swapped[2];
+  bytes[2] = swapped[1];
+  bytes[3] = swapped[0];
+}
+
+void ByteStreamInCompressed::get64bitsBE(U8* bytes)
+{
+  getBytes(swapped, 8);
+  bytes[0] = swapped[7];
+  bytes[1] = swapped[6];
+  bytes[2] = swapped[5];
+  bytes[3] = swapped[4];
+  bytes[4] = swapped[3];
+  bytes[5] = swapped[2];
+  bytes[6] = swapped[1];
+  bytes[7] = swapped[0];
+}
+
+BOOL ByteStreamInCompressed::isSeekable() const
+{
+  return TRUE;
+}
+
+I64 ByteStreamInCompressed::tell() const
+{
+  return buffer_start + (current - buffer);
+}
+
+BOOL ByteStreamInCompressed::seek(const I64 position)
+{
+  if (position < 0) return FALSE;
+  if ((buffer_start <= position) && (position <= buffer_start + (end - buffer)))
+  {
+    current = buffer + (position - buffer_start);
+    return TRUE;
+  }
+  if (number_blocks)
+  {
+    if (position > size) return FALSE;
+    if (position == size)
+    {
+      batch_first = batch_end = number_blocks;
+      buffer_start = size;
+      current = end = buffer;
+      return TRUE;
+    }
+    U32 low = 0;
+    U32 high = number_blocks - 1;
+    while (low < high)
+    {
+      U32 mid = (low + high + 1) / 2;
+      if (blocks[mid].start <= position) low = mid; else high = mid - 1;
+    }
+    if (!load(low)) return FALSE;
+    current = buffer + (position - buffer_start);
+    return TRUE;
+  }
+  if (position < buffer_start)
+  {
+    if (!restart()) return FALSE;
+  }
+  while (position > buffer_start + (end - buffer))
+  {
+    if (!more()) return FALSE;
+  }
+  current = buffer + (position - buffer_start);
+  return TRUE;
+}
+
+BOOL ByteStreamInCompressed::seekEnd(const I64 distance)
+{
+  if (size < 0)
+  {
+    // the one stream must be decompressed to the end to know its size
+    while (more());
+    if (size < 0) return FALSE;
+  }
+  return seek(size - distance);
+}
+
+ByteStreamInCompressed::~ByteStreamInCompressed()
+{
+  U32 t;
+  if (jobs)
+  {
+    for (t = 0; t < threads; t++) free(jobs[t].scratch);
+    free(jobs);
+  }
+#ifdef HAVE_ZLIB
+  if (decompressor && format == BYTE_STREAM_IN_COMPRESSED_GZIP)
+  {
+    inflateEnd((z_stream*)decompressor);
+    free(decompressor);
+  }
+#endif
+#ifdef HAVE_ZSTD
+  if (decompressor && format == BYTE_STREAM_IN_COMPRESSED_ZSTD)
+  {
+    ZSTD_freeDStream((ZSTD_DStream*)decompressor);
+  }
+#endif
+  free(blocks);
+  free(in_buffer);
+  free(buffer);
+}
+
+#endif
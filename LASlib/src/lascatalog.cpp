@@ -0,0 +1,394 @@
+/*
+===============================================================================
+
+  FILE:  lascatalog.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+#include "lascatalog.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lasreader_las.hpp"
+#include "lasindex.hpp"
+#include "lasinterval.hpp"
+#include "bytestreamin_file.hpp"
+#include "bytestreamout_file.hpp"
+
+BOOL LAScatalog::add(const CHAR* file_name)
+{
+  if (file_name == 0) return FALSE;
+  LASreaderLAS lasreaderlas;
+  if (!lasreaderlas.open(file_name, 512, TRUE))
+  {
+    fprintf(stderr,"ERROR (LAScatalog): cannot open '%s'\n", file_name);
+    return FALSE;
+  }
+  LAScatalogEntry* entry = next_entry();
+  if (entry == 0)
+  {
+    lasreaderlas.close();
+    return FALSE;
+  }
+  const LASheader* header = &lasreaderlas.header;
+  entry->file_name = strdup(file_name);
+  entry->number_of_point_records = (header->number_of_point_records ? header->number_of_point_records : header->extended_number_of_point_records);
+  entry->point_data_format = header->point_data_format;
+  entry->point_data_record_length = header->point_data_record_length;
+  entry->scale_factor[0] = header->x_scale_factor;
+  entry->scale_factor[1] = header->y_scale_factor;
+  entry->scale_factor[2] = header->z_scale_factor;
+  entry->offset[0] = header->x_offset;
+  entry->offset[1] = header->y_offset;
+  entry->offset[2] = header->z_offset;
+  entry->min[0] = header->min_x;
+  entry->min[1] = header->min_y;
+  entry->min[2] = header->min_z;
+  entry->max[0] = header->max_x;
+  entry->max[1] = header->max_y;
+  entry->max[2] = header->max_z;
+  entry->lax_cells = 0;
+  entry->lax_intervals = 0;
+  lasreaderlas.close();
+  LASindex lasindex;
+  if (lasindex.read(file_name) && lasindex.get_interval())
+  {
+    entry->lax_cells = lasindex.get_interval()->get_number_cells();
+    entry->lax_intervals = lasindex.get_interval()->get_number_intervals();
+  }
+  number_entries++;
+  return TRUE;
+}
+
+BOOL LAScatalog::add(const LAScatalogEntry* entry)
+{
+  if (entry == 0) return FALSE;
+  LAScatalogEntry* copy = next_entry();
+  if (copy == 0) return FALSE;
+  *copy = *entry;
+  copy->file_name = strdup(entry->file_name);
+  number_entries++;
+  return TRUE;
+}
+
+BOOL LAScatalog::read(const CHAR* file_name)
+{
+  if (file_name == 0) return FALSE;
+  FILE* file = fopen(file_name, "rb");
+  if (file == 0)
+  {
+    fprintf(stderr,"ERROR (LAScatalog): cannot open '%s'\n", file_name);
+    return FALSE;
+  }
+  ByteStreamIn* stream;
+  if (IS_LITTLE_ENDIAN())
+    stream = new ByteStreamInFileLE(file);
+  else
+    stream = new ByteStreamInFileBE(file);
+  if (!read(stream))
+  {
+    fprintf(stderr,"ERROR (LAScatalog): cannot read '%s'\n", file_name);
+    delete stream;
+    fclose(file);
+    return FALSE;
+  }
+  delete stream;
+  fclose(file);
+  return TRUE;
+}
+
+BOOL LAScatalog::write(const CHAR* file_name) const
+{
+  if (file_name == 0) return FALSE;
+  FILE* file = fopen(file_name, "wb");
+  if (file == 0)
+  {
+    fprintf(stderr,"ERROR (LAScatalog): cannot open '%s' for write\n", file_name);
+    return FALSE;
+  }
+  ByteStreamOut* stream;
+  if (IS_LITTLE_ENDIAN())
+    stream = new ByteStreamOutFileLE(file);
+  else
+    stream = new ByteStreamOutFileBE(file);
+  if (!write(stream))
+  {
+    fprintf(stderr,"ERROR (LAScatalog): cannot write '%s'\n", file_name);
+    delete stream;
+    fclose(file);
+    return FALSE;
+  }
+  delete stream;
+  fclose(file);
+  return TRUE;
+}
+
+BOOL LAScatalog::read(ByteStreamIn* stream)
+{
+  clean();
+  char signature[4];
+  try { stream->getBytes((U8*)signature, 4); } catch (...)
+  {
+    fprintf(stderr,"ERROR (LAScatalog): reading signature\n");
+    return FALSE;
+  }
+  if (strncmp(signature, "LASC", 4) != 0)
+  {
+    fprintf(stderr,"ERROR (LAScatalog): wrong signature %4s instead of 'LASC'\n", signature);
+    return FALSE;
+  }
+  U32 version;
+  try { stream->get32bitsLE((U8*)&version); } catch (...)
+  {
+    fprintf(stderr,"ERROR (LAScatalog): reading version\n");
+    return FALSE;
+  }
+  if (version != LAS_CATALOG_VERSION)
+  {
+    fprintf(stderr,"ERROR (LAScatalog): version %u not supported\n", version);
+    return FALSE;
+  }
+  U32 number;
+  try { stream->get32bitsLE((U8*)&number); } catch (...)
+  {
+    fprintf(stderr,"ERROR (LAScatalog): reading number_of_files\n");
+    return FALSE;
+  }
+  for (U32 i = 0; i < number; i++)
+  {
+    LAScatalogEntry* entry = next_entry();
+    if (entry == 0) return FALSE;
+    U16 length;
+    try { stream->get16bitsLE((U8*)&length); } catch (...)
+    {
+      fprintf(stderr,"ERROR (LAScatalog): reading file_name_length of entry %u\n", i);
+      return FALSE;
+    }
+    entry->file_name = (CHAR*)malloc(length + 1);
+    if (entry->file_name == 0)
+    {
+      fprintf(stderr,"ERROR (LAScatalog): allocating file name of %u bytes\n", (U32)length);
+      return FALSE;
+    }
+    entry->file_name[0] = '\0';
+    number_entries++;
+    try
+    {
+      stream->getBytes((U8*)entry->file_name, length);
+      entry->file_name[length] = '\0';
+      stream->get64bitsLE((U8*)&(entry->number_of_point_records));
+      entry->point_data_format = (U8)stream->getByte();
+      stream->get16bitsLE((U8*)&(entry->point_data_record_length));
+      for (U32 j = 0; j < 3; j++) stream->get64bitsLE((U8*)&(entry->scale_factor[j]));
+      for (U32 j = 0; j < 3; j++) stream->get64bitsLE((U8*)&(entry->offset[j]));
+      for (U32 j = 0; j < 3; j++) stream->get64bitsLE((U8*)&(entry->min[j]));
+      for (U32 j = 0; j < 3; j++) stream->get64bitsLE((U8*)&(entry->max[j]));
+      stream->get32bitsLE((U8*)&(entry->lax_cells));
+      stream->get32bitsLE((U8*)&(entry->lax_intervals));
+    }
+    catch (...)
+    {
+      fprintf(stderr,"ERROR (LAScatalog): reading entry %u of %u\n", i, number);
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+BOOL LAScatalog::write(ByteStreamOut* stream) const
+{
+  if (!stream->putBytes((U8*)"LASC", 4))
+  {
+    fprintf(stderr,"ERROR (LAScatalog): writing signature\n");
+    return FALSE;
+  }
+  U32 version = LAS_CATALOG_VERSION;
+  if (!stream->put32bitsLE((U8*)&version))
+  {
+    fprintf(stderr,"ERROR (LAScatalog): writing version\n");
+    return FALSE;
+  }
+  if (!stream->put32bitsLE((U8*)&number_entries))
+  {
+    fprintf(stderr,"ERROR (LAScatalog): writing number_of_files\n");
+    return FALSE;
+  }
+  for (U32 i = 0; i < number_entries; i++)
+  {
+    const LAScatalogEntry* entry = entries + i;
+    size_t length = strlen(entry->file_name);
+    if (length > U16_MAX)
+    {
+      fprintf(stderr,"ERROR (LAScatalog): file name '%s' is too long\n", entry->file_name);
+      return FALSE;
+    }
+    U16 length16 = (U16)length;
+    BOOL ok = stream->put16bitsLE((U8*)&length16);
+    ok = ok && stream->putBytes((U8*)entry->file_name, length16);
+    ok = ok && stream->put64bitsLE((U8*)&(entry->number_of_point_records));
+    ok = ok && stream->putByte(entry->point_data_format);
+    ok = ok && stream->put16bitsLE((U8*)&(entry->point_data_record_length));
+    for (U32 j = 0; j < 3; j++) ok = ok && stream->put64bitsLE((U8*)&(entry->scale_factor[j]));
+    for (U32 j = 0; j < 3; j++) ok = ok && stream->put64bitsLE((U8*)&(entry->offset[j]));
+    for (U32 j = 0; j < 3; j++) ok = ok && stream->put64bitsLE((U8*)&(entry->min[j]));
+    for (U32 j = 0; j < 3; j++) ok = ok && stream->put64bitsLE((U8*)&(entry->max[j]));
+    ok = ok && stream->put32bitsLE((U8*)&(entry->lax_cells));
+    ok = ok && stream->put32bitsLE((U8*)&(entry->lax_intervals));
+    if (!ok)
+    {
+      fprintf(stderr,"ERROR (LAScatalog): writing entry %u of %u\n", i, number_entries);
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+U32 LAScatalog::intersect_rectangle(const F64 r_min_x, const F64 r_min_y, const F64 r_max_x, const F64 r_max_y)
+{
+  number_selected = 0;
+  for (U32 i = 0; i < number_entries; i++)
+  {
+    const LAScatalogEntry* entry = entries + i;
+    if (entry->number_of_point_records == 0) continue;
+    if (entry->min[0] > r_max_x || entry->max[0] < r_min_x) continue;
+    if (entry->min[1] > r_max_y || entry->max[1] < r_min_y) continue;
+    select(i);
+  }
+  return number_selected;
+}
+
+U32 LAScatalog::intersect_tile(const F32 ll_x, const F32 ll_y, const F32 size)
+{
+  number_selected = 0;
+  for (U32 i = 0; i < number_entries; i++)
+  {
+    const LAScatalogEntry* entry = entries + i;
+    if (entry->number_of_point_records == 0) continue;
+    if (entry->min[0] >= (ll_x + size) || entry->max[0] < ll_x) continue;
+    if (entry->min[1] >= (ll_y + size) || entry->max[1] < ll_y) continue;
+    select(i);
+  }
+  return number_selected;
+}
+
+U32 LAScatalog::intersect_circle(const F64 center_x, const F64 center_y, const F64 radius)
+{
+  number_selected = 0;
+  for (U32 i = 0; i < number_entries; i++)
+  {
+    const LAScatalogEntry* entry = entries + i;
+    if (entry->number_of_point_records == 0) continue;
+    // distance from the center to the closest point of the bounding box
+    F64 dx = 0.0;
+    if (center_x < entry->min[0]) dx = entry->min[0] - center_x;
+    else if (center_x > entry->max[0]) dx = center_x - entry->max[0];
+    F64 dy = 0.0;
+    if (center_y < entry->min[1]) dy = entry->min[1] - center_y;
+    else if (center_y > entry->max[1]) dy = center_y - entry->max[1];
+    if ((dx*dx + dy*dy) > (radius*radius)) continue;
+    select(i);
+  }
+  return number_selected;
+}
+
+U32 LAScatalog::select_all()
+{
+  number_selected = 0;
+  for (U32 i = 0; i < number_entries; i++)
+  {
+    select(i);
+  }
+  return number_selected;
+}
+
+I64 LAScatalog::get_number_of_point_records() const
+{
+  I64 number = 0;
+  for (U32 i = 0; i < number_entries; i++)
+  {
+    number += entries[i].number_of_point_records;
+  }
+  return number;
+}
+
+void LAScatalog::clean()
+{
+  for (U32 i = 0; i < number_entries; i++)
+  {
+    free(entries[i].file_name);
+  }
+  if (entries) free(entries);
+  if (selected) free(selected);
+  entries = 0;
+  number_entries = 0;
+  alloced_entries = 0;
+  selected = 0;
+  number_selected = 0;
+}
+
+LAScatalog::LAScatalog()
+{
+  entries = 0;
+  number_entries = 0;
+  alloced_entries = 0;
+  selected = 0;
+  number_selected = 0;
+}
+
+LAScatalog::~LAScatalog()
+{
+  clean();
+}
+
+// returns the slot after the last entry. it only counts once it is filled
+
+LAScatalogEntry* LAScatalog::next_entry()
+{
+  if (number_entries == alloced_entries)
+  {
+    U32 alloc = (alloced_entries ? 2*alloced_entries : 64);
+    LAScatalogEntry* new_entries = (LAScatalogEntry*)realloc(entries, alloc*sizeof(LAScatalogEntry));
+    U32* new_selected = (U32*)realloc(selected, alloc*sizeof(U32));
+    if (new_entries) entries = new_entries;
+    if (new_selected) selected = new_selected;
+    if (new_entries == 0 || new_selected == 0)
+    {
+      fprintf(stderr,"ERROR (LAScatalog): cannot allocate %u entries\n", alloc);
+      return 0;
+    }
+    alloced_entries = alloc;
+  }
+  memset(entries + number_entries, 0, sizeof(LAScatalogEntry));
+  return entries + number_entries;
+}
+
+void LAScatalog::select(const U32 i)
+{
+  selected[number_selected] = i;
+  number_selected++;
+}
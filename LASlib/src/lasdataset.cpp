@@ -0,0 +1,391 @@
+/*
+===============================================================================
+
+  FILE:  lasdataset.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+#include "lasdataset.hpp"
+
+#include "lasreader_las.hpp"
+#include "lasreadpoint.hpp"
+#include "lasindex.hpp"
+#include "bytestreamin_array.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+BOOL LASdataset::open(const CHAR* file_name)
+{
+  close();
+
+  // positioned reads need the bytes of the LAS or LAZ file itself
+
+  file = fopen(file_name, "rb");
+  if (file == 0)
+  {
+    fprintf(stderr,"ERROR (LASdataset): cannot open '%s'\n", file_name);
+    return FALSE;
+  }
+  CHAR signature[4];
+  if (!read_bytes((U8*)signature, 0, 4) || (strncmp(signature, "LASF", 4) != 0))
+  {
+    fprintf(stderr,"ERROR (LASdataset): '%s' is not a LAS or LAZ file\n", file_name);
+    close();
+    return FALSE;
+  }
+
+  // the reader parses the header with all VLRs and EVLRs and keeps it for us
+
+  lasreader = new LASreaderLAS();
+  if (!lasreader->open(file_name))
+  {
+    fprintf(stderr,"ERROR (LASdataset): cannot read header of '%s'\n", file_name);
+    close();
+    return FALSE;
+  }
+  header = &(lasreader->header);
+  npoints = (header->number_of_point_records ? header->number_of_point_records : header->extended_number_of_point_records);
+  compressed = (header->laszip && (header->laszip->compressor != LASZIP_COMPRESSOR_NONE));
+
+  if (compressed)
+  {
+    if (header->laszip->compressor != LASZIP_COMPRESSOR_POINTWISE_CHUNKED)
+    {
+      fprintf(stderr,"ERROR (LASdataset): '%s' is compressed without chunks\n", file_name);
+      close();
+      return FALSE;
+    }
+
+    // read the chunk table once. the first point index of every chunk follows
+    // from the totals of variable chunks or from the fixed chunk size
+
+    LASreadPoint* reader = new LASreadPoint();
+    U32 number = 0;
+    U32 size = 0;
+    const I64* starts = 0;
+    const I64* totals = 0;
+    if (!reader->setup(header->laszip->num_items, header->laszip->items, header->laszip) || !reader->init(lasreader->get_stream()) || !reader->get_chunk_table(&number, &starts, &totals, &size))
+    {
+      fprintf(stderr,"ERROR (LASdataset): cannot read chunk table of '%s'\n", file_name);
+      delete reader;
+      close();
+      return FALSE;
+    }
+    number_chunks = number;
+    chunk_firsts = (I64*)malloc(sizeof(I64)*(number_chunks+1));
+    chunk_bytes = (I64*)malloc(sizeof(I64)*(number_chunks+1));
+    if (chunk_firsts && chunk_bytes)
+    {
+      for (U32 c = 0; c <= number_chunks; c++)
+      {
+        chunk_bytes[c] = starts[c];
+        chunk_firsts[c] = (totals ? totals[c] : (I64)c*size);
+      }
+      chunk_firsts[number_chunks] = npoints;
+    }
+    delete reader;
+    if ((chunk_firsts == 0) || (chunk_bytes == 0))
+    {
+      fprintf(stderr,"ERROR (LASdataset): cannot allocate chunk table of %u chunks\n", number_chunks);
+      close();
+      return FALSE;
+    }
+
+    // every cursor decodes one chunk at a time as a pointwise stream
+
+    laszip = new LASzip();
+    if (!laszip->setup(header->laszip->num_items, header->laszip->items, LASZIP_COMPRESSOR_POINTWISE))
+    {
+      fprintf(stderr,"ERROR (LASdataset): %s\n", laszip->get_error());
+      close();
+      return FALSE;
+    }
+    laszip->coder = header->laszip->coder;
+    laszip->options = header->laszip->options;
+  }
+  else
+  {
+    // uncompressed points are cut into chunks of fixed size
+
+    number_chunks = (U32)((npoints + LAS_DATASET_CHUNK_SIZE - 1) / LAS_DATASET_CHUNK_SIZE);
+    chunk_firsts = (I64*)malloc(sizeof(I64)*(number_chunks+1));
+    chunk_bytes = (I64*)malloc(sizeof(I64)*(number_chunks+1));
+    if ((chunk_firsts == 0) || (chunk_bytes == 0))
+    {
+      fprintf(stderr,"ERROR (LASdataset): cannot allocate %u chunks\n", number_chunks);
+      close();
+      return FALSE;
+    }
+    for (U32 c = 0; c <= number_chunks; c++)
+    {
+      chunk_firsts[c] = (c < number_chunks ? (I64)c*LAS_DATASET_CHUNK_SIZE : npoints);
+      chunk_bytes[c] = header->offset_to_point_data + chunk_firsts[c]*header->point_data_record_length;
+    }
+  }
+
+  max_chunk_bytes = 0;
+  for (U32 c = 0; c < number_chunks; c++)
+  {
+    if ((chunk_bytes[c+1] - chunk_bytes[c]) > max_chunk_bytes) max_chunk_bytes = chunk_bytes[c+1] - chunk_bytes[c];
+  }
+
+  // the spatial index is either inside the file or in a LAX file next to it
+
+  if (lasreader->get_index() == 0)
+  {
+    LASindex* lax = new LASindex();
+    if (lax->read(file_name))
+      lasreader->set_index(lax);
+    else
+      delete lax;
+  }
+  index = lasreader->get_index();
+
+  // from now on all points are read with positioned reads
+
+  lasreader->close();
+  return TRUE;
+}
+
+U32 LASdataset::get_chunk(const I64 p_index) const
+{
+  U32 low = 0;
+  U32 high = number_chunks;
+  while ((high - low) > 1)
+  {
+    U32 mid = (low + high) / 2;
+    if (chunk_firsts[mid] <= p_index)
+      low = mid;
+    else
+      high = mid;
+  }
+  return low;
+}
+
+BOOL LASdataset::read_bytes(U8* bytes, const I64 start, const I64 size) const
+{
+  if (file == 0) return FALSE;
+  I64 done = 0;
+  while (done < size)
+  {
+#ifdef _WIN32
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(OVERLAPPED));
+    overlapped.Offset = (DWORD)((start + done) & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)((start + done) >> 32);
+    DWORD want = (DWORD)((size - done) < (1 << 30) ? (size - done) : (1 << 30));
+    DWORD got = 0;
+    if (!ReadFile((HANDLE)_get_osfhandle(_fileno(file)), bytes + done, want, &got, &overlapped) || (got == 0)) return FALSE;
+#else
+    ssize_t got = pread(fileno(file), bytes + done, (size_t)(size - done), (off_t)(start + done));
+    if (got <= 0) return FALSE;
+#endif
+    done += got;
+  }
+  return TRUE;
+}
+
+LAScursor* LASdataset::create_cursor() const
+{
+  if (header == 0) return 0;
+  LAScursor* cursor = new LAScursor(this);
+  const LASitem* items;
+  U32 num_items;
+  if (compressed)
+  {
+    num_items = laszip->num_items;
+    items = laszip->items;
+  }
+  else
+  {
+    num_items = lasreader->point.num_items;
+    items = lasreader->point.items;
+  }
+  if (!cursor->point.init(header, num_items, items, header) || !cursor->reader->setup(num_items, items, laszip))
+  {
+    fprintf(stderr,"ERROR (LASdataset): cannot create cursor for point type %d\n", header->point_data_format);
+    delete cursor;
+    return 0;
+  }
+  cursor->buffer = (U8*)malloc((size_t)(max_chunk_bytes ? max_chunk_bytes : 1));
+  if (cursor->buffer == 0)
+  {
+#ifdef _WIN32
+    fprintf(stderr,"ERROR (LASdataset): cannot allocate %I64d bytes for a chunk\n", max_chunk_bytes);
+#else
+    fprintf(stderr,"ERROR (LASdataset): cannot allocate %lld bytes for a chunk\n", max_chunk_bytes);
+#endif
+    delete cursor;
+    return 0;
+  }
+  return cursor;
+}
+
+void LASdataset::close()
+{
+  if (lasreader)
+  {
+    delete lasreader;
+    lasreader = 0;
+  }
+  if (laszip)
+  {
+    delete laszip;
+    laszip = 0;
+  }
+  if (file)
+  {
+    fclose(file);
+    file = 0;
+  }
+  if (chunk_firsts)
+  {
+    free(chunk_firsts);
+    chunk_firsts = 0;
+  }
+  if (chunk_bytes)
+  {
+    free(chunk_bytes);
+    chunk_bytes = 0;
+  }
+  header = 0;
+  index = 0;
+  npoints = 0;
+  compressed = FALSE;
+  number_chunks = 0;
+  max_chunk_bytes = 0;
+}
+
+LASdataset::LASdataset()
+{
+  lasreader = 0;
+  laszip = 0;
+  file = 0;
+  chunk_firsts = 0;
+  chunk_bytes = 0;
+  close();
+}
+
+LASdataset::~LASdataset()
+{
+  close();
+}
+
+BOOL LAScursor::seek_chunk(const U32 chunk)
+{
+  if (chunk >= dataset->number_chunks) return FALSE;
+  I64 size = dataset->chunk_bytes[chunk+1] - dataset->chunk_bytes[chunk];
+  if (!dataset->read_bytes(buffer, dataset->chunk_bytes[chunk], size))
+  {
+    fprintf(stderr,"ERROR (LAScursor): cannot read chunk %u\n", chunk);
+    return FALSE;
+  }
+  if (stream) delete stream;
+  if (IS_LITTLE_ENDIAN())
+    stream = new ByteStreamInArrayLE(buffer, size);
+  else
+    stream = new ByteStreamInArrayBE(buffer, size);
+  if (!reader->init(stream)) return FALSE;
+  current_chunk = chunk;
+  p_count = dataset->chunk_firsts[chunk];
+  chunk_end = dataset->chunk_firsts[chunk+1];
+  return TRUE;
+}
+
+BOOL LAScursor::seek(const I64 p_index)
+{
+  if ((p_index < 0) || (p_index >= dataset->npoints)) return FALSE;
+  U32 chunk = dataset->get_chunk(p_index);
+  if ((chunk != current_chunk) || (p_index < p_count))
+  {
+    if (!seek_chunk(chunk)) return FALSE;
+  }
+  if (dataset->compressed)
+  {
+    while (p_count < p_index)
+    {
+      if (!reader->read(point.point)) return FALSE;
+      p_count++;
+    }
+  }
+  else
+  {
+    // uncompressed points are at fixed positions within the chunk
+    stream->seek((p_index - dataset->chunk_firsts[chunk]) * dataset->header->point_data_record_length);
+    p_count = p_index;
+  }
+  return TRUE;
+}
+
+BOOL LAScursor::read_point()
+{
+  if (p_count >= chunk_end)
+  {
+    U32 next = (current_chunk == U32_MAX ? 0 : current_chunk + 1);
+    if (!seek_chunk(next)) return FALSE;
+  }
+  if (!reader->read(point.point))
+  {
+    if (reader->error())
+    {
+      fprintf(stderr,"ERROR (LAScursor): %s\n", reader->error());
+    }
+    return FALSE;
+  }
+  p_count++;
+  return TRUE;
+}
+
+LAScursor::LAScursor(const LASdataset* dataset)
+{
+  this->dataset = dataset;
+  reader = new LASreadPoint();
+  stream = 0;
+  buffer = 0;
+  current_chunk = U32_MAX;
+  chunk_end = 0;
+  p_count = 0;
+}
+
+LAScursor::~LAScursor()
+{
+  if (reader)
+  {
+    reader->done();
+    delete reader;
+  }
+  if (stream) delete stream;
+  if (buffer) free(buffer);
+}
@@ -0,0 +1,309 @@
+/*
+===============================================================================
+
+  FILE:  lasgrid.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+#include "lasgrid.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+BOOL LASgrid::setup(const F64 min_x, const F64 min_y, const F64 max_x, const F64 max_y, const F32 step, const U32 methods)
+{
+  clean();
+  if ((step <= 0.0f) || (min_x > max_x) || (min_y > max_y))
+  {
+    fprintf(stderr,"ERROR (LASgrid): invalid step %g or bounding box\n", step);
+    return FALSE;
+  }
+  if ((methods == 0) || (methods & ~(LAS_GRID_MIN | LAS_GRID_MAX | LAS_GRID_MEAN | LAS_GRID_COUNT | LAS_GRID_IDW)))
+  {
+    fprintf(stderr,"ERROR (LASgrid): invalid methods %u\n", methods);
+    return FALSE;
+  }
+  F64 first_col = floor(min_x / step);
+  F64 first_row = floor(min_y / step);
+  F64 number_cols = floor(max_x / step) - first_col + 1;
+  F64 number_rows = floor(max_y / step) - first_row + 1;
+  if (number_cols * number_rows > (F64)I32_MAX)
+  {
+    fprintf(stderr,"ERROR (LASgrid): %.0f by %.0f cells are too many for step %g\n", number_cols, number_rows, step);
+    return FALSE;
+  }
+  this->step = step;
+  this->methods = methods;
+  orig_x = first_col * step;
+  orig_y = first_row * step;
+  cols = (U32)number_cols;
+  rows = (U32)number_rows;
+
+  U32 i, number_cells = cols*rows;
+  count = (U32*)calloc(number_cells, sizeof(U32));
+  if (methods & LAS_GRID_MIN)
+  {
+    min = (F32*)malloc(number_cells*sizeof(F32));
+    if (min) for (i = 0; i < number_cells; i++) min[i] = F32_MAX;
+  }
+  if (methods & LAS_GRID_MAX)
+  {
+    max = (F32*)malloc(number_cells*sizeof(F32));
+    if (max) for (i = 0; i < number_cells; i++) max[i] = -F32_MAX;
+  }
+  if (methods & LAS_GRID_MEAN)
+  {
+    sum = (F64*)calloc(number_cells, sizeof(F64));
+  }
+  if (methods & LAS_GRID_IDW)
+  {
+    idw_sum = (F64*)calloc(number_cells, sizeof(F64));
+    idw_weight = (F64*)calloc(number_cells, sizeof(F64));
+  }
+  if ((count == 0) || ((methods & LAS_GRID_MIN) && (min == 0)) || ((methods & LAS_GRID_MAX) && (max == 0)) || ((methods & LAS_GRID_MEAN) && (sum == 0)) || ((methods & LAS_GRID_IDW) && ((idw_sum == 0) || (idw_weight == 0))))
+  {
+    fprintf(stderr,"ERROR (LASgrid): cannot allocate %u cells\n", number_cells);
+    clean();
+    return FALSE;
+  }
+  return TRUE;
+}
+
+void LASgrid::add_class(const U32 classification)
+{
+  if (classification < 32) class_mask |= (1u << classification);
+}
+
+void LASgrid::add(const LASpoint* point)
+{
+  if (class_mask && !(class_mask & (1u << point->get_classification()))) return;
+
+  F64 x = point->get_x();
+  F64 y = point->get_y();
+  I32 col = (I32)floor((x - orig_x) / step);
+  I32 row = (I32)floor((y - orig_y) / step);
+  if (col < 0) col = 0; else if (col >= (I32)cols) col = cols - 1;
+  if (row < 0) row = 0; else if (row >= (I32)rows) row = rows - 1;
+  U32 cell = row*cols + col;
+
+  F64 z = point->get_z();
+  count[cell]++;
+  if (min && (z < min[cell])) min[cell] = (F32)z;
+  if (max && (z > max[cell])) max[cell] = (F32)z;
+  if (sum) sum[cell] += z;
+  if (idw_sum)
+  {
+    // weight by the inverse squared distance to the cell center. a point on
+    // the center gets the weight of one at a hundredth of the step
+    F64 dx = x - (orig_x + (col + 0.5) * step);
+    F64 dy = y - (orig_y + (row + 0.5) * step);
+    F64 d2 = dx*dx + dy*dy;
+    F64 d2_min = 0.0001 * step * step;
+    F64 w = 1.0 / (d2 < d2_min ? d2_min : d2);
+    idw_sum[cell] += w * z;
+    idw_weight[cell] += w;
+  }
+}
+
+F32 LASgrid::get_value(const U32 method, const U32 col, const U32 row) const
+{
+  U32 cell = row*cols + col;
+  if (count[cell] == 0) return LAS_GRID_NODATA;
+  switch (method)
+  {
+  case LAS_GRID_MIN:
+    return min[cell];
+  case LAS_GRID_MAX:
+    return max[cell];
+  case LAS_GRID_MEAN:
+    return (F32)(sum[cell] / count[cell]);
+  case LAS_GRID_COUNT:
+    return (F32)count[cell];
+  case LAS_GRID_IDW:
+    return (F32)(idw_sum[cell] / idw_weight[cell]);
+  }
+  return LAS_GRID_NODATA;
+}
+
+BOOL LASgrid::write(const CHAR* file_name, const U32 method) const
+{
+  if ((count == 0) || (((methods & method) == 0) && (method != LAS_GRID_COUNT)))
+  {
+    fprintf(stderr,"ERROR (LASgrid): method '%s' was not set up\n", get_method_name(method));
+    return FALSE;
+  }
+  const CHAR* extension = strrchr(file_name, '.');
+  if (extension && ((strcmp(extension, ".bil") == 0) || (strcmp(extension, ".BIL") == 0)))
+  {
+    return write_bil(file_name, method);
+  }
+  return write_asc(file_name, method);
+}
+
+// rows are written from the top (north) down
+
+BOOL LASgrid::write_asc(const CHAR* file_name, const U32 method) const
+{
+  FILE* file = fopen(file_name, "w");
+  if (file == 0)
+  {
+    fprintf(stderr,"ERROR (LASgrid): cannot open '%s'\n", file_name);
+    return FALSE;
+  }
+  fprintf(file, "ncols %u\012", cols);
+  fprintf(file, "nrows %u\012", rows);
+  fprintf(file, "xllcorner %.10g\012", orig_x);
+  fprintf(file, "yllcorner %.10g\012", orig_y);
+  fprintf(file, "cellsize %g\012", step);
+  fprintf(file, "NODATA_value %g\012", LAS_GRID_NODATA);
+  U32 col, row;
+  for (row = rows; row > 0; row--)
+  {
+    for (col = 0; col < cols; col++)
+    {
+      fprintf(file, (col ? " %.7g" : "%.7g"), get_value(method, col, row-1));
+    }
+    fprintf(file, "\012");
+  }
+  BOOL ok = !ferror(file);
+  fclose(file);
+  if (!ok) fprintf(stderr,"ERROR (LASgrid): cannot write '%s'\n", file_name);
+  return ok;
+}
+
+// a single-band BIL of 32 bit floats. the *.hdr file replaces the extension
+// and, as ESRI defines it, ulxmap and ulymap are the center of the top left cell
+
+BOOL LASgrid::write_bil(const CHAR* file_name, const U32 method) const
+{
+  I32 len = (I32)strlen(file_name);
+  CHAR* file_name_hdr = (CHAR*)malloc(len + 5);
+  strcpy(file_name_hdr, file_name);
+  while ((len > 0) && (file_name_hdr[len] != '.')) len--;
+  strcpy(file_name_hdr + len, ".hdr");
+
+  FILE* file = fopen(file_name_hdr, "w");
+  if (file == 0)
+  {
+    fprintf(stderr,"ERROR (LASgrid): cannot open '%s'\n", file_name_hdr);
+    free(file_name_hdr);
+    return FALSE;
+  }
+  fprintf(file, "byteorder %s\012", (IS_LITTLE_ENDIAN() ? "I" : "M"));
+  fprintf(file, "layout bil\012");
+  fprintf(file, "nrows %u\012", rows);
+  fprintf(file, "ncols %u\012", cols);
+  fprintf(file, "nbands 1\012");
+  fprintf(file, "nbits 32\012");
+  fprintf(file, "pixeltype float\012");
+  fprintf(file, "nodata %g\012", LAS_GRID_NODATA);
+  fprintf(file, "ulxmap %.10g\012", orig_x + 0.5*step);
+  fprintf(file, "ulymap %.10g\012", orig_y + (rows - 0.5)*step);
+  fprintf(file, "xdim %g\012", step);
+  fprintf(file, "ydim %g\012", step);
+  fclose(file);
+  free(file_name_hdr);
+
+  file = fopen(file_name, "wb");
+  if (file == 0)
+  {
+    fprintf(stderr,"ERROR (LASgrid): cannot open '%s'\n", file_name);
+    return FALSE;
+  }
+  F32* line = (F32*)malloc(cols*sizeof(F32));
+  BOOL ok = (line != 0);
+  U32 col, row;
+  for (row = rows; ok && (row > 0); row--)
+  {
+    for (col = 0; col < cols; col++) line[col] = get_value(method, col, row-1);
+    ok = (fwrite(line, sizeof(F32), cols, file) == cols);
+  }
+  free(line);
+  fclose(file);
+  if (!ok) fprintf(stderr,"ERROR (LASgrid): cannot write '%s'\n", file_name);
+  return ok;
+}
+
+U32 LASgrid::parse_method(const CHAR* name)
+{
+  if (strcmp(name, "min") == 0) return LAS_GRID_MIN;
+  if (strcmp(name, "max") == 0) return LAS_GRID_MAX;
+  if (strcmp(name, "mean") == 0) return LAS_GRID_MEAN;
+  if (strcmp(name, "count") == 0) return LAS_GRID_COUNT;
+  if (strcmp(name, "idw") == 0) return LAS_GRID_IDW;
+  return 0;
+}
+
+const CHAR* LASgrid::get_method_name(const U32 method)
+{
+  switch (method)
+  {
+  case LAS_GRID_MIN:
+    return "min";
+  case LAS_GRID_MAX:
+    return "max";
+  case LAS_GRID_MEAN:
+    return "mean";
+  case LAS_GRID_COUNT:
+    return "count";
+  case LAS_GRID_IDW:
+    return "idw";
+  }
+  return "unknown";
+}
+
+void LASgrid::clean()
+{
+  if (count) free(count);
+  if (min) free(min);
+  if (max) free(max);
+  if (sum) free(sum);
+  if (idw_sum) free(idw_sum);
+  if (idw_weight) free(idw_weight);
+  count = 0;
+  min = max = 0;
+  sum = idw_sum = idw_weight = 0;
+  methods = 0;
+  step = 0.0f;
+  orig_x = orig_y = 0.0;
+  cols = rows = 0;
+}
+
+LASgrid::LASgrid()
+{
+  count = 0;
+  min = max = 0;
+  sum = idw_sum = idw_weight = 0;
+  class_mask = 0;
+  clean();
+}
+
+LASgrid::~LASgrid()
+{
+  clean();
+}
@@ -0,0 +1,248 @@
+/*
+===============================================================================
+
+  FILE:  laslod.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+#include "laslod.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+LASlod::LASlod()
+{
+  levels = 0;
+  spacing = LAS_LOD_SPACING_DEFAULT;
+  depth = 0;
+  level_nodes = 0;
+  level_points = 0;
+  level_indices = 0;
+}
+
+LASlod::~LASlod()
+{
+  clean();
+}
+
+void LASlod::clean()
+{
+  if (level_indices)
+  {
+    for (U32 l = 0; l < levels; l++)
+    {
+      if (level_indices[l]) free(level_indices[l]);
+    }
+    free(level_indices);
+    level_indices = 0;
+  }
+  if (level_nodes)
+  {
+    free(level_nodes);
+    level_nodes = 0;
+  }
+  if (level_points)
+  {
+    free(level_points);
+    level_points = 0;
+  }
+}
+
+BOOL LASlod::setup(const F64 min_x, const F64 max_x, const F64 min_y, const F64 max_y, const U32 levels, const U32 spacing)
+{
+  if (levels == 0)
+  {
+    fprintf(stderr,"ERROR: LOD hierarchy needs at least one level\n");
+    return FALSE;
+  }
+  if ((levels - 1 + spacing) > LAS_LOD_MAX_DEPTH)
+  {
+    fprintf(stderr,"ERROR: LOD levels %u plus spacing %u exceed quadtree depth of %d\n", levels, spacing, LAS_LOD_MAX_DEPTH + 1);
+    return FALSE;
+  }
+  clean();
+  this->levels = levels;
+  this->spacing = spacing;
+  depth = levels - 1 + spacing;
+  if (!quadtree.tiling_setup((F32)min_x, (F32)max_x, (F32)min_y, (F32)max_y, depth))
+  {
+    fprintf(stderr,"ERROR: cannot set up quadtree for LOD hierarchy\n");
+    return FALSE;
+  }
+  level_nodes = (U32*)calloc(levels, sizeof(U32));
+  level_points = (I64*)calloc(levels, sizeof(I64));
+  level_indices = (U32**)calloc(levels, sizeof(U32*));
+  if ((level_nodes == 0) || (level_points == 0) || (level_indices == 0))
+  {
+    fprintf(stderr,"ERROR: allocating LOD hierarchy with %u levels\n", levels);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+// the smallest number of levels whose subsampled upper levels could hold all points
+U32 LASlod::auto_levels(const I64 npoints, const U32 spacing)
+{
+  U32 levels = 1;
+  I64 capacity = ((I64)1) << (2*spacing);
+  while ((capacity < npoints) && (levels < 7) && ((levels + spacing) <= LAS_LOD_MAX_DEPTH))
+  {
+    levels++;
+    capacity = ((I64)1) << (2*(levels - 1 + spacing));
+  }
+  return levels;
+}
+
+BOOL LASlod::add_level(const U32 level, const U32 number_of_nodes, const U32* level_indices, const I64 number_of_points)
+{
+  if (level >= levels)
+  {
+    fprintf(stderr,"ERROR: LOD level %u out of range [0,%u)\n", level, levels);
+    return FALSE;
+  }
+  if (this->level_indices[level]) free(this->level_indices[level]);
+  this->level_indices[level] = (U32*)malloc(sizeof(U32)*(number_of_nodes ? number_of_nodes : 1));
+  if (this->level_indices[level] == 0)
+  {
+    fprintf(stderr,"ERROR: allocating %u LOD nodes\n", number_of_nodes);
+    return FALSE;
+  }
+  if (number_of_nodes) memcpy(this->level_indices[level], level_indices, sizeof(U32)*number_of_nodes);
+  level_nodes[level] = number_of_nodes;
+  level_points[level] = number_of_points;
+  return TRUE;
+}
+
+I64 LASlod::get_number_of_points(const U32 level) const
+{
+  I64 number_of_points = 0;
+  for (U32 l = 0; (l <= level) && (l < levels); l++)
+  {
+    number_of_points += level_points[l];
+  }
+  return number_of_points;
+}
+
+U32 LASlod::get_number_of_nodes(const U32 level) const
+{
+  if (level >= levels) return 0;
+  return level_nodes[level];
+}
+
+const U32* LASlod::get_level_indices(const U32 level) const
+{
+  if (level >= levels) return 0;
+  return level_indices[level];
+}
+
+BOOL LASlod::pack(U8** data, U16* record_length) const
+{
+  U32 l;
+  U32 nodes = 0;
+  for (l = 0; l < levels; l++) nodes += level_nodes[l];
+  U32 length = 28 + 12*levels + 4*nodes;
+  if (length > U16_MAX)
+  {
+    fprintf(stderr,"ERROR: LOD hierarchy with %u nodes does not fit into a VLR. use fewer levels.\n", nodes);
+    return FALSE;
+  }
+  // LASheader::add_vlr() takes ownership and expects new []
+  U8* buffer = new U8[length];
+  U8* b = buffer;
+  U32 version = LAS_LOD_VERSION;
+  memcpy(b, &version, 4); b += 4;
+  memcpy(b, &levels, 4); b += 4;
+  memcpy(b, &spacing, 4); b += 4;
+  F32 bb[4];
+  bb[0] = quadtree.min_x; bb[1] = quadtree.max_x; bb[2] = quadtree.min_y; bb[3] = quadtree.max_y;
+  memcpy(b, bb, 16); b += 16;
+  for (l = 0; l < levels; l++)
+  {
+    memcpy(b, &(level_nodes[l]), 4); b += 4;
+    memcpy(b, &(level_points[l]), 8); b += 8;
+  }
+  for (l = 0; l < levels; l++)
+  {
+    memcpy(b, level_indices[l], 4*level_nodes[l]); b += 4*level_nodes[l];
+  }
+  *data = buffer;
+  *record_length = (U16)length;
+  return TRUE;
+}
+
+BOOL LASlod::unpack(const U8* data, const U16 record_length)
+{
+  if ((data == 0) || (record_length < 28))
+  {
+    fprintf(stderr,"ERROR: LOD VLR is too short\n");
+    return FALSE;
+  }
+  U32 version, levels, spacing;
+  memcpy(&version, data, 4);
+  memcpy(&levels, data + 4, 4);
+  memcpy(&spacing, data + 8, 4);
+  if (version != LAS_LOD_VERSION)
+  {
+    fprintf(stderr,"ERROR: unknown LOD VLR version %u\n", version);
+    return FALSE;
+  }
+  F32 bb[4];
+  memcpy(bb, data + 12, 16);
+  if (record_length < (28 + 12*levels))
+  {
+    fprintf(stderr,"ERROR: LOD VLR is too short for %u levels\n", levels);
+    return FALSE;
+  }
+  if (!setup(bb[0], bb[1], bb[2], bb[3], levels, spacing)) return FALSE;
+  U32 l;
+  U32 nodes = 0;
+  const U8* b = data + 28;
+  for (l = 0; l < levels; l++)
+  {
+    memcpy(&(level_nodes[l]), b, 4); b += 4;
+    memcpy(&(level_points[l]), b, 8); b += 8;
+    nodes += level_nodes[l];
+  }
+  if (record_length != (28 + 12*levels + 4*nodes))
+  {
+    fprintf(stderr,"ERROR: LOD VLR has %u bytes instead of %u\n", record_length, 28 + 12*levels + 4*nodes);
+    return FALSE;
+  }
+  for (l = 0; l < levels; l++)
+  {
+    level_indices[l] = (U32*)malloc(sizeof(U32)*(level_nodes[l] ? level_nodes[l] : 1));
+    memcpy(level_indices[l], b, 4*level_nodes[l]); b += 4*level_nodes[l];
+  }
+  return TRUE;
+}
+
+BOOL LASlod::unpack(const LASheader* header)
+{
+  const LASvlr* vlr = header->get_vlr(LAS_LOD_USER_ID, LAS_LOD_RECORD_ID);
+  if (vlr == 0) return FALSE;
+  return unpack(vlr->data, vlr->record_length_after_header);
+}
@@ -0,0 +1,531 @@
+/*
+===============================================================================
+
+  FILE:  lasneighbors.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+#include "lasneighbors.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <map>
+using namespace std;
+
+class LASneighborsTile
+{
+public:
+  U32 number;
+  I32* xyz;
+  I64* index;
+  U32* start;       // of each bucket plus one for the end
+  U32 used;
+  LASneighborsTile() { number = 0; xyz = 0; index = 0; start = 0; used = 0; };
+  ~LASneighborsTile() { if (xyz) free(xyz); if (index) free(index); if (start) free(start); };
+};
+
+typedef map<I64, LASneighborsTile*> my_tile_map;
+
+struct LASneighborsKey
+{
+  I64 key;
+  U32 query;
+};
+
+static int compare_keys(const void* a, const void* b)
+{
+  const LASneighborsKey* ka = (const LASneighborsKey*)a;
+  const LASneighborsKey* kb = (const LASneighborsKey*)b;
+  if (ka->key < kb->key) return -1;
+  if (ka->key > kb->key) return 1;
+  return (ka->query < kb->query ? -1 : (ka->query > kb->query ? 1 : 0));
+}
+
+LASneighbors::LASneighbors()
+{
+  lasreader = 0;
+  use_z = TRUE;
+  min_x = min_y = max_x = max_y = 0.0;
+  tile_size = bucket_size = 0.0;
+  tiles_x = tiles_y = 0;
+  buckets = buckets_x = buckets_y = 0;
+  max_points = LAS_NEIGHBORS_MAX_POINTS;
+  cached_points = 0;
+  clock = 0;
+  tiles = new my_tile_map();
+  tiles_loaded = 0;
+  points_loaded = 0;
+  sorted = 0;
+  alloced_sorted = 0;
+  read_xyz = 0;
+  read_index = 0;
+  read_bucket = 0;
+  alloced_read = 0;
+}
+
+LASneighbors::~LASneighbors()
+{
+  close();
+  delete ((my_tile_map*)tiles);
+}
+
+BOOL LASneighbors::open(LASreader* lasreader, const BOOL use_z, const F64 tile_size, const I64 max_points)
+{
+  if (lasreader == 0)
+  {
+    fprintf(stderr, "ERROR: lasreader pointer is zero\n");
+    return FALSE;
+  }
+  if (lasreader->get_index() == 0)
+  {
+    fprintf(stderr, "ERROR: neighbor queries need a spatial index (LAX file)\n");
+    return FALSE;
+  }
+  close();
+
+  this->lasreader = lasreader;
+  this->use_z = use_z;
+  this->max_points = max_points;
+  min_x = lasreader->header.min_x;
+  min_y = lasreader->header.min_y;
+  max_x = lasreader->header.max_x;
+  max_y = lasreader->header.max_y;
+
+  F64 extent = (max_x - min_x > max_y - min_y ? max_x - min_x : max_y - min_y);
+  if (extent <= 0.0) extent = 1.0;
+  if (tile_size > 0.0)
+  {
+    this->tile_size = tile_size;
+  }
+  else if (lasreader->npoints > LAS_NEIGHBORS_TILE_POINTS)
+  {
+    this->tile_size = sqrt((max_x - min_x)*(max_y - min_y)*LAS_NEIGHBORS_TILE_POINTS/lasreader->npoints);
+    if (this->tile_size <= 0.0 || this->tile_size > extent) this->tile_size = extent;
+  }
+  else
+  {
+    this->tile_size = extent;
+  }
+  F64 number_x = ceil((max_x - min_x) / this->tile_size);
+  F64 number_y = ceil((max_y - min_y) / this->tile_size);
+  if (number_x * number_y > 1.0e8)
+  {
+    fprintf(stderr, "ERROR: tile size %g gives too many tiles\n", this->tile_size);
+    return FALSE;
+  }
+  tiles_x = (number_x < 1.0 ? 1 : (I32)number_x);
+  tiles_y = (number_y < 1.0 ? 1 : (I32)number_y);
+
+  // about LAS_NEIGHBORS_BUCKET_POINTS points per bucket for an even density
+  F64 tile_points = (F64)lasreader->npoints / tiles_x / tiles_y;
+  buckets = (I32)sqrt(tile_points / LAS_NEIGHBORS_BUCKET_POINTS);
+  if (buckets < 1) buckets = 1;
+  else if (buckets > 1024) buckets = 1024;
+  bucket_size = this->tile_size / buckets;
+  buckets_x = tiles_x * buckets;
+  buckets_y = tiles_y * buckets;
+  return TRUE;
+}
+
+inline I32 LASneighbors::get_bucket_x(const F64 x) const
+{
+  F64 b = floor((x - min_x) / bucket_size);
+  if (b < 0.0) return 0;
+  if (b >= buckets_x) return buckets_x - 1;
+  return (I32)b;
+}
+
+inline I32 LASneighbors::get_bucket_y(const F64 y) const
+{
+  F64 b = floor((y - min_y) / bucket_size);
+  if (b < 0.0) return 0;
+  if (b >= buckets_y) return buckets_y - 1;
+  return (I32)b;
+}
+
+inline F64 LASneighbors::get_distance(const F64* query, const I32* xyz) const
+{
+  F64 dx = lasreader->header.get_x(xyz[0]) - query[0];
+  F64 dy = lasreader->header.get_y(xyz[1]) - query[1];
+  if (use_z)
+  {
+    F64 dz = lasreader->header.get_z(xyz[2]) - query[2];
+    return dx*dx + dy*dy + dz*dz;
+  }
+  return dx*dx + dy*dy;
+}
+
+BOOL LASneighbors::load_tile(LASneighborsTile* tile, const I32 tile_x, const I32 tile_y)
+{
+  // points on the border belong to the tile of their bucket so a little more is read
+  F64 ex = 2.0*lasreader->header.x_scale_factor;
+  F64 ey = 2.0*lasreader->header.y_scale_factor;
+  F64 x0 = min_x + tile_x*tile_size;
+  F64 y0 = min_y + tile_y*tile_size;
+  lasreader->inside_none();
+  lasreader->inside_rectangle(x0 - ex, y0 - ey, x0 + tile_size + ex, y0 + tile_size + ey);
+
+  U32 n = 0;
+  while (lasreader->read_point())
+  {
+    I32 bx = get_bucket_x(lasreader->point.get_x());
+    I32 by = get_bucket_y(lasreader->point.get_y());
+    if ((bx / buckets != tile_x) || (by / buckets != tile_y)) continue;
+    if (n == alloced_read)
+    {
+      alloced_read = (alloced_read ? 2*alloced_read : 65536);
+      read_xyz = (I32*)realloc(read_xyz, sizeof(I32)*3*alloced_read);
+      read_index = (I64*)realloc(read_index, sizeof(I64)*alloced_read);
+      read_bucket = (U32*)realloc(read_bucket, sizeof(U32)*alloced_read);
+      if (read_xyz == 0 || read_index == 0 || read_bucket == 0)
+      {
+        fprintf(stderr, "ERROR: allocating %u points for tile %d %d\n", alloced_read, tile_x, tile_y);
+        lasreader->inside_none();
+        return FALSE;
+      }
+    }
+    read_xyz[3*n+0] = lasreader->point.get_X();
+    read_xyz[3*n+1] = lasreader->point.get_Y();
+    read_xyz[3*n+2] = lasreader->point.get_Z();
+    read_index[n] = lasreader->p_count - 1;
+    read_bucket[n] = (by - tile_y*buckets)*buckets + (bx - tile_x*buckets);
+    n++;
+  }
+  lasreader->inside_none();
+
+  // sort the points by bucket
+  U32 b, i, number_buckets = buckets*buckets;
+  tile->number = n;
+  tile->start = (U32*)calloc(number_buckets + 1, sizeof(U32));
+  tile->xyz = (I32*)malloc(sizeof(I32)*3*(n ? n : 1));
+  tile->index = (I64*)malloc(sizeof(I64)*(n ? n : 1));
+  if (tile->start == 0 || tile->xyz == 0 || tile->index == 0)
+  {
+    fprintf(stderr, "ERROR: allocating %u points for tile %d %d\n", n, tile_x, tile_y);
+    return FALSE;
+  }
+  for (i = 0; i < n; i++) tile->start[read_bucket[i]+1]++;
+  for (b = 0; b < number_buckets; b++) tile->start[b+1] += tile->start[b];
+  for (i = 0; i < n; i++)
+  {
+    U32 j = tile->start[read_bucket[i]]++;
+    tile->xyz[3*j+0] = read_xyz[3*i+0];
+    tile->xyz[3*j+1] = read_xyz[3*i+1];
+    tile->xyz[3*j+2] = read_xyz[3*i+2];
+    tile->index[j] = read_index[i];
+  }
+  for (b = number_buckets; b > 0; b--) tile->start[b] = tile->start[b-1];
+  tile->start[0] = 0;
+  return TRUE;
+}
+
+void LASneighbors::evict_tiles()
+{
+  my_tile_map* map = (my_tile_map*)tiles;
+  while ((cached_points > max_points) && (map->size() > 1))
+  {
+    my_tile_map::iterator oldest = map->begin();
+    my_tile_map::iterator it;
+    for (it = map->begin(); it != map->end(); it++)
+    {
+      if ((*it).second->used < (*oldest).second->used) oldest = it;
+    }
+    cached_points -= (*oldest).second->number;
+    delete (*oldest).second;
+    map->erase(oldest);
+  }
+}
+
+LASneighborsTile* LASneighbors::get_tile(const I32 tile_x, const I32 tile_y)
+{
+  my_tile_map* map = (my_tile_map*)tiles;
+  I64 key = ((I64)tile_y)*tiles_x + tile_x;
+  my_tile_map::iterator it = map->find(key);
+  LASneighborsTile* tile;
+  if (it != map->end())
+  {
+    tile = (*it).second;
+  }
+  else
+  {
+    tile = new LASneighborsTile();
+    if (!load_tile(tile, tile_x, tile_y))
+    {
+      delete tile;
+      return 0;
+    }
+    map->insert(my_tile_map::value_type(key, tile));
+    cached_points += tile->number;
+    points_loaded += tile->number;
+    tiles_loaded++;
+  }
+  tile->used = ++clock;
+  evict_tiles();
+  return tile;
+}
+
+// answer the queries in the order of their tiles and buckets
+
+BOOL LASneighbors::order(const U32 number, const F64* queries)
+{
+  if (alloced_sorted < number)
+  {
+    if (sorted) free(sorted);
+    alloced_sorted = number;
+    sorted = (U32*)malloc(sizeof(U32)*alloced_sorted);
+  }
+  LASneighborsKey* keys = (LASneighborsKey*)malloc(sizeof(LASneighborsKey)*(number ? number : 1));
+  if (sorted == 0 || keys == 0)
+  {
+    fprintf(stderr, "ERROR: allocating %u queries\n", number);
+    alloced_sorted = 0;
+    if (keys) free(keys);
+    return FALSE;
+  }
+  U32 i;
+  for (i = 0; i < number; i++)
+  {
+    I32 bx = get_bucket_x(queries[3*i+0]);
+    I32 by = get_bucket_y(queries[3*i+1]);
+    I64 tile = ((I64)(by / buckets))*tiles_x + (bx / buckets);
+    keys[i].key = tile*buckets*buckets + (by % buckets)*buckets + (bx % buckets);
+    keys[i].query = i;
+  }
+  qsort(keys, number, sizeof(LASneighborsKey), compare_keys);
+  for (i = 0; i < number; i++) sorted[i] = keys[i].query;
+  free(keys);
+  return TRUE;
+}
+
+BOOL LASneighbors::add_knn(const F64* query, const U32 k, LASneighbor* neighbors, U32* count, const I32 bx, const I32 by)
+{
+  LASneighborsTile* tile = get_tile(bx / buckets, by / buckets);
+  if (tile == 0) return FALSE;
+  U32 b = (by % buckets)*buckets + (bx % buckets);
+  U32 i;
+  for (i = tile->start[b]; i < tile->start[b+1]; i++)
+  {
+    F64 d = get_distance(query, tile->xyz + 3*i);
+    if ((*count == k) && (d >= neighbors[k-1].distance)) continue;
+    // insert sorted by distance
+    U32 j = (*count < k ? (*count)++ : k - 1);
+    while ((j > 0) && (neighbors[j-1].distance > d))
+    {
+      neighbors[j] = neighbors[j-1];
+      j--;
+    }
+    neighbors[j].index = tile->index[i];
+    neighbors[j].x = lasreader->header.get_x(tile->xyz[3*i+0]);
+    neighbors[j].y = lasreader->header.get_y(tile->xyz[3*i+1]);
+    neighbors[j].z = lasreader->header.get_z(tile->xyz[3*i+2]);
+    neighbors[j].distance = d;
+  }
+  return TRUE;
+}
+
+BOOL LASneighbors::search_knn(const F64* query, const U32 k, LASneighbor* neighbors, U32* found)
+{
+  I32 qx = get_bucket_x(query[0]);
+  I32 qy = get_bucket_y(query[1]);
+  U32 count = 0;
+  I32 r, bx, by;
+  for (r = 0; ; r++)
+  {
+    // visit the ring of buckets at distance r around the bucket of the query
+    I32 lx = qx - r, hx = qx + r;
+    I32 ly = qy - r, hy = qy + r;
+    for (by = (ly < 0 ? 0 : ly); by <= (hy < buckets_y ? hy : buckets_y - 1); by++)
+    {
+      if (by == ly || by == hy)
+      {
+        for (bx = (lx < 0 ? 0 : lx); bx <= (hx < buckets_x ? hx : buckets_x - 1); bx++)
+        {
+          if (!add_knn(query, k, neighbors, &count, bx, by)) return FALSE;
+        }
+      }
+      else
+      {
+        if (lx >= 0 && !add_knn(query, k, neighbors, &count, lx, by)) return FALSE;
+        if (hx < buckets_x && !add_knn(query, k, neighbors, &count, hx, by)) return FALSE;
+      }
+    }
+    // done when every bucket was visited or no unvisited point can be closer
+    if (lx <= 0 && ly <= 0 && hx >= buckets_x - 1 && hy >= buckets_y - 1) break;
+    if (count == k)
+    {
+      F64 edge = F64_MAX;
+      if (lx > 0 && query[0] - (min_x + lx*bucket_size) < edge) edge = query[0] - (min_x + lx*bucket_size);
+      if (hx < buckets_x - 1 && (min_x + (hx+1)*bucket_size) - query[0] < edge) edge = (min_x + (hx+1)*bucket_size) - query[0];
+      if (ly > 0 && query[1] - (min_y + ly*bucket_size) < edge) edge = query[1] - (min_y + ly*bucket_size);
+      if (hy < buckets_y - 1 && (min_y + (hy+1)*bucket_size) - query[1] < edge) edge = (min_y + (hy+1)*bucket_size) - query[1];
+      if (edge > 0.0 && edge*edge >= neighbors[k-1].distance) break;
+    }
+  }
+  U32 i;
+  for (i = 0; i < count; i++) neighbors[i].distance = sqrt(neighbors[i].distance);
+  *found = count;
+  return TRUE;
+}
+
+BOOL LASneighbors::knn(const U32 number, const F64* queries, const U32 k, LASneighbor* neighbors, U32* found)
+{
+  if (lasreader == 0)
+  {
+    fprintf(stderr, "ERROR: LASneighbors was not opened\n");
+    return FALSE;
+  }
+  if (k == 0)
+  {
+    memset(found, 0, sizeof(U32)*number);
+    return TRUE;
+  }
+  if (!order(number, queries)) return FALSE;
+  U32 i;
+  for (i = 0; i < number; i++)
+  {
+    U32 q = sorted[i];
+    if (!search_knn(queries + 3*q, k, neighbors + ((I64)q)*k, found + q)) return FALSE;
+  }
+  return TRUE;
+}
+
+BOOL LASneighbors::radius(const U32 number, const F64* queries, const F64 radius, LASneighbor** neighbors, I64* alloced, I64* offsets)
+{
+  if (lasreader == 0)
+  {
+    fprintf(stderr, "ERROR: LASneighbors was not opened\n");
+    return FALSE;
+  }
+  if (!order(number, queries)) return FALSE;
+
+  // found in the order of the tiles and then moved into the order of the queries
+  I64* first = (I64*)malloc(sizeof(I64)*(number ? number : 1));
+  LASneighbor* found = 0;
+  I64 alloced_found = 0;
+  I64 count = 0;
+  if (first == 0)
+  {
+    fprintf(stderr, "ERROR: allocating %u queries\n", number);
+    return FALSE;
+  }
+  F64 radius2 = radius*radius;
+  U32 i;
+  for (i = 0; i < number; i++)
+  {
+    U32 q = sorted[i];
+    const F64* query = queries + 3*q;
+    first[q] = count;
+    I32 lx = get_bucket_x(query[0] - radius), hx = get_bucket_x(query[0] + radius);
+    I32 ly = get_bucket_y(query[1] - radius), hy = get_bucket_y(query[1] + radius);
+    I32 bx, by;
+    for (by = ly; by <= hy; by++)
+    {
+      for (bx = lx; bx <= hx; bx++)
+      {
+        LASneighborsTile* tile = get_tile(bx / buckets, by / buckets);
+        if (tile == 0)
+        {
+          free(first);
+          if (found) free(found);
+          return FALSE;
+        }
+        U32 b = (by % buckets)*buckets + (bx % buckets);
+        U32 j;
+        for (j = tile->start[b]; j < tile->start[b+1]; j++)
+        {
+          F64 d = get_distance(query, tile->xyz + 3*j);
+          if (d > radius2) continue;
+          if (count == alloced_found)
+          {
+            alloced_found = (alloced_found ? 2*alloced_found : 1024);
+            found = (LASneighbor*)realloc(found, sizeof(LASneighbor)*alloced_found);
+            if (found == 0)
+            {
+              fprintf(stderr, "ERROR: allocating %lld neighbors\n", (long long)alloced_found);
+              free(first);
+              return FALSE;
+            }
+          }
+          found[count].index = tile->index[j];
+          found[count].x = lasreader->header.get_x(tile->xyz[3*j+0]);
+          found[count].y = lasreader->header.get_y(tile->xyz[3*j+1]);
+          found[count].z = lasreader->header.get_z(tile->xyz[3*j+2]);
+          found[count].distance = sqrt(d);
+          count++;
+        }
+      }
+    }
+  }
+
+  if (*alloced < count)
+  {
+    *alloced = count;
+    *neighbors = (LASneighbor*)realloc(*neighbors, sizeof(LASneighbor)*(*alloced));
+    if (*neighbors == 0)
+    {
+      fprintf(stderr, "ERROR: allocating %lld neighbors\n", (long long)count);
+      *alloced = 0;
+      free(first);
+      if (found) free(found);
+      return FALSE;
+    }
+  }
+  // the neighbors of a query end where those of the next query in tile order start
+  for (i = 0; i < number; i++)
+  {
+    U32 q = sorted[i];
+    offsets[q+1] = (i + 1 < number ? first[sorted[i+1]] : count) - first[q];
+  }
+  offsets[0] = 0;
+  for (i = 0; i < number; i++) offsets[i+1] += offsets[i];
+  for (i = 0; i < number; i++)
+  {
+    if (offsets[i+1] > offsets[i]) memcpy(*neighbors + offsets[i], found + first[i], sizeof(LASneighbor)*(size_t)(offsets[i+1] - offsets[i]));
+  }
+  free(first);
+  if (found) free(found);
+  return TRUE;
+}
+
+void LASneighbors::close()
+{
+  my_tile_map* map = (my_tile_map*)tiles;
+  my_tile_map::iterator it;
+  for (it = map->begin(); it != map->end(); it++) delete (*it).second;
+  map->clear();
+  cached_points = 0;
+  clock = 0;
+  lasreader = 0;
+  if (sorted) { free(sorted); sorted = 0; }
+  alloced_sorted = 0;
+  if (read_xyz) { free(read_xyz); read_xyz = 0; }
+  if (read_index) { free(read_index); read_index = 0; }
+  if (read_bucket) { free(read_bucket); read_bucket = 0; }
+  alloced_read = 0;
+}
@@ -0,0 +1,596 @@
+/*
+===============================================================================
+
+  FILE:  laspipeline.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+#include "laspipeline.hpp"
+
+#include "lasreader.hpp"
+#include "laswriter.hpp"
+#include "laspolygon.hpp"
+#include "lasgrid.hpp"
+#include "lasindex.hpp"
+#include "lastrace.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+LASpipelineBlock::LASpipelineBlock()
+{
+  points = 0;
+  number = 0;
+  capacity = 0;
+  sequence = 0;
+  first = 0;
+}
+
+LASpipelineBlock::~LASpipelineBlock()
+{
+  if (points) delete [] points;
+}
+
+void LASpipelineBlock::compact(const BOOL* keep)
+{
+  U32 i, kept = 0;
+  for (i = 0; i < number; i++)
+  {
+    if (keep[i])
+    {
+      if (kept != i) points[kept] = points[i];
+      kept++;
+    }
+  }
+  number = kept;
+}
+
+static BOOL* pipeline_keep(BOOL* keep, U32* alloc, const U32 number)
+{
+  if (number > *alloc)
+  {
+    if (keep) delete [] keep;
+    keep = new BOOL[number];
+    *alloc = number;
+  }
+  return keep;
+}
+
+LASpipelineClip::LASpipelineClip(const LASpolygon* polygon)
+{
+  this->polygon = polygon;
+  keep = 0;
+  alloc = 0;
+}
+
+LASpipelineClip::~LASpipelineClip()
+{
+  if (keep) delete [] keep;
+}
+
+BOOL LASpipelineClip::process(LASpipelineBlock* block)
+{
+  keep = pipeline_keep(keep, &alloc, block->number);
+  for (U32 i = 0; i < block->number; i++) keep[i] = polygon->inside(block->points[i].get_x(), block->points[i].get_y());
+  block->compact(keep);
+  return TRUE;
+}
+
+LASpipelineStage* LASpipelineClip::clone() const
+{
+  return new LASpipelineClip(polygon);
+}
+
+LASpipelineGrid::LASpipelineGrid(LASgrid* grid)
+{
+  this->grid = grid;
+}
+
+BOOL LASpipelineGrid::process(LASpipelineBlock* block)
+{
+  for (U32 i = 0; i < block->number; i++) grid->add(block->points + i);
+  return TRUE;
+}
+
+LASpipelineIndex::LASpipelineIndex(LASindex* index)
+{
+  this->index = index;
+  count = 0;
+}
+
+BOOL LASpipelineIndex::process(LASpipelineBlock* block)
+{
+  for (U32 i = 0; i < block->number; i++)
+  {
+    index->add(block->points[i].get_x(), block->points[i].get_y(), count);
+    count++;
+  }
+  return TRUE;
+}
+
+LASpipelineStats::LASpipelineStats()
+{
+  number_of_point_records = 0;
+  memset(number_of_points_by_return, 0, sizeof(number_of_points_by_return));
+  memset(classification, 0, sizeof(classification));
+  min_X = min_Y = min_Z = I32_MAX;
+  max_X = max_Y = max_Z = I32_MIN;
+}
+
+BOOL LASpipelineStats::process(LASpipelineBlock* block)
+{
+  for (U32 i = 0; i < block->number; i++)
+  {
+    const LASpoint* point = block->points + i;
+    if (point->X < min_X) min_X = point->X;
+    if (point->X > max_X) max_X = point->X;
+    if (point->Y < min_Y) min_Y = point->Y;
+    if (point->Y > max_Y) max_Y = point->Y;
+    if (point->Z < min_Z) min_Z = point->Z;
+    if (point->Z > max_Z) max_Z = point->Z;
+    if (point->extended_point_type)
+    {
+      number_of_points_by_return[point->extended_return_number & 15]++;
+      classification[point->extended_classification]++;
+    }
+    else
+    {
+      number_of_points_by_return[point->return_number]++;
+      classification[point->classification]++;
+    }
+  }
+  number_of_point_records += block->number;
+  return TRUE;
+}
+
+LASpipelineStage* LASpipelineStats::clone() const
+{
+  return new LASpipelineStats();
+}
+
+BOOL LASpipelineStats::merge(const LASpipelineStage* copy)
+{
+  const LASpipelineStats* stats = (const LASpipelineStats*)copy;
+  U32 i;
+  number_of_point_records += stats->number_of_point_records;
+  for (i = 0; i < 16; i++) number_of_points_by_return[i] += stats->number_of_points_by_return[i];
+  for (i = 0; i < 256; i++) classification[i] += stats->classification[i];
+  if (stats->min_X < min_X) min_X = stats->min_X;
+  if (stats->max_X > max_X) max_X = stats->max_X;
+  if (stats->min_Y < min_Y) min_Y = stats->min_Y;
+  if (stats->max_Y > max_Y) max_Y = stats->max_Y;
+  if (stats->min_Z < min_Z) min_Z = stats->min_Z;
+  if (stats->max_Z > max_Z) max_Z = stats->max_Z;
+  return TRUE;
+}
+
+void LASpipelineStats::print(FILE* file, const LASheader* header) const
+{
+  U32 i;
+#ifdef _WIN32
+  fprintf(file, "number of point records: %I64d\n", number_of_point_records);
+#else
+  fprintf(file, "number of point records: %lld\n", number_of_point_records);
+#endif
+  if (number_of_point_records == 0) return;
+  fprintf(file, "min x y z: %.2f %.2f %.2f\n", header->get_x(min_X), header->get_y(min_Y), header->get_z(min_Z));
+  fprintf(file, "max x y z: %.2f %.2f %.2f\n", header->get_x(max_X), header->get_y(max_Y), header->get_z(max_Z));
+  for (i = 0; i < 16; i++)
+  {
+    if (number_of_points_by_return[i] == 0) continue;
+#ifdef _WIN32
+    fprintf(file, "return %u: %I64d\n", i, number_of_points_by_return[i]);
+#else
+    fprintf(file, "return %u: %lld\n", i, number_of_points_by_return[i]);
+#endif
+  }
+  for (i = 0; i < 256; i++)
+  {
+    if (classification[i] == 0) continue;
+#ifdef _WIN32
+    fprintf(file, "classification %u: %I64d\n", i, classification[i]);
+#else
+    fprintf(file, "classification %u: %lld\n", i, classification[i]);
+#endif
+  }
+}
+
+LASpipelineWriter::LASpipelineWriter(LASwriter* writer, const BOOL inventory)
+{
+  this->writer = writer;
+  this->inventory = inventory;
+}
+
+BOOL LASpipelineWriter::process(LASpipelineBlock* block)
+{
+  for (U32 i = 0; i < block->number; i++)
+  {
+    if (!writer->write_point(block->points + i)) return FALSE;
+    if (inventory) writer->update_inventory(block->points + i);
+  }
+  return TRUE;
+}
+
+// a bounded queue between two stages. blocks are only put in the order of
+// their sequence numbers, so the copies of a stage that finish blocks out
+// of order wait for each other here. the free blocks are held in a queue
+// that is not ordered.
+
+class LASpipelineQueue
+{
+public:
+  std::vector<LASpipelineBlock*> ring;
+  U64 head;
+  U64 tail;
+  BOOL ordered;
+  BOOL closed;
+  U32 producers;
+  BOOL* abort;
+  std::mutex* lock;
+  std::condition_variable changed;
+
+  BOOL put(LASpipelineBlock* block)
+  {
+    std::unique_lock<std::mutex> guard(*lock);
+    while (!*abort && (((tail - head) == ring.size()) || (ordered && ((U64)block->sequence != tail)))) changed.wait(guard);
+    if (*abort) return FALSE;
+    ring[tail % ring.size()] = block;
+    tail++;
+    changed.notify_all();
+    return TRUE;
+  }
+
+  LASpipelineBlock* get()
+  {
+    std::unique_lock<std::mutex> guard(*lock);
+    while (!*abort && !closed && (head == tail)) changed.wait(guard);
+    if (*abort || (head == tail)) return 0;
+    LASpipelineBlock* block = ring[head % ring.size()];
+    head++;
+    changed.notify_all();
+    return block;
+  }
+
+  void done()
+  {
+    std::lock_guard<std::mutex> guard(*lock);
+    producers--;
+    if (producers == 0) closed = TRUE;
+    changed.notify_all();
+  }
+};
+
+class LASpipelineRun
+{
+public:
+  std::mutex lock;
+  BOOL abort;
+  CHAR error[256];
+  std::vector<LASpipelineQueue*> queues; // the input of each stage plus the free blocks
+  std::vector<LASpipelineBlock*> blocks;
+
+  void fail(const CHAR* stage)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (!abort) sprintf(error, "stage '%s' failed", stage);
+    abort = TRUE;
+    for (size_t q = 0; q < queues.size(); q++) queues[q]->changed.notify_all();
+  }
+
+  ~LASpipelineRun()
+  {
+    for (size_t q = 0; q < queues.size(); q++) delete queues[q];
+    for (size_t b = 0; b < blocks.size(); b++) delete blocks[b];
+  }
+};
+
+static void pipeline_work(LASpipelineRun* run, LASpipelineStage* stage, LASpipelineQueue* in, LASpipelineQueue* out)
+{
+  LASpipelineBlock* block;
+  while ((block = in->get()))
+  {
+    I64 start = LAStrace::now();
+    if (!stage->process(block))
+    {
+      run->fail(stage->name());
+      break;
+    }
+    if (LAStrace::is_enabled()) LAStrace::complete(stage->name(), "pipeline", start, block->number);
+    if (!out->put(block)) break;
+  }
+  out->done();
+}
+
+static BOOL pipeline_read(LASreader* lasreader, LASpipelineBlock* block, I64* remaining)
+{
+  block->number = 0;
+  while ((block->number < block->capacity) && (*remaining != 0) && lasreader->read_point())
+  {
+    block->points[block->number] = lasreader->point;
+    block->number++;
+    if (*remaining > 0) (*remaining)--;
+  }
+  return (block->number != 0);
+}
+
+static LASpipelineBlock* pipeline_block(const LASheader* header, const U32 capacity)
+{
+  LASpipelineBlock* block = new LASpipelineBlock();
+  block->points = new LASpoint[capacity];
+  block->capacity = capacity;
+  for (U32 i = 0; i < capacity; i++)
+  {
+    BOOL ok;
+    if (header->laszip)
+      ok = block->points[i].init(header, header->laszip->num_items, header->laszip->items, header);
+    else
+      ok = block->points[i].init(header, header->point_data_format, header->point_data_record_length, header);
+    if (!ok)
+    {
+      delete block;
+      return 0;
+    }
+  }
+  return block;
+}
+
+LASpipeline::LASpipeline()
+{
+  number_stages = 0;
+  stages = 0;
+  threads = 0;
+  threaded = FALSE;
+  block_size = LAS_PIPELINE_BLOCK_SIZE;
+  queue_size = LAS_PIPELINE_QUEUE_SIZE;
+  error[0] = '\0';
+}
+
+LASpipeline::~LASpipeline()
+{
+  for (U32 s = 0; s < number_stages; s++) delete stages[s];
+  if (stages) free(stages);
+  if (threads) free(threads);
+}
+
+BOOL LASpipeline::add(LASpipelineStage* stage, const U32 threads)
+{
+  if (stage == 0)
+  {
+    sprintf(error, "stage pointer is zero");
+    return FALSE;
+  }
+  stages = (LASpipelineStage**)realloc(stages, sizeof(LASpipelineStage*)*(number_stages+1));
+  this->threads = (U32*)realloc(this->threads, sizeof(U32)*(number_stages+1));
+  stages[number_stages] = stage;
+  this->threads[number_stages] = (threads ? threads : 1);
+  number_stages++;
+  return TRUE;
+}
+
+void LASpipeline::set_threaded(const BOOL threaded)
+{
+  this->threaded = threaded;
+}
+
+void LASpipeline::set_block_size(const U32 block_size)
+{
+  this->block_size = (block_size ? block_size : LAS_PIPELINE_BLOCK_SIZE);
+}
+
+void LASpipeline::set_queue_size(const U32 queue_size)
+{
+  this->queue_size = (queue_size ? queue_size : LAS_PIPELINE_QUEUE_SIZE);
+}
+
+BOOL LASpipeline::open_stages(const LASheader* header)
+{
+  for (U32 s = 0; s < number_stages; s++)
+  {
+    if (!stages[s]->open(header))
+    {
+      sprintf(error, "cannot open stage '%s'", stages[s]->name());
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+BOOL LASpipeline::close_stages()
+{
+  BOOL ok = TRUE;
+  for (U32 s = 0; s < number_stages; s++)
+  {
+    if (!stages[s]->close())
+    {
+      sprintf(error, "cannot close stage '%s'", stages[s]->name());
+      ok = FALSE;
+    }
+  }
+  return ok;
+}
+
+I64 LASpipeline::run(LASreader* lasreader, const I64 number)
+{
+  if (lasreader == 0)
+  {
+    sprintf(error, "reader pointer is zero");
+    return -1;
+  }
+  if (number_stages == 0)
+  {
+    sprintf(error, "no stages");
+    return -1;
+  }
+  if (!open_stages(&lasreader->header)) return -1;
+  I64 read = (threaded ? run_threaded(lasreader, number) : run_serial(lasreader, number));
+  if (!close_stages()) return -1;
+  return read;
+}
+
+I64 LASpipeline::run_serial(LASreader* lasreader, const I64 number)
+{
+  LASpipelineBlock* block = pipeline_block(&lasreader->header, block_size);
+  if (block == 0)
+  {
+    sprintf(error, "cannot allocate block of %u points", block_size);
+    return -1;
+  }
+  I64 remaining = number;
+  I64 read = 0;
+  while (pipeline_read(lasreader, block, &remaining))
+  {
+    block->first = read;
+    read += block->number;
+    for (U32 s = 0; s < number_stages; s++)
+    {
+      if (!stages[s]->process(block))
+      {
+        sprintf(error, "stage '%s' failed", stages[s]->name());
+        delete block;
+        return -1;
+      }
+    }
+    block->sequence++;
+  }
+  delete block;
+  return read;
+}
+
+// the calling thread reads. every stage has one thread per copy
+
+I64 LASpipeline::run_threaded(LASreader* lasreader, const I64 number)
+{
+  U32 s, t;
+  LASpipelineRun run;
+  run.abort = FALSE;
+  run.error[0] = '\0';
+
+  U32 copies = 0;
+  std::vector< std::vector<LASpipelineStage*> > workers(number_stages);
+  for (s = 0; s < number_stages; s++)
+  {
+    workers[s].push_back(stages[s]);
+    for (t = 1; t < threads[s]; t++)
+    {
+      LASpipelineStage* copy = stages[s]->clone();
+      if (copy == 0) break;
+      workers[s].push_back(copy);
+    }
+    copies += (U32)workers[s].size();
+  }
+
+  // enough blocks for all queues and threads to be busy
+
+  U32 number_blocks = queue_size*(number_stages + 1) + copies;
+  for (s = 0; s <= number_stages; s++)
+  {
+    LASpipelineQueue* queue = new LASpipelineQueue();
+    queue->ring.resize(s < number_stages ? queue_size : number_blocks);
+    queue->head = 0;
+    queue->tail = 0;
+    queue->ordered = (s < number_stages);
+    queue->closed = FALSE;
+    queue->producers = (s == 0 ? 1 : (U32)workers[s-1].size());
+    queue->abort = &run.abort;
+    queue->lock = &run.lock;
+    run.queues.push_back(queue);
+  }
+  LASpipelineQueue* free_blocks = run.queues[number_stages];
+  for (U32 b = 0; b < number_blocks; b++)
+  {
+    LASpipelineBlock* block = pipeline_block(&lasreader->header, block_size);
+    if (block == 0)
+    {
+      sprintf(error, "cannot allocate block of %u points", block_size);
+      for (s = 0; s < number_stages; s++) for (t = 1; t < workers[s].size(); t++) delete workers[s][t];
+      return -1;
+    }
+    run.blocks.push_back(block);
+    free_blocks->ring[b] = block;
+  }
+  free_blocks->tail = number_blocks;
+
+  std::vector<std::thread> running;
+  try
+  {
+    for (s = 0; s < number_stages; s++)
+    {
+      for (t = 0; t < workers[s].size(); t++)
+      {
+        running.push_back(std::thread(pipeline_work, &run, workers[s][t], run.queues[s], run.queues[s+1]));
+      }
+    }
+  }
+  catch (...)
+  {
+    run.fail("start");
+    sprintf(run.error, "cannot start thread %u of stage %u", t, s);
+  }
+
+  // the last stage gives the blocks back into the free queue where they
+  // are taken in whatever order they come. get() and put() see an abort
+  // under the lock of the run and then return no block or FALSE
+
+  I64 remaining = number;
+  I64 read = 0;
+  I64 sequence = 0;
+  LASpipelineBlock* block;
+  while ((block = free_blocks->get()))
+  {
+    if (!pipeline_read(lasreader, block, &remaining))
+    {
+      break;
+    }
+    block->first = read;
+    block->sequence = sequence++;
+    read += block->number;
+    if (!run.queues[0]->put(block)) break;
+  }
+  run.queues[0]->done();
+
+  for (t = 0; t < running.size(); t++) running[t].join();
+
+  for (s = 0; s < number_stages; s++)
+  {
+    for (t = 1; t < workers[s].size(); t++)
+    {
+      if (!run.abort && !stages[s]->merge(workers[s][t])) run.fail(stages[s]->name());
+      delete workers[s][t];
+    }
+  }
+  if (run.abort)
+  {
+    sprintf(error, "%s", run.error);
+    return -1;
+  }
+  return read;
+}
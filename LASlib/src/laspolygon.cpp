@@ -0,0 +1,466 @@
+/*
+===============================================================================
+
+  FILE:  laspolygon.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+#include "laspolygon.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bytestreamin_file.hpp"
+
+static int compare_doubles(const void* a, const void* b)
+{
+  F64 da = *((const F64*)a);
+  F64 db = *((const F64*)b);
+  if (da < db) return -1;
+  if (da > db) return 1;
+  return 0;
+}
+
+BOOL LASpolygon::read_shp(const CHAR* file_name)
+{
+  if (file_name == 0) return FALSE;
+  FILE* file = fopen(file_name, "rb");
+  if (file == 0)
+  {
+    fprintf(stderr,"ERROR (LASpolygon): cannot open '%s'\n", file_name);
+    return FALSE;
+  }
+  ByteStreamIn* stream;
+  if (IS_LITTLE_ENDIAN())
+    stream = new ByteStreamInFileLE(file);
+  else
+    stream = new ByteStreamInFileBE(file);
+
+  I32 file_code, file_length, version, shape_type;
+  try
+  {
+    stream->get32bitsBE((U8*)&file_code);
+    stream->seek(24);
+    stream->get32bitsBE((U8*)&file_length);
+    stream->get32bitsLE((U8*)&version);
+    stream->get32bitsLE((U8*)&shape_type);
+  }
+  catch (...)
+  {
+    fprintf(stderr,"ERROR (LASpolygon): reading header of '%s'\n", file_name);
+    delete stream;
+    fclose(file);
+    return FALSE;
+  }
+  if (file_code != 9994)
+  {
+    fprintf(stderr,"ERROR (LASpolygon): wrong shapefile code %d != 9994 in '%s'\n", file_code, file_name);
+    delete stream;
+    fclose(file);
+    return FALSE;
+  }
+  if (shape_type != 5 && shape_type != 15 && shape_type != 25)
+  {
+    fprintf(stderr,"ERROR (LASpolygon): wrong shape type %d != 5,15,25 in '%s'\n", shape_type, file_name);
+    delete stream;
+    fclose(file);
+    return FALSE;
+  }
+
+  I64 length = 2*(I64)file_length;
+  I64 position = 100;
+  I32* parts = 0;
+  F64* points = 0;
+  I32 alloced_parts = 0;
+  I32 alloced_points = 0;
+  BOOL ok = TRUE;
+
+  while (ok && (position + 8 <= length))
+  {
+    I32 record_number, content_length, record_type;
+    try
+    {
+      stream->seek(position);
+      stream->get32bitsBE((U8*)&record_number);
+      stream->get32bitsBE((U8*)&content_length);
+      stream->get32bitsLE((U8*)&record_type);
+    }
+    catch (...)
+    {
+      fprintf(stderr,"ERROR (LASpolygon): reading record at %d of '%s'\n", (I32)position, file_name);
+      ok = FALSE;
+      break;
+    }
+    position += 8 + 2*(I64)content_length;
+    if (record_type == 0) continue; // null shape
+    if (record_type != shape_type)
+    {
+      fprintf(stderr,"ERROR (LASpolygon): record %d has shape type %d instead of %d\n", record_number, record_type, shape_type);
+      ok = FALSE;
+      break;
+    }
+    I32 num_parts, num_points;
+    try
+    {
+      F64 box[4];
+      for (U32 j = 0; j < 4; j++) stream->get64bitsLE((U8*)&(box[j]));
+      stream->get32bitsLE((U8*)&num_parts);
+      stream->get32bitsLE((U8*)&num_points);
+      if ((num_parts < 0) || (num_points < 0) || (num_parts > num_points))
+      {
+        fprintf(stderr,"ERROR (LASpolygon): record %d has %d parts and %d points\n", record_number, num_parts, num_points);
+        ok = FALSE;
+        break;
+      }
+      if (num_parts >= alloced_parts)
+      {
+        alloced_parts = num_parts + 1;
+        I32* more_parts = (I32*)realloc(parts, sizeof(I32)*alloced_parts);
+        if (more_parts == 0) throw 1;
+        parts = more_parts;
+      }
+      if (num_points > alloced_points)
+      {
+        alloced_points = num_points;
+        F64* more_points = (F64*)realloc(points, sizeof(F64)*2*alloced_points);
+        if (more_points == 0) throw 1;
+        points = more_points;
+      }
+      for (I32 j = 0; j < num_parts; j++) stream->get32bitsLE((U8*)&(parts[j]));
+      parts[num_parts] = num_points;
+      for (I32 j = 0; j < 2*num_points; j++) stream->get64bitsLE((U8*)&(points[j]));
+    }
+    catch (...)
+    {
+      fprintf(stderr,"ERROR (LASpolygon): reading record %d of '%s'\n", record_number, file_name);
+      ok = FALSE;
+      break;
+    }
+    for (I32 j = 0; j < num_parts; j++)
+    {
+      if ((parts[j] < 0) || (parts[j] > parts[j+1]))
+      {
+        fprintf(stderr,"ERROR (LASpolygon): record %d has bad part %d\n", record_number, j);
+        ok = FALSE;
+        break;
+      }
+      if (!add_ring(parts[j+1] - parts[j], points + 2*parts[j]))
+      {
+        ok = FALSE;
+        break;
+      }
+    }
+  }
+
+  if (parts) free(parts);
+  if (points) free(points);
+  delete stream;
+  fclose(file);
+  return ok;
+}
+
+BOOL LASpolygon::add_ring(const U32 number, const F64* xy)
+{
+  if (number < 3) return TRUE; // no area
+  if (number_edges + number > alloced_edges)
+  {
+    U32 alloc = alloced_edges + (alloced_edges > number ? alloced_edges : number);
+    F64* more_edges = (F64*)realloc(edges, sizeof(F64)*4*alloc);
+    if (more_edges == 0)
+    {
+      fprintf(stderr,"ERROR (LASpolygon): cannot allocate %u edges\n", alloc);
+      return FALSE;
+    }
+    edges = more_edges;
+    alloced_edges = alloc;
+  }
+  for (U32 i = 0; i < number; i++)
+  {
+    const F64* p0 = xy + 2*i;
+    const F64* p1 = xy + 2*((i+1) % number);
+    if ((p0[0] == p1[0]) && (p0[1] == p1[1])) continue;
+    F64* edge = edges + 4*number_edges;
+    edge[0] = p0[0];
+    edge[1] = p0[1];
+    edge[2] = p1[0];
+    edge[3] = p1[1];
+    if (number_edges == 0)
+    {
+      min_x = max_x = p0[0];
+      min_y = max_y = p0[1];
+    }
+    if (p0[0] < min_x) min_x = p0[0]; else if (p0[0] > max_x) max_x = p0[0];
+    if (p0[1] < min_y) min_y = p0[1]; else if (p0[1] > max_y) max_y = p0[1];
+    number_edges++;
+  }
+  number_rings++;
+  return TRUE;
+}
+
+BOOL LASpolygon::prepare(const F64 cell_size)
+{
+  if (number_edges == 0)
+  {
+    fprintf(stderr,"ERROR (LASpolygon): no polygon with an area\n");
+    return FALSE;
+  }
+  if (cells) free(cells);
+  if (row_start) free(row_start);
+  if (row_x0) free(row_x0);
+  if (row_y0) free(row_y0);
+  if (row_y1) free(row_y1);
+  if (row_slope) free(row_slope);
+  cells = 0;
+  row_start = 0;
+  row_x0 = row_y0 = row_y1 = row_slope = 0;
+
+  F64 extent = ((max_x - min_x) > (max_y - min_y) ? (max_x - min_x) : (max_y - min_y));
+  this->cell_size = (cell_size > 0.0 ? cell_size : extent / LAS_POLYGON_RASTER_SIZE);
+  if (this->cell_size <= 0.0) this->cell_size = 1.0;
+  cols = (I32)((max_x - min_x) / this->cell_size) + 1;
+  rows = (I32)((max_y - min_y) / this->cell_size) + 1;
+
+  cells = (U8*)calloc((size_t)cols*rows, sizeof(U8));
+  row_start = (U32*)calloc(rows + 1, sizeof(U32));
+  if ((cells == 0) || (row_start == 0))
+  {
+    fprintf(stderr,"ERROR (LASpolygon): cannot allocate raster of %d by %d cells\n", cols, rows);
+    return FALSE;
+  }
+
+  // count the edges of each row
+
+  U32 e;
+  I32 r, c;
+  for (e = 0; e < number_edges; e++)
+  {
+    const F64* edge = edges + 4*e;
+    I32 r0 = get_row(edge[1] < edge[3] ? edge[1] : edge[3]);
+    I32 r1 = get_row(edge[1] < edge[3] ? edge[3] : edge[1]);
+    for (r = r0; r <= r1; r++) row_start[r+1]++;
+  }
+  for (r = 0; r < rows; r++) row_start[r+1] += row_start[r];
+  U32 total = row_start[rows];
+  row_x0 = (F64*)malloc(sizeof(F64)*total);
+  row_y0 = (F64*)malloc(sizeof(F64)*total);
+  row_y1 = (F64*)malloc(sizeof(F64)*total);
+  row_slope = (F64*)malloc(sizeof(F64)*total);
+  U32* fill = (U32*)malloc(sizeof(U32)*rows);
+  if ((row_x0 == 0) || (row_y0 == 0) || (row_y1 == 0) || (row_slope == 0) || (fill == 0))
+  {
+    fprintf(stderr,"ERROR (LASpolygon): cannot allocate %u row edges\n", total);
+    if (fill) free(fill);
+    return FALSE;
+  }
+  memcpy(fill, row_start, sizeof(U32)*rows);
+
+  // sort the edges into the rows and mark the cells they pass through
+
+  for (e = 0; e < number_edges; e++)
+  {
+    const F64* edge = edges + 4*e;
+    F64 slope = (edge[3] != edge[1] ? (edge[2] - edge[0]) / (edge[3] - edge[1]) : 0.0);
+    F64 lo = (edge[1] < edge[3] ? edge[1] : edge[3]);
+    F64 hi = (edge[1] < edge[3] ? edge[3] : edge[1]);
+    I32 r0 = get_row(lo);
+    I32 r1 = get_row(hi);
+    for (r = r0; r <= r1; r++)
+    {
+      U32 i = fill[r]++;
+      row_x0[i] = edge[0];
+      row_y0[i] = edge[1];
+      row_y1[i] = edge[3];
+      row_slope[i] = slope;
+      // the piece of the edge within this row
+      F64 a = min_y + r*this->cell_size;
+      F64 b = a + this->cell_size;
+      if (a < lo) a = lo;
+      if (b > hi) b = hi;
+      F64 xa, xb;
+      if (edge[3] != edge[1])
+      {
+        xa = edge[0] + (a - edge[1]) * slope;
+        xb = edge[0] + (b - edge[1]) * slope;
+      }
+      else
+      {
+        xa = edge[0];
+        xb = edge[2];
+      }
+      I32 c0 = get_col(xa < xb ? xa : xb);
+      I32 c1 = get_col(xa < xb ? xb : xa);
+      for (c = c0; c <= c1; c++) cells[r*cols + c] = LAS_POLYGON_BOUNDARY;
+    }
+  }
+  free(fill);
+
+  // the other cells are entirely inside or outside. decide at their center
+
+  F64* crossings = (F64*)malloc(sizeof(F64)*(total ? total : 1));
+  if (crossings == 0)
+  {
+    fprintf(stderr,"ERROR (LASpolygon): cannot allocate %u crossings\n", total);
+    return FALSE;
+  }
+  for (r = 0; r < rows; r++)
+  {
+    F64 y = min_y + (r + 0.5)*this->cell_size;
+    U32 number = 0;
+    for (e = row_start[r]; e < row_start[r+1]; e++)
+    {
+      if ((row_y0[e] > y) != (row_y1[e] > y))
+      {
+        crossings[number++] = row_x0[e] + (y - row_y0[e]) * row_slope[e];
+      }
+    }
+    qsort(crossings, number, sizeof(F64), compare_doubles);
+    U32 k = 0;
+    for (c = 0; c < cols; c++)
+    {
+      F64 x = min_x + (c + 0.5)*this->cell_size;
+      while ((k < number) && (crossings[k] < x)) k++;
+      U8* cell = cells + r*cols + c;
+      if (*cell != LAS_POLYGON_BOUNDARY) *cell = ((k & 1) ? LAS_POLYGON_INSIDE : LAS_POLYGON_OUTSIDE);
+    }
+  }
+  free(crossings);
+  return TRUE;
+}
+
+I32 LASpolygon::classify(const F64 min_x, const F64 min_y, const F64 max_x, const F64 max_y) const
+{
+  if ((min_x > this->max_x) || (max_x < this->min_x) || (min_y > this->max_y) || (max_y < this->min_y)) return LAS_POLYGON_OUTSIDE;
+  if (cells == 0) return LAS_POLYGON_BOUNDARY;
+  BOOL beyond = ((min_x < this->min_x) || (max_x > this->max_x) || (min_y < this->min_y) || (max_y > this->max_y));
+  I32 c0 = get_col(min_x), c1 = get_col(max_x);
+  I32 r0 = get_row(min_y), r1 = get_row(max_y);
+  I32 state = cells[r0*cols + c0];
+  if (state == LAS_POLYGON_BOUNDARY) return LAS_POLYGON_BOUNDARY;
+  if (beyond && (state == LAS_POLYGON_INSIDE)) return LAS_POLYGON_BOUNDARY;
+  for (I32 r = r0; r <= r1; r++)
+  {
+    const U8* row = cells + r*cols;
+    for (I32 c = c0; c <= c1; c++)
+    {
+      if (row[c] != state) return LAS_POLYGON_BOUNDARY;
+    }
+  }
+  return state;
+}
+
+BOOL LASpolygon::inside(const F64 x, const F64 y) const
+{
+  if ((x < min_x) || (x > max_x) || (y < min_y) || (y > max_y)) return FALSE;
+  if (cells == 0)
+  {
+    // not prepared. test against all edges
+    U32 crossings = 0;
+    for (U32 e = 0; e < number_edges; e++)
+    {
+      const F64* edge = edges + 4*e;
+      if (((edge[1] > y) != (edge[3] > y)) && (x < edge[0] + (y - edge[1]) * (edge[2] - edge[0]) / (edge[3] - edge[1]))) crossings++;
+    }
+    return (crossings & 1);
+  }
+  I32 r = get_row(y);
+  U8 state = cells[r*cols + get_col(x)];
+  if (state != LAS_POLYGON_BOUNDARY) return (state == LAS_POLYGON_INSIDE);
+  return inside_row(x, y, r);
+}
+
+void LASpolygon::inside(const U32 number, const F64* x, const F64* y, U8* result) const
+{
+  for (U32 i = 0; i < number; i++)
+  {
+    result[i] = (U8)inside(x[i], y[i]);
+  }
+}
+
+void LASpolygon::clean()
+{
+  if (edges) free(edges);
+  if (cells) free(cells);
+  if (row_start) free(row_start);
+  if (row_x0) free(row_x0);
+  if (row_y0) free(row_y0);
+  if (row_y1) free(row_y1);
+  if (row_slope) free(row_slope);
+  edges = 0;
+  number_edges = 0;
+  alloced_edges = 0;
+  number_rings = 0;
+  min_x = min_y = max_x = max_y = 0.0;
+  cell_size = 0.0;
+  cols = rows = 0;
+  cells = 0;
+  row_start = 0;
+  row_x0 = row_y0 = row_y1 = row_slope = 0;
+}
+
+LASpolygon::LASpolygon()
+{
+  edges = 0;
+  cells = 0;
+  row_start = 0;
+  row_x0 = row_y0 = row_y1 = row_slope = 0;
+  clean();
+}
+
+LASpolygon::~LASpolygon()
+{
+  clean();
+}
+
+inline I32 LASpolygon::get_col(const F64 x) const
+{
+  I32 c = (I32)((x - min_x) / cell_size);
+  if (c < 0) return 0;
+  if (c >= cols) return cols - 1;
+  return c;
+}
+
+inline I32 LASpolygon::get_row(const F64 y) const
+{
+  I32 r = (I32)((y - min_y) / cell_size);
+  if (r < 0) return 0;
+  if (r >= rows) return rows - 1;
+  return r;
+}
+
+// even-odd test with only the edges that span this row. the loop has no
+// branches so that it vectorizes
+
+BOOL LASpolygon::inside_row(const F64 x, const F64 y, const I32 r) const
+{
+  U32 crossings = 0;
+  const U32 end = row_start[r+1];
+  for (U32 e = row_start[r]; e < end; e++)
+  {
+    crossings ^= (U32)(((row_y0[e] > y) != (row_y1[e] > y)) & (x < row_x0[e] + (y - row_y0[e]) * row_slope[e]));
+  }
+  return (crossings & 1);
+}
@@ -33,6 +33,8 @@
 #include "lasindex.hpp"
 #include "lasfilter.hpp"
 #include "lastransform.hpp"
+#include "lascatalog.hpp"
+#include "laspolygon.hpp"
 
 #include "lasreader_las.hpp"
 #include "lasreader_bin.hpp"
@@ -154,6 +156,42 @@ BOOL LASreader::inside_none()
   return TRUE;
 }
 
+void LASreader::prefetch_index()
+{
+  // hand the intervals of the query to the reader so it can fetch their chunks ahead
+  U32 number = 0;
+  U32 alloced = 1024;
+  I64* starts = (I64*)malloc(sizeof(I64)*alloced);
+  I64* ends = (I64*)malloc(sizeof(I64)*alloced);
+  if (starts && ends)
+  {
+    while (index->has_intervals())
+    {
+      if (number == alloced)
+      {
+        alloced *= 2;
+        I64* more_starts = (I64*)realloc(starts, sizeof(I64)*alloced);
+        if (more_starts) starts = more_starts;
+        I64* more_ends = (I64*)realloc(ends, sizeof(I64)*alloced);
+        if (more_ends) ends = more_ends;
+        if ((more_starts == 0) || (more_ends == 0))
+        {
+          number = 0;
+          break;
+        }
+      }
+      starts[number] = index->start;
+      ends[number] = index->end;
+      number++;
+    }
+    // rewind the intervals for seek_next()
+    index->get_intervals();
+    if (number) prefetch(number, starts, ends);
+  }
+  if (starts) free(starts);
+  if (ends) free(ends);
+}
+
 BOOL LASreader::inside_tile(const F32 ll_x, const F32 ll_y, const F32 size)
 {
   inside = 1;
@@ -188,6 +226,7 @@ BOOL LASreader::inside_tile(const F32 ll_x, const F32 ll_y, const F32 size)
     if (index)
     {
       if (index) index->intersect_tile(ll_x, ll_y, size);
+      prefetch_index();
       read_complex = &LASreader::read_point_inside_tile_indexed;
     }
     else
@@ -200,6 +239,7 @@ BOOL LASreader::inside_tile(const F32 ll_x, const F32 ll_y, const F32 size)
     if (index)
     {
       if (index) index->intersect_tile(ll_x, ll_y, size);
+      prefetch_index();
       read_simple = &LASreader::read_point_inside_tile_indexed;
     }
     else
@@ -241,6 +281,7 @@ BOOL LASreader::inside_circle(const F64 center_x, const F64 center_y, const F64
     if (index)
     {
       if (index) index->intersect_circle(center_x, center_y, radius);
+      prefetch_index();
       read_complex = &LASreader::read_point_inside_circle_indexed;
     }
     else
@@ -253,6 +294,7 @@ BOOL LASreader::inside_circle(const F64 center_x, const F64 center_y, const F64
     if (index)
     {
       if (index) index->intersect_circle(center_x, center_y, radius);
+      prefetch_index();
       read_simple = &LASreader::read_point_inside_circle_indexed;
     }
     else
@@ -294,6 +336,7 @@ BOOL LASreader::inside_rectangle(const F64 min_x, const F64 min_y, const F64 max
     if (index)
     {
       index->intersect_rectangle(min_x, min_y, max_x, max_y);
+      prefetch_index();
       read_complex = &LASreader::read_point_inside_rectangle_indexed;
     }
     else
@@ -306,6 +349,7 @@ BOOL LASreader::inside_rectangle(const F64 min_x, const F64 min_y, const F64 max
     if (index)
     {
       index->intersect_rectangle(min_x, min_y, max_x, max_y);
+      prefetch_index();
       read_simple = &LASreader::read_point_inside_rectangle_indexed;
     }
     else
@@ -470,6 +514,10 @@ I32 LASreadOpener::unparse(CHAR* string) const
   {
     n += sprintf(string + n, "-io_ibuffer %d ", io_ibuffer_size);
   }
+  if (decompress_threads != 1)
+  {
+    n += sprintf(string + n, "-decompress_threads %u ", decompress_threads);
+  }
   return n;
 }
 
@@ -493,6 +541,8 @@ LASreader* LASreadOpener::open(const CHAR* other_file_name)
 {
   if (filter) filter->reset();
 
+  if (catalog_pending) add_catalog_file_names();
+
   if (file_names || other_file_name)
   {
     use_stdin = FALSE;
@@ -644,6 +694,7 @@ LASreader* LASreadOpener::open(const CHAR* other_file_name)
           lasreaderlas = new LASreaderLASreoffset(offset[0], offset[1], offset[2]);
         else
           lasreaderlas = new LASreaderLASrescalereoffset(scale_factor[0], scale_factor[1], scale_factor[2], offset[0], offset[1], offset[2]);
+        lasreaderlas->set_decompress_threads(decompress_threads);
         if (!lasreaderlas->open(file_name, io_ibuffer_size))
         {
           fprintf(stderr,"ERROR: cannot open lasreaderlas with file name '%s'\n", file_name);
@@ -976,6 +1027,45 @@ LASreader* LASreadOpener::open(const CHAR* other_file_name)
       }
     }
   }
+  else if (use_memory)
+  {
+    use_memory = FALSE;
+    LASreaderLAS* lasreaderlas;
+    if (scale_factor == 0 && offset == 0)
+      lasreaderlas = new LASreaderLAS();
+    else if (scale_factor != 0 && offset == 0)
+      lasreaderlas = new LASreaderLASrescale(scale_factor[0], scale_factor[1], scale_factor[2]);
+    else if (scale_factor == 0 && offset != 0)
+      lasreaderlas = new LASreaderLASreoffset(offset[0], offset[1], offset[2]);
+    else
+      lasreaderlas = new LASreaderLASrescalereoffset(scale_factor[0], scale_factor[1], scale_factor[2], offset[0], offset[1], offset[2]);
+    if (!lasreaderlas->open(memory_data, memory_size))
+    {
+      fprintf(stderr,"ERROR: cannot open lasreaderlas from memory\n");
+      delete lasreaderlas;
+      return 0;
+    }
+    if (filter) lasreaderlas->set_filter(filter);
+    if (transform) lasreaderlas->set_transform(transform);
+    if (inside_tile) lasreaderlas->inside_tile(inside_tile[0], inside_tile[1], inside_tile[2]);
+    if (inside_circle) lasreaderlas->inside_circle(inside_circle[0], inside_circle[1], inside_circle[2]);
+    if (inside_rectangle) lasreaderlas->inside_rectangle(inside_rectangle[0], inside_rectangle[1], inside_rectangle[2], inside_rectangle[3]);
+    if (pipe_on)
+    {
+      LASreaderPipeOn* lasreaderpipeon = new LASreaderPipeOn();
+      if (!lasreaderpipeon->open(lasreaderlas))
+      {
+        fprintf(stderr,"ERROR: cannot open lasreaderpipeon with lasreaderlas from memory\n");
+        delete lasreaderpipeon;
+        return 0;
+      }
+      return lasreaderpipeon;
+    }
+    else
+    {
+      return lasreaderlas;
+    }
+  }
   else if (use_stdin)
   {
     use_stdin = FALSE; populate_header = TRUE;
@@ -1133,6 +1223,7 @@ BOOL LASreadOpener::reopen(LASreader* lasreader, BOOL remain_buffered)
       if (strstr(file_name, ".las") || strstr(file_name, ".laz") || strstr(file_name, ".LAS") || strstr(file_name, ".LAZ"))
       {
         LASreaderLAS* lasreaderlas = (LASreaderLAS*)lasreader;
+        lasreaderlas->set_decompress_threads(decompress_threads);
         if (!lasreaderlas->open(file_name, io_ibuffer_size))
         {
           fprintf(stderr,"ERROR: cannot reopen lasreaderlas with file name '%s'\n", file_name);
@@ -1273,6 +1364,23 @@ BOOL LASreadOpener::reopen(LASreader* lasreader, BOOL remain_buffered)
       }
     }
   }
+  else if (memory_data)
+  {
+    LASreaderLAS* lasreaderlas = (LASreaderLAS*)lasreader;
+    if (!lasreaderlas->open(memory_data, memory_size))
+    {
+      fprintf(stderr,"ERROR: cannot reopen lasreaderlas from memory\n");
+      return FALSE;
+    }
+    if (inside_rectangle || inside_tile || inside_circle)
+    {
+      lasreaderlas->inside_none();
+      if (inside_rectangle) lasreaderlas->inside_rectangle(inside_rectangle[0], inside_rectangle[1], inside_rectangle[2], inside_rectangle[3]);
+      else if (inside_tile) lasreaderlas->inside_tile(inside_tile[0], inside_tile[1], inside_tile[2]);
+      else lasreaderlas->inside_circle(inside_circle[0], inside_circle[1], inside_circle[2]);
+    }
+    return TRUE;
+  }
   else
   {
     fprintf(stderr,"ERROR: no lasreader input specified\n");
@@ -1310,6 +1418,7 @@ void LASreadOpener::usage() const
   fprintf(stderr,"Supported LAS Inputs\n");
   fprintf(stderr,"  -i lidar.las\n");
   fprintf(stderr,"  -i lidar.laz\n");
+  fprintf(stderr,"  -i lidar.las.gz -decompress_threads 4 (also *.las.zst)\n");
   fprintf(stderr,"  -i lidar1.las lidar2.las lidar3.las -merged\n");
   fprintf(stderr,"  -i *.las - merged\n");
   fprintf(stderr,"  -i flight0??.laz flight1??.laz\n");
@@ -1319,6 +1428,8 @@ void LASreadOpener::usage() const
   fprintf(stderr,"  -i lidar.txt -iparse xyzti -iskip 2 (on-the-fly from ASCII)\n");
   fprintf(stderr,"  -i lidar.txt -iparse xyzi -itranslate_intensity 1024\n");
   fprintf(stderr,"  -lof file_list.txt\n");
+  fprintf(stderr,"  -catalog tiles.lac (only the files that intersect '-inside')\n");
+  fprintf(stderr,"  -clip_polygon boundary.shp (only the points inside the polygons)\n");
   fprintf(stderr,"  -stdin (pipe from stdin)\n");
   fprintf(stderr,"  -rescale 0.01 0.01 0.001\n");
   fprintf(stderr,"  -rescale_xy 0.01 0.01\n");
@@ -1430,6 +1541,34 @@ BOOL LASreadOpener::parse(int argc, char* argv[])
       }
       *argv[i]='\0'; *argv[i+1]='\0'; i+=1;
     }
+    else if (strcmp(argv[i],"-catalog") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: catalog\n", argv[i]);
+        return FALSE;
+      }
+      if (!set_catalog(argv[i+1]))
+      {
+        fprintf(stderr, "ERROR: cannot load catalog '%s'\n", argv[i+1]);
+        return FALSE;
+      }
+      *argv[i]='\0'; *argv[i+1]='\0'; i+=1;
+    }
+    else if (strcmp(argv[i],"-clip_polygon") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: shapefile\n", argv[i]);
+        return FALSE;
+      }
+      if (!set_clip_polygon(argv[i+1]))
+      {
+        fprintf(stderr, "ERROR: cannot load polygons from '%s'\n", argv[i+1]);
+        return FALSE;
+      }
+      *argv[i]='\0'; *argv[i+1]='\0'; i+=1;
+    }
     else if (strcmp(argv[i],"-rescale") == 0)
     {
       if ((i+3) >= argc)
@@ -1688,6 +1827,16 @@ BOOL LASreadOpener::parse(int argc, char* argv[])
       set_io_ibuffer_size((I32)atoi(argv[i+1]));
       *argv[i]='\0'; *argv[i+1]='\0'; i+=1;
     }
+    else if (strcmp(argv[i],"-decompress_threads") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: number\n", argv[i]);
+        return FALSE;
+      }
+      set_decompress_threads((U32)atoi(argv[i+1]));
+      *argv[i]='\0'; *argv[i+1]='\0'; i+=1;
+    }
     else if (strcmp(argv[i],"-do_not_populate") == 0)
     {
       set_populate_header(FALSE);
@@ -1712,6 +1861,10 @@ BOOL LASreadOpener::parse(int argc, char* argv[])
     }
   }
 
+  // add the files of the catalog that intersect the area-of-interest
+
+  if (catalog_pending) add_catalog_file_names();
+
   // check that there are only buffered neighbors for single files
 
   if (neighbor_file_name_number)
@@ -1872,6 +2025,11 @@ void LASreadOpener::set_apply_file_source_ID(const BOOL apply_file_source_ID)
   this->apply_file_source_ID = apply_file_source_ID;
 }
 
+void LASreadOpener::set_decompress_threads(U32 decompress_threads)
+{
+  this->decompress_threads = (decompress_threads ? decompress_threads : 1);
+}
+
 void LASreadOpener::set_io_ibuffer_size(I32 io_ibuffer_size)
 {
   this->io_ibuffer_size = io_ibuffer_size;
@@ -1983,6 +2141,54 @@ BOOL LASreadOpener::add_list_of_files(const CHAR* list_of_files, BOOL unique)
   return TRUE;
 }
 
+BOOL LASreadOpener::set_catalog(const CHAR* catalog_name)
+{
+  if (catalog) delete catalog;
+  catalog = new LAScatalog();
+  if (!catalog->read(catalog_name))
+  {
+    delete catalog;
+    catalog = 0;
+    catalog_pending = FALSE;
+    return FALSE;
+  }
+  catalog_pending = TRUE;
+  return TRUE;
+}
+
+BOOL LASreadOpener::set_clip_polygon(const CHAR* shp_file_name)
+{
+  if (polygon) delete polygon;
+  polygon = new LASpolygon();
+  if (!polygon->read_shp(shp_file_name) || !polygon->prepare())
+  {
+    delete polygon;
+    polygon = 0;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+void LASreadOpener::add_catalog_file_names()
+{
+  catalog_pending = FALSE;
+  if (catalog == 0) return;
+  if (inside_tile)
+    catalog->intersect_tile(inside_tile[0], inside_tile[1], inside_tile[2]);
+  else if (inside_circle)
+    catalog->intersect_circle(inside_circle[0], inside_circle[1], inside_circle[2]);
+  else if (inside_rectangle)
+    catalog->intersect_rectangle(inside_rectangle[0], inside_rectangle[1], inside_rectangle[2], inside_rectangle[3]);
+  else if (polygon)
+    catalog->intersect_rectangle(polygon->get_min_x(), polygon->get_min_y(), polygon->get_max_x(), polygon->get_max_y());
+  else
+    catalog->select_all();
+  for (U32 i = 0; i < catalog->get_number_selected(); i++)
+  {
+    add_file_name(catalog->get_selected(i)->file_name, unique);
+  }
+}
+
 void LASreadOpener::delete_file_name(U32 file_name_id)
 {
   if (file_name_id < file_name_number)
@@ -2186,6 +2392,14 @@ void LASreadOpener::set_pipe_on(BOOL pipe_on)
   this->pipe_on = pipe_on;
 }
 
+// the buffer is read in place and must stay valid until the LASreader is closed
+void LASreadOpener::set_memory(const U8* data, const I64 size)
+{
+  memory_data = data;
+  memory_size = size;
+  use_memory = (data != 0);
+}
+
 void LASreadOpener::set_inside_tile(const F32 ll_x, const F32 ll_y, const F32 size)
 {
   if (inside_tile == 0) inside_tile = new F32[3];
@@ -2213,17 +2427,21 @@ void LASreadOpener::set_inside_rectangle(const F64 min_x, const F64 min_y, const
 
 BOOL LASreadOpener::active() const
 {
-  return ((file_name_current < file_name_number) || use_stdin);
+  return ((file_name_current < file_name_number) || use_stdin || use_memory);
 }
 
 LASreadOpener::LASreadOpener()
 {
   io_ibuffer_size = LAS_TOOLS_IO_IBUFFER_SIZE;
+  decompress_threads = 1;
   file_names = 0;
   file_name = 0;
   neighbor_file_names = 0;
   merged = FALSE;
   use_stdin = FALSE;
+  use_memory = FALSE;
+  memory_data = 0;
+  memory_size = 0;
   comma_not_point = FALSE;
   scale_factor = 0;
   offset = 0;
@@ -2265,6 +2483,9 @@ LASreadOpener::LASreadOpener()
   inside_rectangle = 0;
   filter = 0;
   transform = 0;
+  catalog = 0;
+  catalog_pending = FALSE;
+  polygon = 0;
 }
 
 LASreadOpener::~LASreadOpener()
@@ -2289,4 +2510,6 @@ LASreadOpener::~LASreadOpener()
   if (inside_rectangle) delete [] inside_rectangle;
   if (filter) delete filter;
   if (transform) delete transform;
+  if (catalog) delete catalog;
+  if (polygon) delete polygon;
 }
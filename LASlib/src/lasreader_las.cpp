@@ -33,6 +33,9 @@
 #include "bytestreamin.hpp"
 #include "bytestreamin_file.hpp"
 #include "bytestreamin_istream.hpp"
+#include "bytestreamin_array.hpp"
+#include "bytestreamin_uring.hpp"
+#include "bytestreamin_compressed.hpp"
 #include "lasreadpoint.hpp"
 #include "lasindex.hpp"
 
@@ -67,14 +70,59 @@ BOOL LASreaderLAS::open(const char* file_name, I32 io_buffer_size, BOOL peek_onl
 
   // create input
   ByteStreamIn* in;
+#ifndef _WIN32
+  if (ByteStreamInCompressed::get_format(file) != BYTE_STREAM_IN_COMPRESSED_NONE)
+  {
+    if (!IS_LITTLE_ENDIAN())
+    {
+      fprintf(stderr, "ERROR: compressed input '%s' needs a little-endian machine\n", file_name);
+      fclose(file);
+      file = 0;
+      return FALSE;
+    }
+    ByteStreamInCompressed* compressed = new ByteStreamInCompressed(file, decompress_threads);
+    if (!compressed->init())
+    {
+      fprintf(stderr, "ERROR: cannot decompress '%s'\n", file_name);
+      delete compressed;
+      fclose(file);
+      file = 0;
+      return FALSE;
+    }
+    return open(compressed, peek_only);
+  }
+#endif
+#if defined(__linux__)
+  if (IS_LITTLE_ENDIAN())
+    in = new ByteStreamInFileUring(file);
+#else
   if (IS_LITTLE_ENDIAN())
     in = new ByteStreamInFileLE(file);
+#endif
   else
     in = new ByteStreamInFileBE(file);
 
   return open(in, peek_only);
 }
 
+BOOL LASreaderLAS::open(const U8* data, const I64 size, BOOL peek_only)
+{
+  if (data == 0)
+  {
+    fprintf(stderr,"ERROR: data pointer is zero\n");
+    return FALSE;
+  }
+
+  // create input
+  ByteStreamIn* in;
+  if (IS_LITTLE_ENDIAN())
+    in = new ByteStreamInArrayLE((U8*)data, size);
+  else
+    in = new ByteStreamInArrayBE((U8*)data, size);
+
+  return open(in, peek_only);
+}
+
 BOOL LASreaderLAS::open(FILE* file, BOOL peek_only)
 {
   if (file == 0)
@@ -1284,7 +1332,7 @@ BOOL LASreaderLAS::seek(const I64 p_index)
   {
     if (p_index < npoints)
     {
-      if (reader->seek((U32)p_count, (U32)p_index))
+      if (reader->seek(p_count, p_index))
       {
         p_count = p_index;
         return TRUE;
@@ -1294,6 +1342,15 @@ BOOL LASreaderLAS::seek(const I64 p_index)
   return FALSE;
 }
 
+BOOL LASreaderLAS::prefetch(const U32 number_intervals, const I64* starts, const I64* ends)
+{
+  if (reader)
+  {
+    return reader->prefetch(number_intervals, starts, ends);
+  }
+  return FALSE;
+}
+
 BOOL LASreaderLAS::read_point_default()
 {
   if (p_count < npoints)
@@ -1302,11 +1359,19 @@ BOOL LASreaderLAS::read_point_default()
     {
       if (reader->error())
       {
-        fprintf(stderr,"ERROR: '%s' after %u of %u points\n", reader->error(), (U32)p_count, (U32)npoints);
+#ifdef _WIN32
+        fprintf(stderr,"ERROR: '%s' after %I64d of %I64d points\n", reader->error(), p_count, npoints);
+#else
+        fprintf(stderr,"ERROR: '%s' after %lld of %lld points\n", reader->error(), p_count, npoints);
+#endif
       }
       else
       {
-        fprintf(stderr,"WARNING: end-of-file after %u of %u points\n", (U32)p_count, (U32)npoints);
+#ifdef _WIN32
+        fprintf(stderr,"WARNING: end-of-file after %I64d of %I64d points\n", p_count, npoints);
+#else
+        fprintf(stderr,"WARNING: end-of-file after %lld of %lld points\n", p_count, npoints);
+#endif
       }
       return FALSE;
     }
@@ -1383,8 +1448,14 @@ void LASreaderLAS::close(BOOL close_stream)
   }
 }
 
+void LASreaderLAS::set_decompress_threads(U32 decompress_threads)
+{
+  this->decompress_threads = (decompress_threads ? decompress_threads : 1);
+}
+
 LASreaderLAS::LASreaderLAS()
 {
+  decompress_threads = 1;
   file = 0;
   stream = 0;
   reader = 0;
@@ -39,6 +39,89 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define LAS_TEE_BATCH_POINTS 4096
+#define LAS_TEE_RING_BATCHES 8
+#define LAS_TEE_SPIN 64
+
+// single-producer, single-consumer ring of point batches. the reading thread
+// fills the batch at 'head' and publishes it by incrementing 'head'. the writer
+// thread compresses the batch at 'tail' and frees it by incrementing 'tail'.
+// a thread that finds the ring full (or empty) spins briefly and then sleeps
+// until the other thread signals that it has freed (or filled) a batch.
+
+class LASteeRing
+{
+public:
+  U8* batches[LAS_TEE_RING_BATCHES];
+  U32 batch_points[LAS_TEE_RING_BATCHES];
+  U32 point_size;
+  U32 fill;
+  std::atomic<U32> head;
+  std::atomic<U32> tail;
+  std::atomic<bool> done;
+  std::mutex mutex;
+  std::condition_variable filled;
+  std::condition_variable freed;
+  LASpoint point;
+  LASwriter* laswriter;
+  std::thread thread;
+};
+
+// the waiting thread checks its condition under the mutex and the signalling
+// thread takes the mutex after its store, so that no signal is lost
+
+static void tee_signal(LASteeRing* tee, std::condition_variable* condition)
+{
+  {
+    std::lock_guard<std::mutex> lock(tee->mutex);
+  }
+  condition->notify_one();
+}
+
+static BOOL tee_have_batch(LASteeRing* tee, const U32 tail)
+{
+  return (tail != tee->head.load(std::memory_order_acquire)) || tee->done.load(std::memory_order_acquire);
+}
+
+static void tee_write_batches(LASteeRing* tee)
+{
+  U32 tail = tee->tail.load(std::memory_order_relaxed);
+  while (true)
+  {
+    if (tail == tee->head.load(std::memory_order_acquire))
+    {
+      U32 spin = 0;
+      while (!tee_have_batch(tee, tail) && (spin < LAS_TEE_SPIN))
+      {
+        std::this_thread::yield();
+        spin++;
+      }
+      if (!tee_have_batch(tee, tail))
+      {
+        std::unique_lock<std::mutex> lock(tee->mutex);
+        tee->filled.wait(lock, [tee, tail]{ return tee_have_batch(tee, tail); });
+      }
+      // check once more because the last batch may come with 'done'
+      if (tail == tee->head.load(std::memory_order_acquire)) break;
+    }
+    U32 slot = tail % LAS_TEE_RING_BATCHES;
+    const U8* batch = tee->batches[slot];
+    for (U32 i = 0; i < tee->batch_points[slot]; i++)
+    {
+      tee->point.copy_from(batch + i*tee->point_size);
+      tee->laswriter->write_point(&tee->point);
+    }
+    tail++;
+    tee->tail.store(tail, std::memory_order_release);
+    tee_signal(tee, &tee->freed);
+  }
+}
+
 BOOL LASreaderPipeOn::open(LASreader* lasreader)
 {
   if (lasreader == 0)
@@ -82,6 +165,7 @@ BOOL LASreaderPipeOn::open(LASreader* lasreader)
 
   // create the LASwriter
 
+  tee_finish();
   if (laswriter) delete laswriter;
   laswriter = 0;
 
@@ -102,6 +186,13 @@ BOOL LASreaderPipeOn::open(LASreader* lasreader)
 
   laswriter = laswriterlas;
 
+  // hand the compression to a background writer thread
+
+  if (!tee_start())
+  {
+    fprintf(stderr, "WARNING: cannot start writer thread. writing to stdout synchronously.\n");
+  }
+
   npoints = (header.number_of_point_records ? header.number_of_point_records : header.extended_number_of_point_records);
   p_count = 0;
 
@@ -148,6 +239,83 @@ I32 LASreaderPipeOn::get_format() const
   return (lasreader ? lasreader->get_format() : LAS_TOOLS_FORMAT_DEFAULT);
 }
 
+BOOL LASreaderPipeOn::tee_start()
+{
+  U32 i;
+  tee = new LASteeRing();
+  for (i = 0; i < LAS_TEE_RING_BATCHES; i++)
+  {
+    tee->batches[i] = 0;
+    tee->batch_points[i] = 0;
+  }
+  tee->point_size = point.total_point_size;
+  tee->fill = 0;
+  tee->head.store(0);
+  tee->tail.store(0);
+  tee->done.store(false);
+  tee->laswriter = laswriter;
+  // the writer thread needs its own point with the same layout
+  BOOL initialized;
+  if (header.laszip)
+  {
+    initialized = tee->point.init(&header, header.laszip->num_items, header.laszip->items);
+  }
+  else
+  {
+    initialized = tee->point.init(&header, header.point_data_format, header.point_data_record_length);
+  }
+  if (!initialized)
+  {
+    tee_finish();
+    return FALSE;
+  }
+  for (i = 0; i < LAS_TEE_RING_BATCHES; i++)
+  {
+    tee->batches[i] = (U8*)malloc(LAS_TEE_BATCH_POINTS*tee->point_size);
+    if (tee->batches[i] == 0)
+    {
+      tee_finish();
+      return FALSE;
+    }
+  }
+  try
+  {
+    tee->thread = std::thread(tee_write_batches, tee);
+  }
+  catch (...)
+  {
+    tee_finish();
+    return FALSE;
+  }
+  return TRUE;
+}
+
+// publishes the last batch, waits for the writer thread, and releases the ring
+
+void LASreaderPipeOn::tee_finish()
+{
+  if (tee == 0) return;
+  if (tee->thread.joinable())
+  {
+    U32 head = tee->head.load(std::memory_order_relaxed);
+    if (tee->fill)
+    {
+      tee->batch_points[head % LAS_TEE_RING_BATCHES] = tee->fill;
+      tee->head.store(head + 1, std::memory_order_release);
+      tee->fill = 0;
+    }
+    tee->done.store(true, std::memory_order_release);
+    tee_signal(tee, &tee->filled);
+    tee->thread.join();
+  }
+  for (U32 i = 0; i < LAS_TEE_RING_BATCHES; i++)
+  {
+    if (tee->batches[i]) free(tee->batches[i]);
+  }
+  delete tee;
+  tee = 0;
+}
+
 BOOL LASreaderPipeOn::read_point_default()
 {
   while (true)
@@ -155,13 +323,42 @@ BOOL LASreaderPipeOn::read_point_default()
     if (lasreader->read_point())
     {
       point = lasreader->point;
-      if (laswriter)
+      if (tee)
+      {
+        U32 head = tee->head.load(std::memory_order_relaxed);
+        U32 slot = head % LAS_TEE_RING_BATCHES;
+        point.copy_to(tee->batches[slot] + tee->fill*tee->point_size);
+        tee->fill++;
+        if (tee->fill == LAS_TEE_BATCH_POINTS)
+        {
+          tee->batch_points[slot] = tee->fill;
+          tee->fill = 0;
+          head++;
+          tee->head.store(head, std::memory_order_release);
+          tee_signal(tee, &tee->filled);
+          // wait until the writer thread has freed the next batch
+          U32 spin = 0;
+          while (((head - tee->tail.load(std::memory_order_acquire)) == LAS_TEE_RING_BATCHES) && (spin < LAS_TEE_SPIN))
+          {
+            std::this_thread::yield();
+            spin++;
+          }
+          if ((head - tee->tail.load(std::memory_order_acquire)) == LAS_TEE_RING_BATCHES)
+          {
+            LASteeRing* ring = tee;
+            std::unique_lock<std::mutex> lock(ring->mutex);
+            ring->freed.wait(lock, [ring, head]{ return (head - ring->tail.load(std::memory_order_acquire)) != LAS_TEE_RING_BATCHES; });
+          }
+        }
+      }
+      else if (laswriter)
       {
         laswriter->write_point(&point);
       }
       p_count++;
       return TRUE;
     }
+    tee_finish();
     if (laswriter)
     {
       laswriter->close();
@@ -185,10 +382,12 @@ LASreaderPipeOn::LASreaderPipeOn()
 {
   lasreader = 0;
   laswriter = 0;
+  tee = 0;
 }
 
 LASreaderPipeOn::~LASreaderPipeOn()
 {
   if (lasreader || laswriter) close();
+  tee_finish();
   if (lasreader) delete lasreader;
 }
@@ -31,6 +31,7 @@
 #include "laswaveform13reader.hpp"
 
 #include "bytestreamin_file.hpp"
+#include "bytestreamin_array.hpp"
 #include "arithmeticdecoder.hpp"
 #include "integercompressor.hpp"
 
@@ -62,6 +63,17 @@ LASwaveform13reader::LASwaveform13reader()
   dec = 0;
   ic8 = 0;
   ic16 = 0;
+
+  batch_number = 0;
+  batch_alloc = 0;
+  batch = 0;
+  batch_sorted = 0;
+  batch_samples = 0;
+  batch_samples_alloc = 0;
+  buffer = 0;
+  buffer_alloc = 0;
+  buffer_start = 0;
+  buffer_end = 0;
 }
   
 LASwaveform13reader::~LASwaveform13reader()
@@ -70,6 +82,10 @@ LASwaveform13reader::~LASwaveform13reader()
   if (ic8) delete ic8;
   if (ic16) delete ic16;
   if (dec) delete dec;
+  if (batch) delete [] batch;
+  if (batch_sorted) delete [] batch_sorted;
+  if (batch_samples) delete [] batch_samples;
+  if (buffer) free(buffer);
 }
 
 BOOL LASwaveform13reader::is_compressed() const
@@ -254,28 +270,28 @@ BOOL LASwaveform13reader::open(const char* file_name, I64 start_of_waveform_data
   return TRUE;
 }
 
-BOOL LASwaveform13reader::read_waveform(const LASpoint* point)
+BOOL LASwaveform13reader::set_waveform(const LASpoint* point, U32* index)
 {
-  U32 index = point->wavepacket.getIndex();
-  if (index == 0)
+  *index = point->wavepacket.getIndex();
+  if (*index == 0)
   {
     return FALSE;
   }
 
-  if (wave_packet_descr[index] == 0)
+  if (wave_packet_descr[*index] == 0)
   {
-    fprintf(stderr, "ERROR: wavepacket is indexing non-existant descriptor %u\n", index);
+    fprintf(stderr, "ERROR: wavepacket is indexing non-existant descriptor %u\n", *index);
     return FALSE;
   }
 
-  nbits = wave_packet_descr[index]->getBitsPerSample();
+  nbits = wave_packet_descr[*index]->getBitsPerSample();
   if ((nbits != 8) && (nbits != 16))
   {
     fprintf(stderr, "ERROR: waveform with %d bits per samples not supported yet\n", nbits);
     return FALSE;
   }
 
-  nsamples = wave_packet_descr[index]->getNumberOfSamples();
+  nsamples = wave_packet_descr[*index]->getNumberOfSamples();
 
 //  temporary Optech Fix
 //  nsamples = point->wavepacket.getSize(); 
@@ -287,7 +303,7 @@ BOOL LASwaveform13reader::read_waveform(const LASpoint* point)
     return FALSE;
   }
 
-  temporal = wave_packet_descr[index]->getTemporalSpacing();
+  temporal = wave_packet_descr[*index]->getTemporalSpacing();
   location = point->wavepacket.getLocation();
 
   XYZt[0] = point->wavepacket.getXt();
@@ -298,6 +314,58 @@ BOOL LASwaveform13reader::read_waveform(const LASpoint* point)
   XYZreturn[1] = point->get_y();
   XYZreturn[2] = point->get_z();
 
+  return TRUE;
+}
+
+BOOL LASwaveform13reader::read_samples(ByteStreamIn* in, const U32 index, U8* out)
+{
+  U32 bytes = ((nbits/8) * nsamples);
+  try
+  {
+    if (wave_packet_descr[index]->getCompressionType() == 0)
+    {
+      in->getBytes(out, bytes);
+    }
+    else
+    {
+      if (nbits == 8)
+      {
+        in->getBytes(out, 1);
+        dec->init(in);
+        ic8->initDecompressor();
+        for (U32 i = 1; i < nsamples; i++)
+        {
+          out[i] = ic8->decompress(out[i-1]);
+        }
+      }
+      else
+      {
+        in->getBytes(out, 2);
+        dec->init(in);
+        ic16->initDecompressor();
+        for (U32 i = 1; i < nsamples; i++)
+        {
+          ((U16*)out)[i] = ic16->decompress(((U16*)out)[i-1]);
+        }
+      }
+      dec->done();
+    }
+  }
+  catch(...)
+  {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+BOOL LASwaveform13reader::read_waveform(const LASpoint* point)
+{
+  U32 index;
+  if (!set_waveform(point, &index))
+  {
+    return FALSE;
+  }
+
   // alloc data
 
   if (size < ((nbits/8) * nsamples))
@@ -313,38 +381,219 @@ BOOL LASwaveform13reader::read_waveform(const LASpoint* point)
   I64 position = start_of_waveform_data_packet_record + point->wavepacket.getOffset();
   stream->seek(position);
 
-  if (wave_packet_descr[index]->getCompressionType() == 0)
+  if (!read_samples(stream, index, samples))
+  {
+    fprintf(stderr, "ERROR: cannot read %u bytes for waveform with %u samples of %u bits\n", size, nsamples, nbits);
+    return FALSE;
+  }
+
+  s_count = 0;
+  return TRUE;
+}
+
+// packets that are at most this far apart are fetched with the same read
+#define LAS_WAVEFORM_BATCH_GAP         16384
+// a read fetches up to three times its length more (but at most this much)
+// so that the next block may find its packets already in memory. blocks of
+// few points in random order thus do not read much they do not need
+#define LAS_WAVEFORM_BATCH_READ_AHEAD  1048576
+// packets are not added to a read that would grow beyond this
+#define LAS_WAVEFORM_BATCH_SPAN_MAX    (16*1048576)
+
+struct LASwaveform13packet
+{
+  I64 position;   // in the file
+  U32 bytes;      // in the file
+  U32 point;      // in the block
+  U32 index;      // of the descriptor
+  U32 nbits;
+  U32 nsamples;
+  U32 temporal;
+  F32 location;
+  F32 XYZt[3];
+  F64 XYZreturn[3];
+  U32 offset;     // of the samples in batch_samples
+  BOOL ok;
+};
+
+static int compare_packets(const void* a, const void* b)
+{
+  const LASwaveform13packet* pa = (const LASwaveform13packet*)a;
+  const LASwaveform13packet* pb = (const LASwaveform13packet*)b;
+  if (pa->position < pb->position) return -1;
+  if (pa->position > pb->position) return 1;
+  return (pa->point < pb->point ? -1 : (pa->point > pb->point ? 1 : 0));
+}
+
+BOOL LASwaveform13reader::read_waveforms(const U32 number, const LASpoint * const * points)
+{
+  U32 i, j, sorted;
+
+  if (stream == 0)
   {
-    try { stream->getBytes(samples, size); } catch(...)
+    fprintf(stderr, "ERROR: waveform file not open\n");
+    return FALSE;
+  }
+
+  if (number > batch_alloc)
+  {
+    if (batch) delete [] batch;
+    if (batch_sorted) delete [] batch_sorted;
+    batch = new LASwaveform13packet[number];
+    batch_sorted = new LASwaveform13packet[number];
+    batch_alloc = number;
+  }
+  batch_number = number;
+
+  // describe the packet of every point and where its samples go
+
+  U32 total = 0;
+  sorted = 0;
+  for (i = 0; i < number; i++)
+  {
+    LASwaveform13packet* packet = batch + i;
+    packet->point = i;
+    packet->ok = FALSE;
+    if (!set_waveform(points[i], &packet->index)) continue;
+    packet->nbits = nbits;
+    packet->nsamples = nsamples;
+    packet->temporal = temporal;
+    packet->location = location;
+    packet->XYZt[0] = XYZt[0];
+    packet->XYZt[1] = XYZt[1];
+    packet->XYZt[2] = XYZt[2];
+    packet->XYZreturn[0] = XYZreturn[0];
+    packet->XYZreturn[1] = XYZreturn[1];
+    packet->XYZreturn[2] = XYZreturn[2];
+    packet->position = start_of_waveform_data_packet_record + points[i]->wavepacket.getOffset();
+    packet->bytes = ((nbits/8) * nsamples);
+    packet->offset = total;
+    total += packet->bytes;
+    if ((wave_packet_descr[packet->index]->getCompressionType() != 0) && points[i]->wavepacket.getSize())
     {
-      fprintf(stderr, "ERROR: cannot read %u bytes for waveform with %u samples of %u bits\n", size, nsamples, nbits);
-      return FALSE;
+      packet->bytes = points[i]->wavepacket.getSize();
     }
+    batch_sorted[sorted++] = *packet;
   }
-  else
+
+  if (total > batch_samples_alloc)
   {
-    if (nbits == 8)
+    if (batch_samples) delete [] batch_samples;
+    batch_samples = new U8[total];
+    batch_samples_alloc = total;
+  }
+
+  // visit the packets in file order
+
+  qsort(batch_sorted, sorted, sizeof(LASwaveform13packet), compare_packets);
+
+  BOOL all_ok = TRUE;
+  for (i = 0; i < sorted; i++)
+  {
+    LASwaveform13packet* packet = batch_sorted + i;
+    U8* out = batch_samples + packet->offset;
+    nbits = packet->nbits;
+    nsamples = packet->nsamples;
+
+    // points that share a packet decode it once
+
+    if (i && (packet->position == batch_sorted[i-1].position) && (packet->index == batch_sorted[i-1].index) && batch[batch_sorted[i-1].point].ok)
+    {
+      memcpy(out, batch_samples + batch_sorted[i-1].offset, (nbits/8) * nsamples);
+      batch[packet->point].ok = TRUE;
+      continue;
+    }
+
+    // fetch this and the following nearby packets with one read
+
+    I64 end = packet->position + packet->bytes;
+    if ((packet->position < buffer_start) || (end > buffer_end))
     {
-      stream->getBytes(samples, 1);
-      dec->init(stream);
-      ic8->initDecompressor();
-      for (s_count = 1; s_count < nsamples; s_count++)
+      for (j = i + 1; j < sorted; j++)
+      {
+        const LASwaveform13packet* next = batch_sorted + j;
+        if (next->position > (end + LAS_WAVEFORM_BATCH_GAP)) break;
+        if ((next->position + next->bytes - packet->position) > LAS_WAVEFORM_BATCH_SPAN_MAX) break;
+        if ((next->position + next->bytes) > end) end = next->position + next->bytes;
+      }
+      U32 length = (U32)(end - packet->position);
+      if (length < LAS_WAVEFORM_BATCH_READ_AHEAD)
+      {
+        length = ((4*length) < LAS_WAVEFORM_BATCH_READ_AHEAD ? 4*length : LAS_WAVEFORM_BATCH_READ_AHEAD);
+      }
+      if (length > buffer_alloc)
+      {
+        if (buffer) free(buffer);
+        buffer = (U8*)malloc(length);
+        buffer_alloc = (buffer ? length : 0);
+      }
+      buffer_start = packet->position;
+      buffer_end = packet->position;
+      if (buffer && stream->seek(packet->position))
       {
-        samples[s_count] = ic8->decompress(samples[s_count-1]);
+        buffer_end += fread(buffer, 1, length, file);
       }
     }
-    else
+
+    // decode from memory. should a compressed packet whose size is not
+    // stored run past the end of what was read, read it from the file
+
+    BOOL ok = FALSE;
+    if ((buffer_start <= packet->position) && (packet->position < buffer_end))
     {
-      stream->getBytes(samples, 2);
-      dec->init(stream);
-      ic16->initDecompressor();
-      for (s_count = 1; s_count < nsamples; s_count++)
+      if (IS_LITTLE_ENDIAN())
       {
-        ((U16*)samples)[s_count] = ic16->decompress(((U16*)samples)[s_count-1]);
+        ByteStreamInArrayLE in(buffer + (packet->position - buffer_start), buffer_end - packet->position);
+        ok = read_samples(&in, packet->index, out);
+      }
+      else
+      {
+        ByteStreamInArrayBE in(buffer + (packet->position - buffer_start), buffer_end - packet->position);
+        ok = read_samples(&in, packet->index, out);
       }
     }
-    dec->done();
+    if (!ok)
+    {
+      stream->seek(packet->position);
+      ok = read_samples(stream, packet->index, out);
+    }
+    if (!ok)
+    {
+      fprintf(stderr, "ERROR: cannot read %u bytes for waveform with %u samples of %u bits\n", packet->bytes, nsamples, nbits);
+      all_ok = FALSE;
+    }
+    batch[packet->point].ok = ok;
   }
+  return all_ok;
+}
+
+BOOL LASwaveform13reader::select_waveform(const U32 i)
+{
+  if ((i >= batch_number) || !batch[i].ok)
+  {
+    return FALSE;
+  }
+
+  const LASwaveform13packet* packet = batch + i;
+  nbits = packet->nbits;
+  nsamples = packet->nsamples;
+  temporal = packet->temporal;
+  location = packet->location;
+  XYZt[0] = packet->XYZt[0];
+  XYZt[1] = packet->XYZt[1];
+  XYZt[2] = packet->XYZt[2];
+  XYZreturn[0] = packet->XYZreturn[0];
+  XYZreturn[1] = packet->XYZreturn[1];
+  XYZreturn[2] = packet->XYZreturn[2];
+
+  if (size < ((nbits/8) * nsamples))
+  {
+    if (samples) delete [] samples;
+    samples = new U8[((nbits/8) * nsamples)];
+  }
+
+  size = ((nbits/8) * nsamples);
+  memcpy(samples, batch_samples + packet->offset, size);
 
   s_count = 0;
   return TRUE;
@@ -454,4 +703,6 @@ void LASwaveform13reader::close()
     fclose(file);
     file = 0;
   }
+  buffer_start = 0;
+  buffer_end = 0;
 }
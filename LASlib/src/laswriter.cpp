@@ -55,7 +55,8 @@ LASwriter* LASwriteOpener::open(const LASheader* header)
   if (use_nil)
   {
     LASwriterLAS* laswriterlas = new LASwriterLAS();
-    if (!laswriterlas->open(header, (format == LAS_TOOLS_FORMAT_LAZ ? LASZIP_COMPRESSOR_CHUNKED : LASZIP_COMPRESSOR_NONE), 2, chunk_size))
+    laswriterlas->set_coder(coder);
+    if (!laswriterlas->open(header, (format == LAS_TOOLS_FORMAT_LAZ ? LASZIP_COMPRESSOR_CHUNKED : LASZIP_COMPRESSOR_NONE), version, chunk_size))
     {
       fprintf(stderr,"ERROR: cannot open laswriterlas to NULL\n");
       delete laswriterlas;
@@ -63,12 +64,74 @@ LASwriter* LASwriteOpener::open(const LASheader* header)
     }
     return laswriterlas;
   }
+  else if (use_memory)
+  {
+    if (format > LAS_TOOLS_FORMAT_LAZ)
+    {
+      fprintf(stderr,"ERROR: format %d cannot be written to memory\n", format);
+      return 0;
+    }
+    LASwriterLAS* laswriterlas = new LASwriterLAS();
+    laswriterlas->set_coder(coder);
+    if (!laswriterlas->open_memory(header, (format == LAS_TOOLS_FORMAT_LAZ ? LASZIP_COMPRESSOR_CHUNKED : LASZIP_COMPRESSOR_NONE), version, chunk_size))
+    {
+      fprintf(stderr,"ERROR: cannot open laswriterlas to memory\n");
+      delete laswriterlas;
+      return 0;
+    }
+    return laswriterlas;
+  }
+  else if (range_file)
+  {
+    LASwriter* laswriter = 0;
+    if (format == LAS_TOOLS_FORMAT_TXT)
+    {
+      LASwriterTXT* laswritertxt = new LASwriterTXT();
+      if (opts) laswritertxt->set_pts(TRUE);
+      else if (optx) laswritertxt->set_ptx(TRUE);
+      if (laswritertxt->open(range_file, header, parse_string, separator))
+      {
+        if (scale_rgb != 1.0f) laswritertxt->set_scale_rgb(scale_rgb);
+        laswriter = laswritertxt;
+      }
+      else delete laswritertxt;
+    }
+    else if (format == LAS_TOOLS_FORMAT_BIN)
+    {
+      LASwriterBIN* laswriterbin = new LASwriterBIN();
+      if (laswriterbin->open(range_file, header, "ts8")) laswriter = laswriterbin;
+      else delete laswriterbin;
+    }
+    else if (format == LAS_TOOLS_FORMAT_QFIT)
+    {
+      LASwriterQFIT* laswriterqfit = new LASwriterQFIT();
+      if (laswriterqfit->open(range_file, header, 40)) laswriter = laswriterqfit;
+      else delete laswriterqfit;
+    }
+    else if (format == LAS_TOOLS_FORMAT_VRML)
+    {
+      LASwriterWRL* laswriterwrl = new LASwriterWRL();
+      if (laswriterwrl->open(range_file, header, parse_string)) laswriter = laswriterwrl;
+      else delete laswriterwrl;
+    }
+    else
+    {
+      fprintf(stderr,"ERROR: format %d has no rank-range writer\n", format);
+      return 0;
+    }
+    if (laswriter == 0)
+    {
+      fprintf(stderr,"ERROR: cannot open rank-range writer for format %d\n", format);
+    }
+    return laswriter;
+  }
   else if (file_name)
   {
     if (format <= LAS_TOOLS_FORMAT_LAZ)
     {
       LASwriterLAS* laswriterlas = new LASwriterLAS();
-      if (!laswriterlas->open(file_name, header, (format == LAS_TOOLS_FORMAT_LAZ ? LASZIP_COMPRESSOR_CHUNKED : LASZIP_COMPRESSOR_NONE), 2, chunk_size, io_obuffer_size))
+      laswriterlas->set_coder(coder);
+      if (!laswriterlas->open(file_name, header, (format == LAS_TOOLS_FORMAT_LAZ ? LASZIP_COMPRESSOR_CHUNKED : LASZIP_COMPRESSOR_NONE), version, chunk_size, io_obuffer_size))
       {
         fprintf(stderr,"ERROR: cannot open laswriterlas with file name '%s'\n", file_name);
         delete laswriterlas;
@@ -134,7 +197,8 @@ LASwriter* LASwriteOpener::open(const LASheader* header)
     if (format <= LAS_TOOLS_FORMAT_LAZ)
     {
       LASwriterLAS* laswriterlas = new LASwriterLAS();
-      if (!laswriterlas->open(stdout, header, (format == LAS_TOOLS_FORMAT_LAZ ? LASZIP_COMPRESSOR_CHUNKED : LASZIP_COMPRESSOR_NONE), 2, chunk_size))
+      laswriterlas->set_coder(coder);
+      if (!laswriterlas->open(stdout, header, (format == LAS_TOOLS_FORMAT_LAZ ? LASZIP_COMPRESSOR_CHUNKED : LASZIP_COMPRESSOR_NONE), version, chunk_size))
       {
         fprintf(stderr,"ERROR: cannot open laswriterlas to stdout\n");
         delete laswriterlas;
@@ -229,6 +293,8 @@ void LASwriteOpener::usage() const
   fprintf(stderr,"  -odix _classified (specify file name appendix)\n");
   fprintf(stderr,"  -ocut 2 (cut the last two characters from name)\n");
   fprintf(stderr,"  -olas -olaz -otxt -obin -oqfit (specify format)\n");
+  fprintf(stderr,"  -rans (compress LAZ with the faster-decoding rANS coder)\n");
+  fprintf(stderr,"  -profile fast (or default, max, or scanline; trades LAZ decoding speed for size)\n");
   fprintf(stderr,"  -stdout (pipe to stdout)\n");
   fprintf(stderr,"  -nil    (pipe to NULL)\n");
 }
@@ -350,6 +416,25 @@ BOOL LASwriteOpener::parse(int argc, char* argv[])
       set_chunk_size(atoi(argv[i+1]));
       *argv[i]='\0'; *argv[i+1]='\0'; i+=1;
     }
+    else if (strcmp(argv[i],"-profile") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: fast, default, max, or scanline\n", argv[i]);
+        return FALSE;
+      }
+      if (!set_profile(argv[i+1]))
+      {
+        fprintf(stderr,"ERROR: unknown compression profile '%s'. use fast, default, max, or scanline\n", argv[i+1]);
+        return FALSE;
+      }
+      *argv[i]='\0'; *argv[i+1]='\0'; i+=1;
+    }
+    else if (strcmp(argv[i],"-rans") == 0)
+    {
+      set_coder(LASZIP_CODER_RANS);
+      *argv[i]='\0';
+    }
     else if (strcmp(argv[i],"-oparse") == 0)
     {
       if ((i+1) >= argc)
@@ -613,6 +698,36 @@ void LASwriteOpener::set_chunk_size(U32 chunk_size)
   this->chunk_size = chunk_size;
 }
 
+BOOL LASwriteOpener::set_profile(const CHAR* profile)
+{
+  if (strcmp(profile, "fast") == 0)
+  {
+    version = LASZIP_VERSION_FAST;
+  }
+  else if (strcmp(profile, "default") == 0)
+  {
+    version = LASZIP_VERSION_DEFAULT;
+  }
+  else if (strcmp(profile, "max") == 0)
+  {
+    version = LASZIP_VERSION_MAX;
+  }
+  else if (strcmp(profile, "scanline") == 0)
+  {
+    version = LASZIP_VERSION_SCANLINE;
+  }
+  else
+  {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+void LASwriteOpener::set_coder(U16 coder)
+{
+  this->coder = coder;
+}
+
 void LASwriteOpener::make_numbered_file_name(const CHAR* file_name, I32 digits)
 {
   int len;
@@ -943,7 +1058,7 @@ void LASwriteOpener::set_scale_rgb(F32 scale_rgb)
 
 BOOL LASwriteOpener::active() const
 {
-  return (file_name != 0 || use_stdout || use_nil);
+  return (file_name != 0 || use_stdout || use_nil || use_memory);
 }
 
 void LASwriteOpener::add_directory(const CHAR* directory)
@@ -1027,8 +1142,12 @@ LASwriteOpener::LASwriteOpener()
   specified = FALSE;
   force = FALSE;
   chunk_size = LASZIP_CHUNK_SIZE_DEFAULT;
+  coder = LASZIP_CODER_ARITHMETIC;
+  version = LASZIP_VERSION_DEFAULT;
   use_stdout = FALSE;
   use_nil = FALSE;
+  range_file = 0;
+  use_memory = FALSE;
 }
 
 LASwriteOpener::~LASwriteOpener()
@@ -182,7 +182,13 @@ BOOL LASwriterBIN::open(ByteStreamOut* stream, const LASheader* header, const ch
   tsheader.time = (header->point_data_format == 1) || (header->point_data_format == 3) || (header->point_data_format == 4) || (header->point_data_format == 5);
   tsheader.rgb = (header->point_data_format == 2) || (header->point_data_format == 3) || (header->point_data_format == 5);
 
-  return stream->putBytes((U8*)&tsheader, sizeof(TSheader));
+  if (!stream->putBytes((U8*)&tsheader, sizeof(TSheader))) return FALSE;
+
+  // the points start here
+  range_marks[0] = stream->tell();
+  number_range_marks = 1;
+
+  return TRUE;
 }
 
 BOOL LASwriterBIN::write_point(const LASpoint* point)
@@ -253,6 +259,8 @@ I64 LASwriterBIN::close(BOOL update_header)
   
   if (stream)
   {
+    // the points end here
+    if (number_range_marks == 1) range_marks[number_range_marks++] = stream->tell();
     if (update_header && p_count != npoints)
     {
       if (!stream->isSeekable())
@@ -291,6 +299,7 @@ LASwriterBIN::LASwriterBIN()
 {
   stream = 0;
   file = 0;
+  number_range_marks = 0;
 }
 
 LASwriterBIN::~LASwriterBIN()
@@ -33,7 +33,9 @@
 #include "bytestreamout_nil.hpp"
 #include "bytestreamout_file.hpp"
 #include "bytestreamout_ostream.hpp"
+#include "bytestreamout_array.hpp"
 #include "laswritepoint.hpp"
+#include "lastrace.hpp"
 
 #ifdef _WIN32
 #include <fcntl.h>
@@ -123,6 +125,25 @@ BOOL LASwriterLAS::open(ostream& stream, const LASheader* header, U32 compressor
   return open(out, header, compressor, requested_version, chunk_size);
 }
 
+BOOL LASwriterLAS::open_memory(const LASheader* header, U32 compressor, I32 requested_version, I32 chunk_size, I64 alloc)
+{
+  ByteStreamOut* out;
+  if (IS_LITTLE_ENDIAN())
+    out = new ByteStreamOutArrayLE(alloc);
+  else
+    out = new ByteStreamOutArrayBE(alloc);
+
+  if (memory_data)
+  {
+    free(memory_data);
+    memory_data = 0;
+    memory_size = 0;
+  }
+  memory = TRUE;
+
+  return open(out, header, compressor, requested_version, chunk_size);
+}
+
 BOOL LASwriterLAS::open(ByteStreamOut* stream, const LASheader* header, U32 compressor, I32 requested_version, I32 chunk_size)
 {
   U32 i, j;
@@ -180,10 +201,16 @@ BOOL LASwriterLAS::open(ByteStreamOut* stream, const LASheader* header, U32 comp
     laszip = new LASzip();
     laszip->setup(point.num_items, point.items, compressor);
     if (chunk_size > -1) laszip->set_chunk_size((U32)chunk_size);
+    else if (chunk_size == -1) laszip->set_chunk_size(U32_MAX); // variable-sized chunks
     if (compressor == LASZIP_COMPRESSOR_NONE) laszip->request_version(0);
     else if (chunk_size == 0) { fprintf(stderr,"ERROR: adaptive chunking is depricated\n"); return FALSE; }
     else if (requested_version) laszip->request_version(requested_version);
     else laszip->request_version(2);
+    if (compressor && (coder != LASZIP_CODER_ARITHMETIC) && !laszip->request_coder(coder))
+    {
+      fprintf(stderr,"ERROR: %s\n", laszip->get_error());
+      return FALSE;
+    }
     laszip_vlr_data_size = 34 + 6*laszip->num_items;
   }
 
@@ -1208,6 +1235,7 @@ BOOL LASwriterLAS::update_header(const LASheader* header, BOOL use_inventory, BO
 
 I64 LASwriterLAS::close(BOOL update_header)
 {
+  LAStraceScope scope("close writer", "io", p_count);
   I64 bytes = 0;
 
   if (p_count != npoints)
@@ -1271,6 +1299,13 @@ I64 LASwriterLAS::close(BOOL update_header)
       }
     }
     bytes = stream->tell() - header_start_position;
+    if (memory)
+    {
+      // keep the complete file before the stream goes away
+      memory_size = ((ByteStreamOutArray*)stream)->getSize();
+      memory_data = ((ByteStreamOutArray*)stream)->takeData();
+      memory = FALSE;
+    }
     delete stream;
     stream = 0;
   }
@@ -1287,11 +1322,24 @@ I64 LASwriterLAS::close(BOOL update_header)
   return bytes;
 }
 
+U8* LASwriterLAS::take_data(I64* size)
+{
+  U8* data = memory_data;
+  if (size) *size = memory_size;
+  memory_data = 0;
+  memory_size = 0;
+  return data;
+}
+
 LASwriterLAS::LASwriterLAS()
 {
   file = 0;
   stream = 0;
   writer = 0;
+  memory = FALSE;
+  memory_data = 0;
+  memory_size = 0;
+  coder = LASZIP_CODER_ARITHMETIC;
   writing_las_1_4 = FALSE;
   writing_new_point_type = FALSE;
 }
@@ -1299,4 +1347,5 @@ LASwriterLAS::LASwriterLAS()
 LASwriterLAS::~LASwriterLAS()
 {
   if (writer || stream) close();
+  if (memory_data) free(memory_data);
 }
@@ -217,6 +217,10 @@ BOOL LASwriterQFIT::open(ByteStreamOut* stream, const LASheader* header, I32 ver
 
   memset(buffer, 0, 48);
 
+  // the points start here
+  range_marks[0] = stream->tell();
+  number_range_marks = 1;
+
   return TRUE;
 }
 
@@ -275,6 +279,8 @@ I64 LASwriterQFIT::close(BOOL update_header)
   
   if (stream)
   {
+    // the points end here
+    if (number_range_marks == 1) range_marks[number_range_marks++] = stream->tell();
     bytes = stream->tell();
     delete stream;
     stream = 0;
@@ -303,6 +309,7 @@ LASwriterQFIT::LASwriterQFIT()
   pitch_array_offset = -1;
   roll_array_offset = -1;
   pulse_width_array_offset = -1;
+  number_range_marks = 0;
 }
 
 LASwriterQFIT::~LASwriterQFIT()
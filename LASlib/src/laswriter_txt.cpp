@@ -263,7 +263,13 @@ BOOL LASwriterTXT::open(FILE* file, const LASheader* header, const CHAR* parse_s
     }
   }
 
-  return check_parse_string(this->parse_string);
+  if (!check_parse_string(this->parse_string)) return FALSE;
+
+  // the points start here
+  range_marks[0] = (I64)ftell(file);
+  number_range_marks = 1;
+
+  return TRUE;
 }
 
 static void lidardouble2string(CHAR* string, double value)
@@ -504,16 +510,16 @@ BOOL LASwriterTXT::write_point(const LASpoint* point)
       break;
     case 'm': // the index of the point (count starts at 0)
 #ifdef _WIN32
-      fprintf(file, "%I64d", p_count-1);
+      fprintf(file, "%I64d", range_start+p_count-1);
 #else
-      fprintf(file, "%lld", p_count-1);
+      fprintf(file, "%lld", range_start+p_count-1);
 #endif
       break;
     case 'M': // the index of the point (count starts at 1)
 #ifdef _WIN32
-      fprintf(file, "%I64d", p_count);
+      fprintf(file, "%I64d", range_start+p_count);
 #else
-      fprintf(file, "%lld", p_count);
+      fprintf(file, "%lld", range_start+p_count);
 #endif
       break;
     case 'w': // the wavepacket descriptor index
@@ -555,7 +561,10 @@ BOOL LASwriterTXT::update_header(const LASheader* header, BOOL use_inventory, BO
 
 I64 LASwriterTXT::close(BOOL update_header)
 {
-  U32 bytes = (U32)ftell(file);
+  I64 bytes = (I64)ftell(file);
+
+  // the points end here
+  if (number_range_marks == 1) range_marks[number_range_marks++] = bytes;
 
   if (file)
   {
@@ -587,6 +596,8 @@ LASwriterTXT::LASwriterTXT()
   opts = FALSE;
   optx = FALSE;
   scale_rgb = 1.0f;
+  number_range_marks = 0;
+  range_start = 0;
 }
 
 LASwriterTXT::~LASwriterTXT()
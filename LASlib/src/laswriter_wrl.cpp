@@ -123,6 +123,9 @@ BOOL LASwriterWRL::open(FILE* file, const LASheader* header, const CHAR* parse_s
   fprintf(file, "\tgeometry PointSet {\012");
   fprintf(file, "\t\tcoord Coordinate {\012");
   fprintf(file, "\t\t\tpoint [\012");
+  // the coordinates start here
+  range_marks[0] = (I64)ftell(file);
+  number_range_marks = 1;
   return TRUE;
 }
 
@@ -199,16 +202,24 @@ I64 LASwriterWRL::close(BOOL update_header)
   {
     return 0;
   }
+  // the coordinates end here
+  range_marks[1] = (I64)ftell(file);
+  number_range_marks = 2;
   fprintf(file, "\t\t\t]\012");
   fprintf(file, "\t\t}\012");
   if (rgb)
   {
     fprintf(file, "\t\tcolor Color {\012");
     fprintf(file, "\t\t\tcolor [\012");
+    // the colors start here
+    range_marks[2] = (I64)ftell(file);
     for (I32 i = 0; i < p_count; i++)
     {
       fprintf(file, "%.2f %.2f %.2f\012",((1.0f/255.0f)*rgb[3*i]),((1.0f/255.0f)*rgb[3*i+1]),((1.0f/255.0f)*rgb[3*i+2]));
     }
+    // the colors end here
+    range_marks[3] = (I64)ftell(file);
+    number_range_marks = 4;
     fprintf(file, "\t\t\t]\012");
     fprintf(file, "\t\t}\012");
   }
@@ -239,6 +250,7 @@ LASwriterWRL::LASwriterWRL()
   file = 0;
   rgb = 0;
   rgb_alloc = 0;
+  number_range_marks = 0;
 }
 
 LASwriterWRL::~LASwriterWRL()
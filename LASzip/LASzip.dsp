@@ -113,6 +113,26 @@ SOURCE=.\src\arithmeticmodel.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\bytestreamin_uring.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lastrace.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lascounters.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\ransdecoder.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\ransencoder.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\integercompressor.cpp
 # End Source File
 # Begin Source File
@@ -137,6 +157,18 @@ SOURCE=.\src\lasreaditemcompressed_v2.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\lasreaditemcompressed_v3.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lasreaditemcompressed_v4.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lasreaditemcompressed_v5.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\lasreadpoint.cpp
 # End Source File
 # Begin Source File
@@ -149,10 +181,26 @@ SOURCE=.\src\laswriteitemcompressed_v2.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\laswriteitemcompressed_v3.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\laswriteitemcompressed_v4.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\laswriteitemcompressed_v5.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\laswritepoint.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\laswritepointasync.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\laszip.cpp
 # End Source File
 # Begin Source File
@@ -177,6 +225,22 @@ SOURCE=.\src\arithmeticmodel.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\entropydecoder.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\entropyencoder.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\ransdecoder.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\ransencoder.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\bytestreamin.hpp
 # End Source File
 # Begin Source File
@@ -189,6 +253,18 @@ SOURCE=.\src\bytestreamin_file.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\bytestreamin_uring.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lastrace.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lascounters.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\bytestreamin_istream.hpp
 # End Source File
 # Begin Source File
@@ -253,6 +329,18 @@ SOURCE=.\src\lasreaditemcompressed_v2.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\lasreaditemcompressed_v3.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lasreaditemcompressed_v4.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\lasreaditemcompressed_v5.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\lasreaditemraw.hpp
 # End Source File
 # Begin Source File
@@ -273,6 +361,18 @@ SOURCE=.\src\laswriteitemcompressed_v2.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\laswriteitemcompressed_v3.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\laswriteitemcompressed_v4.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\laswriteitemcompressed_v5.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\laswriteitemraw.hpp
 # End Source File
 # Begin Source File
@@ -281,6 +381,10 @@ SOURCE=.\src\laswritepoint.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\laswritepointasync.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\laszip.hpp
 # End Source File
 # Begin Source File
@@ -293,6 +397,10 @@ SOURCE=.\src\laszip_common_v2.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\laszip_common_v5.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\dll\laszip_dll.h
 # End Source File
 # Begin Source File
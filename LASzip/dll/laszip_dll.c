@@ -570,6 +570,27 @@ laszip_request_compatibility_mode
   return 1;
 };
 
+/*---------------------------------------------------------------------------*/
+typedef laszip_I32 (*laszip_request_writer_threads_def)
+(
+    laszip_POINTER                     pointer
+    , const laszip_U32                 threads
+);
+laszip_request_writer_threads_def laszip_request_writer_threads_ptr = 0;
+LASZIP_API laszip_I32
+laszip_request_writer_threads
+(
+    laszip_POINTER                     pointer
+    , const laszip_U32                 threads
+)
+{
+  if (laszip_request_writer_threads_ptr)
+  {
+    return (*laszip_request_writer_threads_ptr)(pointer, threads);
+  }
+  return 1;
+};
+
 /*---------------------------------------------------------------------------*/
 typedef laszip_I32 (*laszip_open_writer_def)
 (
@@ -593,6 +614,50 @@ laszip_open_writer
   return 1;
 };
 
+/*---------------------------------------------------------------------------*/
+typedef laszip_I32 (*laszip_open_writer_array_def)
+(
+    laszip_POINTER                     pointer
+    , laszip_BOOL                      compress
+);
+laszip_open_writer_array_def laszip_open_writer_array_ptr = 0;
+LASZIP_API laszip_I32
+laszip_open_writer_array
+(
+    laszip_POINTER                     pointer
+    , laszip_BOOL                      compress
+)
+{
+  if (laszip_open_writer_array_ptr)
+  {
+    return (*laszip_open_writer_array_ptr)(pointer, compress);
+  }
+  return 1;
+};
+
+/*---------------------------------------------------------------------------*/
+typedef laszip_I32 (*laszip_get_writer_array_def)
+(
+    laszip_POINTER                     pointer
+    , laszip_U8**                      data
+    , laszip_I64*                      size
+);
+laszip_get_writer_array_def laszip_get_writer_array_ptr = 0;
+LASZIP_API laszip_I32
+laszip_get_writer_array
+(
+    laszip_POINTER                     pointer
+    , laszip_U8**                      data
+    , laszip_I64*                      size
+)
+{
+  if (laszip_get_writer_array_ptr)
+  {
+    return (*laszip_get_writer_array_ptr)(pointer, data, size);
+  }
+  return 1;
+};
+
 /*---------------------------------------------------------------------------*/
 typedef laszip_I32 (*laszip_write_point_def)
 (
@@ -713,6 +778,31 @@ laszip_open_reader
   return 1;
 };
 
+/*---------------------------------------------------------------------------*/
+typedef laszip_I32 (*laszip_open_reader_array_def)
+(
+    laszip_POINTER                     pointer
+    , const laszip_U8*                 data
+    , laszip_I64                       size
+    , laszip_BOOL*                     is_compressed
+);
+laszip_open_reader_array_def laszip_open_reader_array_ptr = 0;
+LASZIP_API laszip_I32
+laszip_open_reader_array
+(
+    laszip_POINTER                     pointer
+    , const laszip_U8*                 data
+    , laszip_I64                       size
+    , laszip_BOOL*                     is_compressed
+)
+{
+  if (laszip_open_reader_array_ptr)
+  {
+    return (*laszip_open_reader_array_ptr)(pointer, data, size, is_compressed);
+  }
+  return 1;
+};
+
 /*---------------------------------------------------------------------------*/
 typedef laszip_I32 (*laszip_has_spatial_index_def)
 (
@@ -981,11 +1071,26 @@ laszip_I32 laszip_load_dll()
      FreeLibrary(laszip_HINSTANCE);
      return 1;
   }
+  laszip_request_writer_threads_ptr = (laszip_request_writer_threads_def)GetProcAddress(laszip_HINSTANCE, "laszip_request_writer_threads");
+  if (laszip_request_writer_threads_ptr == NULL) {
+     FreeLibrary(laszip_HINSTANCE);
+     return 1;
+  }
   laszip_open_writer_ptr = (laszip_open_writer_def)GetProcAddress(laszip_HINSTANCE, "laszip_open_writer");
   if (laszip_open_writer_ptr == NULL) {
      FreeLibrary(laszip_HINSTANCE);
      return 1;
   }
+  laszip_open_writer_array_ptr = (laszip_open_writer_array_def)GetProcAddress(laszip_HINSTANCE, "laszip_open_writer_array");
+  if (laszip_open_writer_array_ptr == NULL) {
+     FreeLibrary(laszip_HINSTANCE);
+     return 1;
+  }
+  laszip_get_writer_array_ptr = (laszip_get_writer_array_def)GetProcAddress(laszip_HINSTANCE, "laszip_get_writer_array");
+  if (laszip_get_writer_array_ptr == NULL) {
+     FreeLibrary(laszip_HINSTANCE);
+     return 1;
+  }
   laszip_write_point_ptr = (laszip_write_point_def)GetProcAddress(laszip_HINSTANCE, "laszip_write_point");
   if (laszip_write_point_ptr == NULL) {
      FreeLibrary(laszip_HINSTANCE);
@@ -1016,6 +1121,11 @@ laszip_I32 laszip_load_dll()
      FreeLibrary(laszip_HINSTANCE);
      return 1;
   }
+  laszip_open_reader_array_ptr = (laszip_open_reader_array_def)GetProcAddress(laszip_HINSTANCE, "laszip_open_reader_array");
+  if (laszip_open_reader_array_ptr == NULL) {
+     FreeLibrary(laszip_HINSTANCE);
+     return 1;
+  }
   laszip_has_spatial_index_ptr = (laszip_has_spatial_index_def)GetProcAddress(laszip_HINSTANCE, "laszip_has_spatial_index");
   if (laszip_has_spatial_index_ptr == NULL) {
      FreeLibrary(laszip_HINSTANCE);
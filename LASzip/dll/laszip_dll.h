@@ -24,6 +24,8 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- laszip_request_writer_threads() compresses chunks with worker threads
+    18 October 2026 -- laszip_open_writer_array() and laszip_open_reader_array() for LAZ in memory
     23 September 2015 -- correct update of bounding box and counters from inventory on closing
     22 September 2015 -- bug fix for not overwriting description of pre-existing "extra bytes"
     5 September 2015 -- "LAS 1.4 compatibility mode" now allows pre-existing "extra bytes"
@@ -380,6 +382,15 @@ laszip_request_compatibility_mode(
     , const laszip_BOOL                request
 );
 
+/*---------------------------------------------------------------------------*/
+/* before laszip_open_writer(). with 'threads' > 0 laszip_write_point() only  */
+/* copies the point and that many threads compress the chunks. 0 is default */
+LASZIP_API laszip_I32
+laszip_request_writer_threads(
+    laszip_POINTER                     pointer
+    , const laszip_U32                 threads
+);
+
 /*---------------------------------------------------------------------------*/
 LASZIP_API laszip_I32
 laszip_open_writer(
@@ -388,6 +399,23 @@ laszip_open_writer(
     , laszip_BOOL                      compress
 );
 
+/*---------------------------------------------------------------------------*/
+LASZIP_API laszip_I32
+laszip_open_writer_array(
+    laszip_POINTER                     pointer
+    , laszip_BOOL                      compress
+);
+
+/*---------------------------------------------------------------------------*/
+/* after laszip_close_writer() for laszip_open_writer_array(). the data stays */
+/* owned by LASzip and is valid until the next writer is opened or cleaned   */
+LASZIP_API laszip_I32
+laszip_get_writer_array(
+    laszip_POINTER                     pointer
+    , laszip_U8**                      data
+    , laszip_I64*                      size
+);
+
 /*---------------------------------------------------------------------------*/
 LASZIP_API laszip_I32
 laszip_write_point(
@@ -427,6 +455,16 @@ laszip_open_reader(
     , laszip_BOOL*                     is_compressed
 );
 
+/*---------------------------------------------------------------------------*/
+/* reads the data in place. it must stay valid until laszip_close_reader()   */
+LASZIP_API laszip_I32
+laszip_open_reader_array(
+    laszip_POINTER                     pointer
+    , const laszip_U8*                 data
+    , laszip_I64                       size
+    , laszip_BOOL*                     is_compressed
+);
+
 /*---------------------------------------------------------------------------*/
 LASZIP_API laszip_I32
 laszip_has_spatial_index(
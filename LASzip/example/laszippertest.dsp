@@ -107,6 +107,14 @@ SOURCE=..\src\arithmeticmodel.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\src\ransdecoder.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\ransencoder.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\src\integercompressor.cpp
 # End Source File
 # Begin Source File
@@ -119,6 +127,18 @@ SOURCE=..\src\lasreaditemcompressed_v2.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\src\lasreaditemcompressed_v3.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\lasreaditemcompressed_v4.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\lasreaditemcompressed_v5.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\src\lasreadpoint.cpp
 # End Source File
 # Begin Source File
@@ -135,6 +155,18 @@ SOURCE=..\src\laswriteitemcompressed_v2.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\src\laswriteitemcompressed_v3.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\laswriteitemcompressed_v4.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\laswriteitemcompressed_v5.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\src\laswritepoint.cpp
 # End Source File
 # Begin Source File
@@ -167,6 +199,22 @@ SOURCE=..\src\arithmeticmodel.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\src\entropydecoder.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\entropyencoder.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\ransdecoder.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\ransencoder.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\src\bytestreamin.hpp
 # End Source File
 # Begin Source File
@@ -219,6 +267,18 @@ SOURCE=..\src\lasreaditemcompressed_v2.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\src\lasreaditemcompressed_v3.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\lasreaditemcompressed_v4.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\lasreaditemcompressed_v5.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\src\lasreaditemraw.hpp
 # End Source File
 # Begin Source File
@@ -243,6 +303,18 @@ SOURCE=..\src\laswriteitemcompressed_v2.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\src\laswriteitemcompressed_v3.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\laswriteitemcompressed_v4.hpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\src\laswriteitemcompressed_v5.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\src\laswriteitemraw.hpp
 # End Source File
 # Begin Source File
@@ -259,6 +331,10 @@ SOURCE=..\src\laszip_common_v2.hpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\src\laszip_common_v5.hpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\src\laszipper.hpp
 # End Source File
 # Begin Source File
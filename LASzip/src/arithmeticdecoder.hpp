@@ -25,6 +25,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- final class inheriting again from EntropyDecoder for rANS
     13 November 2014 -- integrity check in readBits(), readByte(), readShort()
      6 September 2014 -- removed the (unused) inheritance from EntropyDecoder
     10 January 2011 -- licensing change for LGPL release and liblas integration
@@ -37,12 +38,12 @@
 #define ARITHMETIC_DECODER_HPP
 
 #include "mydefs.hpp"
-#include "bytestreamin.hpp"
+#include "entropydecoder.hpp"
 
 class ArithmeticModel;
 class ArithmeticBitModel;
 
-class ArithmeticDecoder
+class ArithmeticDecoder final : public EntropyDecoder
 {
 public:
 
@@ -25,6 +25,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- final class inheriting again from EntropyEncoder for rANS
      6 September 2014 -- removed the (unused) inheritance from EntropyEncoder
     10 January 2011 -- licensing change for LGPL release and liblas integration
      8 December 2010 -- unified framework for all entropy coders
@@ -36,12 +37,12 @@
 #define ARITHMETIC_ENCODER_HPP
 
 #include "mydefs.hpp"
-#include "bytestreamout.hpp"
+#include "entropyencoder.hpp"
 
 class ArithmeticModel;
 class ArithmeticBitModel;
 
-class ArithmeticEncoder
+class ArithmeticEncoder final : public EntropyEncoder
 {
 public:
 
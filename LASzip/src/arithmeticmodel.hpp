@@ -25,6 +25,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- models are shared with the RANSEncoder and RANSDecoder
     10 January 2011 -- licensing change for LGPL release and liblas integration
     8 December 2010 -- unified framework for all entropy coders
     30 October 2009 -- refactoring Amir Said's FastAC code
@@ -54,6 +55,11 @@ const U32 BM__MaxCount    = 1 << BM__LengthShift;  // for adaptive models
 const U32 DM__LengthShift = 15;     // length bits discarded before mult.
 const U32 DM__MaxCount    = 1 << DM__LengthShift;  // for adaptive models
 
+                       // rANS coder: probabilities come from the same models
+const U32 RANS__Low       = 1 << 16;   // lower bound of the coder states
+const U32 RANS__States    = 2;         // interleaved states (a power of 2)
+const U32 RANS__Buffer    = 4096;      // initial number of buffered symbols
+
 class ArithmeticModel
 {
 public:
@@ -70,6 +76,8 @@ private:
   BOOL compress;
   friend class ArithmeticEncoder;
   friend class ArithmeticDecoder;
+  friend class RANSEncoder;
+  friend class RANSDecoder;
 };
 
 class ArithmeticBitModel
@@ -86,6 +94,8 @@ private:
   U32 bit_0_prob, bit_0_count, bit_count;
   friend class ArithmeticEncoder;
   friend class ArithmeticDecoder;
+  friend class RANSEncoder;
+  friend class RANSDecoder;
 };
 
 #endif
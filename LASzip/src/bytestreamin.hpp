@@ -24,6 +24,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- prefetch() announces byte ranges that will be read soon
      2 January 2013 -- new functions for reading a stream of groups of bits  
      1 October 2011 -- added 64 bit file support in MSVC 6.0 at McCafe at Hbf Linz
     10 January 2011 -- licensing change for LGPL release and liblas integration
@@ -78,6 +79,8 @@ public:
   virtual BOOL seek(const I64 position) = 0;
 /* seek to the end of the file                               */
   virtual BOOL seekEnd(const I64 distance=0) = 0;
+/* ranges [starts[i], ends[i]) will be read in this order     */
+  virtual BOOL prefetch(const U32 number, const I64* starts, const I64* ends) { return FALSE; };
 /* constructor                                               */
   inline ByteStreamIn() { bit_buffer = 0; num_buffer = 0; };
 /* destructor                                                */
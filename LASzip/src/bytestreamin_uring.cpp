@@ -0,0 +1,532 @@
+/*
+===============================================================================
+
+  FILE:  bytestreamin_uring.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+
+#include "bytestreamin_uring.hpp"
+#include "lastrace.hpp"
+
+#if defined(__linux__)
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+// larger ranges are split into reads of this size
+#define BYTE_STREAM_IN_URING_PIECE (1 << 20)
+
+static int io_uring_setup(unsigned entries, struct io_uring_params* p)
+{
+  return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int io_uring_enter(int ring, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+  return (int)syscall(__NR_io_uring_enter, ring, to_submit, min_complete, flags, 0, 0);
+}
+
+ByteStreamInFileUring::ByteStreamInFileUring(FILE* file) : ByteStreamInFileLE(file)
+{
+  ring = -1;
+  sq_map = cq_map = sqes = 0;
+  number_ranges = 0;
+  range_starts = range_ends = 0;
+  next_range = first_range = 0;
+  for (U32 i = 0; i < BYTE_STREAM_IN_URING_DEPTH; i++)
+  {
+    slots[i].buffer = 0;
+    slots[i].alloced = 0;
+    slots[i].range = U32_MAX;
+    slots[i].result = 0;
+    slots[i].done = TRUE;
+    slots[i].iovec = 0;
+  }
+  active = 0;
+  current = end = 0;
+  active_start = 0;
+}
+
+ByteStreamInFileUring::~ByteStreamInFileUring()
+{
+  U32 i;
+  if (ring >= 0)
+  {
+    // the kernel may still write into buffers of reads in flight
+    for (i = 0; i < BYTE_STREAM_IN_URING_DEPTH; i++)
+    {
+      if (!slots[i].done && !wait(&slots[i]))
+      {
+        teardown();
+        break;
+      }
+    }
+    if (ring >= 0)
+    {
+      munmap(sqes, (size_t)sqes_size);
+      if (cq_map != sq_map) munmap(cq_map, (size_t)cq_map_size);
+      munmap(sq_map, (size_t)sq_map_size);
+      close(ring);
+    }
+  }
+  for (i = 0; i < BYTE_STREAM_IN_URING_DEPTH; i++)
+  {
+    if (slots[i].buffer) free(slots[i].buffer);
+    if (slots[i].iovec) free(slots[i].iovec);
+  }
+  if (range_starts) free(range_starts);
+  if (range_ends) free(range_ends);
+}
+
+BOOL ByteStreamInFileUring::setup()
+{
+  U32 i;
+  for (i = 0; i < BYTE_STREAM_IN_URING_DEPTH; i++)
+  {
+    if (slots[i].iovec == 0) slots[i].iovec = malloc(sizeof(struct iovec));
+    if (slots[i].iovec == 0) return FALSE;
+  }
+
+  struct io_uring_params p;
+  memset(&p, 0, sizeof(p));
+  ring = io_uring_setup(BYTE_STREAM_IN_URING_DEPTH, &p);
+  if (ring < 0)
+  {
+    ring = -1;
+    return FALSE;
+  }
+
+  sq_map_size = p.sq_off.array + p.sq_entries*sizeof(U32);
+  cq_map_size = p.cq_off.cqes + p.cq_entries*sizeof(struct io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    if (cq_map_size > sq_map_size) sq_map_size = cq_map_size;
+    cq_map_size = sq_map_size;
+  }
+  sq_map = mmap(0, (size_t)sq_map_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+  if (sq_map == MAP_FAILED)
+  {
+    close(ring);
+    ring = -1;
+    return FALSE;
+  }
+  if (p.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    cq_map = sq_map;
+  }
+  else
+  {
+    cq_map = mmap(0, (size_t)cq_map_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+    if (cq_map == MAP_FAILED)
+    {
+      munmap(sq_map, (size_t)sq_map_size);
+      close(ring);
+      ring = -1;
+      return FALSE;
+    }
+  }
+  sqes_size = p.sq_entries*sizeof(struct io_uring_sqe);
+  sqes = mmap(0, (size_t)sqes_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, ring, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED)
+  {
+    if (cq_map != sq_map) munmap(cq_map, (size_t)cq_map_size);
+    munmap(sq_map, (size_t)sq_map_size);
+    close(ring);
+    ring = -1;
+    return FALSE;
+  }
+
+  sq_head = (U32*)((U8*)sq_map + p.sq_off.head);
+  sq_tail = (U32*)((U8*)sq_map + p.sq_off.tail);
+  sq_mask = (U32*)((U8*)sq_map + p.sq_off.ring_mask);
+  sq_array = (U32*)((U8*)sq_map + p.sq_off.array);
+  cq_head = (U32*)((U8*)cq_map + p.cq_off.head);
+  cq_tail = (U32*)((U8*)cq_map + p.cq_off.tail);
+  cq_mask = (U32*)((U8*)cq_map + p.cq_off.ring_mask);
+  cqes = (U8*)cq_map + p.cq_off.cqes;
+  return TRUE;
+}
+
+// waiting for a read failed, so reads may still be in flight. their buffers
+// are left to the kernel and never reused or freed, the ring is closed, and
+// the stream reads from the FILE* from now on
+
+void ByteStreamInFileUring::teardown()
+{
+  U32 i;
+  for (i = 0; i < BYTE_STREAM_IN_URING_DEPTH; i++)
+  {
+    if (!slots[i].done)
+    {
+      slots[i].buffer = 0;
+      slots[i].alloced = 0;
+      slots[i].iovec = 0;
+      slots[i].done = TRUE;
+    }
+    slots[i].range = U32_MAX;
+  }
+  munmap(sqes, (size_t)sqes_size);
+  if (cq_map != sq_map) munmap(cq_map, (size_t)cq_map_size);
+  munmap(sq_map, (size_t)sq_map_size);
+  close(ring);
+  ring = -1;
+  sq_map = MAP_FAILED;
+  if (range_starts) free(range_starts);
+  if (range_ends) free(range_ends);
+  range_starts = range_ends = 0;
+  number_ranges = next_range = first_range = 0;
+  active = 0;
+  current = end = 0;
+}
+
+BOOL ByteStreamInFileUring::prefetch(const U32 number, const I64* starts, const I64* ends)
+{
+  U32 i;
+
+  if (ring < 0)
+  {
+    if (sq_map) return FALSE; // setup() failed before
+    if (!setup())
+    {
+      sq_map = MAP_FAILED;
+      return FALSE;
+    }
+  }
+
+  // forget earlier ranges
+  I64 position = tell();
+  active = 0;
+  current = end = 0;
+  for (i = 0; i < BYTE_STREAM_IN_URING_DEPTH; i++)
+  {
+    if (slots[i].range != U32_MAX) release(&slots[i]);
+  }
+  ByteStreamInFile::seek(position);
+  if (ring < 0) return FALSE; // torn down by release()
+
+  if (range_starts) free(range_starts);
+  if (range_ends) free(range_ends);
+  range_starts = range_ends = 0;
+  number_ranges = next_range = first_range = 0;
+  I64 pieces = 0;
+  for (i = 0; i < number; i++)
+  {
+    if (starts[i] < ends[i]) pieces += (ends[i] - starts[i] + BYTE_STREAM_IN_URING_PIECE - 1) / BYTE_STREAM_IN_URING_PIECE;
+  }
+  if (pieces == 0 || pieces >= U32_MAX) return FALSE;
+  range_starts = (I64*)malloc(sizeof(I64)*pieces);
+  range_ends = (I64*)malloc(sizeof(I64)*pieces);
+  if ((range_starts == 0) || (range_ends == 0)) return FALSE;
+  for (i = 0; i < number; i++)
+  {
+    I64 start = starts[i];
+    while (start < ends[i])
+    {
+      range_starts[number_ranges] = start;
+      start = (ends[i] - start > BYTE_STREAM_IN_URING_PIECE ? start + BYTE_STREAM_IN_URING_PIECE : ends[i]);
+      range_ends[number_ranges] = start;
+      number_ranges++;
+    }
+  }
+
+  submit();
+  activate(position);
+  return TRUE;
+}
+
+BOOL ByteStreamInFileUring::submit()
+{
+  if ((ring < 0) || (next_range >= number_ranges)) return TRUE;
+  U32 i, tail, index, count = 0;
+  tail = *sq_tail;
+  for (i = 0; (i < BYTE_STREAM_IN_URING_DEPTH) && (next_range < number_ranges); i++)
+  {
+    Slot* slot = &slots[i];
+    if (slot->range != U32_MAX) continue;
+    U32 size = (U32)(range_ends[next_range] - range_starts[next_range]);
+    if (slot->alloced < size)
+    {
+      U8* buffer = (U8*)realloc(slot->buffer, size);
+      if (buffer == 0) break;
+      slot->buffer = buffer;
+      slot->alloced = size;
+    }
+    struct iovec* iov = (struct iovec*)slot->iovec;
+    iov->iov_base = slot->buffer;
+    iov->iov_len = size;
+    index = tail & *sq_mask;
+    struct io_uring_sqe* sqe = &(((struct io_uring_sqe*)sqes)[index]);
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = fileno(file);
+    sqe->addr = (U64)(size_t)iov;
+    sqe->len = 1;
+    sqe->off = (U64)range_starts[next_range];
+    sqe->user_data = i;
+    sq_array[index] = index;
+    tail++;
+    slot->range = next_range++;
+    slot->result = 0;
+    slot->done = FALSE;
+    count++;
+  }
+  if (count == 0) return TRUE;
+  __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+  int submitted;
+  do
+  {
+    submitted = io_uring_enter(ring, count, 0, 0);
+  } while ((submitted < 0) && ((errno == EINTR) || (errno == EAGAIN)));
+  if (submitted < 0)
+  {
+    // the reads were not submitted. stop prefetching and let fill() read them with pread()
+    for (i = 0; i < BYTE_STREAM_IN_URING_DEPTH; i++)
+    {
+      if ((slots[i].range != U32_MAX) && !slots[i].done)
+      {
+        slots[i].result = -1;
+        slots[i].done = TRUE;
+      }
+    }
+    number_ranges = next_range;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+void ByteStreamInFileUring::reap()
+{
+  U32 head = *cq_head;
+  U32 tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+  while (head != tail)
+  {
+    struct io_uring_cqe* cqe = &(((struct io_uring_cqe*)cqes)[head & *cq_mask]);
+    Slot* slot = &slots[cqe->user_data];
+    slot->result = cqe->res;
+    slot->done = TRUE;
+    head++;
+  }
+  __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+}
+
+BOOL ByteStreamInFileUring::wait(Slot* slot)
+{
+  if (slot->done) return TRUE;
+  LAStraceScope scope("wait for read", "io", slot->range);
+  while (!slot->done)
+  {
+    reap();
+    if (slot->done) break;
+    if ((io_uring_enter(ring, 0, 1, IORING_ENTER_GETEVENTS) < 0) && (errno != EINTR))
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+BOOL ByteStreamInFileUring::fill(Slot* slot)
+{
+  // complete short or failed reads synchronously
+  U32 size = (U32)(range_ends[slot->range] - range_starts[slot->range]);
+  U32 got = (slot->result > 0 ? (U32)slot->result : 0);
+  while (got < size)
+  {
+    ssize_t r = pread(fileno(file), slot->buffer + got, size - got, (off_t)(range_starts[slot->range] + got));
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return FALSE;
+    got += (U32)r;
+  }
+  slot->result = (I32)got;
+  return TRUE;
+}
+
+void ByteStreamInFileUring::release(Slot* slot)
+{
+  if (!slot->done && !wait(slot))
+  {
+    // the slot cannot be reused while its read may be in flight
+    teardown();
+    return;
+  }
+  slot->range = U32_MAX;
+  if (slot == active)
+  {
+    active = 0;
+    current = end = 0;
+  }
+}
+
+ByteStreamInFileUring::Slot* ByteStreamInFileUring::find(U32 range)
+{
+  for (U32 i = 0; i < BYTE_STREAM_IN_URING_DEPTH; i++)
+  {
+    if (slots[i].range == range) return &slots[i];
+  }
+  return 0;
+}
+
+BOOL ByteStreamInFileUring::activate(const I64 position)
+{
+  if (first_range >= number_ranges) return FALSE;
+  while (first_range < number_ranges)
+  {
+    if (position < range_starts[first_range])
+    {
+      // not in a range
+      break;
+    }
+    Slot* slot = find(first_range);
+    if (position >= range_ends[first_range])
+    {
+      // this range was skipped
+      if (slot) release(slot);
+      first_range++;
+      continue;
+    }
+    if (slot == 0)
+    {
+      // skipped ranges were never submitted
+      next_range = first_range;
+      submit();
+      slot = find(first_range);
+      if (slot == 0) break;
+    }
+    first_range++;
+    if (!wait(slot))
+    {
+      teardown();
+      return FALSE;
+    }
+    if (!fill(slot))
+    {
+      release(slot);
+      submit();
+      return FALSE;
+    }
+    active = slot;
+    active_start = range_starts[slot->range];
+    current = slot->buffer + (position - active_start);
+    end = slot->buffer + slot->result;
+    submit();
+    return TRUE;
+  }
+  submit();
+  return FALSE;
+}
+
+U32 ByteStreamInFileUring::getByte()
+{
+  if (current < end)
+  {
+    return *current++;
+  }
+  if (active)
+  {
+    I64 position = active_start + (end - active->buffer);
+    release(active);
+    if (activate(position)) return *current++;
+    ByteStreamInFile::seek(position);
+  }
+  return ByteStreamInFile::getByte();
+}
+
+void ByteStreamInFileUring::getBytes(U8* bytes, const U32 num_bytes)
+{
+  U32 remaining = num_bytes;
+  while (remaining)
+  {
+    U32 available = (U32)(end - current);
+    if (available >= remaining)
+    {
+      memcpy(bytes, current, remaining);
+      current += remaining;
+      return;
+    }
+    if (available)
+    {
+      memcpy(bytes, current, available);
+      current += available;
+      bytes += available;
+      remaining -= available;
+    }
+    if (active == 0) break;
+    I64 position = active_start + (end - active->buffer);
+    release(active);
+    if (!activate(position))
+    {
+      ByteStreamInFile::seek(position);
+      break;
+    }
+  }
+  ByteStreamInFile::getBytes(bytes, remaining);
+}
+
+I64 ByteStreamInFileUring::tell() const
+{
+  if (active)
+  {
+    return active_start + (current - active->buffer);
+  }
+  return ByteStreamInFile::tell();
+}
+
+BOOL ByteStreamInFileUring::seek(const I64 position)
+{
+  if (active)
+  {
+    if ((active_start <= position) && (position < active_start + (end - active->buffer)))
+    {
+      current = active->buffer + (position - active_start);
+      return TRUE;
+    }
+    release(active);
+  }
+  if (activate(position))
+  {
+    return TRUE;
+  }
+  return ByteStreamInFile::seek(position);
+}
+
+BOOL ByteStreamInFileUring::seekEnd(const I64 distance)
+{
+  if (active)
+  {
+    release(active);
+    submit();
+  }
+  return ByteStreamInFile::seekEnd(distance);
+}
+
+#endif
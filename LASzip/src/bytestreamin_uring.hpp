@@ -0,0 +1,127 @@
+/*
+===============================================================================
+
+  FILE:  bytestreamin_uring.hpp
+
+  CONTENTS:
+
+    Class for FILE*-based little-endian input streams that read the byte
+    ranges announced with prefetch() ahead of time with Linux io_uring.
+
+    The ranges (e.g. the chunks of the intervals of a spatial index query or
+    the point range of one process) are submitted as a batch with up to
+    BYTE_STREAM_IN_URING_DEPTH reads in flight. Ranges larger than a
+    megabyte are read in pieces so that one long range is also read ahead
+    while it is decoded. When the stream seeks into or reads on into a range
+    it waits only for that range and serves it from memory. The ranges must
+    be used in the order given. Ranges that are skipped are dropped, and
+    reads outside of the ranges, seeks back, or failed reads fall back to
+    the FILE* like ByteStreamInFileLE.
+
+    The ring is only created by the first prefetch() so that the stream is
+    as cheap as ByteStreamInFileLE when nothing is prefetched. When io_uring
+    is not available prefetch() returns FALSE and nothing changes. Outside
+    of Linux the class is not defined.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- falls back to the FILE* when waiting for a read fails
+    18 October 2026 -- waits for reads are recorded with LAStrace
+    18 October 2026 -- created for batched reads of scattered chunks
+
+===============================================================================
+*/
+#ifndef BYTE_STREAM_IN_URING_H
+#define BYTE_STREAM_IN_URING_H
+
+#if defined(__linux__)
+
+#include "bytestreamin_file.hpp"
+
+#define BYTE_STREAM_IN_URING_DEPTH 32
+
+class ByteStreamInFileUring : public ByteStreamInFileLE
+{
+public:
+  ByteStreamInFileUring(FILE* file);
+/* read these byte ranges [starts[i], ends[i]) ahead         */
+  BOOL prefetch(const U32 number, const I64* starts, const I64* ends);
+/* read a single byte                                        */
+  U32 getByte();
+/* read an array of bytes                                    */
+  void getBytes(U8* bytes, const U32 num_bytes);
+/* get current position of stream                            */
+  I64 tell() const;
+/* seek to this position in the stream                       */
+  BOOL seek(const I64 position);
+/* seek to the end of the file                               */
+  BOOL seekEnd(const I64 distance=0);
+/* destructor                                                */
+  ~ByteStreamInFileUring();
+private:
+  struct Slot
+  {
+    U8* buffer;
+    U32 alloced;
+    U32 range;
+    I32 result;
+    BOOL done;
+    void* iovec;
+  };
+  BOOL setup();
+  void teardown();
+  BOOL submit();
+  BOOL wait(Slot* slot);
+  BOOL fill(Slot* slot);
+  void reap();
+  void release(Slot* slot);
+  BOOL activate(const I64 position);
+  Slot* find(U32 range);
+
+  int ring;
+  U32* sq_head;
+  U32* sq_tail;
+  U32* sq_mask;
+  U32* sq_array;
+  U32* cq_head;
+  U32* cq_tail;
+  U32* cq_mask;
+  void* sqes;
+  void* cqes;
+  void* sq_map;
+  void* cq_map;
+  U64 sq_map_size;
+  U64 cq_map_size;
+  U64 sqes_size;
+
+  U32 number_ranges;
+  I64* range_starts;
+  I64* range_ends;
+  U32 next_range;   // first range that is not yet submitted
+  U32 first_range;  // first range that was neither used nor dropped
+  Slot slots[BYTE_STREAM_IN_URING_DEPTH];
+
+  Slot* active;
+  U8* current;
+  U8* end;
+  I64 active_start;
+};
+
+#endif
+
+#endif
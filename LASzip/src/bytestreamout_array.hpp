@@ -22,6 +22,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- honor the initial allocation and grow geometrically
     19 July 2015 -- moved from LASlib to LASzip for "compatibility mode" in DLL
      9 April 2012 -- created after cooking Zuccini/Onion/Potatoe dinner for Mara
   
@@ -103,8 +104,8 @@ private:
 
 inline ByteStreamOutArray::ByteStreamOutArray(I64 alloc)
 {
-  this->data = (U8*)malloc((U32)alloc);
-  this->alloc = 1024;
+  this->data = (U8*)malloc((size_t)alloc);
+  this->alloc = (this->data ? alloc : 0);
   this->size = 0;
   this->curr = 0;
 }
@@ -113,8 +114,8 @@ inline BOOL ByteStreamOutArray::putByte(U8 byte)
 {
   if (curr == alloc)
   {
-    alloc += 1024;
-    data = (U8*)realloc(data, (U32)alloc);
+    alloc += (alloc > 1024 ? alloc : 1024);
+    data = (U8*)realloc(data, (size_t)alloc);
     if (data == 0)
     {
       return FALSE;
@@ -130,8 +131,10 @@ inline BOOL ByteStreamOutArray::putBytes(const U8* bytes, U32 num_bytes)
 {
   if ((curr+num_bytes) > alloc)
   {
-    alloc += (1024+num_bytes);
-    data = (U8*)realloc(data, (U32)alloc);
+    // grow geometrically so that writing large files stays linear
+    alloc += (alloc > 1024 ? alloc : 1024);
+    if ((curr+num_bytes) > alloc) alloc = curr+num_bytes+1024;
+    data = (U8*)realloc(data, (size_t)alloc);
     if (data == 0)
     {
       return FALSE;
@@ -0,0 +1,98 @@
+/*
+===============================================================================
+
+  FILE:  entropydecoder.hpp
+
+  CONTENTS:
+
+    Abstract base class for the entropy decoders. LASreadPoint starts and ends
+    chunks through this interface. The item decompressors are templates of
+    the final decoder classes, so that coding a symbol is a direct call. A
+    new LASZIP_CODER is added by implementing this interface and adding
+    its class to the instantiations of the items.
+
+  PROGRAMMERS:
+
+    martin.isenburg@rapidlasso.com  -  http://rapidlasso.com
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- brought back to add the rANS coder next to arithmetic
+    10 January 2011 -- licensing change for LGPL release and liblas integration
+     8 December 2010 -- unified framework for all entropy coders
+
+===============================================================================
+*/
+#ifndef ENTROPY_DECODER_HPP
+#define ENTROPY_DECODER_HPP
+
+#include "mydefs.hpp"
+#include "bytestreamin.hpp"
+
+class ArithmeticModel;
+class ArithmeticBitModel;
+
+class EntropyDecoder
+{
+public:
+
+/* Manage decoding                                           */
+  virtual BOOL init(ByteStreamIn* instream) = 0;
+  virtual void done() = 0;
+
+/* Manage an entropy model for a single bit                  */
+  virtual ArithmeticBitModel* createBitModel() = 0;
+  virtual void initBitModel(ArithmeticBitModel* model) = 0;
+  virtual void destroyBitModel(ArithmeticBitModel* model) = 0;
+
+/* Manage an entropy model for n symbols (table optional)    */
+  virtual ArithmeticModel* createSymbolModel(U32 n) = 0;
+  virtual void initSymbolModel(ArithmeticModel* model, U32* table=0) = 0;
+  virtual void destroySymbolModel(ArithmeticModel* model) = 0;
+
+/* Decode a bit with modelling                               */
+  virtual U32 decodeBit(ArithmeticBitModel* model) = 0;
+
+/* Decode a symbol with modelling                            */
+  virtual U32 decodeSymbol(ArithmeticModel* model) = 0;
+
+/* Decode a bit without modelling                            */
+  virtual U32 readBit() = 0;
+
+/* Decode bits without modelling                             */
+  virtual U32 readBits(U32 bits) = 0;
+
+/* Decode an unsigned char without modelling                 */
+  virtual U8 readByte() = 0;
+
+/* Decode an unsigned short without modelling                */
+  virtual U16 readShort() = 0;
+
+/* Decode an unsigned int without modelling                  */
+  virtual U32 readInt() = 0;
+
+/* Decode a float without modelling                          */
+  virtual F32 readFloat() = 0;
+
+/* Decode an unsigned 64 bit int without modelling           */
+  virtual U64 readInt64() = 0;
+
+/* Decode a double without modelling                         */
+  virtual F64 readDouble() = 0;
+
+/* Destructor                                                */
+  virtual ~EntropyDecoder() {};
+};
+
+#endif
@@ -0,0 +1,98 @@
+/*
+===============================================================================
+
+  FILE:  entropyencoder.hpp
+
+  CONTENTS:
+
+    Abstract base class for the entropy encoders. LASwritePoint starts and ends
+    chunks through this interface. The item compressors are templates of
+    the final encoder classes, so that coding a symbol is a direct call. A
+    new LASZIP_CODER is added by implementing this interface and adding
+    its class to the instantiations of the items.
+
+  PROGRAMMERS:
+
+    martin.isenburg@rapidlasso.com  -  http://rapidlasso.com
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- brought back to add the rANS coder next to arithmetic
+    10 January 2011 -- licensing change for LGPL release and liblas integration
+     8 December 2010 -- unified framework for all entropy coders
+
+===============================================================================
+*/
+#ifndef ENTROPY_ENCODER_HPP
+#define ENTROPY_ENCODER_HPP
+
+#include "mydefs.hpp"
+#include "bytestreamout.hpp"
+
+class ArithmeticModel;
+class ArithmeticBitModel;
+
+class EntropyEncoder
+{
+public:
+
+/* Manage encoding                                           */
+  virtual BOOL init(ByteStreamOut* outstream) = 0;
+  virtual void done() = 0;
+
+/* Manage an entropy model for a single bit                  */
+  virtual ArithmeticBitModel* createBitModel() = 0;
+  virtual void initBitModel(ArithmeticBitModel* model) = 0;
+  virtual void destroyBitModel(ArithmeticBitModel* model) = 0;
+
+/* Manage an entropy model for n symbols (table optional)    */
+  virtual ArithmeticModel* createSymbolModel(U32 n) = 0;
+  virtual void initSymbolModel(ArithmeticModel* model, U32 *table=0) = 0;
+  virtual void destroySymbolModel(ArithmeticModel* model) = 0;
+
+/* Encode a bit with modelling                               */
+  virtual void encodeBit(ArithmeticBitModel* model, U32 sym) = 0;
+
+/* Encode a symbol with modelling                            */
+  virtual void encodeSymbol(ArithmeticModel* model, U32 sym) = 0;
+
+/* Encode a bit without modelling                            */
+  virtual void writeBit(U32 sym) = 0;
+
+/* Encode bits without modelling                             */
+  virtual void writeBits(U32 bits, U32 sym) = 0;
+
+/* Encode an unsigned char without modelling                 */
+  virtual void writeByte(U8 sym) = 0;
+
+/* Encode an unsigned short without modelling                */
+  virtual void writeShort(U16 sym) = 0;
+
+/* Encode an unsigned int without modelling                  */
+  virtual void writeInt(U32 sym) = 0;
+
+/* Encode a float without modelling                          */
+  virtual void writeFloat(F32 sym) = 0;
+
+/* Encode an unsigned 64 bit int without modelling           */
+  virtual void writeInt64(U64 sym) = 0;
+
+/* Encode a double without modelling                         */
+  virtual void writeDouble(F64 sym) = 0;
+
+/* Destructor                                                */
+  virtual ~EntropyEncoder() {};
+};
+
+#endif
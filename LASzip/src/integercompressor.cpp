@@ -29,6 +29,10 @@
 ===============================================================================
 */
 #include "integercompressor.hpp"
+#include "arithmeticencoder.hpp"
+#include "arithmeticdecoder.hpp"
+#include "ransencoder.hpp"
+#include "ransdecoder.hpp"
 
 #define COMPRESS_ONLY_K
 #undef COMPRESS_ONLY_K
@@ -43,7 +47,8 @@
 #include <math.h>
 #endif
 
-IntegerCompressor::IntegerCompressor(ArithmeticEncoder* enc, U32 bits, U32 contexts, U32 bits_high, U32 range)
+template <class Encoder, class Decoder>
+IntegerCoder<Encoder, Decoder>::IntegerCoder(Encoder* enc, U32 bits, U32 contexts, U32 bits_high, U32 range)
 {
   assert(enc);
   this->enc = enc;
@@ -105,7 +110,8 @@ IntegerCompressor::IntegerCompressor(ArithmeticEncoder* enc, U32 bits, U32 conte
 #endif
 }
 
-IntegerCompressor::IntegerCompressor(ArithmeticDecoder* dec, U32 bits, U32 contexts, U32 bits_high, U32 range)
+template <class Encoder, class Decoder>
+IntegerCoder<Encoder, Decoder>::IntegerCoder(Decoder* dec, U32 bits, U32 contexts, U32 bits_high, U32 range)
 {
   assert(dec);
   this->enc = 0;
@@ -155,7 +161,8 @@ IntegerCompressor::IntegerCompressor(ArithmeticDecoder* dec, U32 bits, U32 conte
   mCorrector = 0;
 }
 
-IntegerCompressor::~IntegerCompressor()
+template <class Encoder, class Decoder>
+IntegerCoder<Encoder, Decoder>::~IntegerCoder()
 {
   U32 i;
   if (mBits)
@@ -215,7 +222,8 @@ IntegerCompressor::~IntegerCompressor()
 #endif
 }
 
-void IntegerCompressor::initCompressor()
+template <class Encoder, class Decoder>
+void IntegerCoder<Encoder, Decoder>::initCompressor()
 {
   U32 i;
 
@@ -260,7 +268,8 @@ void IntegerCompressor::initCompressor()
 #endif
 }
 
-void IntegerCompressor::compress(I32 pred, I32 real, U32 context)
+template <class Encoder, class Decoder>
+void IntegerCoder<Encoder, Decoder>::compress(I32 pred, I32 real, U32 context)
 {
   assert(enc);
   // the corrector will be within the interval [ - (corr_range - 1)  ...  + (corr_range - 1) ]
@@ -271,7 +280,8 @@ void IntegerCompressor::compress(I32 pred, I32 real, U32 context)
   writeCorrector(corr, mBits[context]);
 }
 
-void IntegerCompressor::initDecompressor()
+template <class Encoder, class Decoder>
+void IntegerCoder<Encoder, Decoder>::initDecompressor()
 {
   U32 i;
 
@@ -316,7 +326,8 @@ void IntegerCompressor::initDecompressor()
 #endif
 }
 
-I32 IntegerCompressor::decompress(I32 pred, U32 context)
+template <class Encoder, class Decoder>
+I32 IntegerCoder<Encoder, Decoder>::decompress(I32 pred, U32 context)
 {
   assert(dec);
   I32 real = pred + readCorrector(mBits[context]);
@@ -360,7 +371,8 @@ else
 }
 */
 
-void IntegerCompressor::writeCorrector(I32 c, ArithmeticModel* mBits)
+template <class Encoder, class Decoder>
+void IntegerCoder<Encoder, Decoder>::writeCorrector(I32 c, ArithmeticModel* mBits)
 {
   U32 c1;
 
@@ -463,7 +475,8 @@ void IntegerCompressor::writeCorrector(I32 c, ArithmeticModel* mBits)
 #endif // COMPRESS_ONLY_K
 }
 
-I32 IntegerCompressor::readCorrector(ArithmeticModel* mBits)
+template <class Encoder, class Decoder>
+I32 IntegerCoder<Encoder, Decoder>::readCorrector(ArithmeticModel* mBits)
 {
   I32 c;
 
@@ -546,3 +559,11 @@ I32 IntegerCompressor::readCorrector(ArithmeticModel* mBits)
 
   return c;
 }
+
+// the item compressors use the coder they are compiled for
+
+template class IntegerCoder<EntropyEncoder, EntropyDecoder>;
+template class IntegerCoder<ArithmeticEncoder, EntropyDecoder>;
+template class IntegerCoder<RANSEncoder, EntropyDecoder>;
+template class IntegerCoder<EntropyEncoder, ArithmeticDecoder>;
+template class IntegerCoder<EntropyEncoder, RANSDecoder>;
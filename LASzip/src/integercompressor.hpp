@@ -19,6 +19,10 @@
     are stored raw without predicive coding. How many of the higher bits
     are compressed can be specified with bits_high. The default is 8.
 
+    The item compressors use an IntegerCoder of the concrete entropy coder
+    they are compiled for, so that coding a symbol is a direct call. The
+    IntegerCompressor codes through the EntropyEncoder and EntropyDecoder.
+
   PROGRAMMERS:
 
     martin.isenburg@rapidlasso.com  -  http://rapidlasso.com
@@ -36,6 +40,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- templated on the entropy coders for the rANS coder
      6 September 2014 -- removed inheritance of EntropyEncoder and EntropyDecoder
     10 January 2011 -- licensing change for LGPL release and liblas integration
     10 December 2010 -- unified for all entropy coders at Baeckerei Schaefer
@@ -48,17 +53,18 @@
 #ifndef INTEGER_COMPRESSOR_HPP
 #define INTEGER_COMPRESSOR_HPP
 
-#include "arithmeticencoder.hpp"
-#include "arithmeticdecoder.hpp"
+#include "entropyencoder.hpp"
+#include "entropydecoder.hpp"
 
-class IntegerCompressor
+template <class Encoder, class Decoder>
+class IntegerCoder
 {
 public:
 
   // Constructor & Deconstructor
-  IntegerCompressor(ArithmeticEncoder* enc, U32 bits=16, U32 contexts=1, U32 bits_high=8, U32 range=0);
-  IntegerCompressor(ArithmeticDecoder* dec, U32 bits=16, U32 contexts=1, U32 bits_high=8, U32 range=0);
-  ~IntegerCompressor();
+  IntegerCoder(Encoder* enc, U32 bits=16, U32 contexts=1, U32 bits_high=8, U32 range=0);
+  IntegerCoder(Decoder* dec, U32 bits=16, U32 contexts=1, U32 bits_high=8, U32 range=0);
+  ~IntegerCoder();
 
   // Manage Compressor
   void initCompressor();
@@ -88,8 +94,8 @@ private:
   I32 corr_min;
   I32 corr_max;
 
-  ArithmeticEncoder* enc;
-  ArithmeticDecoder* dec;
+  Encoder* enc;
+  Decoder* dec;
 
   ArithmeticModel** mBits;
 
@@ -98,4 +104,6 @@ private:
   int** corr_histogram;
 };
 
+typedef IntegerCoder<EntropyEncoder, EntropyDecoder> IntegerCompressor;
+
 #endif
@@ -0,0 +1,193 @@
+/*
+===============================================================================
+
+  FILE:  lascounters.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+
+#include "lascounters.hpp"
+
+#include "laszip.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+BOOL LAScounters::enabled = FALSE;
+U32 LAScounters::sample_mask = LAS_COUNTERS_SAMPLE_DEFAULT - 1;
+U64 LAScounters::counts[LAS_COUNTERS_REGIONS][LAS_COUNTERS_EVENTS];
+U64 LAScounters::numbers[LAS_COUNTERS_REGIONS];
+
+static const CHAR* counters_event_names[LAS_COUNTERS_EVENTS] = { "instructions", "cycles", "branch-misses", "cache-misses", "task-clock" };
+static CHAR counters_region_names[LAS_COUNTERS_REGIONS][32];
+
+#if defined(__linux__)
+
+static int counters_fds[LAS_COUNTERS_EVENTS] = { -1, -1, -1, -1, -1 };
+static int counters_leader = -1;
+static U32 counters_opened = 0;
+static U32 counters_order[LAS_COUNTERS_EVENTS]; // the event of each value in the group
+static pthread_t counters_thread;
+
+static int counters_open(U32 type, U64 config, int leader)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = (leader == -1 ? 1 : 0);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+BOOL LAScounters::enable(const U32 sample_interval)
+{
+  disable();
+  sample_mask = 1;
+  while ((sample_mask * 2) <= sample_interval) sample_mask *= 2;
+  sample_mask--;
+
+  // the hardware events lead the group. the task clock (a software event)
+  // can join a hardware group but not the other way round
+  static const U32 types[LAS_COUNTERS_EVENTS] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE };
+  static const U64 configs[LAS_COUNTERS_EVENTS] = { PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_SW_TASK_CLOCK };
+  for (U32 e = 0; e < LAS_COUNTERS_EVENTS; e++)
+  {
+    int fd = counters_open(types[e], configs[e], counters_leader);
+    if (fd < 0) continue;
+    if (counters_leader == -1) counters_leader = fd;
+    counters_fds[e] = fd;
+    counters_order[counters_opened++] = e;
+  }
+  if (counters_leader == -1) return FALSE;
+
+  memset(counts, 0, sizeof(counts));
+  memset(numbers, 0, sizeof(numbers));
+  counters_thread = pthread_self();
+  ioctl(counters_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(counters_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  enabled = TRUE;
+  return TRUE;
+}
+
+BOOL LAScounters::read(U64* values)
+{
+  if (!enabled || !pthread_equal(counters_thread, pthread_self())) return FALSE;
+  U64 group[1 + LAS_COUNTERS_EVENTS];
+  if (::read(counters_leader, group, sizeof(U64)*(1 + counters_opened)) != (ssize_t)(sizeof(U64)*(1 + counters_opened))) return FALSE;
+  memset(values, 0, sizeof(U64)*LAS_COUNTERS_EVENTS);
+  for (U32 i = 0; (i < counters_opened) && (i < group[0]); i++)
+  {
+    values[counters_order[i]] = group[1 + i];
+  }
+  return TRUE;
+}
+
+BOOL LAScounters::has_event(const U32 event)
+{
+  return (event < LAS_COUNTERS_EVENTS) && (counters_fds[event] != -1);
+}
+
+void LAScounters::disable()
+{
+  enabled = FALSE;
+  if (counters_leader != -1) ioctl(counters_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  for (U32 e = 0; e < LAS_COUNTERS_EVENTS; e++)
+  {
+    if (counters_fds[e] != -1) close(counters_fds[e]);
+    counters_fds[e] = -1;
+  }
+  counters_leader = -1;
+  counters_opened = 0;
+}
+
+#else
+
+BOOL LAScounters::enable(const U32 sample_interval)
+{
+  return FALSE;
+}
+
+BOOL LAScounters::read(U64* values)
+{
+  return FALSE;
+}
+
+BOOL LAScounters::has_event(const U32 event)
+{
+  return FALSE;
+}
+
+void LAScounters::disable()
+{
+  enabled = FALSE;
+}
+
+#endif
+
+void LAScounters::add(const U32 region, const U64* start, const U32 number)
+{
+  U64 now[LAS_COUNTERS_EVENTS];
+  if (!read(now)) return;
+  for (U32 e = 0; e < LAS_COUNTERS_EVENTS; e++)
+  {
+    counts[region][e] += (now[e] - start[e]) * number;
+  }
+  numbers[region] += number;
+}
+
+void LAScounters::set_items(const U32 first_region, const U32 num_items, const LASitem* items)
+{
+  for (U32 i = 0; (i < num_items) && (i < LAS_COUNTERS_MAX_ITEMS); i++)
+  {
+    const CHAR* name = items[i].get_name();
+    sprintf(counters_region_names[first_region + i], "%s %s v%d", (first_region == LAS_COUNTERS_ENCODE ? "encode" : "decode"), (name ? name : "item"), (I32)items[i].version);
+  }
+}
+
+const CHAR* LAScounters::get_event_name(const U32 event)
+{
+  return (event < LAS_COUNTERS_EVENTS ? counters_event_names[event] : "unknown");
+}
+
+const CHAR* LAScounters::get_region_name(const U32 region)
+{
+  if (region == LAS_COUNTERS_CHUNK_RESTART) return "chunk restart";
+  if (region == LAS_COUNTERS_STREAM_IO) return "stream I/O";
+  if ((region < LAS_COUNTERS_CHUNK_RESTART) && counters_region_names[region][0]) return counters_region_names[region];
+  return "unknown";
+}
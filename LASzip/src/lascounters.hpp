@@ -0,0 +1,122 @@
+/*
+===============================================================================
+
+  FILE:  lascounters.hpp
+
+  CONTENTS:
+
+    Counts hardware events (instructions, cycles, branch misses, and cache
+    misses) plus the task clock with Linux perf_event_open() for regions of
+    the codec: the encoding and decoding of each item, chunk restarts (the
+    done() and init() of the entropy coder at chunk boundaries with the raw
+    first point), and stream I/O (seeks, chunk tables, waits for reads).
+
+    Reading the counters is a system call, which is far more expensive than
+    coding one item. Therefore only every n-th point (the sample interval)
+    has its items measured one by one, and each such sample stands for n
+    points. Chunk restarts and stream I/O are rare and measured every time.
+    Only the thread that called enable() is counted.
+
+    Counters that the CPU, the kernel, or a virtual machine does not offer
+    are left out, and when none can be opened enable() returns FALSE and
+    nothing is counted. Outside of Linux enable() always returns FALSE.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for tuning the item coders on our CPUs
+
+===============================================================================
+*/
+#ifndef LAS_COUNTERS_HPP
+#define LAS_COUNTERS_HPP
+
+#include "mydefs.hpp"
+
+#define LAS_COUNTERS_INSTRUCTIONS   0
+#define LAS_COUNTERS_CYCLES         1
+#define LAS_COUNTERS_BRANCH_MISSES  2
+#define LAS_COUNTERS_CACHE_MISSES   3
+#define LAS_COUNTERS_TASK_CLOCK     4
+#define LAS_COUNTERS_EVENTS         5
+
+#define LAS_COUNTERS_MAX_ITEMS      8
+#define LAS_COUNTERS_ENCODE         0   // + item index
+#define LAS_COUNTERS_DECODE         8   // + item index
+#define LAS_COUNTERS_CHUNK_RESTART 16
+#define LAS_COUNTERS_STREAM_IO     17
+#define LAS_COUNTERS_REGIONS       18
+
+#define LAS_COUNTERS_SAMPLE_DEFAULT 256
+
+class LASitem;
+
+class LAScounters
+{
+public:
+  // opens the counters for the calling thread. the sample interval is
+  // rounded down to a power of two
+  static BOOL enable(const U32 sample_interval=LAS_COUNTERS_SAMPLE_DEFAULT);
+  static inline BOOL is_enabled() { return enabled; };
+
+  // is the point with this count one whose items are measured
+  static inline BOOL is_sample(const U32 count) { return enabled && ((count & sample_mask) == 0); };
+  static inline U32 get_sample_interval() { return sample_mask + 1; };
+
+  // the current counts. FALSE when called from another thread
+  static BOOL read(U64* values);
+  // adds the counts since start to a region as if they were measured for
+  // this many points (or calls)
+  static void add(const U32 region, const U64* start, const U32 number=1);
+
+  // names the item regions of the encoder or the decoder
+  static void set_items(const U32 first_region, const U32 num_items, const LASitem* items);
+
+  static BOOL has_event(const U32 event);
+  static const CHAR* get_event_name(const U32 event);
+  static const CHAR* get_region_name(const U32 region);
+  static inline const U64* get_counts(const U32 region) { return counts[region]; };
+  static inline U64 get_number(const U32 region) { return numbers[region]; };
+
+  static void disable();
+
+private:
+  static BOOL enabled;
+  static U32 sample_mask;
+  static U64 counts[LAS_COUNTERS_REGIONS][LAS_COUNTERS_EVENTS];
+  static U64 numbers[LAS_COUNTERS_REGIONS];
+};
+
+class LAScountersScope
+{
+public:
+  inline LAScountersScope(const U32 region)
+  {
+    this->region = region;
+    active = (LAScounters::is_enabled() && LAScounters::read(start));
+  };
+  inline ~LAScountersScope()
+  {
+    if (active) LAScounters::add(region, start);
+  };
+private:
+  U32 region;
+  BOOL active;
+  U64 start[LAS_COUNTERS_EVENTS];
+};
+
+#endif
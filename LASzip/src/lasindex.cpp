@@ -239,6 +239,15 @@ BOOL LASindex::intersect_rectangle(const F64 r_min_x, const F64 r_min_y, const F
   return FALSE;
 }
 
+BOOL LASindex::intersect_rectangle(const F64 r_min_x, const F64 r_min_y, const F64 r_max_x, const F64 r_max_y, BOOL (*keep_cell)(const F32* min, const F32* max, const void* data), const void* data)
+{
+  have_interval = FALSE;
+  cells = spatial->intersect_rectangle(r_min_x, r_min_y, r_max_x, r_max_y);
+  if (cells)
+    return merge_intervals(keep_cell, data);
+  return FALSE;
+}
+
 BOOL LASindex::intersect_tile(const F32 ll_x, const F32 ll_y, const F32 size)
 {
   have_interval = FALSE;
@@ -591,7 +600,7 @@ BOOL LASindex::seek_next(LASreadPoint* reader, I64 &p_count)
   if (!have_interval)
   {
     if (!has_intervals()) return FALSE;
-    reader->seek((U32)p_count, start);
+    reader->seek(p_count, start);
     p_count = start;
   }
   if (p_count == end)
@@ -617,13 +626,19 @@ BOOL LASindex::seek_next(LASreader* lasreader)
 #endif
 
 // merge the intervals of non-empty cells
-BOOL LASindex::merge_intervals()
+BOOL LASindex::merge_intervals(BOOL (*keep_cell)(const F32* min, const F32* max, const void* data), const void* data)
 {
   if (spatial->get_intersected_cells())
   {
     U32 used_cells = 0;
+    F32 min[2], max[2];
     while (spatial->has_more_cells())
     {
+      if (keep_cell)
+      {
+        spatial->get_cell_bounding_box(spatial->current_cell, min, max);
+        if (!keep_cell(min, max, data)) continue;
+      }
       if (interval->get_cell(spatial->current_cell))
       {
         interval->add_current_cell_to_merge_cell_set();
@@ -27,6 +27,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- intersect_rectangle() may keep only the cells a callback accepts
      2 April 2015 -- add seek_next(LASreadPoint* reader, I64 &p_count) for DLL
      2 April 2015 -- delete read_next(LASreader* lasreader) that was not used
     31 March 2015 -- remove unused LASquadtree inheritance of abstract LASspatial 
@@ -71,6 +72,8 @@ public:
   BOOL intersect_rectangle(const F64 r_min_x, const F64 r_min_y, const F64 r_max_x, const F64 r_max_y);
   BOOL intersect_tile(const F32 ll_x, const F32 ll_y, const F32 size);
   BOOL intersect_circle(const F64 center_x, const F64 center_y, const F64 radius);
+  // only uses the cells whose bounding box 'keep_cell' accepts (e.g. for polygons)
+  BOOL intersect_rectangle(const F64 r_min_x, const F64 r_min_y, const F64 r_max_x, const F64 r_max_y, BOOL (*keep_cell)(const F32* min, const F32* max, const void* data), const void* data);
 
   // access the intersected intervals
   BOOL get_intervals();
@@ -97,7 +100,7 @@ public:
   LASinterval* get_interval() const;
 
 private:
-  BOOL merge_intervals();
+  BOOL merge_intervals(BOOL (*keep_cell)(const F32* min, const F32* max, const void* data)=0, const void* data=0);
 
   LASquadtree* spatial;
   LASinterval* interval;
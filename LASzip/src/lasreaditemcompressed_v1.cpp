@@ -30,6 +30,8 @@
 */
 
 #include "lasreaditemcompressed_v1.hpp"
+#include "arithmeticdecoder.hpp"
+#include "ransdecoder.hpp"
 #include "laszip_common_v1.hpp"
 
 #include <assert.h>
@@ -57,7 +59,8 @@ struct LASpoint10
   U16 point_source_ID;
 };
 
-LASreadItemCompressed_POINT10_v1::LASreadItemCompressed_POINT10_v1(ArithmeticDecoder* dec)
+template <class Decoder>
+LASreadItemCompressed_POINT10_v1<Decoder>::LASreadItemCompressed_POINT10_v1(Decoder* dec)
 {
   U32 i;
 
@@ -66,12 +69,12 @@ LASreadItemCompressed_POINT10_v1::LASreadItemCompressed_POINT10_v1(ArithmeticDec
   this->dec = dec;
 
   /* create models and integer compressors */
-  ic_dx = new IntegerCompressor(dec, 32);  // 32 bits, 1 context
-  ic_dy = new IntegerCompressor(dec, 32, 20); // 32 bits, 20 contexts
-  ic_z = new IntegerCompressor(dec, 32, 20);  // 32 bits, 20 contexts
-  ic_intensity = new IntegerCompressor(dec, 16);
-  ic_scan_angle_rank = new IntegerCompressor(dec, 8, 2);
-  ic_point_source_ID = new IntegerCompressor(dec, 16);
+  ic_dx = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32);  // 32 bits, 1 context
+  ic_dy = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 20); // 32 bits, 20 contexts
+  ic_z = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 20);  // 32 bits, 20 contexts
+  ic_intensity = new IntegerCoder<EntropyEncoder, Decoder>(dec, 16);
+  ic_scan_angle_rank = new IntegerCoder<EntropyEncoder, Decoder>(dec, 8, 2);
+  ic_point_source_ID = new IntegerCoder<EntropyEncoder, Decoder>(dec, 16);
   m_changed_values = dec->createSymbolModel(64);
   for (i = 0; i < 256; i++)
   {
@@ -81,7 +84,8 @@ LASreadItemCompressed_POINT10_v1::LASreadItemCompressed_POINT10_v1(ArithmeticDec
   }
 }
 
-LASreadItemCompressed_POINT10_v1::~LASreadItemCompressed_POINT10_v1()
+template <class Decoder>
+LASreadItemCompressed_POINT10_v1<Decoder>::~LASreadItemCompressed_POINT10_v1()
 {
   U32 i;
 
@@ -100,7 +104,8 @@ LASreadItemCompressed_POINT10_v1::~LASreadItemCompressed_POINT10_v1()
   }
 }
 
-BOOL LASreadItemCompressed_POINT10_v1::init(const U8* item)
+template <class Decoder>
+BOOL LASreadItemCompressed_POINT10_v1<Decoder>::init(const U8* item)
 {
   U32 i;
 
@@ -130,7 +135,8 @@ BOOL LASreadItemCompressed_POINT10_v1::init(const U8* item)
   return TRUE;
 }
 
-inline void LASreadItemCompressed_POINT10_v1::read(U8* item)
+template <class Decoder>
+inline void LASreadItemCompressed_POINT10_v1<Decoder>::read(U8* item)
 {
   // find median difference for x and y from 3 preceding differences
   I32 median_x;
@@ -258,7 +264,8 @@ inline void LASreadItemCompressed_POINT10_v1::read(U8* item)
 
 #define LASZIP_GPSTIME_MULTIMAX 512
 
-LASreadItemCompressed_GPSTIME11_v1::LASreadItemCompressed_GPSTIME11_v1(ArithmeticDecoder* dec)
+template <class Decoder>
+LASreadItemCompressed_GPSTIME11_v1<Decoder>::LASreadItemCompressed_GPSTIME11_v1(Decoder* dec)
 {
   /* set decoder */
   assert(dec);
@@ -266,17 +273,19 @@ LASreadItemCompressed_GPSTIME11_v1::LASreadItemCompressed_GPSTIME11_v1(Arithmeti
   /* create entropy models and integer compressors */
   m_gpstime_multi = dec->createSymbolModel(LASZIP_GPSTIME_MULTIMAX);
   m_gpstime_0diff = dec->createSymbolModel(3);
-  ic_gpstime = new IntegerCompressor(dec, 32, 6); // 32 bits, 6 contexts
+  ic_gpstime = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 6); // 32 bits, 6 contexts
 }
 
-LASreadItemCompressed_GPSTIME11_v1::~LASreadItemCompressed_GPSTIME11_v1()
+template <class Decoder>
+LASreadItemCompressed_GPSTIME11_v1<Decoder>::~LASreadItemCompressed_GPSTIME11_v1()
 {
   dec->destroySymbolModel(m_gpstime_multi);
   dec->destroySymbolModel(m_gpstime_0diff);
   delete ic_gpstime;
 }
 
-BOOL LASreadItemCompressed_GPSTIME11_v1::init(const U8* item)
+template <class Decoder>
+BOOL LASreadItemCompressed_GPSTIME11_v1<Decoder>::init(const U8* item)
 {
   /* init state */
   last_gpstime_diff = 0;
@@ -292,7 +301,8 @@ BOOL LASreadItemCompressed_GPSTIME11_v1::init(const U8* item)
   return TRUE;
 }
 
-inline void LASreadItemCompressed_GPSTIME11_v1::read(U8* item)
+template <class Decoder>
+inline void LASreadItemCompressed_GPSTIME11_v1<Decoder>::read(U8* item)
 {
   I32 multi;
   if (last_gpstime_diff == 0) // if the last integer difference was zero
@@ -368,7 +378,8 @@ inline void LASreadItemCompressed_GPSTIME11_v1::read(U8* item)
 ===============================================================================
 */
 
-LASreadItemCompressed_RGB12_v1::LASreadItemCompressed_RGB12_v1(ArithmeticDecoder* dec)
+template <class Decoder>
+LASreadItemCompressed_RGB12_v1<Decoder>::LASreadItemCompressed_RGB12_v1(Decoder* dec)
 {
   /* set decoder */
   assert(dec);
@@ -376,20 +387,22 @@ LASreadItemCompressed_RGB12_v1::LASreadItemCompressed_RGB12_v1(ArithmeticDecoder
 
   /* create models and integer compressors */
   m_byte_used = dec->createSymbolModel(64);
-  ic_rgb = new IntegerCompressor(dec, 8, 6);
+  ic_rgb = new IntegerCoder<EntropyEncoder, Decoder>(dec, 8, 6);
 
   /* create last item */
   last_item = new U8[6];
 }
 
-LASreadItemCompressed_RGB12_v1::~LASreadItemCompressed_RGB12_v1()
+template <class Decoder>
+LASreadItemCompressed_RGB12_v1<Decoder>::~LASreadItemCompressed_RGB12_v1()
 {
   dec->destroySymbolModel(m_byte_used);
   delete ic_rgb;
   delete [] last_item;
 }
 
-BOOL LASreadItemCompressed_RGB12_v1::init(const U8* item)
+template <class Decoder>
+BOOL LASreadItemCompressed_RGB12_v1<Decoder>::init(const U8* item)
 {
   /* init state */
 
@@ -402,7 +415,8 @@ BOOL LASreadItemCompressed_RGB12_v1::init(const U8* item)
   return TRUE;
 }
 
-inline void LASreadItemCompressed_RGB12_v1::read(U8* item)
+template <class Decoder>
+inline void LASreadItemCompressed_RGB12_v1<Decoder>::read(U8* item)
 {
   U32 sym = dec->decodeSymbol(m_byte_used);
   if (sym & (1 << 0)) ((U16*)item)[0] = (U16)ic_rgb->decompress(((U16*)last_item)[0]&255, 0);
@@ -426,7 +440,8 @@ inline void LASreadItemCompressed_RGB12_v1::read(U8* item)
 ===============================================================================
 */
 
-LASreadItemCompressed_WAVEPACKET13_v1::LASreadItemCompressed_WAVEPACKET13_v1(ArithmeticDecoder* dec)
+template <class Decoder>
+LASreadItemCompressed_WAVEPACKET13_v1<Decoder>::LASreadItemCompressed_WAVEPACKET13_v1(Decoder* dec)
 {
   /* set decoder */
   assert(dec);
@@ -438,16 +453,17 @@ LASreadItemCompressed_WAVEPACKET13_v1::LASreadItemCompressed_WAVEPACKET13_v1(Ari
   m_offset_diff[1] = dec->createSymbolModel(4);
   m_offset_diff[2] = dec->createSymbolModel(4);
   m_offset_diff[3] = dec->createSymbolModel(4);
-  ic_offset_diff = new IntegerCompressor(dec, 32);
-  ic_packet_size = new IntegerCompressor(dec, 32);
-  ic_return_point = new IntegerCompressor(dec, 32);
-  ic_xyz = new IntegerCompressor(dec, 32, 3);
+  ic_offset_diff = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32);
+  ic_packet_size = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32);
+  ic_return_point = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32);
+  ic_xyz = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 3);
 
   /* create last item */
   last_item = new U8[28];
 }
 
-LASreadItemCompressed_WAVEPACKET13_v1::~LASreadItemCompressed_WAVEPACKET13_v1()
+template <class Decoder>
+LASreadItemCompressed_WAVEPACKET13_v1<Decoder>::~LASreadItemCompressed_WAVEPACKET13_v1()
 {
   dec->destroySymbolModel(m_packet_index);
   dec->destroySymbolModel(m_offset_diff[0]);
@@ -461,7 +477,8 @@ LASreadItemCompressed_WAVEPACKET13_v1::~LASreadItemCompressed_WAVEPACKET13_v1()
   delete [] last_item;
 }
 
-BOOL LASreadItemCompressed_WAVEPACKET13_v1::init(const U8* item)
+template <class Decoder>
+BOOL LASreadItemCompressed_WAVEPACKET13_v1<Decoder>::init(const U8* item)
 {
   /* init state */
   last_diff_32 = 0;
@@ -484,7 +501,8 @@ BOOL LASreadItemCompressed_WAVEPACKET13_v1::init(const U8* item)
   return TRUE;
 }
 
-inline void LASreadItemCompressed_WAVEPACKET13_v1::read(U8* item)
+template <class Decoder>
+inline void LASreadItemCompressed_WAVEPACKET13_v1<Decoder>::read(U8* item)
 {
   item[0] = (U8)(dec->decodeSymbol(m_packet_index));
   item++;
@@ -529,7 +547,8 @@ inline void LASreadItemCompressed_WAVEPACKET13_v1::read(U8* item)
 ===============================================================================
 */
 
-LASreadItemCompressed_BYTE_v1::LASreadItemCompressed_BYTE_v1(ArithmeticDecoder* dec, U32 number)
+template <class Decoder>
+LASreadItemCompressed_BYTE_v1<Decoder>::LASreadItemCompressed_BYTE_v1(Decoder* dec, U32 number)
 {
   /* set decoder */
   assert(dec);
@@ -538,19 +557,21 @@ LASreadItemCompressed_BYTE_v1::LASreadItemCompressed_BYTE_v1(ArithmeticDecoder*
   this->number = number;
 
   /* create models and integer compressors */
-  ic_byte = new IntegerCompressor(dec, 8, number);
+  ic_byte = new IntegerCoder<EntropyEncoder, Decoder>(dec, 8, number);
 
   /* create last item */
   last_item = new U8[number];
 }
 
-LASreadItemCompressed_BYTE_v1::~LASreadItemCompressed_BYTE_v1()
+template <class Decoder>
+LASreadItemCompressed_BYTE_v1<Decoder>::~LASreadItemCompressed_BYTE_v1()
 {
   delete ic_byte;
   delete [] last_item;
 }
 
-BOOL LASreadItemCompressed_BYTE_v1::init(const U8* item)
+template <class Decoder>
+BOOL LASreadItemCompressed_BYTE_v1<Decoder>::init(const U8* item)
 {
   /* init state */
 
@@ -562,7 +583,8 @@ BOOL LASreadItemCompressed_BYTE_v1::init(const U8* item)
   return TRUE;
 }
 
-inline void LASreadItemCompressed_BYTE_v1::read(U8* item)
+template <class Decoder>
+inline void LASreadItemCompressed_BYTE_v1<Decoder>::read(U8* item)
 {
   U32 i;
   for (i = 0; i < number; i++)
@@ -573,3 +595,16 @@ inline void LASreadItemCompressed_BYTE_v1::read(U8* item)
 }
 
 // vim: set ts=2 sw=2 expandtabs
+
+// the coders that the items are compiled for
+
+template class LASreadItemCompressed_POINT10_v1<ArithmeticDecoder>;
+template class LASreadItemCompressed_POINT10_v1<RANSDecoder>;
+template class LASreadItemCompressed_GPSTIME11_v1<ArithmeticDecoder>;
+template class LASreadItemCompressed_GPSTIME11_v1<RANSDecoder>;
+template class LASreadItemCompressed_RGB12_v1<ArithmeticDecoder>;
+template class LASreadItemCompressed_RGB12_v1<RANSDecoder>;
+template class LASreadItemCompressed_WAVEPACKET13_v1<ArithmeticDecoder>;
+template class LASreadItemCompressed_WAVEPACKET13_v1<RANSDecoder>;
+template class LASreadItemCompressed_BYTE_v1<ArithmeticDecoder>;
+template class LASreadItemCompressed_BYTE_v1<RANSDecoder>;
@@ -24,6 +24,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- templated on the entropy decoder to also support rANS
     6 September 2014 -- removed inheritance of EntropyEncoder and EntropyDecoder
     10 January 2011 -- licensing change for LGPL release and liblas integration
     7 December 2010 -- refactored after getting invited to KAUST in Saudi Arabia
@@ -34,14 +35,15 @@
 #define LAS_READ_ITEM_COMPRESSED_V1_HPP
 
 #include "lasreaditem.hpp"
-#include "arithmeticdecoder.hpp"
+#include "entropydecoder.hpp"
 #include "integercompressor.hpp"
 
+template <class Decoder>
 class LASreadItemCompressed_POINT10_v1 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_POINT10_v1(ArithmeticDecoder* dec);
+  LASreadItemCompressed_POINT10_v1(Decoder* dec);
 
   BOOL init(const U8* item);
   void read(U8* item);
@@ -49,29 +51,30 @@ public:
   ~LASreadItemCompressed_POINT10_v1();
 
 private:
-  ArithmeticDecoder* dec;
+  Decoder* dec;
   U8 last_item[20];
 
   I32 last_x_diff[3];
   I32 last_y_diff[3];
   I32 last_incr;
-  IntegerCompressor* ic_dx;
-  IntegerCompressor* ic_dy;
-  IntegerCompressor* ic_z;
-  IntegerCompressor* ic_intensity;
-  IntegerCompressor* ic_scan_angle_rank;
-  IntegerCompressor* ic_point_source_ID;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_dx;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_dy;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_z;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_intensity;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_scan_angle_rank;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_point_source_ID;
   ArithmeticModel* m_changed_values;
   ArithmeticModel* m_bit_byte[256];
   ArithmeticModel* m_classification[256];
   ArithmeticModel* m_user_data[256];
 };
 
+template <class Decoder>
 class LASreadItemCompressed_GPSTIME11_v1 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_GPSTIME11_v1(ArithmeticDecoder* dec);
+  LASreadItemCompressed_GPSTIME11_v1(Decoder* dec);
 
   BOOL init(const U8* item);
   void read(U8* item);
@@ -79,21 +82,22 @@ public:
   ~LASreadItemCompressed_GPSTIME11_v1();
 
 private:
-  ArithmeticDecoder* dec;
+  Decoder* dec;
   U64I64F64 last_gpstime;
 
   ArithmeticModel* m_gpstime_multi;
   ArithmeticModel* m_gpstime_0diff;
-  IntegerCompressor* ic_gpstime;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_gpstime;
   I32 multi_extreme_counter;
   I32 last_gpstime_diff;
 };
 
+template <class Decoder>
 class LASreadItemCompressed_RGB12_v1 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_RGB12_v1(ArithmeticDecoder* dec);
+  LASreadItemCompressed_RGB12_v1(Decoder* dec);
 
   BOOL init(const U8* item);
   void read(U8* item);
@@ -101,18 +105,19 @@ public:
   ~LASreadItemCompressed_RGB12_v1();
 
 private:
-  ArithmeticDecoder* dec;
+  Decoder* dec;
   U8* last_item;
 
   ArithmeticModel* m_byte_used;
-  IntegerCompressor* ic_rgb;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_rgb;
 };
 
+template <class Decoder>
 class LASreadItemCompressed_WAVEPACKET13_v1 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_WAVEPACKET13_v1(ArithmeticDecoder* dec);
+  LASreadItemCompressed_WAVEPACKET13_v1(Decoder* dec);
 
   BOOL init(const U8* item);
   void read(U8* item);
@@ -120,24 +125,25 @@ public:
   ~LASreadItemCompressed_WAVEPACKET13_v1();
 
 private:
-  ArithmeticDecoder* dec;
+  Decoder* dec;
   U8* last_item;
 
   I32 last_diff_32;
   U32 sym_last_offset_diff;
   ArithmeticModel* m_packet_index;
   ArithmeticModel* m_offset_diff[4];
-  IntegerCompressor* ic_offset_diff;
-  IntegerCompressor* ic_packet_size;
-  IntegerCompressor* ic_return_point;
-  IntegerCompressor* ic_xyz;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_offset_diff;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_packet_size;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_return_point;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_xyz;
 };
 
+template <class Decoder>
 class LASreadItemCompressed_BYTE_v1 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_BYTE_v1(ArithmeticDecoder* dec, U32 number);
+  LASreadItemCompressed_BYTE_v1(Decoder* dec, U32 number);
 
   BOOL init(const U8* item);
   void read(U8* item);
@@ -145,11 +151,11 @@ public:
   ~LASreadItemCompressed_BYTE_v1();
 
 private:
-  ArithmeticDecoder* dec;
+  Decoder* dec;
   U32 number;
   U8* last_item;
 
-  IntegerCompressor* ic_byte;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_byte;
 };
 
 #endif
@@ -30,6 +30,8 @@
 */
 
 #include "lasreaditemcompressed_v2.hpp"
+#include "arithmeticdecoder.hpp"
+#include "ransdecoder.hpp"
 
 #include <assert.h>
 #include <string.h>
@@ -50,7 +52,8 @@ struct LASpoint10
   U16 point_source_ID;
 };
 
-LASreadItemCompressed_POINT10_v2::LASreadItemCompressed_POINT10_v2(ArithmeticDecoder* dec)
+template <class Decoder>
+LASreadItemCompressed_POINT10_v2<Decoder>::LASreadItemCompressed_POINT10_v2(Decoder* dec)
 {
   U32 i;
 
@@ -60,22 +63,23 @@ LASreadItemCompressed_POINT10_v2::LASreadItemCompressed_POINT10_v2(ArithmeticDec
 
   /* create models and integer compressors */
   m_changed_values = dec->createSymbolModel(64);
-  ic_intensity = new IntegerCompressor(dec, 16, 4);
+  ic_intensity = new IntegerCoder<EntropyEncoder, Decoder>(dec, 16, 4);
   m_scan_angle_rank[0] = dec->createSymbolModel(256);
   m_scan_angle_rank[1] = dec->createSymbolModel(256);
-  ic_point_source_ID = new IntegerCompressor(dec, 16);
+  ic_point_source_ID = new IntegerCoder<EntropyEncoder, Decoder>(dec, 16);
   for (i = 0; i < 256; i++)
   {
     m_bit_byte[i] = 0;
     m_classification[i] = 0;
     m_user_data[i] = 0;
   }
-  ic_dx = new IntegerCompressor(dec, 32, 2);  // 32 bits, 2 context
-  ic_dy = new IntegerCompressor(dec, 32, 22); // 32 bits, 22 contexts
-  ic_z = new IntegerCompressor(dec, 32, 20);  // 32 bits, 20 contexts
+  ic_dx = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 2);  // 32 bits, 2 context
+  ic_dy = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 22); // 32 bits, 22 contexts
+  ic_z = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 20);  // 32 bits, 20 contexts
 }
 
-LASreadItemCompressed_POINT10_v2::~LASreadItemCompressed_POINT10_v2()
+template <class Decoder>
+LASreadItemCompressed_POINT10_v2<Decoder>::~LASreadItemCompressed_POINT10_v2()
 {
   U32 i;
 
@@ -95,7 +99,8 @@ LASreadItemCompressed_POINT10_v2::~LASreadItemCompressed_POINT10_v2()
   delete ic_z;
 }
 
-BOOL LASreadItemCompressed_POINT10_v2::init(const U8* item)
+template <class Decoder>
+BOOL LASreadItemCompressed_POINT10_v2<Decoder>::init(const U8* item)
 {
   U32 i;
 
@@ -134,7 +139,8 @@ BOOL LASreadItemCompressed_POINT10_v2::init(const U8* item)
   return TRUE;
 }
 
-inline void LASreadItemCompressed_POINT10_v2::read(U8* item)
+template <class Decoder>
+inline void LASreadItemCompressed_POINT10_v2<Decoder>::read(U8* item)
 {
   U32 r, n, m, l;
   U32 k_bits;
@@ -250,7 +256,8 @@ inline void LASreadItemCompressed_POINT10_v2::read(U8* item)
 
 #define LASZIP_GPSTIME_MULTI_TOTAL (LASZIP_GPSTIME_MULTI - LASZIP_GPSTIME_MULTI_MINUS + 6) 
 
-LASreadItemCompressed_GPSTIME11_v2::LASreadItemCompressed_GPSTIME11_v2(ArithmeticDecoder* dec)
+template <class Decoder>
+LASreadItemCompressed_GPSTIME11_v2<Decoder>::LASreadItemCompressed_GPSTIME11_v2(Decoder* dec)
 {
   /* set decoder */
   assert(dec);
@@ -258,17 +265,19 @@ LASreadItemCompressed_GPSTIME11_v2::LASreadItemCompressed_GPSTIME11_v2(Arithmeti
   /* create entropy models and integer compressors */
   m_gpstime_multi = dec->createSymbolModel(LASZIP_GPSTIME_MULTI_TOTAL);
   m_gpstime_0diff = dec->createSymbolModel(6);
-  ic_gpstime = new IntegerCompressor(dec, 32, 9); // 32 bits, 9 contexts
+  ic_gpstime = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 9); // 32 bits, 9 contexts
 }
 
-LASreadItemCompressed_GPSTIME11_v2::~LASreadItemCompressed_GPSTIME11_v2()
+template <class Decoder>
+LASreadItemCompressed_GPSTIME11_v2<Decoder>::~LASreadItemCompressed_GPSTIME11_v2()
 {
   dec->destroySymbolModel(m_gpstime_multi);
   dec->destroySymbolModel(m_gpstime_0diff);
   delete ic_gpstime;
 }
 
-BOOL LASreadItemCompressed_GPSTIME11_v2::init(const U8* item)
+template <class Decoder>
+BOOL LASreadItemCompressed_GPSTIME11_v2<Decoder>::init(const U8* item)
 {
   /* init state */
   last = 0, next = 0;
@@ -294,7 +303,8 @@ BOOL LASreadItemCompressed_GPSTIME11_v2::init(const U8* item)
   return TRUE;
 }
 
-inline void LASreadItemCompressed_GPSTIME11_v2::read(U8* item)
+template <class Decoder>
+inline void LASreadItemCompressed_GPSTIME11_v2<Decoder>::read(U8* item)
 {
   I32 multi;
   if (last_gpstime_diff[last] == 0) // if the last integer difference was zero
@@ -405,7 +415,8 @@ inline void LASreadItemCompressed_GPSTIME11_v2::read(U8* item)
 ===============================================================================
 */
 
-LASreadItemCompressed_RGB12_v2::LASreadItemCompressed_RGB12_v2(ArithmeticDecoder* dec)
+template <class Decoder>
+LASreadItemCompressed_RGB12_v2<Decoder>::LASreadItemCompressed_RGB12_v2(Decoder* dec)
 {
   /* set decoder */
   assert(dec);
@@ -421,7 +432,8 @@ LASreadItemCompressed_RGB12_v2::LASreadItemCompressed_RGB12_v2(ArithmeticDecoder
   m_rgb_diff_5 = dec->createSymbolModel(256);
 }
 
-LASreadItemCompressed_RGB12_v2::~LASreadItemCompressed_RGB12_v2()
+template <class Decoder>
+LASreadItemCompressed_RGB12_v2<Decoder>::~LASreadItemCompressed_RGB12_v2()
 {
   dec->destroySymbolModel(m_byte_used);
   dec->destroySymbolModel(m_rgb_diff_0);
@@ -432,7 +444,8 @@ LASreadItemCompressed_RGB12_v2::~LASreadItemCompressed_RGB12_v2()
   dec->destroySymbolModel(m_rgb_diff_5);
 }
 
-BOOL LASreadItemCompressed_RGB12_v2::init(const U8* item)
+template <class Decoder>
+BOOL LASreadItemCompressed_RGB12_v2<Decoder>::init(const U8* item)
 {
   /* init state */
 
@@ -450,7 +463,8 @@ BOOL LASreadItemCompressed_RGB12_v2::init(const U8* item)
   return TRUE;
 }
 
-inline void LASreadItemCompressed_RGB12_v2::read(U8* item)
+template <class Decoder>
+inline void LASreadItemCompressed_RGB12_v2<Decoder>::read(U8* item)
 {
   U8 corr;
   I32 diff = 0;
@@ -530,7 +544,8 @@ inline void LASreadItemCompressed_RGB12_v2::read(U8* item)
 ===============================================================================
 */
 
-LASreadItemCompressed_BYTE_v2::LASreadItemCompressed_BYTE_v2(ArithmeticDecoder* dec, U32 number)
+template <class Decoder>
+LASreadItemCompressed_BYTE_v2<Decoder>::LASreadItemCompressed_BYTE_v2(Decoder* dec, U32 number)
 {
   U32 i;
 
@@ -551,7 +566,8 @@ LASreadItemCompressed_BYTE_v2::LASreadItemCompressed_BYTE_v2(ArithmeticDecoder*
   last_item = new U8[number];
 }
 
-LASreadItemCompressed_BYTE_v2::~LASreadItemCompressed_BYTE_v2()
+template <class Decoder>
+LASreadItemCompressed_BYTE_v2<Decoder>::~LASreadItemCompressed_BYTE_v2()
 {
   U32 i;
   for (i = 0; i < number; i++)
@@ -562,7 +578,8 @@ LASreadItemCompressed_BYTE_v2::~LASreadItemCompressed_BYTE_v2()
   delete [] last_item;
 }
 
-BOOL LASreadItemCompressed_BYTE_v2::init(const U8* item)
+template <class Decoder>
+BOOL LASreadItemCompressed_BYTE_v2<Decoder>::init(const U8* item)
 {
   U32 i;
   /* init state */
@@ -578,7 +595,8 @@ BOOL LASreadItemCompressed_BYTE_v2::init(const U8* item)
   return TRUE;
 }
 
-inline void LASreadItemCompressed_BYTE_v2::read(U8* item)
+template <class Decoder>
+inline void LASreadItemCompressed_BYTE_v2<Decoder>::read(U8* item)
 {
   U32 i;
   I32 value;
@@ -589,3 +607,14 @@ inline void LASreadItemCompressed_BYTE_v2::read(U8* item)
   }
   memcpy(last_item, item, number);
 }
+
+// the coders that the items are compiled for
+
+template class LASreadItemCompressed_POINT10_v2<ArithmeticDecoder>;
+template class LASreadItemCompressed_POINT10_v2<RANSDecoder>;
+template class LASreadItemCompressed_GPSTIME11_v2<ArithmeticDecoder>;
+template class LASreadItemCompressed_GPSTIME11_v2<RANSDecoder>;
+template class LASreadItemCompressed_RGB12_v2<ArithmeticDecoder>;
+template class LASreadItemCompressed_RGB12_v2<RANSDecoder>;
+template class LASreadItemCompressed_BYTE_v2<ArithmeticDecoder>;
+template class LASreadItemCompressed_BYTE_v2<RANSDecoder>;
@@ -24,6 +24,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- templated on the entropy decoder to also support rANS
     6 September 2014 -- removed inheritance of EntropyEncoder and EntropyDecoder
     5 March 2011 -- created first night in ibiza to improve the RGB compressor
   
@@ -33,16 +34,17 @@
 #define LAS_READ_ITEM_COMPRESSED_V2_HPP
 
 #include "lasreaditem.hpp"
-#include "arithmeticdecoder.hpp"
+#include "entropydecoder.hpp"
 #include "integercompressor.hpp"
 
 #include "laszip_common_v2.hpp"
 
+template <class Decoder>
 class LASreadItemCompressed_POINT10_v2 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_POINT10_v2(ArithmeticDecoder* dec);
+  LASreadItemCompressed_POINT10_v2(Decoder* dec);
 
   BOOL init(const U8* item);
   void read(U8* item);
@@ -50,7 +52,7 @@ public:
   ~LASreadItemCompressed_POINT10_v2();
 
 private:
-  ArithmeticDecoder* dec;
+  Decoder* dec;
   U8 last_item[20];
   U16 last_intensity[16];
   StreamingMedian5 last_x_diff_median5[16];
@@ -58,22 +60,23 @@ private:
   I32 last_height[8];
 
   ArithmeticModel* m_changed_values;
-  IntegerCompressor* ic_intensity;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_intensity;
   ArithmeticModel* m_scan_angle_rank[2];
-  IntegerCompressor* ic_point_source_ID;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_point_source_ID;
   ArithmeticModel* m_bit_byte[256];
   ArithmeticModel* m_classification[256];
   ArithmeticModel* m_user_data[256];
-  IntegerCompressor* ic_dx;
-  IntegerCompressor* ic_dy;
-  IntegerCompressor* ic_z;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_dx;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_dy;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_z;
 };
 
+template <class Decoder>
 class LASreadItemCompressed_GPSTIME11_v2 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_GPSTIME11_v2(ArithmeticDecoder* dec);
+  LASreadItemCompressed_GPSTIME11_v2(Decoder* dec);
 
   BOOL init(const U8* item);
   void read(U8* item);
@@ -81,7 +84,7 @@ public:
   ~LASreadItemCompressed_GPSTIME11_v2();
 
 private:
-  ArithmeticDecoder* dec;
+  Decoder* dec;
   U32 last, next;
   U64I64F64 last_gpstime[4];
   I32 last_gpstime_diff[4];
@@ -89,14 +92,15 @@ private:
 
   ArithmeticModel* m_gpstime_multi;
   ArithmeticModel* m_gpstime_0diff;
-  IntegerCompressor* ic_gpstime;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_gpstime;
 };
 
+template <class Decoder>
 class LASreadItemCompressed_RGB12_v2 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_RGB12_v2(ArithmeticDecoder* dec);
+  LASreadItemCompressed_RGB12_v2(Decoder* dec);
 
   BOOL init(const U8* item);
   void read(U8* item);
@@ -104,7 +108,7 @@ public:
   ~LASreadItemCompressed_RGB12_v2();
 
 private:
-  ArithmeticDecoder* dec;
+  Decoder* dec;
   U16 last_item[3];
 
   ArithmeticModel* m_byte_used;
@@ -116,11 +120,12 @@ private:
   ArithmeticModel* m_rgb_diff_5;
 };
 
+template <class Decoder>
 class LASreadItemCompressed_BYTE_v2 : public LASreadItemCompressed
 {
 public:
 
-  LASreadItemCompressed_BYTE_v2(ArithmeticDecoder* dec, U32 number);
+  LASreadItemCompressed_BYTE_v2(Decoder* dec, U32 number);
 
   BOOL init(const U8* item);
   void read(U8* item);
@@ -128,7 +133,7 @@ public:
   ~LASreadItemCompressed_BYTE_v2();
 
 private:
-  ArithmeticDecoder* dec;
+  Decoder* dec;
   U32 number;
   U8* last_item;
 
@@ -0,0 +1,219 @@
+/*
+===============================================================================
+
+  FILE:  lasreaditemcompressed_v3.cpp
+  
+  CONTENTS:
+  
+    see corresponding header file
+  
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  
+  CHANGE HISTORY:
+  
+    see corresponding header file
+  
+===============================================================================
+*/
+
+#include "lasreaditemcompressed_v3.hpp"
+#include "arithmeticdecoder.hpp"
+#include "ransdecoder.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+/*
+===============================================================================
+                       LASreadItemCompressed_POINT10_v3
+===============================================================================
+*/
+
+struct LASpoint10
+{
+  I32 x;
+  I32 y;
+  I32 z;
+  U16 intensity;
+  U8 return_number : 3;
+  U8 number_of_returns_of_given_pulse : 3;
+  U8 scan_direction_flag : 1;
+  U8 edge_of_flight_line : 1;
+  U8 classification;
+  I8 scan_angle_rank;
+  U8 user_data;
+  U16 point_source_ID;
+};
+
+template <class Decoder>
+LASreadItemCompressed_POINT10_v3<Decoder>::LASreadItemCompressed_POINT10_v3(Decoder* dec)
+{
+  /* set decoder */
+  assert(dec);
+  this->dec = dec;
+
+  /* create models and integer compressors */
+  m_changed_values = dec->createSymbolModel(64);
+  ic_intensity = new IntegerCoder<EntropyEncoder, Decoder>(dec, 16, 1, 4);
+  m_scan_angle_rank = dec->createSymbolModel(256);
+  ic_point_source_ID = new IntegerCoder<EntropyEncoder, Decoder>(dec, 16, 1, 4);
+  m_bit_byte = dec->createSymbolModel(256);
+  m_classification = dec->createSymbolModel(256);
+  m_user_data = dec->createSymbolModel(256);
+  ic_dx = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 2, 4);  // 32 bits, 2 contexts, 4 high bits
+  ic_dy = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 2, 4);  // 32 bits, 2 contexts, 4 high bits
+  ic_z = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 2, 4);   // 32 bits, 2 contexts, 4 high bits
+}
+
+template <class Decoder>
+LASreadItemCompressed_POINT10_v3<Decoder>::~LASreadItemCompressed_POINT10_v3()
+{
+  dec->destroySymbolModel(m_changed_values);
+  delete ic_intensity;
+  dec->destroySymbolModel(m_scan_angle_rank);
+  delete ic_point_source_ID;
+  dec->destroySymbolModel(m_bit_byte);
+  dec->destroySymbolModel(m_classification);
+  dec->destroySymbolModel(m_user_data);
+  delete ic_dx;
+  delete ic_dy;
+  delete ic_z;
+}
+
+template <class Decoder>
+BOOL LASreadItemCompressed_POINT10_v3<Decoder>::init(const U8* item)
+{
+  U32 i;
+
+  /* init state */
+  for (i=0; i < 16; i++)
+  {
+    last_x_diff[i] = 0;
+    last_y_diff[i] = 0;
+    last_intensity[i] = 0;
+    last_height[i/2] = 0;
+  }
+
+  /* init models and integer compressors */
+  dec->initSymbolModel(m_changed_values);
+  ic_intensity->initDecompressor();
+  dec->initSymbolModel(m_scan_angle_rank);
+  ic_point_source_ID->initDecompressor();
+  dec->initSymbolModel(m_bit_byte);
+  dec->initSymbolModel(m_classification);
+  dec->initSymbolModel(m_user_data);
+  ic_dx->initDecompressor();
+  ic_dy->initDecompressor();
+  ic_z->initDecompressor();
+
+  /* init last item */
+  memcpy(last_item, item, 20);
+
+  /* but set intensity to zero */ 
+  last_item[12] = 0;
+  last_item[13] = 0;
+
+  return TRUE;
+}
+
+template <class Decoder>
+inline void LASreadItemCompressed_POINT10_v3<Decoder>::read(U8* item)
+{
+  U32 r, n, m, l;
+  I32 diff;
+
+  // decompress which other values have changed
+  I32 changed_values = dec->decodeSymbol(m_changed_values);
+
+  if (changed_values)
+  {
+    // decompress the edge_of_flight_line, scan_direction_flag, ... if it has changed
+    if (changed_values & 32)
+    {
+      last_item[14] = (U8)dec->decodeSymbol(m_bit_byte);
+    }
+
+    r = ((LASpoint10*)last_item)->return_number;
+    n = ((LASpoint10*)last_item)->number_of_returns_of_given_pulse;
+    m = number_return_map[n][r];
+    l = number_return_level[n][r];
+
+    // decompress the intensity if it has changed
+    if (changed_values & 16)
+    {
+      ((LASpoint10*)last_item)->intensity = (U16)ic_intensity->decompress(last_intensity[m]);
+      last_intensity[m] = ((LASpoint10*)last_item)->intensity;
+    }
+    else
+    {
+      ((LASpoint10*)last_item)->intensity = last_intensity[m];
+    }
+
+    // decompress the classification ... if it has changed
+    if (changed_values & 8)
+    {
+      last_item[15] = (U8)dec->decodeSymbol(m_classification);
+    }
+    
+    // decompress the scan_angle_rank ... if it has changed
+    if (changed_values & 4)
+    {
+      I32 val = dec->decodeSymbol(m_scan_angle_rank);
+      last_item[16] = U8_FOLD(val + last_item[16]);
+    }
+
+    // decompress the user_data ... if it has changed
+    if (changed_values & 2)
+    {
+      last_item[17] = (U8)dec->decodeSymbol(m_user_data);
+    }
+
+    // decompress the point_source_ID ... if it has changed
+    if (changed_values & 1)
+    {
+      ((LASpoint10*)last_item)->point_source_ID = (U16)ic_point_source_ID->decompress(((LASpoint10*)last_item)->point_source_ID);
+    }
+  }
+  else
+  {
+    r = ((LASpoint10*)last_item)->return_number;
+    n = ((LASpoint10*)last_item)->number_of_returns_of_given_pulse;
+    m = number_return_map[n][r];
+    l = number_return_level[n][r];
+  }
+
+  // decompress x coordinate
+  diff = ic_dx->decompress(last_x_diff[m], n==1);
+  ((LASpoint10*)last_item)->x += diff;
+  last_x_diff[m] = diff;
+
+  // decompress y coordinate
+  diff = ic_dy->decompress(last_y_diff[m], n==1);
+  ((LASpoint10*)last_item)->y += diff;
+  last_y_diff[m] = diff;
+
+  // decompress z coordinate
+  ((LASpoint10*)last_item)->z = ic_z->decompress(last_height[l], n==1);
+  last_height[l] = ((LASpoint10*)last_item)->z;
+
+  // copy the last point
+  memcpy(item, last_item, 20);
+}
+
+// the coders that the items are compiled for
+
+template class LASreadItemCompressed_POINT10_v3<ArithmeticDecoder>;
+template class LASreadItemCompressed_POINT10_v3<RANSDecoder>;
@@ -0,0 +1,79 @@
+/*
+===============================================================================
+
+  FILE:  lasreaditemcompressed_v3.hpp
+  
+  CONTENTS:
+  
+    Implementation of LASitemReadCompressed for the "fast" profile (version
+    3) of POINT10. All other items have no version 3 and keep using version 2.
+    It uses fewer contexts and cheaper predictors than version 2: one model
+    each for the bit byte, the classification, the user data, and the scan
+    angle rank instead of one per previous value, the last difference instead
+    of the median of the last five differences to predict x and y, and only
+    the upper 4 instead of 8 bits of large correctors are entropy coded. This
+    gives up a few percent of compression for faster decompression.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  
+  CHANGE HISTORY:
+  
+    18 October 2026 -- created for the speed-oriented compression profiles
+
+===============================================================================
+*/
+#ifndef LAS_READ_ITEM_COMPRESSED_V3_HPP
+#define LAS_READ_ITEM_COMPRESSED_V3_HPP
+
+#include "lasreaditem.hpp"
+#include "entropydecoder.hpp"
+#include "integercompressor.hpp"
+
+#include "laszip_common_v2.hpp"
+
+template <class Decoder>
+class LASreadItemCompressed_POINT10_v3 : public LASreadItemCompressed
+{
+public:
+
+  LASreadItemCompressed_POINT10_v3(Decoder* dec);
+
+  BOOL init(const U8* item);
+  void read(U8* item);
+
+  ~LASreadItemCompressed_POINT10_v3();
+
+private:
+  Decoder* dec;
+  U8 last_item[20];
+  U16 last_intensity[16];
+  I32 last_x_diff[16];
+  I32 last_y_diff[16];
+  I32 last_height[8];
+
+  ArithmeticModel* m_changed_values;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_intensity;
+  ArithmeticModel* m_scan_angle_rank;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_point_source_ID;
+  ArithmeticModel* m_bit_byte;
+  ArithmeticModel* m_classification;
+  ArithmeticModel* m_user_data;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_dx;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_dy;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_z;
+};
+
+#endif
@@ -0,0 +1,258 @@
+/*
+===============================================================================
+
+  FILE:  lasreaditemcompressed_v4.cpp
+  
+  CONTENTS:
+  
+    see corresponding header file
+  
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  
+  CHANGE HISTORY:
+  
+    see corresponding header file
+  
+===============================================================================
+*/
+
+#include "lasreaditemcompressed_v4.hpp"
+#include "arithmeticdecoder.hpp"
+#include "ransdecoder.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+/*
+===============================================================================
+                       LASreadItemCompressed_POINT10_v4
+===============================================================================
+*/
+
+struct LASpoint10
+{
+  I32 x;
+  I32 y;
+  I32 z;
+  U16 intensity;
+  U8 return_number : 3;
+  U8 number_of_returns_of_given_pulse : 3;
+  U8 scan_direction_flag : 1;
+  U8 edge_of_flight_line : 1;
+  U8 classification;
+  I8 scan_angle_rank;
+  U8 user_data;
+  U16 point_source_ID;
+};
+
+template <class Decoder>
+LASreadItemCompressed_POINT10_v4<Decoder>::LASreadItemCompressed_POINT10_v4(Decoder* dec)
+{
+  U32 i;
+
+  /* set decoder */
+  assert(dec);
+  this->dec = dec;
+
+  /* create models and integer compressors */
+  m_changed_values = dec->createSymbolModel(64);
+  ic_intensity = new IntegerCoder<EntropyEncoder, Decoder>(dec, 16, 16);
+  m_scan_angle_rank[0] = dec->createSymbolModel(256);
+  m_scan_angle_rank[1] = dec->createSymbolModel(256);
+  ic_point_source_ID = new IntegerCoder<EntropyEncoder, Decoder>(dec, 16);
+  for (i = 0; i < 256; i++)
+  {
+    m_bit_byte[i] = 0;
+    m_classification[i] = 0;
+    m_user_data[i] = 0;
+  }
+  ic_dx = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 22); // 32 bits, 22 contexts
+  ic_dy = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 22); // 32 bits, 22 contexts
+  ic_z = new IntegerCoder<EntropyEncoder, Decoder>(dec, 32, 20);  // 32 bits, 20 contexts
+}
+
+template <class Decoder>
+LASreadItemCompressed_POINT10_v4<Decoder>::~LASreadItemCompressed_POINT10_v4()
+{
+  U32 i;
+
+  dec->destroySymbolModel(m_changed_values);
+  delete ic_intensity;
+  dec->destroySymbolModel(m_scan_angle_rank[0]);
+  dec->destroySymbolModel(m_scan_angle_rank[1]);
+  delete ic_point_source_ID;
+  for (i = 0; i < 256; i++)
+  {
+    if (m_bit_byte[i]) dec->destroySymbolModel(m_bit_byte[i]);
+    if (m_classification[i]) dec->destroySymbolModel(m_classification[i]);
+    if (m_user_data[i]) dec->destroySymbolModel(m_user_data[i]);
+  }
+  delete ic_dx;
+  delete ic_dy;
+  delete ic_z;
+}
+
+template <class Decoder>
+BOOL LASreadItemCompressed_POINT10_v4<Decoder>::init(const U8* item)
+{
+  U32 i;
+
+  /* init state */
+  for (i=0; i < 16; i++)
+  {
+    last_x_diff_median5[i].init();
+    last_y_diff_median5[i].init();
+    last_k_x[i] = 0;
+    last_intensity[i] = 0;
+    last_height[i/2] = 0;
+  }
+
+  /* init models and integer compressors */
+  dec->initSymbolModel(m_changed_values);
+  ic_intensity->initDecompressor();
+  dec->initSymbolModel(m_scan_angle_rank[0]);
+  dec->initSymbolModel(m_scan_angle_rank[1]);
+  ic_point_source_ID->initDecompressor();
+  for (i = 0; i < 256; i++)
+  {
+    if (m_bit_byte[i]) dec->initSymbolModel(m_bit_byte[i]);
+    if (m_classification[i]) dec->initSymbolModel(m_classification[i]);
+    if (m_user_data[i]) dec->initSymbolModel(m_user_data[i]);
+  }
+  ic_dx->initDecompressor();
+  ic_dy->initDecompressor();
+  ic_z->initDecompressor();
+
+  /* init last item */
+  memcpy(last_item, item, 20);
+
+  /* but set intensity to zero */ 
+  last_item[12] = 0;
+  last_item[13] = 0;
+
+  return TRUE;
+}
+
+template <class Decoder>
+inline void LASreadItemCompressed_POINT10_v4<Decoder>::read(U8* item)
+{
+  U32 r, n, m, l;
+  U32 k_bits;
+  I32 median, diff;
+
+  // decompress which other values have changed
+  I32 changed_values = dec->decodeSymbol(m_changed_values);
+
+  if (changed_values)
+  {
+    // decompress the edge_of_flight_line, scan_direction_flag, ... if it has changed
+    if (changed_values & 32)
+    {
+      if (m_bit_byte[last_item[14]] == 0)
+      {
+        m_bit_byte[last_item[14]] = dec->createSymbolModel(256);
+        dec->initSymbolModel(m_bit_byte[last_item[14]]);
+      }
+      last_item[14] = (U8)dec->decodeSymbol(m_bit_byte[last_item[14]]);
+    }
+
+    r = ((LASpoint10*)last_item)->return_number;
+    n = ((LASpoint10*)last_item)->number_of_returns_of_given_pulse;
+    m = number_return_map[n][r];
+    l = number_return_level[n][r];
+
+    // decompress the intensity if it has changed
+    if (changed_values & 16)
+    {
+      ((LASpoint10*)last_item)->intensity = (U16)ic_intensity->decompress(last_intensity[m], m);
+      last_intensity[m] = ((LASpoint10*)last_item)->intensity;
+    }
+    else
+    {
+      ((LASpoint10*)last_item)->intensity = last_intensity[m];
+    }
+
+    // decompress the classification ... if it has changed
+    if (changed_values & 8)
+    {
+      if (m_classification[last_item[15]] == 0)
+      {
+        m_classification[last_item[15]] = dec->createSymbolModel(256);
+        dec->initSymbolModel(m_classification[last_item[15]]);
+      }
+      last_item[15] = (U8)dec->decodeSymbol(m_classification[last_item[15]]);
+    }
+    
+    // decompress the scan_angle_rank ... if it has changed
+    if (changed_values & 4)
+    {
+      I32 val = dec->decodeSymbol(m_scan_angle_rank[((LASpoint10*)last_item)->scan_direction_flag]);
+      last_item[16] = U8_FOLD(val + last_item[16]);
+    }
+
+    // decompress the user_data ... if it has changed
+    if (changed_values & 2)
+    {
+      if (m_user_data[last_item[17]] == 0)
+      {
+        m_user_data[last_item[17]] = dec->createSymbolModel(256);
+        dec->initSymbolModel(m_user_data[last_item[17]]);
+      }
+      last_item[17] = (U8)dec->decodeSymbol(m_user_data[last_item[17]]);
+    }
+
+    // decompress the point_source_ID ... if it has changed
+    if (changed_values & 1)
+    {
+      ((LASpoint10*)last_item)->point_source_ID = (U16)ic_point_source_ID->decompress(((LASpoint10*)last_item)->point_source_ID);
+    }
+  }
+  else
+  {
+    r = ((LASpoint10*)last_item)->return_number;
+    n = ((LASpoint10*)last_item)->number_of_returns_of_given_pulse;
+    m = number_return_map[n][r];
+    l = number_return_level[n][r];
+  }
+
+  // decompress x coordinate
+  k_bits = last_k_x[m];
+  median = last_x_diff_median5[m].get();
+  diff = ic_dx->decompress(median, (n==1) + ( k_bits < 20 ? U32_ZERO_BIT_0(k_bits) : 20 ));
+  ((LASpoint10*)last_item)->x += diff;
+  last_x_diff_median5[m].add(diff);
+  last_k_x[m] = ic_dx->getK();
+
+  // decompress y coordinate
+  median = last_y_diff_median5[m].get();
+  k_bits = ic_dx->getK();
+  diff = ic_dy->decompress(median, (n==1) + ( k_bits < 20 ? U32_ZERO_BIT_0(k_bits) : 20 ));
+  ((LASpoint10*)last_item)->y += diff;
+  last_y_diff_median5[m].add(diff);
+
+  // decompress z coordinate
+  k_bits = (ic_dx->getK() + ic_dy->getK()) / 2;
+  ((LASpoint10*)last_item)->z = ic_z->decompress(last_height[l], (n==1) + (k_bits < 18 ? U32_ZERO_BIT_0(k_bits) : 18));
+  last_height[l] = ((LASpoint10*)last_item)->z;
+
+  // copy the last point
+  memcpy(item, last_item, 20);
+}
+
+// the coders that the items are compiled for
+
+template class LASreadItemCompressed_POINT10_v4<ArithmeticDecoder>;
+template class LASreadItemCompressed_POINT10_v4<RANSDecoder>;
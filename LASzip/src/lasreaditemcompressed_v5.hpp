@@ -0,0 +1,80 @@
+/*
+===============================================================================
+
+  FILE:  lasreaditemcompressed_v5.hpp
+  
+  CONTENTS:
+  
+    Implementation of LASitemReadCompressed for the scan line aware version 5
+    of POINT10. All other items have no version 5 and keep using version 2.
+    It is version 2 except for z, which is predicted either from the last
+    height of the same return level or from the point of the previous scan
+    line nearest in x and y (see ScanLine), whichever has recently been the
+    better predictor for that return level. The choice is a context of the
+    z corrector so that both predictors keep their own statistics.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  
+  CHANGE HISTORY:
+  
+    18 October 2026 -- created for scan line aware compression
+
+===============================================================================
+*/
+#ifndef LAS_READ_ITEM_COMPRESSED_V5_HPP
+#define LAS_READ_ITEM_COMPRESSED_V5_HPP
+
+#include "lasreaditem.hpp"
+#include "entropydecoder.hpp"
+#include "integercompressor.hpp"
+
+#include "laszip_common_v2.hpp"
+#include "laszip_common_v5.hpp"
+
+template <class Decoder>
+class LASreadItemCompressed_POINT10_v5 : public LASreadItemCompressed
+{
+public:
+
+  LASreadItemCompressed_POINT10_v5(Decoder* dec);
+
+  BOOL init(const U8* item);
+  void read(U8* item);
+
+  ~LASreadItemCompressed_POINT10_v5();
+
+private:
+  Decoder* dec;
+  U8 last_item[20];
+  U16 last_intensity[16];
+  StreamingMedian5 last_x_diff_median5[16];
+  StreamingMedian5 last_y_diff_median5[16];
+  ScanLine scan_line;
+  I32 last_height[8];
+
+  ArithmeticModel* m_changed_values;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_intensity;
+  ArithmeticModel* m_scan_angle_rank[2];
+  IntegerCoder<EntropyEncoder, Decoder>* ic_point_source_ID;
+  ArithmeticModel* m_bit_byte[256];
+  ArithmeticModel* m_classification[256];
+  ArithmeticModel* m_user_data[256];
+  IntegerCoder<EntropyEncoder, Decoder>* ic_dx;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_dy;
+  IntegerCoder<EntropyEncoder, Decoder>* ic_z;
+};
+
+#endif
@@ -32,14 +32,72 @@
 #include "lasreadpoint.hpp"
 
 #include "arithmeticdecoder.hpp"
+#include "ransdecoder.hpp"
 #include "lasreaditemraw.hpp"
 #include "lasreaditemcompressed_v1.hpp"
 #include "lasreaditemcompressed_v2.hpp"
+#include "lasreaditemcompressed_v3.hpp"
+#include "lasreaditemcompressed_v4.hpp"
+#include "lasreaditemcompressed_v5.hpp"
+#include "lastrace.hpp"
+#include "lascounters.hpp"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// the compressed reader of an item for the entropy decoder, or 0 if the item
+// or its version is not supported
+
+template <class Decoder>
+static LASreadItem* create_reader_compressed(const LASitem* item, Decoder* dec)
+{
+  switch (item->type)
+  {
+  case LASitem::POINT10:
+    if (item->version == 1)
+      return new LASreadItemCompressed_POINT10_v1<Decoder>(dec);
+    else if (item->version == 2)
+      return new LASreadItemCompressed_POINT10_v2<Decoder>(dec);
+    else if (item->version == 3)
+      return new LASreadItemCompressed_POINT10_v3<Decoder>(dec);
+    else if (item->version == 4)
+      return new LASreadItemCompressed_POINT10_v4<Decoder>(dec);
+    else if (item->version == 5)
+      return new LASreadItemCompressed_POINT10_v5<Decoder>(dec);
+    else
+      return 0;
+  case LASitem::GPSTIME11:
+    if (item->version == 1)
+      return new LASreadItemCompressed_GPSTIME11_v1<Decoder>(dec);
+    else if (item->version == 2)
+      return new LASreadItemCompressed_GPSTIME11_v2<Decoder>(dec);
+    else
+      return 0;
+  case LASitem::RGB12:
+    if (item->version == 1)
+      return new LASreadItemCompressed_RGB12_v1<Decoder>(dec);
+    else if (item->version == 2)
+      return new LASreadItemCompressed_RGB12_v2<Decoder>(dec);
+    else
+      return 0;
+  case LASitem::WAVEPACKET13:
+    if (item->version == 1)
+      return new LASreadItemCompressed_WAVEPACKET13_v1<Decoder>(dec);
+    else
+      return 0;
+  case LASitem::BYTE:
+    if (item->version == 1)
+      return new LASreadItemCompressed_BYTE_v1<Decoder>(dec, item->size);
+    else if (item->version == 2)
+      return new LASreadItemCompressed_BYTE_v2<Decoder>(dec, item->size);
+    else
+      return 0;
+  default:
+    return 0;
+  }
+}
+
 LASreadPoint::LASreadPoint()
 {
   point_size = 0;
@@ -57,6 +115,11 @@ LASreadPoint::LASreadPoint()
   tabled_chunks = 0;
   chunk_totals = 0;
   chunk_starts = 0;
+  chunk_trace_start = 0;
+  // used for prefetching
+  prefetch_intervals = 0;
+  prefetch_starts = 0;
+  prefetch_ends = 0;
   // used for seeking
   point_start = 0;
   seek_point = 0;
@@ -89,6 +152,9 @@ BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* lasz
     case LASZIP_CODER_ARITHMETIC:
       dec = new ArithmeticDecoder();
       break;
+    case LASZIP_CODER_RANS:
+      dec = new RANSDecoder();
+      break;
     default:
       // entropy decoder not supported
       return FALSE;
@@ -168,51 +234,14 @@ BOOL LASreadPoint::setup(U32 num_items, const LASitem* items, const LASzip* lasz
     if (!seek_point[0]) return FALSE;
     for (i = 0; i < num_readers; i++)
     {
-      switch (items[i].type)
-      {
-      case LASitem::POINT10:
-        if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_POINT10_v1(dec);
-        else if (items[i].version == 2)
-          readers_compressed[i] = new LASreadItemCompressed_POINT10_v2(dec);
-        else
-          return FALSE;
-        break;
-      case LASitem::GPSTIME11:
-        if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_GPSTIME11_v1(dec);
-        else if (items[i].version == 2)
-          readers_compressed[i] = new LASreadItemCompressed_GPSTIME11_v2(dec);
-        else
-          return FALSE;
-        break;
-      case LASitem::RGB12:
-        if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_RGB12_v1(dec);
-        else if (items[i].version == 2)
-          readers_compressed[i] = new LASreadItemCompressed_RGB12_v2(dec);
-        else
-          return FALSE;
-        break;
-      case LASitem::WAVEPACKET13:
-        if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_WAVEPACKET13_v1(dec);
-        else
-          return FALSE;
-        break;
-      case LASitem::BYTE:
-        if (items[i].version == 1)
-          readers_compressed[i] = new LASreadItemCompressed_BYTE_v1(dec, items[i].size);
-        else if (items[i].version == 2)
-          readers_compressed[i] = new LASreadItemCompressed_BYTE_v2(dec, items[i].size);
-        else
-          return FALSE;
-        break;
-      default:
-        return FALSE;
-      }
+      if (laszip->coder == LASZIP_CODER_RANS)
+        readers_compressed[i] = create_reader_compressed(&items[i], (RANSDecoder*)dec);
+      else
+        readers_compressed[i] = create_reader_compressed(&items[i], (ArithmeticDecoder*)dec);
+      if (readers_compressed[i] == 0) return FALSE;
       if (i) seek_point[i] = seek_point[i-1]+items[i-1].size;
     }
+    LAScounters::set_items(LAS_COUNTERS_DECODE, num_items, items);
     if (laszip->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED)
     {
       if (laszip->chunk_size) chunk_size = laszip->chunk_size;
@@ -248,10 +277,11 @@ BOOL LASreadPoint::init(ByteStreamIn* instream)
   return TRUE;
 }
 
-BOOL LASreadPoint::seek(const U32 current, const U32 target)
+BOOL LASreadPoint::seek(const I64 current, const I64 target)
 {
+  LAStraceScope scope("seek", "io", target);
   if (!instream->isSeekable()) return FALSE;
-  U32 delta = 0;
+  I64 delta = 0;
   if (dec)
   {
     if (point_start == 0)
@@ -265,12 +295,12 @@ BOOL LASreadPoint::seek(const U32 current, const U32 target)
       if (chunk_totals)
       {
         target_chunk = search_chunk_table(target, 0, number_chunks);
-        chunk_size = chunk_totals[target_chunk+1]-chunk_totals[target_chunk];
+        chunk_size = (U32)(chunk_totals[target_chunk+1]-chunk_totals[target_chunk]);
         delta = target - chunk_totals[target_chunk];
       }
       else
       {
-        target_chunk = target/chunk_size;
+        target_chunk = (U32)(target/chunk_size);
         delta = target%chunk_size;
       }
       if (target_chunk >= tabled_chunks)
@@ -283,7 +313,7 @@ BOOL LASreadPoint::seek(const U32 current, const U32 target)
           init_dec();
           chunk_count = 0;
         }
-        delta += (chunk_size*(target_chunk-current_chunk) - chunk_count);
+        delta += (((I64)chunk_size)*(target_chunk-current_chunk) - chunk_count);
       }
       else if (current_chunk != target_chunk || current > target)
       {
@@ -325,6 +355,134 @@ BOOL LASreadPoint::seek(const U32 current, const U32 target)
   return TRUE;
 }
 
+BOOL LASreadPoint::get_chunk_table(U32* number, const I64** starts, const I64** totals, U32* size)
+{
+  if ((dec == 0) || (instream == 0)) return FALSE;
+  if (point_start == 0)
+  {
+    if (!init_dec()) return FALSE;
+    chunk_count = 0;
+  }
+  // an incomplete table only has the chunks that were written before the interruption
+  if ((chunk_starts == 0) || (tabled_chunks < 2)) return FALSE;
+  *number = tabled_chunks - 1;
+  *starts = chunk_starts;
+  *totals = chunk_totals;
+  *size = chunk_size;
+  return TRUE;
+}
+
+BOOL LASreadPoint::prefetch(const U32 number_intervals, const I64* starts, const I64* ends)
+{
+  if (!instream || !instream->isSeekable()) return FALSE;
+  U32 i;
+  if (dec == 0)
+  {
+    // uncompressed points are at fixed positions
+    I64* byte_starts = (I64*)malloc(sizeof(I64)*(number_intervals ? number_intervals : 1));
+    I64* byte_ends = (I64*)malloc(sizeof(I64)*(number_intervals ? number_intervals : 1));
+    BOOL success = FALSE;
+    if (byte_starts && byte_ends)
+    {
+      for (i = 0; i < number_intervals; i++)
+      {
+        byte_starts[i] = point_start + ((I64)point_size)*starts[i];
+        byte_ends[i] = point_start + ((I64)point_size)*(ends[i]+1);
+      }
+      success = instream->prefetch(number_intervals, byte_starts, byte_ends);
+    }
+    if (byte_starts) free(byte_starts);
+    if (byte_ends) free(byte_ends);
+    return success;
+  }
+  // the chunks are only known once the chunk table was read
+  if (prefetch_starts) free(prefetch_starts);
+  if (prefetch_ends) free(prefetch_ends);
+  prefetch_starts = (I64*)malloc(sizeof(I64)*(number_intervals ? number_intervals : 1));
+  prefetch_ends = (I64*)malloc(sizeof(I64)*(number_intervals ? number_intervals : 1));
+  if ((prefetch_starts == 0) || (prefetch_ends == 0))
+  {
+    prefetch_intervals = 0;
+    return FALSE;
+  }
+  for (i = 0; i < number_intervals; i++)
+  {
+    prefetch_starts[i] = starts[i];
+    prefetch_ends[i] = ends[i];
+  }
+  prefetch_intervals = number_intervals;
+  if (chunk_starts) return prefetch_chunks();
+  return TRUE;
+}
+
+BOOL LASreadPoint::prefetch_chunks()
+{
+  U32 i, chunk, number = 0;
+  if (tabled_chunks < 2)
+  {
+    // without a chunk table the chunks are not known
+    free(prefetch_starts);
+    free(prefetch_ends);
+    prefetch_starts = prefetch_ends = 0;
+    prefetch_intervals = 0;
+    return FALSE;
+  }
+  U32* firsts = (U32*)malloc(sizeof(U32)*prefetch_intervals);
+  U32* lasts = (U32*)malloc(sizeof(U32)*prefetch_intervals);
+  I64* byte_starts = 0;
+  I64* byte_ends = 0;
+  BOOL success = FALSE;
+  if (firsts && lasts)
+  {
+    // find the first and the last chunk of every interval
+    I64 alloced = 0;
+    for (i = 0; i < prefetch_intervals; i++)
+    {
+      if (chunk_totals)
+      {
+        firsts[i] = search_chunk_table(prefetch_starts[i], 0, number_chunks);
+        lasts[i] = search_chunk_table(prefetch_ends[i], 0, number_chunks);
+      }
+      else
+      {
+        firsts[i] = (U32)(prefetch_starts[i]/chunk_size);
+        lasts[i] = (U32)(prefetch_ends[i]/chunk_size);
+      }
+      if ((lasts[i]+1) >= tabled_chunks) lasts[i] = tabled_chunks - 2;
+      if (firsts[i] <= lasts[i]) alloced += (lasts[i] - firsts[i] + 1);
+    }
+    if (alloced && (alloced < U32_MAX))
+    {
+      byte_starts = (I64*)malloc(sizeof(I64)*alloced);
+      byte_ends = (I64*)malloc(sizeof(I64)*alloced);
+    }
+    if (byte_starts && byte_ends)
+    {
+      for (i = 0; i < prefetch_intervals; i++)
+      {
+        for (chunk = firsts[i]; chunk <= lasts[i]; chunk++)
+        {
+          // the intervals are sorted but neighbouring ones may share a chunk
+          if (number && (chunk_starts[chunk] <= byte_starts[number-1])) continue;
+          byte_starts[number] = chunk_starts[chunk];
+          byte_ends[number] = chunk_starts[chunk+1];
+          number++;
+        }
+      }
+      success = instream->prefetch(number, byte_starts, byte_ends);
+    }
+  }
+  if (firsts) free(firsts);
+  if (lasts) free(lasts);
+  if (byte_starts) free(byte_starts);
+  if (byte_ends) free(byte_ends);
+  free(prefetch_starts);
+  free(prefetch_ends);
+  prefetch_starts = prefetch_ends = 0;
+  prefetch_intervals = 0;
+  return success;
+}
+
 BOOL LASreadPoint::read(U8* const * point)
 {
   U32 i;
@@ -335,9 +493,13 @@ BOOL LASreadPoint::read(U8* const * point)
     {
       if (chunk_count == chunk_size)
       {
+        // the start of the first chunk also reads the chunk table and is not counted
+        U64 restart[LAS_COUNTERS_EVENTS];
+        BOOL counting = (point_start != 0) && LAScounters::is_enabled() && LAScounters::read(restart);
         if (point_start != 0)
         {
           dec->done();
+          if (LAStrace::is_enabled()) LAStrace::complete("decode chunk", "laz", chunk_trace_start, current_chunk);
           current_chunk++;
           // check integrity
           if (current_chunk < tabled_chunks)
@@ -364,14 +526,27 @@ BOOL LASreadPoint::read(U8* const * point)
         }
         else if (chunk_totals) // variable sized chunks?
         {
-          chunk_size = chunk_totals[current_chunk+1]-chunk_totals[current_chunk];
+          chunk_size = (U32)(chunk_totals[current_chunk+1]-chunk_totals[current_chunk]);
         }
         chunk_count = 0;
+        if (counting) LAScounters::add(LAS_COUNTERS_CHUNK_RESTART, restart);
       }
       chunk_count++;
 
       if (readers)
       {
+        if (LAScounters::is_sample(chunk_count))
+        {
+          // this point stands for all points of the sample interval
+          U64 start[LAS_COUNTERS_EVENTS];
+          for (i = 0; i < num_readers; i++)
+          {
+            BOOL counting = LAScounters::read(start);
+            readers[i]->read(point[i]);
+            if (counting) LAScounters::add(LAS_COUNTERS_DECODE + i, start, LAScounters::get_sample_interval());
+          }
+          return TRUE;
+        }
         for (i = 0; i < num_readers; i++)
         {
           readers[i]->read(point[i]);
@@ -379,6 +554,7 @@ BOOL LASreadPoint::read(U8* const * point)
       }
       else
       {
+        LAScountersScope restart(LAS_COUNTERS_CHUNK_RESTART);
         for (i = 0; i < num_readers; i++)
         {
           readers_raw[i]->read(point[i]);
@@ -438,6 +614,7 @@ BOOL LASreadPoint::check_end()
     if (dec)
     {
       dec->done();
+      if (LAStrace::is_enabled()) LAStrace::complete("decode chunk", "laz", chunk_trace_start, current_chunk);
       current_chunk++;
       // check integrity
       if (current_chunk < tabled_chunks)
@@ -474,17 +651,21 @@ BOOL LASreadPoint::init_dec()
       return FALSE;
     }
     current_chunk = 0;
-    if (chunk_totals) chunk_size = chunk_totals[1];
+    if (chunk_totals) chunk_size = (U32)chunk_totals[1];
+    if (prefetch_intervals) prefetch_chunks();
   }
 
   point_start = instream->tell();
   readers = 0;
+  chunk_trace_start = LAStrace::now();
 
   return TRUE;
 }
 
 BOOL LASreadPoint::read_chunk_table()
 {
+  LAStraceScope scope("read chunk table", "io");
+  LAScountersScope counters(LAS_COUNTERS_STREAM_IO);
   // read the 8 bytes that store the location of the chunk table
   I64 chunk_table_start_position;
   try { instream->get64bitsLE((U8*)&chunk_table_start_position); } catch(...)
@@ -559,7 +740,7 @@ BOOL LASreadPoint::read_chunk_table()
     chunk_starts = 0;
     if (chunk_size == U32_MAX)
     {
-      chunk_totals = new U32[number_chunks+1];
+      chunk_totals = new I64[number_chunks+1];
       if (chunk_totals == 0)
       {
         throw 1;
@@ -581,7 +762,8 @@ BOOL LASreadPoint::read_chunk_table()
       ic.initDecompressor();
       for (i = 1; i <= number_chunks; i++)
       {
-        if (chunk_size == U32_MAX) chunk_totals[i] = ic.decompress((i>1 ? chunk_totals[i-1] : 0), 0);
+        // the table stores 32 bit point counts per chunk whose sum may exceed 32 bits
+        if (chunk_size == U32_MAX) chunk_totals[i] = (U32)ic.decompress((i>1 ? (U32)(chunk_totals[i-1]) : 0), 0);
         chunk_starts[i] = ic.decompress((i>1 ? (U32)(chunk_starts[i-1]) : 0), 1);
         tabled_chunks++;
       }
@@ -641,7 +823,7 @@ BOOL LASreadPoint::read_chunk_table()
   return TRUE;
 }
 
-U32 LASreadPoint::search_chunk_table(const U32 index, const U32 lower, const U32 upper)
+U32 LASreadPoint::search_chunk_table(const I64 index, const U32 lower, const U32 upper)
 {
   if (lower + 1 == upper) return lower;
   U32 mid = (lower+upper)/2;
@@ -681,6 +863,9 @@ LASreadPoint::~LASreadPoint()
   if (chunk_totals) delete [] chunk_totals;
   if (chunk_starts) free(chunk_starts);
 
+  if (prefetch_starts) free(prefetch_starts);
+  if (prefetch_ends) free(prefetch_ends);
+
   if (seek_point)
   {
     delete [] seek_point[0];
@@ -24,6 +24,12 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- samples hardware counters per item coder with LAScounters
+    18 October 2026 -- records the decoding of every chunk and seeks with LAStrace
+    18 October 2026 -- get_chunk_table() for decoding chunks independently of this reader
+    18 October 2026 -- prefetch() passes the byte ranges of the needed chunks to the stream
+    18 October 2026 -- creates the rANS decoder for LASZIP_CODER_RANS
+    18 October 2026 -- 64 bit point indices for seek() and the chunk table
     6 September 2014 -- removed inheritance of EntropyEncoder and EntropyDecoder
     24 August 2014 -- delay read of chunk table until first read() or seek() is called
     6 October 2011 -- large file support & reading with missing chunk table
@@ -45,7 +51,7 @@
 #include "bytestreamin.hpp"
 
 class LASreadItem;
-class ArithmeticDecoder;
+class EntropyDecoder;
 
 class LASreadPoint
 {
@@ -57,11 +63,17 @@ public:
   BOOL setup(const U32 num_items, const LASitem* items, const LASzip* laszip=0);
 
   BOOL init(ByteStreamIn* instream);
-  BOOL seek(const U32 current, const U32 target);
+  BOOL seek(const I64 current, const I64 target);
+  // the points in [starts[i], ends[i]] (inclusive like LASindex intervals) will be read next
+  BOOL prefetch(const U32 number_intervals, const I64* starts, const I64* ends);
   BOOL read(U8* const * point);
   BOOL check_end();
   BOOL done();
 
+  // reads the chunk table (if not done yet) and returns it. chunk i spans the
+  // bytes [starts[i], starts[i+1]). totals is zero unless chunks vary in size
+  BOOL get_chunk_table(U32* number, const I64** starts, const I64** totals, U32* size);
+
   inline const CHAR* error() const { return last_error; };
   inline const CHAR* warning() const { return last_warning; };
 
@@ -71,7 +83,7 @@ private:
   LASreadItem** readers;
   LASreadItem** readers_raw;
   LASreadItem** readers_compressed;
-  ArithmeticDecoder* dec;
+  EntropyDecoder* dec;
   // used for chunking
   U32 chunk_size;
   U32 chunk_count;
@@ -79,10 +91,16 @@ private:
   U32 number_chunks;
   U32 tabled_chunks;
   I64* chunk_starts;
-  U32* chunk_totals;
+  I64* chunk_totals;
+  I64 chunk_trace_start;
   BOOL init_dec();
   BOOL read_chunk_table();
-  U32 search_chunk_table(const U32 index, const U32 lower, const U32 upper);
+  U32 search_chunk_table(const I64 index, const U32 lower, const U32 upper);
+  // used for prefetching
+  U32 prefetch_intervals;
+  I64* prefetch_starts;
+  I64* prefetch_ends;
+  BOOL prefetch_chunks();
   // used for seeking
   I64 point_start;
   U32 point_size;
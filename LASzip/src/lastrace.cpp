@@ -0,0 +1,274 @@
+/*
+===============================================================================
+
+  FILE:  lastrace.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+
+#include "lastrace.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define LAS_TRACE_THREAD __declspec(thread)
+#else
+#include <time.h>
+#include <pthread.h>
+#define LAS_TRACE_THREAD __thread
+#endif
+
+struct LAStraceEvent
+{
+  const CHAR* name;
+  const CHAR* category;
+  I64 start;
+  I64 duration;     // -1 for instant events
+  I64 arg;
+};
+
+struct LAStraceRing
+{
+  LAStraceEvent* events;
+  U32 capacity;
+  U32 thread;
+  I64 written;
+  LAStraceRing* next;
+};
+
+BOOL LAStrace::enabled = FALSE;
+
+static U32 trace_capacity = 0;
+static U32 trace_generation = 0;
+static U32 trace_threads = 0;
+static LAStraceRing* trace_rings = 0;
+static I64 trace_origin = 0;
+
+static LAS_TRACE_THREAD LAStraceRing* thread_ring = 0;
+static LAS_TRACE_THREAD U32 thread_generation = 0;
+
+#ifdef _WIN32
+static CRITICAL_SECTION trace_lock;
+static BOOL trace_lock_initialized = FALSE;
+static inline void trace_lock_acquire() { EnterCriticalSection(&trace_lock); }
+static inline void trace_lock_release() { LeaveCriticalSection(&trace_lock); }
+#else
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static inline void trace_lock_acquire() { pthread_mutex_lock(&trace_lock); }
+static inline void trace_lock_release() { pthread_mutex_unlock(&trace_lock); }
+#endif
+
+static I64 trace_clock()
+{
+#ifdef _WIN32
+  LARGE_INTEGER counter, frequency;
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&frequency);
+  return (I64)((F64)counter.QuadPart * 1.0e9 / (F64)frequency.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (I64)ts.tv_sec * 1000000000 + (I64)ts.tv_nsec;
+#endif
+}
+
+// the ring of the calling thread is created by its first event
+
+static LAStraceRing* trace_get_ring()
+{
+  if (thread_ring && (thread_generation == trace_generation)) return thread_ring;
+  LAStraceRing* ring = (LAStraceRing*)malloc(sizeof(LAStraceRing));
+  if (ring == 0) return 0;
+  ring->events = (LAStraceEvent*)malloc(sizeof(LAStraceEvent)*trace_capacity);
+  if (ring->events == 0)
+  {
+    free(ring);
+    return 0;
+  }
+  ring->capacity = trace_capacity;
+  ring->written = 0;
+  trace_lock_acquire();
+  ring->thread = trace_threads++;
+  ring->next = trace_rings;
+  trace_rings = ring;
+  trace_lock_release();
+  thread_ring = ring;
+  thread_generation = trace_generation;
+  return ring;
+}
+
+static inline void trace_record(const CHAR* name, const CHAR* category, const I64 start, const I64 duration, const I64 arg)
+{
+  LAStraceRing* ring = trace_get_ring();
+  if (ring == 0) return;
+  LAStraceEvent* event = ring->events + (ring->written % ring->capacity);
+  event->name = name;
+  event->category = category;
+  event->start = start;
+  event->duration = duration;
+  event->arg = arg;
+  ring->written++;
+}
+
+BOOL LAStrace::enable(const U32 capacity)
+{
+  if (capacity == 0) return FALSE;
+#ifdef _WIN32
+  if (!trace_lock_initialized)
+  {
+    InitializeCriticalSection(&trace_lock);
+    trace_lock_initialized = TRUE;
+  }
+#endif
+  disable();
+  trace_capacity = capacity;
+  trace_generation++;
+  trace_origin = trace_clock();
+  enabled = TRUE;
+  return TRUE;
+}
+
+I64 LAStrace::now()
+{
+  if (!enabled) return 0;
+  return trace_clock() - trace_origin;
+}
+
+void LAStrace::complete(const CHAR* name, const CHAR* category, const I64 start, const I64 arg)
+{
+  if (!enabled) return;
+  trace_record(name, category, start, now() - start, arg);
+}
+
+void LAStrace::instant(const CHAR* name, const CHAR* category, const I64 arg)
+{
+  if (!enabled) return;
+  trace_record(name, category, now(), -1, arg);
+}
+
+// appends to a growing string
+
+static BOOL trace_append(CHAR** json, I64* length, I64* alloced, const CHAR* text, const I64 size)
+{
+  if ((*length + size + 1) > *alloced)
+  {
+    I64 more = (*alloced ? 2 * *alloced : 65536);
+    while (more < (*length + size + 1)) more *= 2;
+    CHAR* bigger = (CHAR*)realloc(*json, (size_t)more);
+    if (bigger == 0) return FALSE;
+    *json = bigger;
+    *alloced = more;
+  }
+  memcpy(*json + *length, text, (size_t)size);
+  *length += size;
+  (*json)[*length] = '\0';
+  return TRUE;
+}
+
+I64 LAStrace::get_json(CHAR** json, const I32 pid)
+{
+  *json = 0;
+  I64 length = 0;
+  I64 alloced = 0;
+  CHAR entry[512];
+  trace_lock_acquire();
+  for (LAStraceRing* ring = trace_rings; ring; ring = ring->next)
+  {
+    I32 size = sprintf(entry, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", (length ? ",\012" : ""), pid, ring->thread, ring->thread);
+    if (!trace_append(json, &length, &alloced, entry, size)) break;
+    I64 first = (ring->written > ring->capacity ? ring->written - ring->capacity : 0);
+    for (I64 e = first; e < ring->written; e++)
+    {
+      const LAStraceEvent* event = ring->events + (e % ring->capacity);
+      if (event->duration >= 0)
+        size = sprintf(entry, ",\012{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", event->name, event->category, pid, ring->thread, event->start*0.001, event->duration*0.001);
+      else
+        size = sprintf(entry, ",\012{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f", event->name, event->category, pid, ring->thread, event->start*0.001);
+      if (event->arg != -1)
+      {
+#ifdef _WIN32
+        size += sprintf(entry + size, ",\"args\":{\"n\":%I64d}}", event->arg);
+#else
+        size += sprintf(entry + size, ",\"args\":{\"n\":%lld}}", event->arg);
+#endif
+      }
+      else
+      {
+        size += sprintf(entry + size, "}");
+      }
+      if (!trace_append(json, &length, &alloced, entry, size)) break;
+    }
+  }
+  trace_lock_release();
+  return length;
+}
+
+I64 LAStrace::get_number_events()
+{
+  I64 number = 0;
+  trace_lock_acquire();
+  for (LAStraceRing* ring = trace_rings; ring; ring = ring->next)
+  {
+    number += (ring->written > ring->capacity ? ring->capacity : ring->written);
+  }
+  trace_lock_release();
+  return number;
+}
+
+I64 LAStrace::get_number_dropped()
+{
+  I64 number = 0;
+  trace_lock_acquire();
+  for (LAStraceRing* ring = trace_rings; ring; ring = ring->next)
+  {
+    if (ring->written > ring->capacity) number += (ring->written - ring->capacity);
+  }
+  trace_lock_release();
+  return number;
+}
+
+void LAStrace::disable()
+{
+  enabled = FALSE;
+#ifdef _WIN32
+  if (!trace_lock_initialized) return;
+#endif
+  trace_lock_acquire();
+  while (trace_rings)
+  {
+    LAStraceRing* ring = trace_rings;
+    trace_rings = ring->next;
+    free(ring->events);
+    free(ring);
+  }
+  trace_threads = 0;
+  trace_lock_release();
+  // rings that threads still point to belong to an old generation
+  trace_generation++;
+}
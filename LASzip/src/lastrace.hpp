@@ -0,0 +1,107 @@
+/*
+===============================================================================
+
+  FILE:  lastrace.hpp
+
+  CONTENTS:
+
+    A recorder of timed events (the encoding or decoding of one chunk, a
+    seek, a collective MPI call, ...) for looking at where the time goes.
+    The events are kept in a ring buffer per thread so that recording is a
+    few stores without locks or I/O. When the ring is full the oldest events
+    are overwritten and counted as dropped. Times are taken from a monotonic
+    clock in nanoseconds relative to the call of enable().
+
+    Nothing is recorded before enable() is called, and then every record
+    only costs one test of a static flag. At the end all events are turned
+    into the entries of the "traceEvents" array of the Chrome trace format
+    (chrome://tracing or https://ui.perfetto.dev) with get_json().
+
+    I64 start = LAStrace::now();
+    ... encode a chunk ...
+    LAStrace::complete("encode chunk", "laz", start, number);
+
+    {
+      LAStraceScope scope("seek", "io", target);
+      ... seek ...
+    }
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for per-chunk timelines of parallel runs
+
+===============================================================================
+*/
+#ifndef LAS_TRACE_HPP
+#define LAS_TRACE_HPP
+
+#include "mydefs.hpp"
+
+#define LAS_TRACE_CAPACITY_DEFAULT 65536
+
+class LAStrace
+{
+public:
+  // starts recording with rings of this many events per thread
+  static BOOL enable(const U32 capacity=LAS_TRACE_CAPACITY_DEFAULT);
+  static inline BOOL is_enabled() { return enabled; };
+
+  // nanoseconds since enable() or 0 when not recording
+  static I64 now();
+
+  // an event from start (taken with now()) until now. names and categories
+  // must be string constants as only their pointers are kept
+  static void complete(const CHAR* name, const CHAR* category, const I64 start, const I64 arg=-1);
+  // an event without duration
+  static void instant(const CHAR* name, const CHAR* category, const I64 arg=-1);
+
+  // the events of all threads as comma separated Chrome trace events of
+  // process pid. returns the length of the malloc()ed string
+  static I64 get_json(CHAR** json, const I32 pid);
+  static I64 get_number_events();
+  static I64 get_number_dropped();
+
+  // stops recording and frees the rings of all threads
+  static void disable();
+
+private:
+  static BOOL enabled;
+};
+
+class LAStraceScope
+{
+public:
+  inline LAStraceScope(const CHAR* name, const CHAR* category, const I64 arg=-1)
+  {
+    this->name = name;
+    this->category = category;
+    this->arg = arg;
+    start = (LAStrace::is_enabled() ? LAStrace::now() : 0);
+  };
+  inline ~LAStraceScope()
+  {
+    if (LAStrace::is_enabled()) LAStrace::complete(name, category, start, arg);
+  };
+private:
+  const CHAR* name;
+  const CHAR* category;
+  I64 arg;
+  I64 start;
+};
+
+#endif
@@ -74,14 +74,14 @@ bool LASunzipper::open(istream& instream, const LASzip* laszip)
   return true;
 }
 
-bool LASunzipper::seek(const unsigned int position)
+bool LASunzipper::seek(const SIGNED_INT64 position)
 {
   if (!reader->seek(count, position)) return return_error("seek() of LASreadPoint failed");
   count = position;
   return true;
 }
 
-unsigned int LASunzipper::tell() const
+SIGNED_INT64 LASunzipper::tell() const
 {
   return count;
 }
@@ -25,6 +25,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- 64 bit point position for seek() and tell()
     23 April 2011 -- changed interface for easier future compressor support
     10 January 2011 -- licensing change for LGPL release and liblas integration
     12 December 2010 -- created from LASwriter/LASreader after Howard got pushy (-;
@@ -55,8 +56,8 @@ public:
   bool open(FILE* file, const LASzip* laszip);
   bool open(istream& stream, const LASzip* laszip);
  
-  unsigned int tell() const;
-  bool seek(const unsigned int position);
+  SIGNED_INT64 tell() const;
+  bool seek(const SIGNED_INT64 position);
   bool read(unsigned char * const * point);
   bool close();
 
@@ -67,7 +68,7 @@ public:
   const char* get_error() const;
 
 private:
-  unsigned int count;
+  SIGNED_INT64 count;
   ByteStreamIn* stream;
   LASreadPoint* reader;
   bool return_error(const char* err);
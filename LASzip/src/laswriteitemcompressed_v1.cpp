@@ -30,6 +30,8 @@
 */
 
 #include "laswriteitemcompressed_v1.hpp"
+#include "arithmeticencoder.hpp"
+#include "ransencoder.hpp"
 #include "laszip_common_v1.hpp"
 
 #include <assert.h>
@@ -57,7 +59,8 @@ struct LASpoint10
   U16 point_source_ID;
 };
 
-LASwriteItemCompressed_POINT10_v1::LASwriteItemCompressed_POINT10_v1(ArithmeticEncoder* enc)
+template <class Encoder>
+LASwriteItemCompressed_POINT10_v1<Encoder>::LASwriteItemCompressed_POINT10_v1(Encoder* enc)
 {
   U32 i;
 
@@ -66,12 +69,12 @@ LASwriteItemCompressed_POINT10_v1::LASwriteItemCompressed_POINT10_v1(ArithmeticE
   this->enc = enc;
 
   /* create models and integer compressors */
-  ic_dx = new IntegerCompressor(enc, 32);  // 32 bits, 1 context
-  ic_dy = new IntegerCompressor(enc, 32, 20); // 32 bits, 20 contexts
-  ic_z = new IntegerCompressor(enc, 32, 20);  // 32 bits, 20 contexts
-  ic_intensity = new IntegerCompressor(enc, 16);
-  ic_scan_angle_rank = new IntegerCompressor(enc, 8, 2);
-  ic_point_source_ID = new IntegerCompressor(enc, 16);
+  ic_dx = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32);  // 32 bits, 1 context
+  ic_dy = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 20); // 32 bits, 20 contexts
+  ic_z = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 20);  // 32 bits, 20 contexts
+  ic_intensity = new IntegerCoder<Encoder, EntropyDecoder>(enc, 16);
+  ic_scan_angle_rank = new IntegerCoder<Encoder, EntropyDecoder>(enc, 8, 2);
+  ic_point_source_ID = new IntegerCoder<Encoder, EntropyDecoder>(enc, 16);
   m_changed_values = enc->createSymbolModel(64);
   for (i = 0; i < 256; i++)
   {
@@ -81,7 +84,8 @@ LASwriteItemCompressed_POINT10_v1::LASwriteItemCompressed_POINT10_v1(ArithmeticE
   }
 }
 
-LASwriteItemCompressed_POINT10_v1::~LASwriteItemCompressed_POINT10_v1()
+template <class Encoder>
+LASwriteItemCompressed_POINT10_v1<Encoder>::~LASwriteItemCompressed_POINT10_v1()
 {
   U32 i;
   delete ic_dx;
@@ -99,7 +103,8 @@ LASwriteItemCompressed_POINT10_v1::~LASwriteItemCompressed_POINT10_v1()
   }
 }
 
-BOOL LASwriteItemCompressed_POINT10_v1::init(const U8* item)
+template <class Encoder>
+BOOL LASwriteItemCompressed_POINT10_v1<Encoder>::init(const U8* item)
 {
   U32 i;
 
@@ -129,7 +134,8 @@ BOOL LASwriteItemCompressed_POINT10_v1::init(const U8* item)
   return TRUE;
 }
 
-inline BOOL LASwriteItemCompressed_POINT10_v1::write(const U8* item)
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_POINT10_v1<Encoder>::write(const U8* item)
 {
   // find median difference for x and y from 3 preceding differences
   I32 median_x;
@@ -263,7 +269,8 @@ inline BOOL LASwriteItemCompressed_POINT10_v1::write(const U8* item)
 
 #define LASZIP_GPSTIME_MULTIMAX 512
 
-LASwriteItemCompressed_GPSTIME11_v1::LASwriteItemCompressed_GPSTIME11_v1(ArithmeticEncoder* enc)
+template <class Encoder>
+LASwriteItemCompressed_GPSTIME11_v1<Encoder>::LASwriteItemCompressed_GPSTIME11_v1(Encoder* enc)
 {
   /* set encoder */
   assert(enc);
@@ -271,17 +278,19 @@ LASwriteItemCompressed_GPSTIME11_v1::LASwriteItemCompressed_GPSTIME11_v1(Arithme
   /* create entropy models and integer compressors */
   m_gpstime_multi = enc->createSymbolModel(LASZIP_GPSTIME_MULTIMAX);
   m_gpstime_0diff = enc->createSymbolModel(3);
-  ic_gpstime = new IntegerCompressor(enc, 32, 6); // 32 bits, 6 contexts
+  ic_gpstime = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 6); // 32 bits, 6 contexts
 }
 
-LASwriteItemCompressed_GPSTIME11_v1::~LASwriteItemCompressed_GPSTIME11_v1()
+template <class Encoder>
+LASwriteItemCompressed_GPSTIME11_v1<Encoder>::~LASwriteItemCompressed_GPSTIME11_v1()
 {
   enc->destroySymbolModel(m_gpstime_multi);
   enc->destroySymbolModel(m_gpstime_0diff);
   delete ic_gpstime;
 }
 
-BOOL LASwriteItemCompressed_GPSTIME11_v1::init(const U8* item)
+template <class Encoder>
+BOOL LASwriteItemCompressed_GPSTIME11_v1<Encoder>::init(const U8* item)
 {
   /* init state */
   last_gpstime_diff = 0;
@@ -297,7 +306,8 @@ BOOL LASwriteItemCompressed_GPSTIME11_v1::init(const U8* item)
   return TRUE;
 }
 
-inline BOOL LASwriteItemCompressed_GPSTIME11_v1::write(const U8* item)
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_GPSTIME11_v1<Encoder>::write(const U8* item)
 {
   U64I64F64 this_gpstime;
   this_gpstime.i64 = *((I64*)item);
@@ -417,7 +427,8 @@ inline BOOL LASwriteItemCompressed_GPSTIME11_v1::write(const U8* item)
 ===============================================================================
 */
 
-LASwriteItemCompressed_RGB12_v1::LASwriteItemCompressed_RGB12_v1(ArithmeticEncoder* enc)
+template <class Encoder>
+LASwriteItemCompressed_RGB12_v1<Encoder>::LASwriteItemCompressed_RGB12_v1(Encoder* enc)
 {
   /* set encoder */
   assert(enc);
@@ -425,20 +436,22 @@ LASwriteItemCompressed_RGB12_v1::LASwriteItemCompressed_RGB12_v1(ArithmeticEncod
 
   /* create models and integer compressors */
   m_byte_used = enc->createSymbolModel(64);
-  ic_rgb = new IntegerCompressor(enc, 8, 6);
+  ic_rgb = new IntegerCoder<Encoder, EntropyDecoder>(enc, 8, 6);
 
   /* create last item */
   last_item = new U8[6];
 }
 
-LASwriteItemCompressed_RGB12_v1::~LASwriteItemCompressed_RGB12_v1()
+template <class Encoder>
+LASwriteItemCompressed_RGB12_v1<Encoder>::~LASwriteItemCompressed_RGB12_v1()
 {
   enc->destroySymbolModel(m_byte_used);
   delete ic_rgb;
   delete [] last_item;
 }
 
-BOOL LASwriteItemCompressed_RGB12_v1::init(const U8* item)
+template <class Encoder>
+BOOL LASwriteItemCompressed_RGB12_v1<Encoder>::init(const U8* item)
 {
   /* init state */
 
@@ -451,7 +464,8 @@ BOOL LASwriteItemCompressed_RGB12_v1::init(const U8* item)
   return TRUE;
 }
 
-inline BOOL LASwriteItemCompressed_RGB12_v1::write(const U8* item)
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_RGB12_v1<Encoder>::write(const U8* item)
 {
   U32 sym = ((((U16*)last_item)[0]&0x00FF) != (((U16*)item)[0]&0x00FF)) << 0;
   sym |= ((((U16*)last_item)[0]&0xFF00) != (((U16*)item)[0]&0xFF00)) << 1;
@@ -476,7 +490,8 @@ inline BOOL LASwriteItemCompressed_RGB12_v1::write(const U8* item)
 ===============================================================================
 */
 
-LASwriteItemCompressed_WAVEPACKET13_v1::LASwriteItemCompressed_WAVEPACKET13_v1(ArithmeticEncoder* enc)
+template <class Encoder>
+LASwriteItemCompressed_WAVEPACKET13_v1<Encoder>::LASwriteItemCompressed_WAVEPACKET13_v1(Encoder* enc)
 {
   /* set encoder */
   assert(enc);
@@ -488,16 +503,17 @@ LASwriteItemCompressed_WAVEPACKET13_v1::LASwriteItemCompressed_WAVEPACKET13_v1(A
   m_offset_diff[1] = enc->createSymbolModel(4);
   m_offset_diff[2] = enc->createSymbolModel(4);
   m_offset_diff[3] = enc->createSymbolModel(4);
-  ic_offset_diff = new IntegerCompressor(enc, 32);
-  ic_packet_size = new IntegerCompressor(enc, 32);
-  ic_return_point = new IntegerCompressor(enc, 32);
-  ic_xyz = new IntegerCompressor(enc, 32, 3);
+  ic_offset_diff = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32);
+  ic_packet_size = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32);
+  ic_return_point = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32);
+  ic_xyz = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 3);
 
   /* create last item */
   last_item = new U8[28];
 }
 
-LASwriteItemCompressed_WAVEPACKET13_v1::~LASwriteItemCompressed_WAVEPACKET13_v1()
+template <class Encoder>
+LASwriteItemCompressed_WAVEPACKET13_v1<Encoder>::~LASwriteItemCompressed_WAVEPACKET13_v1()
 {
   enc->destroySymbolModel(m_packet_index);
   enc->destroySymbolModel(m_offset_diff[0]);
@@ -511,7 +527,8 @@ LASwriteItemCompressed_WAVEPACKET13_v1::~LASwriteItemCompressed_WAVEPACKET13_v1(
   delete [] last_item;
 }
 
-BOOL LASwriteItemCompressed_WAVEPACKET13_v1::init(const U8* item)
+template <class Encoder>
+BOOL LASwriteItemCompressed_WAVEPACKET13_v1<Encoder>::init(const U8* item)
 {
   /* init state */
   last_diff_32 = 0;
@@ -534,7 +551,8 @@ BOOL LASwriteItemCompressed_WAVEPACKET13_v1::init(const U8* item)
   return TRUE;
 }
 
-inline BOOL LASwriteItemCompressed_WAVEPACKET13_v1::write(const U8* item)
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_WAVEPACKET13_v1<Encoder>::write(const U8* item)
 {
   enc->encodeSymbol(m_packet_index, (U32)(item[0]));
   item++;
@@ -591,7 +609,8 @@ inline BOOL LASwriteItemCompressed_WAVEPACKET13_v1::write(const U8* item)
 ===============================================================================
 */
 
-LASwriteItemCompressed_BYTE_v1::LASwriteItemCompressed_BYTE_v1(ArithmeticEncoder* enc, U32 number)
+template <class Encoder>
+LASwriteItemCompressed_BYTE_v1<Encoder>::LASwriteItemCompressed_BYTE_v1(Encoder* enc, U32 number)
 {
   /* set encoder */
   assert(enc);
@@ -600,19 +619,21 @@ LASwriteItemCompressed_BYTE_v1::LASwriteItemCompressed_BYTE_v1(ArithmeticEncoder
   this->number = number;
 
   /* create models and integer compressors */
-  ic_byte = new IntegerCompressor(enc, 8, number);
+  ic_byte = new IntegerCoder<Encoder, EntropyDecoder>(enc, 8, number);
 
   /* create last item */
   last_item = new U8[number];
 }
 
-LASwriteItemCompressed_BYTE_v1::~LASwriteItemCompressed_BYTE_v1()
+template <class Encoder>
+LASwriteItemCompressed_BYTE_v1<Encoder>::~LASwriteItemCompressed_BYTE_v1()
 {
   delete ic_byte;
   delete [] last_item;
 }
 
-BOOL LASwriteItemCompressed_BYTE_v1::init(const U8* item)
+template <class Encoder>
+BOOL LASwriteItemCompressed_BYTE_v1<Encoder>::init(const U8* item)
 {
   /* init state */
 
@@ -624,7 +645,8 @@ BOOL LASwriteItemCompressed_BYTE_v1::init(const U8* item)
   return TRUE;
 }
 
-inline BOOL LASwriteItemCompressed_BYTE_v1::write(const U8* item)
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_BYTE_v1<Encoder>::write(const U8* item)
 {
   U32 i;
   for (i = 0; i < number; i++)
@@ -636,3 +658,16 @@ inline BOOL LASwriteItemCompressed_BYTE_v1::write(const U8* item)
 }
 
 // vim: set ts=2 sw=2 expandtabs
+
+// the coders that the items are compiled for
+
+template class LASwriteItemCompressed_POINT10_v1<ArithmeticEncoder>;
+template class LASwriteItemCompressed_POINT10_v1<RANSEncoder>;
+template class LASwriteItemCompressed_GPSTIME11_v1<ArithmeticEncoder>;
+template class LASwriteItemCompressed_GPSTIME11_v1<RANSEncoder>;
+template class LASwriteItemCompressed_RGB12_v1<ArithmeticEncoder>;
+template class LASwriteItemCompressed_RGB12_v1<RANSEncoder>;
+template class LASwriteItemCompressed_WAVEPACKET13_v1<ArithmeticEncoder>;
+template class LASwriteItemCompressed_WAVEPACKET13_v1<RANSEncoder>;
+template class LASwriteItemCompressed_BYTE_v1<ArithmeticEncoder>;
+template class LASwriteItemCompressed_BYTE_v1<RANSEncoder>;
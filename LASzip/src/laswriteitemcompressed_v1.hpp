@@ -24,6 +24,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- templated on the entropy encoder to also support rANS
     6 September 2014 -- removed inheritance of EntropyEncoder and EntropyDecoder
     10 January 2011 -- licensing change for LGPL release and liblas integration
     12 December 2010 -- refactored after watching two movies with silke
@@ -34,14 +35,15 @@
 #define LAS_WRITE_ITEM_COMPRESSED_V1_HPP
 
 #include "laswriteitem.hpp"
-#include "arithmeticencoder.hpp"
+#include "entropyencoder.hpp"
 #include "integercompressor.hpp"
 
+template <class Encoder>
 class LASwriteItemCompressed_POINT10_v1 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_POINT10_v1(ArithmeticEncoder* enc);
+  LASwriteItemCompressed_POINT10_v1(Encoder* enc);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
@@ -49,29 +51,30 @@ public:
   ~LASwriteItemCompressed_POINT10_v1();
 
 private:
-  ArithmeticEncoder* enc;
+  Encoder* enc;
   U8 last_item[20];
 
   I32 last_x_diff[3];
   I32 last_y_diff[3];
   I32 last_incr;
-  IntegerCompressor* ic_dx;
-  IntegerCompressor* ic_dy;
-  IntegerCompressor* ic_z;
-  IntegerCompressor* ic_intensity;
-  IntegerCompressor* ic_scan_angle_rank;
-  IntegerCompressor* ic_point_source_ID;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_dx;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_dy;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_z;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_intensity;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_scan_angle_rank;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_point_source_ID;
   ArithmeticModel* m_changed_values;
   ArithmeticModel* m_bit_byte[256];
   ArithmeticModel* m_classification[256];
   ArithmeticModel* m_user_data[256];
 };
 
+template <class Encoder>
 class LASwriteItemCompressed_GPSTIME11_v1 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_GPSTIME11_v1(ArithmeticEncoder* enc);
+  LASwriteItemCompressed_GPSTIME11_v1(Encoder* enc);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
@@ -79,21 +82,22 @@ public:
   ~LASwriteItemCompressed_GPSTIME11_v1();
 
 private:
-  ArithmeticEncoder* enc;
+  Encoder* enc;
   U64I64F64 last_gpstime;
 
   ArithmeticModel* m_gpstime_multi;
   ArithmeticModel* m_gpstime_0diff;
-  IntegerCompressor* ic_gpstime;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_gpstime;
   I32 multi_extreme_counter;
   I32 last_gpstime_diff;
 };
 
+template <class Encoder>
 class LASwriteItemCompressed_RGB12_v1 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_RGB12_v1(ArithmeticEncoder* enc);
+  LASwriteItemCompressed_RGB12_v1(Encoder* enc);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
@@ -101,18 +105,19 @@ public:
   ~LASwriteItemCompressed_RGB12_v1();
 
 private:
-  ArithmeticEncoder* enc;
+  Encoder* enc;
   U8* last_item;
 
   ArithmeticModel* m_byte_used;
-  IntegerCompressor* ic_rgb;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_rgb;
 };
 
+template <class Encoder>
 class LASwriteItemCompressed_WAVEPACKET13_v1 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_WAVEPACKET13_v1(ArithmeticEncoder* enc);
+  LASwriteItemCompressed_WAVEPACKET13_v1(Encoder* enc);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
@@ -120,24 +125,25 @@ public:
   ~LASwriteItemCompressed_WAVEPACKET13_v1();
 
 private:
-  ArithmeticEncoder* enc;
+  Encoder* enc;
   U8* last_item;
 
   I32 last_diff_32;
   U32 sym_last_offset_diff;
   ArithmeticModel* m_packet_index;
   ArithmeticModel* m_offset_diff[4];
-  IntegerCompressor* ic_offset_diff;
-  IntegerCompressor* ic_packet_size;
-  IntegerCompressor* ic_return_point;
-  IntegerCompressor* ic_xyz;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_offset_diff;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_packet_size;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_return_point;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_xyz;
 };
 
+template <class Encoder>
 class LASwriteItemCompressed_BYTE_v1 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_BYTE_v1(ArithmeticEncoder* enc, U32 number);
+  LASwriteItemCompressed_BYTE_v1(Encoder* enc, U32 number);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
@@ -145,11 +151,11 @@ public:
   ~LASwriteItemCompressed_BYTE_v1();
 
 private:
-  ArithmeticEncoder* enc;
+  Encoder* enc;
   U32 number;
   U8* last_item;
 
-  IntegerCompressor* ic_byte;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_byte;
 };
 
 #endif
@@ -30,6 +30,8 @@
 */
 
 #include "laswriteitemcompressed_v2.hpp"
+#include "arithmeticencoder.hpp"
+#include "ransencoder.hpp"
 
 #include <assert.h>
 #include <string.h>
@@ -56,7 +58,8 @@ struct LASpoint10
   U16 point_source_ID;
 };
 
-LASwriteItemCompressed_POINT10_v2::LASwriteItemCompressed_POINT10_v2(ArithmeticEncoder* enc)
+template <class Encoder>
+LASwriteItemCompressed_POINT10_v2<Encoder>::LASwriteItemCompressed_POINT10_v2(Encoder* enc)
 {
   U32 i;
 
@@ -66,22 +69,23 @@ LASwriteItemCompressed_POINT10_v2::LASwriteItemCompressed_POINT10_v2(ArithmeticE
 
   /* create models and integer compressors */
   m_changed_values = enc->createSymbolModel(64);
-  ic_intensity = new IntegerCompressor(enc, 16, 4);
+  ic_intensity = new IntegerCoder<Encoder, EntropyDecoder>(enc, 16, 4);
   m_scan_angle_rank[0] = enc->createSymbolModel(256);
   m_scan_angle_rank[1] = enc->createSymbolModel(256);
-  ic_point_source_ID = new IntegerCompressor(enc, 16);
+  ic_point_source_ID = new IntegerCoder<Encoder, EntropyDecoder>(enc, 16);
   for (i = 0; i < 256; i++)
   {
     m_bit_byte[i] = 0;
     m_classification[i] = 0;
     m_user_data[i] = 0;
   }
-  ic_dx = new IntegerCompressor(enc, 32, 2);  // 32 bits, 2 context
-  ic_dy = new IntegerCompressor(enc, 32, 22); // 32 bits, 22 contexts
-  ic_z = new IntegerCompressor(enc, 32, 20);  // 32 bits, 20 contexts
+  ic_dx = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 2);  // 32 bits, 2 context
+  ic_dy = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 22); // 32 bits, 22 contexts
+  ic_z = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 20);  // 32 bits, 20 contexts
 }
 
-LASwriteItemCompressed_POINT10_v2::~LASwriteItemCompressed_POINT10_v2()
+template <class Encoder>
+LASwriteItemCompressed_POINT10_v2<Encoder>::~LASwriteItemCompressed_POINT10_v2()
 {
   U32 i;
 
@@ -101,7 +105,8 @@ LASwriteItemCompressed_POINT10_v2::~LASwriteItemCompressed_POINT10_v2()
   delete ic_z;
 }
 
-BOOL LASwriteItemCompressed_POINT10_v2::init(const U8* item)
+template <class Encoder>
+BOOL LASwriteItemCompressed_POINT10_v2<Encoder>::init(const U8* item)
 {
   U32 i;
 
@@ -136,7 +141,8 @@ BOOL LASwriteItemCompressed_POINT10_v2::init(const U8* item)
   return TRUE;
 }
 
-inline BOOL LASwriteItemCompressed_POINT10_v2::write(const U8* item)
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_POINT10_v2<Encoder>::write(const U8* item)
 {
   U32 r = ((LASpoint10*)item)->return_number;
   U32 n = ((LASpoint10*)item)->number_of_returns_of_given_pulse;
@@ -243,7 +249,8 @@ inline BOOL LASwriteItemCompressed_POINT10_v2::write(const U8* item)
 
 #define LASZIP_GPSTIME_MULTI_TOTAL (LASZIP_GPSTIME_MULTI - LASZIP_GPSTIME_MULTI_MINUS + 6) 
 
-LASwriteItemCompressed_GPSTIME11_v2::LASwriteItemCompressed_GPSTIME11_v2(ArithmeticEncoder* enc)
+template <class Encoder>
+LASwriteItemCompressed_GPSTIME11_v2<Encoder>::LASwriteItemCompressed_GPSTIME11_v2(Encoder* enc)
 {
   /* set encoder */
   assert(enc);
@@ -251,17 +258,19 @@ LASwriteItemCompressed_GPSTIME11_v2::LASwriteItemCompressed_GPSTIME11_v2(Arithme
   /* create entropy models and integer compressors */
   m_gpstime_multi = enc->createSymbolModel(LASZIP_GPSTIME_MULTI_TOTAL);
   m_gpstime_0diff = enc->createSymbolModel(6);
-  ic_gpstime = new IntegerCompressor(enc, 32, 9); // 32 bits, 9 contexts
+  ic_gpstime = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 9); // 32 bits, 9 contexts
 }
 
-LASwriteItemCompressed_GPSTIME11_v2::~LASwriteItemCompressed_GPSTIME11_v2()
+template <class Encoder>
+LASwriteItemCompressed_GPSTIME11_v2<Encoder>::~LASwriteItemCompressed_GPSTIME11_v2()
 {
   enc->destroySymbolModel(m_gpstime_multi);
   enc->destroySymbolModel(m_gpstime_0diff);
   delete ic_gpstime;
 }
 
-BOOL LASwriteItemCompressed_GPSTIME11_v2::init(const U8* item)
+template <class Encoder>
+BOOL LASwriteItemCompressed_GPSTIME11_v2<Encoder>::init(const U8* item)
 {
   /* init state */
   last = 0, next = 0;
@@ -287,7 +296,8 @@ BOOL LASwriteItemCompressed_GPSTIME11_v2::init(const U8* item)
   return TRUE;
 }
 
-inline BOOL LASwriteItemCompressed_GPSTIME11_v2::write(const U8* item)
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_GPSTIME11_v2<Encoder>::write(const U8* item)
 {
   U64I64F64 this_gpstime;
   this_gpstime.i64 = *((I64*)item);
@@ -455,7 +465,8 @@ inline BOOL LASwriteItemCompressed_GPSTIME11_v2::write(const U8* item)
 ===============================================================================
 */
 
-LASwriteItemCompressed_RGB12_v2::LASwriteItemCompressed_RGB12_v2(ArithmeticEncoder* enc)
+template <class Encoder>
+LASwriteItemCompressed_RGB12_v2<Encoder>::LASwriteItemCompressed_RGB12_v2(Encoder* enc)
 {
   /* set encoder */
   assert(enc);
@@ -471,7 +482,8 @@ LASwriteItemCompressed_RGB12_v2::LASwriteItemCompressed_RGB12_v2(ArithmeticEncod
   m_rgb_diff_5 = enc->createSymbolModel(256);
 }
 
-LASwriteItemCompressed_RGB12_v2::~LASwriteItemCompressed_RGB12_v2()
+template <class Encoder>
+LASwriteItemCompressed_RGB12_v2<Encoder>::~LASwriteItemCompressed_RGB12_v2()
 {
   enc->destroySymbolModel(m_byte_used);
   enc->destroySymbolModel(m_rgb_diff_0);
@@ -482,7 +494,8 @@ LASwriteItemCompressed_RGB12_v2::~LASwriteItemCompressed_RGB12_v2()
   enc->destroySymbolModel(m_rgb_diff_5);
 }
 
-BOOL LASwriteItemCompressed_RGB12_v2::init(const U8* item)
+template <class Encoder>
+BOOL LASwriteItemCompressed_RGB12_v2<Encoder>::init(const U8* item)
 {
   /* init state */
 
@@ -500,7 +513,8 @@ BOOL LASwriteItemCompressed_RGB12_v2::init(const U8* item)
   return TRUE;
 }
 
-inline BOOL LASwriteItemCompressed_RGB12_v2::write(const U8* item)
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_RGB12_v2<Encoder>::write(const U8* item)
 {
   I32 diff_l = 0;
   I32 diff_h = 0;
@@ -558,7 +572,8 @@ inline BOOL LASwriteItemCompressed_RGB12_v2::write(const U8* item)
 ===============================================================================
 */
 
-LASwriteItemCompressed_BYTE_v2::LASwriteItemCompressed_BYTE_v2(ArithmeticEncoder* enc, U32 number)
+template <class Encoder>
+LASwriteItemCompressed_BYTE_v2<Encoder>::LASwriteItemCompressed_BYTE_v2(Encoder* enc, U32 number)
 {
   U32 i;
 
@@ -579,7 +594,8 @@ LASwriteItemCompressed_BYTE_v2::LASwriteItemCompressed_BYTE_v2(ArithmeticEncoder
   last_item = new U8[number];
 }
 
-LASwriteItemCompressed_BYTE_v2::~LASwriteItemCompressed_BYTE_v2()
+template <class Encoder>
+LASwriteItemCompressed_BYTE_v2<Encoder>::~LASwriteItemCompressed_BYTE_v2()
 {
   U32 i;
   for (i = 0; i < number; i++)
@@ -590,7 +606,8 @@ LASwriteItemCompressed_BYTE_v2::~LASwriteItemCompressed_BYTE_v2()
   delete [] last_item;
 }
 
-BOOL LASwriteItemCompressed_BYTE_v2::init(const U8* item)
+template <class Encoder>
+BOOL LASwriteItemCompressed_BYTE_v2<Encoder>::init(const U8* item)
 {
   U32 i;
   /* init state */
@@ -606,7 +623,8 @@ BOOL LASwriteItemCompressed_BYTE_v2::init(const U8* item)
   return TRUE;
 }
 
-inline BOOL LASwriteItemCompressed_BYTE_v2::write(const U8* item)
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_BYTE_v2<Encoder>::write(const U8* item)
 {
   U32 i;
   I32 diff;
@@ -619,3 +637,13 @@ inline BOOL LASwriteItemCompressed_BYTE_v2::write(const U8* item)
   return TRUE;
 }
 
+// the coders that the items are compiled for
+
+template class LASwriteItemCompressed_POINT10_v2<ArithmeticEncoder>;
+template class LASwriteItemCompressed_POINT10_v2<RANSEncoder>;
+template class LASwriteItemCompressed_GPSTIME11_v2<ArithmeticEncoder>;
+template class LASwriteItemCompressed_GPSTIME11_v2<RANSEncoder>;
+template class LASwriteItemCompressed_RGB12_v2<ArithmeticEncoder>;
+template class LASwriteItemCompressed_RGB12_v2<RANSEncoder>;
+template class LASwriteItemCompressed_BYTE_v2<ArithmeticEncoder>;
+template class LASwriteItemCompressed_BYTE_v2<RANSEncoder>;
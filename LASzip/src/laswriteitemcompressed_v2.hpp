@@ -24,6 +24,7 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- templated on the entropy encoder to also support rANS
     6 September 2014 -- removed inheritance of EntropyEncoder and EntropyDecoder
     5 March 2011 -- created first night in ibiza to improve the RGB compressor
 
@@ -33,16 +34,17 @@
 #define LAS_WRITE_ITEM_COMPRESSED_V2_HPP
 
 #include "laswriteitem.hpp"
-#include "arithmeticencoder.hpp"
+#include "entropyencoder.hpp"
 #include "integercompressor.hpp"
 
 #include "laszip_common_v2.hpp"
 
+template <class Encoder>
 class LASwriteItemCompressed_POINT10_v2 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_POINT10_v2(ArithmeticEncoder* enc);
+  LASwriteItemCompressed_POINT10_v2(Encoder* enc);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
@@ -50,7 +52,7 @@ public:
   ~LASwriteItemCompressed_POINT10_v2();
 
 private:
-  ArithmeticEncoder* enc;
+  Encoder* enc;
   U8 last_item[20];
   U16 last_intensity[16];
   StreamingMedian5 last_x_diff_median5[16];
@@ -58,22 +60,23 @@ private:
   I32 last_height[8];
 
   ArithmeticModel* m_changed_values;
-  IntegerCompressor* ic_intensity;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_intensity;
   ArithmeticModel* m_scan_angle_rank[2];
-  IntegerCompressor* ic_point_source_ID;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_point_source_ID;
   ArithmeticModel* m_bit_byte[256];
   ArithmeticModel* m_classification[256];
   ArithmeticModel* m_user_data[256];
-  IntegerCompressor* ic_dx;
-  IntegerCompressor* ic_dy;
-  IntegerCompressor* ic_z;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_dx;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_dy;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_z;
 };
 
+template <class Encoder>
 class LASwriteItemCompressed_GPSTIME11_v2 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_GPSTIME11_v2(ArithmeticEncoder* enc);
+  LASwriteItemCompressed_GPSTIME11_v2(Encoder* enc);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
@@ -81,7 +84,7 @@ public:
   ~LASwriteItemCompressed_GPSTIME11_v2();
 
 private:
-  ArithmeticEncoder* enc;
+  Encoder* enc;
   U32 last, next;
   U64I64F64 last_gpstime[4];
   I32 last_gpstime_diff[4];
@@ -89,14 +92,15 @@ private:
 
   ArithmeticModel* m_gpstime_multi;
   ArithmeticModel* m_gpstime_0diff;
-  IntegerCompressor* ic_gpstime;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_gpstime;
 };
 
+template <class Encoder>
 class LASwriteItemCompressed_RGB12_v2 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_RGB12_v2(ArithmeticEncoder* enc);
+  LASwriteItemCompressed_RGB12_v2(Encoder* enc);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
@@ -104,7 +108,7 @@ public:
   ~LASwriteItemCompressed_RGB12_v2();
 
 private:
-  ArithmeticEncoder* enc;
+  Encoder* enc;
   U16 last_item[3];
 
   ArithmeticModel* m_byte_used;
@@ -116,11 +120,12 @@ private:
   ArithmeticModel* m_rgb_diff_5;
 };
 
+template <class Encoder>
 class LASwriteItemCompressed_BYTE_v2 : public LASwriteItemCompressed
 {
 public:
 
-  LASwriteItemCompressed_BYTE_v2(ArithmeticEncoder* enc, U32 number);
+  LASwriteItemCompressed_BYTE_v2(Encoder* enc, U32 number);
 
   BOOL init(const U8* item);
   BOOL write(const U8* item);
@@ -128,7 +133,7 @@ public:
   ~LASwriteItemCompressed_BYTE_v2();
 
 private:
-  ArithmeticEncoder* enc;
+  Encoder* enc;
   U32 number;
   U8* last_item;
 
@@ -0,0 +1,79 @@
+/*
+===============================================================================
+
+  FILE:  laswriteitemcompressed_v4.hpp
+  
+  CONTENTS:
+  
+    Implementation of LASitemWriteCompressed for the "max" profile (version
+    4) of POINT10. All other items have no version 4 and keep using version 2.
+    It is version 2 with richer contexts: the intensity corrector has one
+    context for each of the 16 return mappings instead of 4, and the x
+    corrector is conditioned on the number of bits of the previous x
+    corrector of the same return mapping, like y is conditioned on x. This
+    gives a bit more compression for cold archives at a small cost in speed.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  
+  CHANGE HISTORY:
+  
+    18 October 2026 -- created for the compression profiles
+
+===============================================================================
+*/
+#ifndef LAS_WRITE_ITEM_COMPRESSED_V4_HPP
+#define LAS_WRITE_ITEM_COMPRESSED_V4_HPP
+
+#include "laswriteitem.hpp"
+#include "entropyencoder.hpp"
+#include "integercompressor.hpp"
+
+#include "laszip_common_v2.hpp"
+
+template <class Encoder>
+class LASwriteItemCompressed_POINT10_v4 : public LASwriteItemCompressed
+{
+public:
+
+  LASwriteItemCompressed_POINT10_v4(Encoder* enc);
+
+  BOOL init(const U8* item);
+  BOOL write(const U8* item);
+
+  ~LASwriteItemCompressed_POINT10_v4();
+
+private:
+  Encoder* enc;
+  U8 last_item[20];
+  U16 last_intensity[16];
+  StreamingMedian5 last_x_diff_median5[16];
+  StreamingMedian5 last_y_diff_median5[16];
+  U32 last_k_x[16];
+  I32 last_height[8];
+
+  ArithmeticModel* m_changed_values;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_intensity;
+  ArithmeticModel* m_scan_angle_rank[2];
+  IntegerCoder<Encoder, EntropyDecoder>* ic_point_source_ID;
+  ArithmeticModel* m_bit_byte[256];
+  ArithmeticModel* m_classification[256];
+  ArithmeticModel* m_user_data[256];
+  IntegerCoder<Encoder, EntropyDecoder>* ic_dx;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_dy;
+  IntegerCoder<Encoder, EntropyDecoder>* ic_z;
+};
+
+#endif
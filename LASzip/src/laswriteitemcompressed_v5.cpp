@@ -0,0 +1,248 @@
+/*
+===============================================================================
+
+  FILE:  laswriteitemcompressed_v5.cpp
+  
+  CONTENTS:
+  
+    see corresponding header file
+  
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  
+  CHANGE HISTORY:
+  
+    see corresponding header file
+  
+===============================================================================
+*/
+
+#include "laswriteitemcompressed_v5.hpp"
+#include "arithmeticencoder.hpp"
+#include "ransencoder.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+/*
+===============================================================================
+                       LASwriteItemCompressed_POINT10_v5
+===============================================================================
+*/
+
+struct LASpoint10
+{
+  I32 x;
+  I32 y;
+  I32 z;
+  U16 intensity;
+  U8 return_number : 3;
+  U8 number_of_returns_of_given_pulse : 3;
+  U8 scan_direction_flag : 1;
+  U8 edge_of_flight_line : 1;
+  U8 classification;
+  I8 scan_angle_rank;
+  U8 user_data;
+  U16 point_source_ID;
+};
+
+template <class Encoder>
+LASwriteItemCompressed_POINT10_v5<Encoder>::LASwriteItemCompressed_POINT10_v5(Encoder* enc)
+{
+  U32 i;
+
+  /* set encoder */
+  assert(enc);
+  this->enc = enc;
+
+  /* create models and integer compressors */
+  m_changed_values = enc->createSymbolModel(64);
+  ic_intensity = new IntegerCoder<Encoder, EntropyDecoder>(enc, 16, 4);
+  m_scan_angle_rank[0] = enc->createSymbolModel(256);
+  m_scan_angle_rank[1] = enc->createSymbolModel(256);
+  ic_point_source_ID = new IntegerCoder<Encoder, EntropyDecoder>(enc, 16);
+  for (i = 0; i < 256; i++)
+  {
+    m_bit_byte[i] = 0;
+    m_classification[i] = 0;
+    m_user_data[i] = 0;
+  }
+  ic_dx = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 2);  // 32 bits, 2 context
+  ic_dy = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 22); // 32 bits, 22 contexts
+  ic_z = new IntegerCoder<Encoder, EntropyDecoder>(enc, 32, 40);  // 32 bits, 2 predictors times 20 contexts
+}
+
+template <class Encoder>
+LASwriteItemCompressed_POINT10_v5<Encoder>::~LASwriteItemCompressed_POINT10_v5()
+{
+  U32 i;
+
+  enc->destroySymbolModel(m_changed_values);
+  delete ic_intensity;
+  enc->destroySymbolModel(m_scan_angle_rank[0]);
+  enc->destroySymbolModel(m_scan_angle_rank[1]);
+  delete ic_point_source_ID;
+  for (i = 0; i < 256; i++)
+  {
+    if (m_bit_byte[i]) enc->destroySymbolModel(m_bit_byte[i]);
+    if (m_classification[i]) enc->destroySymbolModel(m_classification[i]);
+    if (m_user_data[i]) enc->destroySymbolModel(m_user_data[i]);
+  }
+  delete ic_dx;
+  delete ic_dy;
+  delete ic_z;
+}
+
+template <class Encoder>
+BOOL LASwriteItemCompressed_POINT10_v5<Encoder>::init(const U8* item)
+{
+  U32 i;
+
+  /* init state */
+  for (i=0; i < 16; i++)
+  {
+    last_x_diff_median5[i].init();
+    last_y_diff_median5[i].init();
+    last_intensity[i] = 0;
+    last_height[i/2] = 0;
+  }
+
+  scan_line.init();
+
+  /* init models and integer compressors */
+  enc->initSymbolModel(m_changed_values);
+  ic_intensity->initCompressor();
+  enc->initSymbolModel(m_scan_angle_rank[0]);
+  enc->initSymbolModel(m_scan_angle_rank[1]);
+  ic_point_source_ID->initCompressor();
+  for (i = 0; i < 256; i++)
+  {
+    if (m_bit_byte[i]) enc->initSymbolModel(m_bit_byte[i]);
+    if (m_classification[i]) enc->initSymbolModel(m_classification[i]);
+    if (m_user_data[i]) enc->initSymbolModel(m_user_data[i]);
+  }
+  ic_dx->initCompressor();
+  ic_dy->initCompressor();
+  ic_z->initCompressor();
+
+  /* init last item */
+  memcpy(last_item, item, 20);
+
+  return TRUE;
+}
+
+template <class Encoder>
+inline BOOL LASwriteItemCompressed_POINT10_v5<Encoder>::write(const U8* item)
+{
+  U32 r = ((LASpoint10*)item)->return_number;
+  U32 n = ((LASpoint10*)item)->number_of_returns_of_given_pulse;
+  U32 m = number_return_map[n][r];
+  U32 l = number_return_level[n][r];
+  U32 k_bits;
+  I32 median, diff;
+
+  // compress which other values have changed
+  I32 changed_values = (((last_item[14] != item[14]) << 5) | // bit_byte
+                        ((last_intensity[m] != ((LASpoint10*)item)->intensity) << 4) |
+                        ((last_item[15] != item[15]) << 3) | // classification
+                        ((last_item[16] != item[16]) << 2) | // scan_angle_rank
+                        ((last_item[17] != item[17]) << 1) | // user_data
+                        (((LASpoint10*)last_item)->point_source_ID != ((LASpoint10*)item)->point_source_ID));
+
+  enc->encodeSymbol(m_changed_values, changed_values);
+
+  // compress the bit_byte (edge_of_flight_line, scan_direction_flag, returns, ...) if it has changed
+  if (changed_values & 32)
+  {
+    if (m_bit_byte[last_item[14]] == 0)
+    {
+      m_bit_byte[last_item[14]] = enc->createSymbolModel(256);
+      enc->initSymbolModel(m_bit_byte[last_item[14]]);
+    }
+    enc->encodeSymbol(m_bit_byte[last_item[14]], item[14]);
+  }
+
+  // compress the intensity if it has changed
+  if (changed_values & 16)
+  {
+    ic_intensity->compress(last_intensity[m], ((LASpoint10*)item)->intensity, (m < 3 ? m : 3));
+    last_intensity[m] = ((LASpoint10*)item)->intensity;
+  }
+
+  // compress the classification ... if it has changed
+  if (changed_values & 8)
+  {
+    if (m_classification[last_item[15]] == 0)
+    {
+      m_classification[last_item[15]] = enc->createSymbolModel(256);
+      enc->initSymbolModel(m_classification[last_item[15]]);
+    }
+    enc->encodeSymbol(m_classification[last_item[15]], item[15]);
+  }
+  
+  // compress the scan_angle_rank ... if it has changed
+  if (changed_values & 4)
+  {
+    enc->encodeSymbol(m_scan_angle_rank[((LASpoint10*)item)->scan_direction_flag], U8_FOLD(item[16]-last_item[16]));
+  }
+
+  // compress the user_data ... if it has changed
+  if (changed_values & 2)
+  {
+    if (m_user_data[last_item[17]] == 0)
+    {
+      m_user_data[last_item[17]] = enc->createSymbolModel(256);
+      enc->initSymbolModel(m_user_data[last_item[17]]);
+    }
+    enc->encodeSymbol(m_user_data[last_item[17]], item[17]);
+  }
+
+  // compress the point_source_ID ... if it has changed
+  if (changed_values & 1)
+  {
+    ic_point_source_ID->compress(((LASpoint10*)last_item)->point_source_ID, ((LASpoint10*)item)->point_source_ID);
+  }
+
+  // compress x coordinate
+  median = last_x_diff_median5[m].get();
+  diff = ((LASpoint10*)item)->x - ((LASpoint10*)last_item)->x;
+  ic_dx->compress(median, diff, n==1);
+  last_x_diff_median5[m].add(diff);
+
+  // compress y coordinate
+  k_bits = ic_dx->getK();
+  median = last_y_diff_median5[m].get();
+  diff = ((LASpoint10*)item)->y - ((LASpoint10*)last_item)->y;
+  ic_dy->compress(median, diff, (n==1) + ( k_bits < 20 ? U32_ZERO_BIT_0(k_bits) : 20 ));
+  last_y_diff_median5[m].add(diff);
+
+  // compress z coordinate with whichever of the last height of this return level or the
+  // nearest point of the previous scan line has recently predicted this return level better
+  scan_line.check(last_item[14], item[14]);
+  I32 prediction = scan_line.predict(l, last_height[l], ((LASpoint10*)item)->x, ((LASpoint10*)item)->y);
+  k_bits = (ic_dx->getK() + ic_dy->getK()) / 2;
+  ic_z->compress(prediction, ((LASpoint10*)item)->z, 20*scan_line.use_nearest + (n==1) + (k_bits < 18 ? U32_ZERO_BIT_0(k_bits) : 18));
+  scan_line.update(l, last_height[l], ((LASpoint10*)item)->x, ((LASpoint10*)item)->y, ((LASpoint10*)item)->z);
+  last_height[l] = ((LASpoint10*)item)->z;
+
+  // copy the last item
+  memcpy(last_item, item, 20);
+  return TRUE;
+}
+
+// the coders that the items are compiled for
+
+template class LASwriteItemCompressed_POINT10_v5<ArithmeticEncoder>;
+template class LASwriteItemCompressed_POINT10_v5<RANSEncoder>;
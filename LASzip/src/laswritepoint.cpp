@@ -32,13 +32,71 @@
 #include "laswritepoint.hpp"
 
 #include "arithmeticencoder.hpp"
+#include "ransencoder.hpp"
 #include "laswriteitemraw.hpp"
 #include "laswriteitemcompressed_v1.hpp"
 #include "laswriteitemcompressed_v2.hpp"
+#include "laswriteitemcompressed_v3.hpp"
+#include "laswriteitemcompressed_v4.hpp"
+#include "laswriteitemcompressed_v5.hpp"
+#include "lastrace.hpp"
+#include "lascounters.hpp"
 
 #include <string.h>
 #include <stdlib.h>
 
+// the compressed writer of an item for the entropy encoder, or 0 if the item
+// or its version is not supported
+
+template <class Encoder>
+static LASwriteItem* create_writer_compressed(const LASitem* item, Encoder* enc)
+{
+  switch (item->type)
+  {
+  case LASitem::POINT10:
+    if (item->version == 1)
+      return new LASwriteItemCompressed_POINT10_v1<Encoder>(enc);
+    else if (item->version == 2)
+      return new LASwriteItemCompressed_POINT10_v2<Encoder>(enc);
+    else if (item->version == 3)
+      return new LASwriteItemCompressed_POINT10_v3<Encoder>(enc);
+    else if (item->version == 4)
+      return new LASwriteItemCompressed_POINT10_v4<Encoder>(enc);
+    else if (item->version == 5)
+      return new LASwriteItemCompressed_POINT10_v5<Encoder>(enc);
+    else
+      return 0;
+  case LASitem::GPSTIME11:
+    if (item->version == 1)
+      return new LASwriteItemCompressed_GPSTIME11_v1<Encoder>(enc);
+    else if (item->version == 2)
+      return new LASwriteItemCompressed_GPSTIME11_v2<Encoder>(enc);
+    else
+      return 0;
+  case LASitem::RGB12:
+    if (item->version == 1)
+      return new LASwriteItemCompressed_RGB12_v1<Encoder>(enc);
+    else if (item->version == 2)
+      return new LASwriteItemCompressed_RGB12_v2<Encoder>(enc);
+    else
+      return 0;
+  case LASitem::WAVEPACKET13:
+    if (item->version == 1)
+      return new LASwriteItemCompressed_WAVEPACKET13_v1<Encoder>(enc);
+    else
+      return 0;
+  case LASitem::BYTE:
+    if (item->version == 1)
+      return new LASwriteItemCompressed_BYTE_v1<Encoder>(enc, item->size);
+    else if (item->version == 2)
+      return new LASwriteItemCompressed_BYTE_v2<Encoder>(enc, item->size);
+    else
+      return 0;
+  default:
+    return 0;
+  }
+}
+
 LASwritePoint::LASwritePoint()
 {
   outstream = 0;
@@ -56,6 +114,7 @@ LASwritePoint::LASwritePoint()
   chunk_bytes = 0;
   chunk_table_start_position = 0;
   chunk_start_position = 0;
+  chunk_trace_start = 0;
 
   rank = 0;
   process_count = 1;
@@ -86,6 +145,9 @@ BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzi
     case LASZIP_CODER_ARITHMETIC:
       enc = new ArithmeticEncoder();
       break;
+    case LASZIP_CODER_RANS:
+      enc = new RANSEncoder();
+      break;
     default:
       // entropy decoder not supported
       return FALSE;
@@ -157,50 +219,13 @@ BOOL LASwritePoint::setup(const U32 num_items, const LASitem* items, const LASzi
     memset(writers_compressed, 0, num_writers*sizeof(LASwriteItem*));
     for (i = 0; i < num_writers; i++)
     {
-      switch (items[i].type)
-      {
-      case LASitem::POINT10:
-        if (items[i].version == 1)
-          writers_compressed[i] = new LASwriteItemCompressed_POINT10_v1(enc);
-        else if (items[i].version == 2)
-          writers_compressed[i] = new LASwriteItemCompressed_POINT10_v2(enc);
-        else
-          return FALSE;
-        break;
-      case LASitem::GPSTIME11:
-        if (items[i].version == 1)
-          writers_compressed[i] = new LASwriteItemCompressed_GPSTIME11_v1(enc);
-        else if (items[i].version == 2)
-          writers_compressed[i] = new LASwriteItemCompressed_GPSTIME11_v2(enc);
-        else
-          return FALSE;
-        break;
-      case LASitem::RGB12:
-        if (items[i].version == 1)
-          writers_compressed[i] = new LASwriteItemCompressed_RGB12_v1(enc);
-        else if (items[i].version == 2)
-          writers_compressed[i] = new LASwriteItemCompressed_RGB12_v2(enc);
-        else
-          return FALSE;
-        break;
-      case LASitem::WAVEPACKET13:
-        if (items[i].version == 1)
-         writers_compressed[i] = new LASwriteItemCompressed_WAVEPACKET13_v1(enc);
-        else
-          return FALSE;
-        break;
-      case LASitem::BYTE:
-        if (items[i].version == 1)
-         writers_compressed[i] = new LASwriteItemCompressed_BYTE_v1(enc, items[i].size);
-        else if (items[i].version == 2)
-          writers_compressed[i] = new LASwriteItemCompressed_BYTE_v2(enc, items[i].size);
-        else
-          return FALSE;
-        break;
-      default:
-        return FALSE;
-      }
+      if (laszip->coder == LASZIP_CODER_RANS)
+        writers_compressed[i] = create_writer_compressed(&items[i], (RANSEncoder*)enc);
+      else
+        writers_compressed[i] = create_writer_compressed(&items[i], (ArithmeticEncoder*)enc);
+      if (writers_compressed[i] == 0) return FALSE;
     }
+    LAScounters::set_items(LAS_COUNTERS_ENCODE, num_items, items);
     if (laszip->compressor == LASZIP_COMPRESSOR_POINTWISE_CHUNKED)
     {
       if (laszip->chunk_size) chunk_size = laszip->chunk_size;
@@ -258,6 +283,7 @@ BOOL LASwritePoint::write(const U8 * const * point)
 
   if (chunk_count == chunk_size)
   {
+    LAScountersScope restart(LAS_COUNTERS_CHUNK_RESTART);
     enc->done();
     add_chunk_to_table();
     init(outstream);
@@ -267,6 +293,18 @@ BOOL LASwritePoint::write(const U8 * const * point)
 
   if (writers)
   {
+    if (enc && LAScounters::is_sample(chunk_count))
+    {
+      // this point stands for all points of the sample interval
+      U64 start[LAS_COUNTERS_EVENTS];
+      for (i = 0; i < num_writers; i++)
+      {
+        BOOL counting = LAScounters::read(start);
+        writers[i]->write(point[i]);
+        if (counting) LAScounters::add(LAS_COUNTERS_ENCODE + i, start, LAScounters::get_sample_interval());
+      }
+      return TRUE;
+    }
     for (i = 0; i < num_writers; i++)
     {
       writers[i]->write(point[i]);
@@ -274,6 +312,9 @@ BOOL LASwritePoint::write(const U8 * const * point)
   }
   else
   {
+    // the first point of a chunk starts its encoding
+    LAScountersScope restart(LAS_COUNTERS_CHUNK_RESTART);
+    chunk_trace_start = LAStrace::now();
     for (i = 0; i < num_writers; i++)
     {
       writers_raw[i]->write(point[i]);
@@ -343,12 +384,15 @@ BOOL LASwritePoint::add_chunk_to_table()
   if (chunk_size == U32_MAX) chunk_sizes[number_chunks] = chunk_count;
   chunk_bytes[number_chunks] = (U32)(position - chunk_start_position);
   chunk_start_position = position;
+  if (LAStrace::is_enabled()) LAStrace::complete("encode chunk", "laz", chunk_trace_start, number_chunks);
   number_chunks++;
   return TRUE;
 }
 
 BOOL LASwritePoint::write_chunk_table()
 {
+  LAStraceScope scope("write chunk table", "io", number_chunks);
+  LAScountersScope counters(LAS_COUNTERS_STREAM_IO);
 
   if(rank==process_count-1)
   {
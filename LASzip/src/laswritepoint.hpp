@@ -24,6 +24,9 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- samples hardware counters per item coder with LAScounters
+    18 October 2026 -- records the encoding of every chunk with LAStrace
+    18 October 2026 -- creates the rANS encoder for LASZIP_CODER_RANS
     6 September 2014 -- removed inheritance of EntropyEncoder and EntropyDecoder
     6 October 2011 -- large file support & reading with missing chunk table
     9 May 2011 -- the chunked compressor now allows variable chunk sizes
@@ -46,7 +49,7 @@
 #include "mpi.h"
 
 class LASwriteItem;
-class ArithmeticEncoder;
+class EntropyEncoder;
 
 class LASwritePoint
 {
@@ -70,7 +73,7 @@ public:
   LASwriteItem** writers;
   LASwriteItem** writers_raw;
   LASwriteItem** writers_compressed;
-  ArithmeticEncoder* enc;
+  EntropyEncoder* enc;
   // used for chunking
   U32 chunk_size;
   U32 chunk_count;
@@ -79,6 +82,7 @@ public:
   U32* chunk_sizes;
   U32* chunk_bytes;
   I64 chunk_start_position;
+  I64 chunk_trace_start;
   I64 chunk_table_start_position;
   BOOL add_chunk_to_table();
   BOOL write_chunk_table();
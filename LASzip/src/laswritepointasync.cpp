@@ -0,0 +1,343 @@
+/*
+===============================================================================
+
+  FILE:  laswritepointasync.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+
+#include "laswritepointasync.hpp"
+
+#include "laswritepoint.hpp"
+#include "bytestreamout_array.hpp"
+#include "lastrace.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#define LAS_ASYNC_EMPTY       0  // owned by the producer
+#define LAS_ASYNC_FILLED      1  // handed to the workers
+#define LAS_ASYNC_COMPRESSED  2  // waiting to be written in order
+
+struct LASwriteChunk
+{
+  U8* points;
+  U32 number;
+  U32 state;
+  I64 trace_start;
+  ByteStreamOutArray* stream;
+};
+
+// the chunks in flight live in a ring of slots. the producer fills the slot
+// of chunk 'published', the workers take chunks in order at 'taken', and the
+// chunks are written in order at 'emitted'. the counters only grow.
+
+class LASwriteChunks
+{
+public:
+  LASwritePoint* writer;
+  ByteStreamOut* outstream;
+  LASzip laszip;
+  U32 num_items;
+  U32* item_sizes;
+  U32* item_offsets;
+  U32 point_size;
+  U32 chunk_size;
+  U32 number_slots;
+  LASwriteChunk* slots;
+  U32 fill;
+  U64 published;
+  U64 taken;
+  U64 emitted;
+  BOOL emitting;
+  BOOL stop;
+  BOOL failed;
+  std::mutex lock;
+  std::condition_variable work;
+  std::condition_variable space;
+  std::vector<std::thread> threads;
+  std::vector<LASwritePoint*> workers;
+};
+
+static BOOL write_chunks_compress(LASwriteChunks* chunks, LASwritePoint* worker, LASwriteChunk* chunk, U8** point)
+{
+  chunk->trace_start = LAStrace::now();
+  chunk->stream->seek(0);
+  if (!worker->init(chunk->stream)) return FALSE;
+  for (U32 p = 0; p < chunk->number; p++)
+  {
+    U8* raw = chunk->points + p*chunks->point_size;
+    for (U32 i = 0; i < chunks->num_items; i++) point[i] = raw + chunks->item_offsets[i];
+    if (!worker->write(point)) return FALSE;
+  }
+  return worker->done();
+}
+
+// the worker that finds the next chunk in order compressed writes it and
+// any that follow while the lock is released
+
+static void write_chunks_emit(LASwriteChunks* chunks, std::unique_lock<std::mutex>& guard)
+{
+  if (chunks->emitting) return;
+  chunks->emitting = TRUE;
+  while (chunks->emitted < chunks->published)
+  {
+    LASwriteChunk* chunk = chunks->slots + (chunks->emitted % chunks->number_slots);
+    if (chunk->state != LAS_ASYNC_COMPRESSED) break;
+    guard.unlock();
+    BOOL ok = chunks->outstream->putBytes(chunk->stream->getData(), (U32)chunk->stream->tell());
+    chunks->writer->chunk_trace_start = chunk->trace_start;
+    if (ok) ok = chunks->writer->add_chunk_to_table();
+    guard.lock();
+    if (!ok) chunks->failed = TRUE;
+    chunk->state = LAS_ASYNC_EMPTY;
+    chunks->emitted++;
+    chunks->space.notify_all();
+  }
+  chunks->emitting = FALSE;
+}
+
+static void write_chunks_work(LASwriteChunks* chunks, LASwritePoint* worker)
+{
+  U8** point = new U8*[chunks->num_items];
+  std::unique_lock<std::mutex> guard(chunks->lock);
+  while (true)
+  {
+    while (!chunks->stop && (chunks->taken == chunks->published)) chunks->work.wait(guard);
+    if (chunks->taken == chunks->published) break;
+    LASwriteChunk* chunk = chunks->slots + (chunks->taken % chunks->number_slots);
+    chunks->taken++;
+    guard.unlock();
+    BOOL ok = write_chunks_compress(chunks, worker, chunk, point);
+    guard.lock();
+    if (!ok) chunks->failed = TRUE;
+    chunk->state = LAS_ASYNC_COMPRESSED;
+    write_chunks_emit(chunks, guard);
+  }
+  guard.unlock();
+  delete [] point;
+}
+
+// hands the chunk being filled to the workers and maybe waits for the next slot
+
+static BOOL write_chunks_publish(LASwriteChunks* chunks, const BOOL wait)
+{
+  std::unique_lock<std::mutex> guard(chunks->lock);
+  LASwriteChunk* chunk = chunks->slots + (chunks->published % chunks->number_slots);
+  chunk->number = chunks->fill;
+  chunk->state = LAS_ASYNC_FILLED;
+  chunks->published++;
+  chunks->fill = 0;
+  chunks->work.notify_one();
+  if (wait)
+  {
+    LASwriteChunk* next = chunks->slots + (chunks->published % chunks->number_slots);
+    while (next->state != LAS_ASYNC_EMPTY) chunks->space.wait(guard);
+  }
+  return !chunks->failed;
+}
+
+static void write_chunks_stop(LASwriteChunks* chunks)
+{
+  {
+    std::lock_guard<std::mutex> guard(chunks->lock);
+    chunks->stop = TRUE;
+    chunks->work.notify_all();
+  }
+  for (size_t t = 0; t < chunks->threads.size(); t++)
+  {
+    if (chunks->threads[t].joinable()) chunks->threads[t].join();
+  }
+  chunks->threads.clear();
+}
+
+LASwritePointAsync::LASwritePointAsync()
+{
+  chunks = 0;
+  error[0] = '\0';
+}
+
+BOOL LASwritePointAsync::init(LASwritePoint* writer, ByteStreamOut* outstream, const LASzip* laszip, const U32 threads)
+{
+  U32 i;
+
+  if ((writer == 0) || (outstream == 0) || (laszip == 0) || (threads == 0))
+  {
+    sprintf(error, "need a writer, a stream, a LASzip, and at least one thread");
+    return FALSE;
+  }
+  if ((laszip->compressor != LASZIP_COMPRESSOR_POINTWISE_CHUNKED) || (laszip->chunk_size == 0) || (laszip->chunk_size == U32_MAX))
+  {
+    sprintf(error, "need a chunked compressor with a fixed chunk size");
+    return FALSE;
+  }
+  if (chunks)
+  {
+    sprintf(error, "already initialized");
+    return FALSE;
+  }
+
+  chunks = new LASwriteChunks();
+  chunks->writer = writer;
+  chunks->outstream = outstream;
+  chunks->chunk_size = laszip->chunk_size;
+  chunks->fill = 0;
+  chunks->published = 0;
+  chunks->taken = 0;
+  chunks->emitted = 0;
+  chunks->emitting = FALSE;
+  chunks->stop = FALSE;
+  chunks->failed = FALSE;
+
+  // every chunk of the workers is one pointwise compressed stream, which
+  // are exactly the bytes of a chunk of the chunked compressor. the rANS
+  // coder (otherwise only allowed for chunked) also buffers exactly one
+  // chunk that way
+
+  if (!chunks->laszip.setup(laszip->num_items, laszip->items, LASZIP_COMPRESSOR_POINTWISE))
+  {
+    sprintf(error, "%s", chunks->laszip.get_error());
+    delete chunks;
+    chunks = 0;
+    return FALSE;
+  }
+  chunks->laszip.coder = laszip->coder;
+
+  chunks->num_items = laszip->num_items;
+  chunks->item_sizes = new U32[chunks->num_items];
+  chunks->item_offsets = new U32[chunks->num_items];
+  chunks->point_size = 0;
+  for (i = 0; i < chunks->num_items; i++)
+  {
+    chunks->item_sizes[i] = laszip->items[i].size;
+    chunks->item_offsets[i] = chunks->point_size;
+    chunks->point_size += laszip->items[i].size;
+  }
+
+  chunks->number_slots = 2*threads;
+  chunks->slots = new LASwriteChunk[chunks->number_slots];
+  memset(chunks->slots, 0, sizeof(LASwriteChunk)*chunks->number_slots);
+  for (i = 0; i < chunks->number_slots; i++)
+  {
+    chunks->slots[i].points = (U8*)malloc((size_t)chunks->chunk_size*chunks->point_size);
+    if (chunks->slots[i].points == 0)
+    {
+      sprintf(error, "cannot allocate %u chunks of %u points with %u bytes", chunks->number_slots, chunks->chunk_size, chunks->point_size);
+      return FALSE;
+    }
+    if (IS_LITTLE_ENDIAN())
+      chunks->slots[i].stream = new ByteStreamOutArrayLE((I64)chunks->chunk_size*chunks->point_size);
+    else
+      chunks->slots[i].stream = new ByteStreamOutArrayBE((I64)chunks->chunk_size*chunks->point_size);
+  }
+
+  // the workers are created here on the calling thread
+
+  for (i = 0; i < threads; i++)
+  {
+    LASwritePoint* worker = new LASwritePoint();
+    chunks->workers.push_back(worker);
+    if (!worker->setup(chunks->laszip.num_items, chunks->laszip.items, &chunks->laszip))
+    {
+      sprintf(error, "setup of LASwritePoint for worker %u failed", i);
+      return FALSE;
+    }
+  }
+  try
+  {
+    for (i = 0; i < threads; i++)
+    {
+      chunks->threads.push_back(std::thread(write_chunks_work, chunks, chunks->workers[i]));
+    }
+  }
+  catch (...)
+  {
+    sprintf(error, "cannot start worker thread %u of %u", i, threads);
+    write_chunks_stop(chunks);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+BOOL LASwritePointAsync::write(const U8 * const * point)
+{
+  U8* raw = chunks->slots[chunks->published % chunks->number_slots].points + chunks->fill*chunks->point_size;
+  for (U32 i = 0; i < chunks->num_items; i++)
+  {
+    memcpy(raw + chunks->item_offsets[i], point[i], chunks->item_sizes[i]);
+  }
+  chunks->fill++;
+  if (chunks->fill == chunks->chunk_size)
+  {
+    if (!write_chunks_publish(chunks, TRUE))
+    {
+      sprintf(error, "compressing or writing a chunk failed");
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+BOOL LASwritePointAsync::done()
+{
+  if (chunks == 0) return FALSE;
+  if (chunks->fill) write_chunks_publish(chunks, FALSE);
+  write_chunks_stop(chunks);
+  if (chunks->failed || (chunks->emitted != chunks->published))
+  {
+    sprintf(error, "compressing or writing a chunk failed");
+    return FALSE;
+  }
+  return TRUE;
+}
+
+LASwritePointAsync::~LASwritePointAsync()
+{
+  if (chunks == 0) return;
+  write_chunks_stop(chunks);
+  for (size_t w = 0; w < chunks->workers.size(); w++)
+  {
+    delete chunks->workers[w];
+  }
+  if (chunks->slots)
+  {
+    for (U32 i = 0; i < chunks->number_slots; i++)
+    {
+      if (chunks->slots[i].points) free(chunks->slots[i].points);
+      if (chunks->slots[i].stream) delete chunks->slots[i].stream;
+    }
+    delete [] chunks->slots;
+  }
+  if (chunks->item_sizes) delete [] chunks->item_sizes;
+  if (chunks->item_offsets) delete [] chunks->item_offsets;
+  delete chunks;
+}
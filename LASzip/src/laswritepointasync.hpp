@@ -0,0 +1,73 @@
+/*
+===============================================================================
+
+  FILE:  laswritepointasync.hpp
+
+  CONTENTS:
+
+    Compresses the chunks of a chunked LASwritePoint with worker threads so
+    that the thread producing the points only copies them. write() copies
+    the items of a point into the chunk that is being filled. A full chunk
+    is handed to the workers, each of which compresses whole chunks with a
+    LASwritePoint of its own into memory. The compressed chunks are written
+    to the output stream in their original order (by whichever worker
+    finishes the next one) and entered into the chunk table of the chunked
+    LASwritePoint, whose done() then writes the chunk table as usual. The
+    resulting bytes are identical to those of compressing synchronously.
+
+    At most two chunks per worker are held in memory. When all of them are
+    in use write() waits for the oldest one to be written.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for an asynchronous writer in the LASzip DLL
+
+===============================================================================
+*/
+#ifndef LAS_WRITE_POINT_ASYNC_HPP
+#define LAS_WRITE_POINT_ASYNC_HPP
+
+#include "mydefs.hpp"
+#include "laszip.hpp"
+
+class ByteStreamOut;
+class LASwritePoint;
+class LASwriteChunks;
+
+class LASwritePointAsync
+{
+public:
+  LASwritePointAsync();
+  ~LASwritePointAsync();
+
+  // the writer must be set up with a chunked 'laszip' of fixed chunk size
+  // and already be initialized on 'outstream'. starts the worker threads
+  BOOL init(LASwritePoint* writer, ByteStreamOut* outstream, const LASzip* laszip, const U32 threads);
+  BOOL write(const U8 * const * point);
+  // compresses the last chunk, waits for all chunks to be written, and
+  // stops the worker threads. the chunk table is left to writer->done()
+  BOOL done();
+
+  inline const CHAR* get_error() const { return error; };
+
+private:
+  LASwriteChunks* chunks;
+  CHAR error[256];
+};
+
+#endif
@@ -222,7 +222,7 @@ bool LASzip::check_item(const LASitem* item)
   {
   case LASitem::POINT10:
     if (item->size != 20) return return_error("POINT10 has size != 20");
-    if (item->version > 2) return return_error("POINT10 has version > 2");
+    if (item->version > 5) return return_error("POINT10 has version > 5");
     break;
   case LASitem::GPSTIME11:
     if (item->size != 8) return return_error("GPSTIME11 has size != 8");
@@ -275,6 +275,7 @@ bool LASzip::check()
 {
   if (!check_compressor(compressor)) return false;
   if (!check_coder(coder)) return false;
+  if ((coder == LASZIP_CODER_RANS) && (compressor != LASZIP_COMPRESSOR_POINTWISE_CHUNKED)) return return_error("rANS coder needs chunked compressor");
   if (!check_items(num_items, items)) return false;
   return true;
 }
@@ -531,7 +532,7 @@ bool LASzip::request_version(const U16 requested_version)
   else
   {
     if (requested_version < 1) return return_error("with compression version is at least 1");
-    if (requested_version > 2) return return_error("version larger than 2 not supported");
+    if (requested_version > 5) return return_error("version larger than 5 not supported");
   }
   U16 i;
   for (i = 0; i < num_items; i++)
@@ -539,10 +540,12 @@ bool LASzip::request_version(const U16 requested_version)
     switch (items[i].type)
     {
     case LASitem::POINT10:
+        items[i].version = requested_version;
+        break;
     case LASitem::GPSTIME11:
     case LASitem::RGB12:
     case LASitem::BYTE:
-        items[i].version = requested_version;
+        items[i].version = (requested_version < 2 ? requested_version : 2); // profiles 3 to 5 are POINT10 only
         break;
     case LASitem::WAVEPACKET13:
         items[i].version = 1; // no version 2
@@ -554,6 +557,19 @@ bool LASzip::request_version(const U16 requested_version)
   return true;
 }
 
+bool LASzip::request_coder(const U16 requested_coder)
+{
+  if (num_items == 0) return return_error("call setup() before requesting coder");
+  if (!check_coder(requested_coder)) return false;
+  if ((requested_coder == LASZIP_CODER_RANS) && (compressor != LASZIP_COMPRESSOR_POINTWISE_CHUNKED))
+  {
+    // the rANS encoder buffers the symbols of one chunk
+    return return_error("rANS coder needs chunked compressor");
+  }
+  coder = requested_coder;
+  return true;
+}
+
 bool LASzip::is_standard(U8* point_type, U16* record_length)
 {
   return is_standard(num_items, items, point_type, record_length);
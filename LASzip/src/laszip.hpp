@@ -25,6 +25,9 @@
   
   CHANGE HISTORY:
   
+    18 October 2026 -- "scanline" compression profile as POINT10 version 5
+    18 October 2026 -- "fast" and "max" compression profiles as POINT10 versions 3 and 4
+    18 October 2026 -- LASZIP_CODER_RANS as a faster-decoding alternative
     29 July 2013 -- reorganized to create an easy-to-use LASzip DLL 
     5 December 2011 -- learns the chunk table if it is missing (e.g. truncated LAZ)
     6 October 2011 -- large file support, ability to read with missing chunk table
@@ -70,10 +73,17 @@ typedef long long SIGNED_INT64;
 #define LASZIP_COMPRESSOR_DEFAULT LASZIP_COMPRESSOR_CHUNKED
 
 #define LASZIP_CODER_ARITHMETIC             0
-#define LASZIP_CODER_TOTAL_NUMBER_OF        1
+#define LASZIP_CODER_RANS                   1
+#define LASZIP_CODER_TOTAL_NUMBER_OF        2
 
 #define LASZIP_CHUNK_SIZE_DEFAULT           50000
 
+// compression profiles are requested as item versions (see request_version)
+#define LASZIP_VERSION_DEFAULT              2
+#define LASZIP_VERSION_FAST                 3
+#define LASZIP_VERSION_MAX                  4
+#define LASZIP_VERSION_SCANLINE             5
+
 //#include "laszipexport.hpp"
 #define LASZIP_DLL
 
@@ -114,6 +124,7 @@ public:
   bool setup(const unsigned short num_items, const LASitem* items, const unsigned short compressor);
   bool set_chunk_size(const unsigned int chunk_size);             /* for compressor only */
   bool request_version(const unsigned short requested_version);   /* for compressor only */
+  bool request_coder(const unsigned short requested_coder);       /* for chunked compressor only */
 
   // in case a function returns false this string describes the problem
   const char* get_error() const;
@@ -0,0 +1,143 @@
+/*
+===============================================================================
+
+  FILE:  laszip_common_v5.hpp
+  
+  CONTENTS:
+  
+    Common defines and functionalities for version 5 of POINT10 in the
+    LASitemReadCompressed and LASitemWriteCompressed.
+
+    A ScanLine keeps the coordinates of the points of the previous and of
+    the current scan line of a chunk. A new scan line begins when the scan
+    direction flag changes or after a point on the edge of the flight line.
+    It finds the point of the previous scan line that is nearest to a given
+    x and y by searching a small window around the neighbour of the point
+    before, so the coder can predict from the adjacent scan line. For each
+    return level it also tracks the recent errors of predicting z from the
+    last height of that level and from the nearest point so that the coder
+    can use whichever predicts better at the moment.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  
+  CHANGE HISTORY:
+  
+    18 October 2026 -- created for the scan line aware POINT10 version 5
+
+===============================================================================
+*/
+#ifndef LASZIP_COMMON_V5_HPP
+#define LASZIP_COMMON_V5_HPP
+
+#define SCANLINE_MAX 4096
+#define SCANLINE_WINDOW 8
+
+class ScanLine
+{
+public:
+  I32 xyz[2][SCANLINE_MAX][3];
+  U32 number[2];
+  U32 current;
+  I32 cursor;
+  const I32* nearest;
+  BOOL use_nearest;
+  U32 error_height[8];
+  U32 error_nearest[8];
+  void init()
+  {
+    number[0] = number[1] = 0;
+    current = 0;
+    cursor = -1;
+    nearest = 0;
+    use_nearest = FALSE;
+    for (U32 l = 0; l < 8; l++) error_height[l] = error_nearest[l] = 0;
+  }
+  // checks with the bit bytes of the point before and this point whether it starts a new scan line
+  inline void check(U8 last_bit_byte, U8 bit_byte)
+  {
+    if (((last_bit_byte ^ bit_byte) & 0x40) || (last_bit_byte & 0x80))
+    {
+      current = 1 - current;
+      number[current] = 0;
+      cursor = -1;
+    }
+  }
+  // predicts z of a point of return level l at x and y and sets use_nearest
+  inline I32 predict(U32 l, I32 last_height, I32 x, I32 y)
+  {
+    nearest = find(x, y);
+    if (nearest == 0)
+    {
+      use_nearest = FALSE;
+      return last_height;
+    }
+    use_nearest = (error_nearest[l] < error_height[l]);
+    return (use_nearest ? nearest[2] : last_height);
+  }
+  // updates the running prediction errors of return level l with its actual z and adds the point
+  inline void update(U32 l, I32 last_height, I32 x, I32 y, I32 z)
+  {
+    error_height[l] += error(z, last_height) - (error_height[l] >> 5);
+    if (nearest) error_nearest[l] += error(z, nearest[2]) - (error_nearest[l] >> 5);
+    if (number[current] < SCANLINE_MAX)
+    {
+      I32* p = xyz[current][number[current]++];
+      p[0] = x;
+      p[1] = y;
+      p[2] = z;
+    }
+  }
+private:
+  // returns the point of the previous scan line nearest to x and y or 0 if there is none
+  inline const I32* find(I32 x, I32 y)
+  {
+    const U32 previous = 1 - current;
+    if (number[previous] == 0) return 0;
+    I32 i, start, end;
+    if (cursor < 0)
+    {
+      start = 0;
+      end = number[previous];
+    }
+    else
+    {
+      start = (cursor > SCANLINE_WINDOW ? cursor - SCANLINE_WINDOW : 0);
+      end = cursor + SCANLINE_WINDOW + 1;
+      if (end > (I32)number[previous]) end = number[previous];
+    }
+    I64 dx, dy, d, min_d = -1;
+    for (i = start; i < end; i++)
+    {
+      dx = (I64)xyz[previous][i][0] - x;
+      dy = (I64)xyz[previous][i][1] - y;
+      d = dx*dx + dy*dy;
+      if ((min_d < 0) || (d < min_d))
+      {
+        min_d = d;
+        cursor = i;
+      }
+    }
+    return xyz[previous][cursor];
+  }
+  static inline U32 error(I32 z, I32 prediction)
+  {
+    I64 e = (I64)z - prediction;
+    if (e < 0) e = -e;
+    return (e < (1<<24) ? (U32)e : (1<<24));
+  }
+};
+
+#endif
@@ -45,6 +45,7 @@
 #include "bytestreamout_array.hpp"
 #include "bytestreamin_array.hpp"
 #include "laswritepoint.hpp"
+#include "laswritepointasync.hpp"
 #include "lasreadpoint.hpp"
 #include "lasquadtree.hpp"
 #include "lasindex.hpp"
@@ -110,10 +111,14 @@ typedef struct laszip_dll {
   laszip_point_struct point;
   U8** point_items;
   FILE* file;
+  U8* memory_data;
+  I64 memory_size;
   ByteStreamIn* streamin;
   LASreadPoint* reader;
   ByteStreamOut* streamout;
   LASwritePoint* writer;
+  LASwritePointAsync* writer_async;
+  U32 writer_threads;
   LASattributer* attributer;
   CHAR error[1024]; 
   CHAR warning[1024];
@@ -308,6 +313,14 @@ laszip_clean(
       laszip_dll->attributer = 0;
     }
 
+    // dealloc the in-memory output of the last writer
+
+    if (laszip_dll->memory_data)
+    {
+      free(laszip_dll->memory_data);
+      laszip_dll->memory_data = 0;
+    }
+
     // zero everything
 
     memset(laszip_dll, 0, sizeof(laszip_dll_struct));
@@ -1509,6 +1522,42 @@ laszip_request_compatibility_mode(
   return 0;
 }
 
+/*---------------------------------------------------------------------------*/
+LASZIP_API laszip_I32
+laszip_request_writer_threads(
+    laszip_POINTER                     pointer
+    , const laszip_U32                 threads
+)
+{
+  if (pointer == 0) return 1;
+  laszip_dll_struct* laszip_dll = (laszip_dll_struct*)pointer;
+
+  try
+  {
+    if (laszip_dll->reader)
+    {
+      sprintf(laszip_dll->error, "reader is already open");
+      return 1;
+    }
+
+    if (laszip_dll->writer)
+    {
+      sprintf(laszip_dll->error, "writer is already open");
+      return 1;
+    }
+
+    laszip_dll->writer_threads = threads;
+  }
+  catch (...)
+  {
+    sprintf(laszip_dll->error, "internal error in laszip_request_writer_threads");
+    return 1;
+  }
+
+  laszip_dll->error[0] = '\0';
+  return 0;
+}
+
 /*---------------------------------------------------------------------------*/
 LASZIP_API laszip_I32
 laszip_create_spatial_index(
@@ -1554,24 +1603,16 @@ laszip_create_spatial_index(
 }
 
 /*---------------------------------------------------------------------------*/
-LASZIP_API laszip_I32
-laszip_open_writer(
-    laszip_POINTER                     pointer
+// writes to the file or, without a file name, into a growable buffer in memory
+static laszip_I32
+laszip_open_writer_stream(
+    laszip_dll_struct*                 laszip_dll
     , const laszip_CHAR*               file_name
     , laszip_BOOL                      compress
 )
 {
-  if (pointer == 0) return 1;
-  laszip_dll_struct* laszip_dll = (laszip_dll_struct*)pointer;
-
   try
   {
-    if (file_name == 0)
-    {
-      sprintf(laszip_dll->error, "laszip_CHAR pointer 'file_name' is zero");
-      return 1;
-    }
-
     if (laszip_dll->reader)
     {
       sprintf(laszip_dll->error, "reader is already open");
@@ -1778,7 +1819,7 @@ laszip_open_writer(
 
         // add the compatibility VLR
 
-        if (laszip_add_vlr(pointer, "lascompatible\0\0", 22204, 2+2+4+148, 0, (laszip_U8*)out->takeData()))
+        if (laszip_add_vlr(laszip_dll, "lascompatible\0\0", 22204, 2+2+4+148, 0, (laszip_U8*)out->takeData()))
         {
           sprintf(laszip_dll->error, "adding the compatibility VLR");
           return 1;
@@ -1872,7 +1913,7 @@ laszip_open_writer(
 
         // add the extra bytes VLR with the additional attributes
 
-        if (laszip_add_vlr(pointer, "LASF_Spec\0\0\0\0\0\0", 4, laszip_dll->attributer->number_attributes*sizeof(LASattribute), 0, (laszip_U8*)laszip_dll->attributer->attributes))
+        if (laszip_add_vlr(laszip_dll, "LASF_Spec\0\0\0\0\0\0", 4, laszip_dll->attributer->number_attributes*sizeof(LASattribute), 0, (laszip_U8*)laszip_dll->attributer->attributes))
         {
           sprintf(laszip_dll->error, "adding the extra bytes VLR with the additional attributes");
           return 1;
@@ -2017,30 +2058,57 @@ laszip_open_writer(
       laszip->request_version(0);
     }
 
-    // open the file
-
-    laszip_dll->file = fopen(file_name, "wb");
+    // release the in-memory output of an earlier writer
 
-    if (laszip_dll->file == 0)
+    if (laszip_dll->memory_data)
     {
-      sprintf(laszip_dll->error, "cannot open file '%s'", file_name);
-      return 1;
+      free(laszip_dll->memory_data);
+      laszip_dll->memory_data = 0;
+      laszip_dll->memory_size = 0;
     }
 
-    if (setvbuf(laszip_dll->file, NULL, _IOFBF, 262144) != 0)
+    if (file_name)
     {
-      sprintf(laszip_dll->warning, "setvbuf() failed with buffer size 262144\n");
-    }
+      // open the file
 
-    if (IS_LITTLE_ENDIAN())
-      laszip_dll->streamout = new ByteStreamOutFileLE(laszip_dll->file);
-    else
-      laszip_dll->streamout = new ByteStreamOutFileBE(laszip_dll->file);
+      laszip_dll->file = fopen(file_name, "wb");
+
+      if (laszip_dll->file == 0)
+      {
+        sprintf(laszip_dll->error, "cannot open file '%s'", file_name);
+        return 1;
+      }
+
+      if (setvbuf(laszip_dll->file, NULL, _IOFBF, 262144) != 0)
+      {
+        sprintf(laszip_dll->warning, "setvbuf() failed with buffer size 262144\n");
+      }
 
-    if (laszip_dll->streamout == 0)
+      if (IS_LITTLE_ENDIAN())
+        laszip_dll->streamout = new ByteStreamOutFileLE(laszip_dll->file);
+      else
+        laszip_dll->streamout = new ByteStreamOutFileBE(laszip_dll->file);
+
+      if (laszip_dll->streamout == 0)
+      {
+        sprintf(laszip_dll->error, "could not alloc ByteStreamOutFile");
+        return 1;
+      }
+    }
+    else
     {
-      sprintf(laszip_dll->error, "could not alloc ByteStreamOutFile");
-      return 1;
+      // open the growable buffer
+
+      if (IS_LITTLE_ENDIAN())
+        laszip_dll->streamout = new ByteStreamOutArrayLE(262144);
+      else
+        laszip_dll->streamout = new ByteStreamOutArrayBE(262144);
+
+      if (laszip_dll->streamout == 0)
+      {
+        sprintf(laszip_dll->error, "could not alloc ByteStreamOutArray");
+        return 1;
+      }
     }
 
     // write the header variable after variable
@@ -2511,6 +2579,19 @@ laszip_open_writer(
       return 1;
     }
 
+    // maybe compress the chunks with worker threads
+
+    if (compress && laszip_dll->writer_threads)
+    {
+      laszip_dll->writer_async = new LASwritePointAsync();
+      if (!laszip_dll->writer_async->init(laszip_dll->writer, laszip_dll->streamout, laszip, laszip_dll->writer_threads))
+      {
+        sprintf(laszip_dll->warning, "compressing without writer threads: %s", laszip_dll->writer_async->get_error());
+        delete laszip_dll->writer_async;
+        laszip_dll->writer_async = 0;
+      }
+    }
+
     delete laszip;
 
     if (laszip_dll->lax_create)
@@ -2535,10 +2616,85 @@ laszip_open_writer(
   }
   catch (...)
   {
-    sprintf(laszip_dll->error, "internal error in laszip_open_writer '%s'", file_name);
+    sprintf(laszip_dll->error, "internal error in laszip_open_writer '%s'", (file_name ? file_name : "memory"));
+    return 1;
+  }
+
+  laszip_dll->error[0] = '\0';
+  return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+LASZIP_API laszip_I32
+laszip_open_writer(
+    laszip_POINTER                     pointer
+    , const laszip_CHAR*               file_name
+    , laszip_BOOL                      compress
+)
+{
+  if (pointer == 0) return 1;
+  laszip_dll_struct* laszip_dll = (laszip_dll_struct*)pointer;
+
+  if (file_name == 0)
+  {
+    sprintf(laszip_dll->error, "laszip_CHAR pointer 'file_name' is zero");
+    return 1;
+  }
+
+  return laszip_open_writer_stream(laszip_dll, file_name, compress);
+}
+
+/*---------------------------------------------------------------------------*/
+LASZIP_API laszip_I32
+laszip_open_writer_array(
+    laszip_POINTER                     pointer
+    , laszip_BOOL                      compress
+)
+{
+  if (pointer == 0) return 1;
+  laszip_dll_struct* laszip_dll = (laszip_dll_struct*)pointer;
+
+  if (laszip_dll->lax_create)
+  {
+    sprintf(laszip_dll->error, "cannot create spatial index for in-memory output");
     return 1;
   }
 
+  return laszip_open_writer_stream(laszip_dll, 0, compress);
+}
+
+/*---------------------------------------------------------------------------*/
+LASZIP_API laszip_I32
+laszip_get_writer_array(
+    laszip_POINTER                     pointer
+    , laszip_U8**                      data
+    , laszip_I64*                      size
+)
+{
+  if (pointer == 0) return 1;
+  laszip_dll_struct* laszip_dll = (laszip_dll_struct*)pointer;
+
+  if ((data == 0) || (size == 0))
+  {
+    sprintf(laszip_dll->error, "laszip_U8** 'data' or laszip_I64* 'size' pointer is zero");
+    return 1;
+  }
+
+  if (laszip_dll->writer)
+  {
+    sprintf(laszip_dll->error, "cannot get in-memory output before writer is closed");
+    return 1;
+  }
+
+  if (laszip_dll->memory_data == 0)
+  {
+    sprintf(laszip_dll->error, "no in-memory output was written");
+    return 1;
+  }
+
+  *data = laszip_dll->memory_data;
+  *size = laszip_dll->memory_size;
+
   laszip_dll->error[0] = '\0';
   return 0;
 }
@@ -2631,8 +2787,8 @@ laszip_write_point(
       }
     }
 
-    // write the point
-    if (!laszip_dll->writer->write(laszip_dll->point_items))
+    // write the point (or hand it to the writer threads)
+    if (laszip_dll->writer_async ? !laszip_dll->writer_async->write(laszip_dll->point_items) : !laszip_dll->writer->write(laszip_dll->point_items))
     {
 #ifdef _WIN32
       sprintf(laszip_dll->error, "writing point %I64d of %I64d total points", laszip_dll->p_count, laszip_dll->npoints);
@@ -2665,8 +2821,8 @@ laszip_write_indexed_point(
 
   try
   {
-    // write the point
-    if (!laszip_dll->writer->write(laszip_dll->point_items))
+    // write the point (or hand it to the writer threads)
+    if (laszip_dll->writer_async ? !laszip_dll->writer_async->write(laszip_dll->point_items) : !laszip_dll->writer->write(laszip_dll->point_items))
     {
 #ifdef _WIN32
       sprintf(laszip_dll->error, "writing point %I64d of %I64d total points", laszip_dll->p_count, laszip_dll->npoints);
@@ -2736,6 +2892,15 @@ laszip_close_writer(
       return 1;
     }
 
+    if (laszip_dll->writer_async)
+    {
+      BOOL drained = laszip_dll->writer_async->done();
+      if (!drained) sprintf(laszip_dll->error, "writer threads failed: %s", laszip_dll->writer_async->get_error());
+      delete laszip_dll->writer_async;
+      laszip_dll->writer_async = 0;
+      if (!drained) return 1;
+    }
+
     if (!laszip_dll->writer->done())
     {
       sprintf(laszip_dll->error, "done of LASwritePoint failed");
@@ -2849,11 +3014,21 @@ laszip_close_writer(
       laszip_dll->lax_index = 0;
     }
 
+    if (laszip_dll->file == 0)
+    {
+      // keep the complete in-memory output until the next writer is opened
+      laszip_dll->memory_size = ((ByteStreamOutArray*)laszip_dll->streamout)->getSize();
+      laszip_dll->memory_data = ((ByteStreamOutArray*)laszip_dll->streamout)->takeData();
+    }
+
     delete laszip_dll->streamout;
     laszip_dll->streamout = 0;
 
-    fclose(laszip_dll->file);
-    laszip_dll->file = 0;
+    if (laszip_dll->file)
+    {
+      fclose(laszip_dll->file);
+      laszip_dll->file = 0;
+    }
   }
   catch (...)
   {
@@ -2902,24 +3077,18 @@ laszip_exploit_spatial_index(
 }
 
 /*---------------------------------------------------------------------------*/
-LASZIP_API laszip_I32
-laszip_open_reader(
-    laszip_POINTER                     pointer
+// reads from the file or, without a file name, from the buffer in memory
+static laszip_I32
+laszip_open_reader_stream(
+    laszip_dll_struct*                 laszip_dll
     , const laszip_CHAR*               file_name
+    , const laszip_U8*                 data
+    , laszip_I64                       size
     , laszip_BOOL*                     is_compressed
 )
 {
-  if (pointer == 0) return 1;
-  laszip_dll_struct* laszip_dll = (laszip_dll_struct*)pointer;
-
   try
   {
-    if (file_name == 0)
-    {
-      sprintf(laszip_dll->error, "laszip_CHAR pointer 'file_name' is zero");
-      return 1;
-    }
-
     if (is_compressed == 0)
     {
       sprintf(laszip_dll->error, "laszip_BOOL pointer 'is_compressed' is zero");
@@ -2938,30 +3107,48 @@ laszip_open_reader(
       return 1;
     }
 
-    // open the file
+    if (file_name)
+    {
+      // open the file
 
-    laszip_dll->file = fopen(file_name, "rb");
+      laszip_dll->file = fopen(file_name, "rb");
 
-    if (laszip_dll->file == 0)
-    {
-      sprintf(laszip_dll->error, "cannot open file '%s'", file_name);
-      return 1;
-    }
+      if (laszip_dll->file == 0)
+      {
+        sprintf(laszip_dll->error, "cannot open file '%s'", file_name);
+        return 1;
+      }
 
-    if (setvbuf(laszip_dll->file, NULL, _IOFBF, 262144) != 0)
-    {
-      sprintf(laszip_dll->warning, "setvbuf() failed with buffer size 262144\n");
-    }
+      if (setvbuf(laszip_dll->file, NULL, _IOFBF, 262144) != 0)
+      {
+        sprintf(laszip_dll->warning, "setvbuf() failed with buffer size 262144\n");
+      }
 
-    if (IS_LITTLE_ENDIAN())
-      laszip_dll->streamin = new ByteStreamInFileLE(laszip_dll->file);
-    else
-      laszip_dll->streamin = new ByteStreamInFileBE(laszip_dll->file);
+      if (IS_LITTLE_ENDIAN())
+        laszip_dll->streamin = new ByteStreamInFileLE(laszip_dll->file);
+      else
+        laszip_dll->streamin = new ByteStreamInFileBE(laszip_dll->file);
 
-    if (laszip_dll->streamin == 0)
+      if (laszip_dll->streamin == 0)
+      {
+        sprintf(laszip_dll->error, "could not alloc ByteStreamInFile");
+        return 1;
+      }
+    }
+    else
     {
-      sprintf(laszip_dll->error, "could not alloc ByteStreamInFile");
-      return 1;
+      // read the buffer in place
+
+      if (IS_LITTLE_ENDIAN())
+        laszip_dll->streamin = new ByteStreamInArrayLE((U8*)data, size);
+      else
+        laszip_dll->streamin = new ByteStreamInArrayBE((U8*)data, size);
+
+      if (laszip_dll->streamin == 0)
+      {
+        sprintf(laszip_dll->error, "could not alloc ByteStreamInArray");
+        return 1;
+      }
     }
 
     // read the header variable after variable
@@ -3663,7 +3850,7 @@ laszip_open_reader(
 
             // remove the compatibility VLR
 
-            if (laszip_remove_vlr(pointer, "lascompatible\0\0", 22204))
+            if (laszip_remove_vlr(laszip_dll, "lascompatible\0\0", 22204))
             {
               sprintf(laszip_dll->error, "removing the compatibility VLR");
               return 1;
@@ -3681,7 +3868,7 @@ laszip_open_reader(
 
             if (attributer.number_attributes)
             {
-              if (laszip_add_vlr(pointer, "LASF_Spec\0\0\0\0\0\0", 4, attributer.number_attributes*sizeof(LASattribute), 0, (laszip_U8*)attributer.attributes))
+              if (laszip_add_vlr(laszip_dll, "LASF_Spec\0\0\0\0\0\0", 4, attributer.number_attributes*sizeof(LASattribute), 0, (laszip_U8*)attributer.attributes))
               {
                 sprintf(laszip_dll->error, "rewriting the extra bytes VLR without 'LAS 1.4 compatibility mode' attributes");
                 return 1;
@@ -3689,7 +3876,7 @@ laszip_open_reader(
             }
             else
             {
-              if (laszip_remove_vlr(pointer, "LASF_Spec\0\0\0\0\0\0", 4))
+              if (laszip_remove_vlr(laszip_dll, "LASF_Spec\0\0\0\0\0\0", 4))
               {
                 sprintf(laszip_dll->error, "removing the LAS 1.4 attribute VLR");
                 return 1;
@@ -3788,7 +3975,7 @@ laszip_open_reader(
 
     // should we try to exploit existing spatial indexing information
 
-    if (laszip_dll->lax_exploit)
+    if (laszip_dll->lax_exploit && file_name)
     {
       laszip_dll->lax_index = new LASindex();
 
@@ -3816,6 +4003,47 @@ laszip_open_reader(
   return 0;
 }
 
+/*---------------------------------------------------------------------------*/
+LASZIP_API laszip_I32
+laszip_open_reader(
+    laszip_POINTER                     pointer
+    , const laszip_CHAR*               file_name
+    , laszip_BOOL*                     is_compressed
+)
+{
+  if (pointer == 0) return 1;
+  laszip_dll_struct* laszip_dll = (laszip_dll_struct*)pointer;
+
+  if (file_name == 0)
+  {
+    sprintf(laszip_dll->error, "laszip_CHAR pointer 'file_name' is zero");
+    return 1;
+  }
+
+  return laszip_open_reader_stream(laszip_dll, file_name, 0, 0, is_compressed);
+}
+
+/*---------------------------------------------------------------------------*/
+LASZIP_API laszip_I32
+laszip_open_reader_array(
+    laszip_POINTER                     pointer
+    , const laszip_U8*                 data
+    , laszip_I64                       size
+    , laszip_BOOL*                     is_compressed
+)
+{
+  if (pointer == 0) return 1;
+  laszip_dll_struct* laszip_dll = (laszip_dll_struct*)pointer;
+
+  if (data == 0)
+  {
+    sprintf(laszip_dll->error, "laszip_U8 pointer 'data' is zero");
+    return 1;
+  }
+
+  return laszip_open_reader_stream(laszip_dll, 0, data, size, is_compressed);
+}
+
 /*---------------------------------------------------------------------------*/
 LASZIP_API laszip_I32
 laszip_has_spatial_index(
@@ -3971,7 +4199,7 @@ laszip_seek_point(
   try
   {
     // seek to the point
-    if (!laszip_dll->reader->seek((U32)laszip_dll->p_count, (U32)index))
+    if (!laszip_dll->reader->seek(laszip_dll->p_count, index))
     {
 #ifdef _WIN32
       sprintf(laszip_dll->error, "seeking from index %I64d to index %I64d for file with %I64d points", laszip_dll->p_count, index, laszip_dll->npoints);
@@ -4174,8 +4402,11 @@ laszip_close_reader(
       laszip_dll->lax_index = 0;
     }
 
-    fclose(laszip_dll->file);
-    laszip_dll->file = 0;
+    if (laszip_dll->file)
+    {
+      fclose(laszip_dll->file);
+      laszip_dll->file = 0;
+    }
   }
   catch (...)
   {
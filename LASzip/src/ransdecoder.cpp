@@ -0,0 +1,255 @@
+/*
+===============================================================================
+
+  FILE:  ransdecoder.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+
+#include "ransdecoder.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+RANSDecoder::RANSDecoder()
+{
+  instream = 0;
+  inbuffer = 0;
+  inbyte = endbyte = 0;
+  alloced_inbuffer = 0;
+  current = 0;
+}
+
+RANSDecoder::~RANSDecoder()
+{
+  if (inbuffer) free(inbuffer);
+}
+
+BOOL RANSDecoder::init(ByteStreamIn* instream)
+{
+  if (instream == 0) return FALSE;
+  this->instream = instream;
+
+  U32 i, number_words;
+  instream->get32bitsLE((U8*)&number_words);
+  for (i = 0; i < RANS__States; i++)
+  {
+    instream->get32bitsLE((U8*)&(states[i]));
+    if (states[i] < RANS__Low) return FALSE;
+  }
+  current = 0;
+
+  if (alloced_inbuffer < 2*number_words)
+  {
+    if (inbuffer) free(inbuffer);
+    alloced_inbuffer = 2*number_words;
+    inbuffer = (U8*)malloc(alloced_inbuffer);
+    if (inbuffer == 0)
+    {
+      fprintf(stderr,"ERROR: rANS decoder cannot allocate %u bytes\n", alloced_inbuffer);
+      alloced_inbuffer = 0;
+      return FALSE;
+    }
+  }
+  if (number_words) instream->getBytes(inbuffer, 2*number_words);
+  inbyte = inbuffer;
+  endbyte = inbuffer + 2*number_words;
+  return TRUE;
+}
+
+void RANSDecoder::done()
+{
+  instream = 0;
+}
+
+ArithmeticBitModel* RANSDecoder::createBitModel()
+{
+  ArithmeticBitModel* m = new ArithmeticBitModel();
+  return m;
+}
+
+void RANSDecoder::initBitModel(ArithmeticBitModel* m)
+{
+  m->init();
+}
+
+void RANSDecoder::destroyBitModel(ArithmeticBitModel* m)
+{
+  delete m;
+}
+
+ArithmeticModel* RANSDecoder::createSymbolModel(U32 n)
+{
+  ArithmeticModel* m = new ArithmeticModel(n, FALSE);
+  return m;
+}
+
+void RANSDecoder::initSymbolModel(ArithmeticModel* m, U32 *table)
+{
+  m->init(table);
+}
+
+void RANSDecoder::destroySymbolModel(ArithmeticModel* m)
+{
+  delete m;
+}
+
+U32 RANSDecoder::decodeBit(ArithmeticBitModel* m)
+{
+  assert(m);
+
+  U32 x = states[current];
+  U32 slot = x & (BM__MaxCount - 1);
+  U32 sym = (slot >= m->bit_0_prob);                               // decision
+
+  if (sym == 0) {
+    x = m->bit_0_prob * (x >> BM__LengthShift) + slot;
+    ++m->bit_0_count;
+  }
+  else {
+    x = (BM__MaxCount - m->bit_0_prob) * (x >> BM__LengthShift) + slot - m->bit_0_prob;
+  }
+
+  states[current] = renorm(x);                              // renormalization
+  current = (current + 1) & (RANS__States - 1);
+  if (--m->bits_until_update == 0) m->update();       // periodic model update
+
+  return sym;                                         // return data bit value
+}
+
+U32 RANSDecoder::decodeSymbol(ArithmeticModel* m)
+{
+  U32 n, sym;
+  U32 x = states[current];
+  U32 slot = x & (DM__MaxCount - 1);
+
+  if (m->decoder_table) {             // use table look-up for faster decoding
+    U32 t = slot >> m->table_shift;
+    sym = m->decoder_table[t];      // initial decision based on table look-up
+    n = m->decoder_table[t+1] + 1;
+  }
+  else {
+    sym = 0;
+    n = m->symbols;
+  }
+
+  while (n > sym + 1) {                        // finish with bisection search
+    U32 k = (sym + n) >> 1;
+    if (m->distribution[k] > slot) n = k; else sym = k;
+  }
+
+  U32 start = m->distribution[sym];
+  U32 end = (sym == m->last_symbol ? DM__MaxCount : m->distribution[sym+1]);
+  x = (end - start) * (x >> DM__LengthShift) + slot - start;
+
+  states[current] = renorm(x);                              // renormalization
+  current = (current + 1) & (RANS__States - 1);
+
+  ++m->symbol_count[sym];
+  if (--m->symbols_until_update == 0) m->update();    // periodic model update
+
+  assert(sym < m->symbols);
+
+  return sym;
+}
+
+U32 RANSDecoder::readBit()
+{
+  return readBits(1);
+}
+
+U32 RANSDecoder::readBits(U32 bits)
+{
+  assert(bits && (bits <= 32));
+
+  if (bits > 16)
+  {
+    U32 tmp = readShort();
+    bits = bits - 16;
+    U32 tmp1 = readBits(bits) << 16;
+    return (tmp1|tmp);
+  }
+
+  U32 x = states[current];
+  U32 sym = x & ((1u << bits) - 1);
+  states[current] = renorm(x >> bits);                      // renormalization
+  current = (current + 1) & (RANS__States - 1);
+
+  return sym;
+}
+
+U8 RANSDecoder::readByte()
+{
+  return (U8)readBits(8);
+}
+
+U16 RANSDecoder::readShort()
+{
+  return (U16)readBits(16);
+}
+
+U32 RANSDecoder::readInt()
+{
+  U32 lowerInt = readShort();
+  U32 upperInt = readShort();
+  return (upperInt<<16)|lowerInt;
+}
+
+F32 RANSDecoder::readFloat() /* danger in float reinterpretation */
+{
+  U32I32F32 u32i32f32;
+  u32i32f32.u32 = readInt();
+  return u32i32f32.f32;
+}
+
+U64 RANSDecoder::readInt64()
+{
+  U64 lowerInt = readInt();
+  U64 upperInt = readInt();
+  return (upperInt<<32)|lowerInt;
+}
+
+F64 RANSDecoder::readDouble() /* danger in float reinterpretation */
+{
+  U64I64F64 u64i64f64;
+  u64i64f64.u64 = readInt64();
+  return u64i64f64.f64;
+}
+
+inline U32 RANSDecoder::renorm(U32 x)
+{
+  if (x < RANS__Low)                     // one 16 bit word is always enough
+  {
+    if (inbyte == endbyte)
+    {
+      throw 4711;
+    }
+    x = (x << 16) | ((U32)inbyte[1] << 8) | (U32)inbyte[0];
+    inbyte += 2;
+  }
+  return x;
+}
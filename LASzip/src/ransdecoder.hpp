@@ -0,0 +1,104 @@
+/*
+===============================================================================
+
+  FILE:  ransdecoder.hpp
+
+  CONTENTS:
+
+    The decoder for the adaptive rANS coder of the RANSEncoder. It reads the
+    16 bit words of an entire chunk with one call when it is initialized so
+    that decoding a symbol needs neither a division nor a virtual call into
+    the ByteStreamIn but only a multiplication and a table look-up.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created as LASZIP_CODER_RANS for faster decompression
+
+===============================================================================
+*/
+#ifndef RANS_DECODER_HPP
+#define RANS_DECODER_HPP
+
+#include "mydefs.hpp"
+#include "entropydecoder.hpp"
+#include "arithmeticmodel.hpp"
+
+class RANSDecoder final : public EntropyDecoder
+{
+public:
+
+/* Constructor & Destructor                                  */
+  RANSDecoder();
+  ~RANSDecoder();
+
+/* Manage decoding                                           */
+  BOOL init(ByteStreamIn* instream);
+  void done();
+
+/* Manage an entropy model for a single bit                  */
+  ArithmeticBitModel* createBitModel();
+  void initBitModel(ArithmeticBitModel* model);
+  void destroyBitModel(ArithmeticBitModel* model);
+
+/* Manage an entropy model for n symbols (table optional)    */
+  ArithmeticModel* createSymbolModel(U32 n);
+  void initSymbolModel(ArithmeticModel* model, U32* table=0);
+  void destroySymbolModel(ArithmeticModel* model);
+
+/* Decode a bit with modelling                               */
+  U32 decodeBit(ArithmeticBitModel* model);
+
+/* Decode a symbol with modelling                            */
+  U32 decodeSymbol(ArithmeticModel* model);
+
+/* Decode a bit without modelling                            */
+  U32 readBit();
+
+/* Decode bits without modelling                             */
+  U32 readBits(U32 bits);
+
+/* Decode an unsigned char without modelling                 */
+  U8 readByte();
+
+/* Decode an unsigned short without modelling                */
+  U16 readShort();
+
+/* Decode an unsigned int without modelling                  */
+  U32 readInt();
+
+/* Decode a float without modelling                          */
+  F32 readFloat();
+
+/* Decode an unsigned 64 bit int without modelling           */
+  U64 readInt64();
+
+/* Decode a double without modelling                         */
+  F64 readDouble();
+
+private:
+  inline U32 renorm(U32 x);
+  ByteStreamIn* instream;
+  U32 states[RANS__States];
+  U32 current;
+  U8* inbuffer;
+  U8* inbyte;
+  U8* endbyte;
+  U32 alloced_inbuffer;
+};
+
+#endif
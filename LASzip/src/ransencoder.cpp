@@ -0,0 +1,249 @@
+/*
+===============================================================================
+
+  FILE:  ransencoder.cpp
+
+  CONTENTS:
+
+    see corresponding header file
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    see corresponding header file
+
+===============================================================================
+*/
+
+#include "ransencoder.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "arithmeticmodel.hpp"
+
+RANSEncoder::RANSEncoder()
+{
+  outstream = 0;
+  symbols = (RANSsymbol*)malloc(sizeof(RANSsymbol)*RANS__Buffer);
+  alloced_symbols = (symbols ? RANS__Buffer : 0);
+  number_symbols = 0;
+  outbuffer = 0;
+  alloced_outbuffer = 0;
+}
+
+RANSEncoder::~RANSEncoder()
+{
+  if (symbols) free(symbols);
+  if (outbuffer) free(outbuffer);
+}
+
+BOOL RANSEncoder::init(ByteStreamOut* outstream)
+{
+  if (outstream == 0) return FALSE;
+  if (symbols == 0) return FALSE;
+  this->outstream = outstream;
+  number_symbols = 0;
+  return TRUE;
+}
+
+void RANSEncoder::done()
+{
+  U32 i;
+  U32 states[RANS__States];
+  for (i = 0; i < RANS__States; i++) states[i] = RANS__Low;
+
+  // each symbol emits at most one 16 bit word while coding backwards
+
+  if (alloced_outbuffer < 2*number_symbols)
+  {
+    if (outbuffer) free(outbuffer);
+    alloced_outbuffer = 2*number_symbols;
+    outbuffer = (U8*)malloc(alloced_outbuffer);
+    if (outbuffer == 0)
+    {
+      fprintf(stderr,"ERROR: rANS encoder cannot allocate %u bytes\n", alloced_outbuffer);
+      alloced_outbuffer = 0;
+      outstream = 0;
+      return;
+    }
+  }
+
+  U8* outbyte = outbuffer + 2*number_symbols;
+  for (i = number_symbols; i > 0; i--)
+  {
+    const RANSsymbol* s = symbols + (i-1);
+    U32 x = states[(i-1) & (RANS__States-1)];
+    U32 x_max = ((RANS__Low >> s->shift) << 16) * s->freq;
+    if (x >= x_max)
+    {
+      *--outbyte = (U8)(x >> 8);
+      *--outbyte = (U8)(x);
+      x >>= 16;
+    }
+    states[(i-1) & (RANS__States-1)] = ((x / s->freq) << s->shift) + (x % s->freq) + s->start;
+  }
+
+  U32 number_words = (U32)((outbuffer + 2*number_symbols) - outbyte) / 2;
+  outstream->put32bitsLE((U8*)&number_words);
+  for (i = 0; i < RANS__States; i++) outstream->put32bitsLE((U8*)&(states[i]));
+  if (number_words) outstream->putBytes(outbyte, 2*number_words);
+
+  number_symbols = 0;
+  outstream = 0;
+}
+
+ArithmeticBitModel* RANSEncoder::createBitModel()
+{
+  ArithmeticBitModel* m = new ArithmeticBitModel();
+  return m;
+}
+
+void RANSEncoder::initBitModel(ArithmeticBitModel* m)
+{
+  m->init();
+}
+
+void RANSEncoder::destroyBitModel(ArithmeticBitModel* m)
+{
+  delete m;
+}
+
+ArithmeticModel* RANSEncoder::createSymbolModel(U32 n)
+{
+  ArithmeticModel* m = new ArithmeticModel(n, true);
+  return m;
+}
+
+void RANSEncoder::initSymbolModel(ArithmeticModel* m, U32* table)
+{
+  m->init(table);
+}
+
+void RANSEncoder::destroySymbolModel(ArithmeticModel* m)
+{
+  delete m;
+}
+
+void RANSEncoder::encodeBit(ArithmeticBitModel* m, U32 sym)
+{
+  assert(m && (sym <= 1));
+
+  if (sym == 0)
+  {
+    push(0, m->bit_0_prob, BM__LengthShift);
+    ++m->bit_0_count;
+  }
+  else
+  {
+    push(m->bit_0_prob, BM__MaxCount - m->bit_0_prob, BM__LengthShift);
+  }
+
+  if (--m->bits_until_update == 0) m->update();       // periodic model update
+}
+
+void RANSEncoder::encodeSymbol(ArithmeticModel* m, U32 sym)
+{
+  assert(m && (sym <= m->last_symbol));
+
+  U32 start = m->distribution[sym];
+  U32 end = (sym == m->last_symbol ? DM__MaxCount : m->distribution[sym+1]);
+  push(start, end - start, DM__LengthShift);
+
+  ++m->symbol_count[sym];
+  if (--m->symbols_until_update == 0) m->update();    // periodic model update
+}
+
+void RANSEncoder::writeBit(U32 sym)
+{
+  assert(sym < 2);
+  push(sym, 1, 1);
+}
+
+void RANSEncoder::writeBits(U32 bits, U32 sym)
+{
+  assert(bits && (bits <= 32) && (sym < (1u<<bits)));
+
+  if (bits > 16)
+  {
+    writeShort(sym&U16_MAX);
+    sym = sym >> 16;
+    bits = bits - 16;
+  }
+
+  push(sym, 1, bits);
+}
+
+void RANSEncoder::writeByte(U8 sym)
+{
+  push(sym, 1, 8);
+}
+
+void RANSEncoder::writeShort(U16 sym)
+{
+  push(sym, 1, 16);
+}
+
+void RANSEncoder::writeInt(U32 sym)
+{
+  writeShort((U16)(sym & 0xFFFF)); // lower 16 bits
+  writeShort((U16)(sym >> 16));    // UPPER 16 bits
+}
+
+void RANSEncoder::writeFloat(F32 sym) /* danger in float reinterpretation */
+{
+  U32I32F32 u32i32f32;
+  u32i32f32.f32 = sym;
+  writeInt(u32i32f32.u32);
+}
+
+void RANSEncoder::writeInt64(U64 sym)
+{
+  writeInt((U32)(sym & 0xFFFFFFFF)); // lower 32 bits
+  writeInt((U32)(sym >> 32));        // UPPER 32 bits
+}
+
+void RANSEncoder::writeDouble(F64 sym) /* danger in float reinterpretation */
+{
+  U64I64F64 u64i64f64;
+  u64i64f64.f64 = sym;
+  writeInt64(u64i64f64.u64);
+}
+
+inline void RANSEncoder::push(U32 start, U32 freq, U32 shift)
+{
+  assert(freq && ((start + freq) <= (1u << shift)));
+  if ((number_symbols == alloced_symbols) && !grow()) return;
+  RANSsymbol* s = symbols + number_symbols++;
+  s->start = (U16)start;
+  s->freq = (U16)freq;
+  s->shift = (U16)shift;
+}
+
+BOOL RANSEncoder::grow()
+{
+  RANSsymbol* more = (RANSsymbol*)realloc(symbols, sizeof(RANSsymbol)*2*alloced_symbols);
+  if (more == 0)
+  {
+    fprintf(stderr,"ERROR: rANS encoder cannot buffer more than %u symbols\n", alloced_symbols);
+    return FALSE;
+  }
+  symbols = more;
+  alloced_symbols = 2*alloced_symbols;
+  return TRUE;
+}
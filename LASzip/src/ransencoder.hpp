@@ -0,0 +1,121 @@
+/*
+===============================================================================
+
+  FILE:  ransencoder.hpp
+
+  CONTENTS:
+
+    An adaptive range asymmetric numeral system (rANS) encoder that can be
+    used by all compressed items in place of the ArithmeticEncoder. It uses
+    the same ArithmeticModel and ArithmeticBitModel (with their 15 and 13 bit
+    probabilities) so it compresses about as well as arithmetic coding.
+
+    Because rANS pops symbols in the opposite order in which they are pushed
+    the encoder only records the probability intervals of the symbols while
+    the models adapt and codes them backwards with RANS__States interleaved
+    32 bit states in done(). This buffers one chunk of symbols in memory.
+
+    The output for each chunk is:
+      U32  number_of_words               4 bytes
+      U32  states[RANS__States]          4 bytes each
+      U16  words[number_of_words]        2 bytes each
+    and the decoder renormalizes by pulling these 16 bit words in order.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2014, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the COPYING file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created as LASZIP_CODER_RANS for faster decompression
+
+===============================================================================
+*/
+#ifndef RANS_ENCODER_HPP
+#define RANS_ENCODER_HPP
+
+#include "mydefs.hpp"
+#include "entropyencoder.hpp"
+
+class RANSEncoder final : public EntropyEncoder
+{
+public:
+
+/* Constructor & Destructor                                  */
+  RANSEncoder();
+  ~RANSEncoder();
+
+/* Manage encoding                                           */
+  BOOL init(ByteStreamOut* outstream);
+  void done();
+
+/* Manage an entropy model for a single bit                  */
+  ArithmeticBitModel* createBitModel();
+  void initBitModel(ArithmeticBitModel* model);
+  void destroyBitModel(ArithmeticBitModel* model);
+
+/* Manage an entropy model for n symbols (table optional)    */
+  ArithmeticModel* createSymbolModel(U32 n);
+  void initSymbolModel(ArithmeticModel* model, U32 *table=0);
+  void destroySymbolModel(ArithmeticModel* model);
+
+/* Encode a bit with modelling                               */
+  void encodeBit(ArithmeticBitModel* model, U32 sym);
+
+/* Encode a symbol with modelling                            */
+  void encodeSymbol(ArithmeticModel* model, U32 sym);
+
+/* Encode a bit without modelling                            */
+  void writeBit(U32 sym);
+
+/* Encode bits without modelling                             */
+  void writeBits(U32 bits, U32 sym);
+
+/* Encode an unsigned char without modelling                 */
+  void writeByte(U8 sym);
+
+/* Encode an unsigned short without modelling                */
+  void writeShort(U16 sym);
+
+/* Encode an unsigned int without modelling                  */
+  void writeInt(U32 sym);
+
+/* Encode a float without modelling                          */
+  void writeFloat(F32 sym);
+
+/* Encode an unsigned 64 bit int without modelling           */
+  void writeInt64(U64 sym);
+
+/* Encode a double without modelling                         */
+  void writeDouble(F64 sym);
+
+private:
+  struct RANSsymbol
+  {
+    U16 start;
+    U16 freq;
+    U16 shift;
+  };
+  inline void push(U32 start, U32 freq, U32 shift);
+  BOOL grow();
+
+  ByteStreamOut* outstream;
+  RANSsymbol* symbols;
+  U32 number_symbols;
+  U32 alloced_symbols;
+  U8* outbuffer;
+  U32 alloced_outbuffer;
+};
+
+#endif
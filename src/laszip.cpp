@@ -61,8 +61,14 @@ using namespace std;
 #include "geoprojectionconverter.hpp"
 #include "lasindex.hpp"
 #include "lasquadtree.hpp"
+#include "laslod.hpp"
+#include "laspolygon.hpp"
+#include "lasgrid.hpp"
+#include "laspipeline.hpp"
 #include "laswritepoint.hpp"
 #include "arithmeticencoder.hpp"
+#include "lastrace.hpp"
+#include "lascounters.hpp"
 
 #include "mpi.h"
 
@@ -88,6 +94,21 @@ void usage(bool error=false, bool wait=false)
   fprintf(stderr,"laszip -i lidar.laz -o lidar_unzipped.las\n");
   fprintf(stderr,"laszip -i lidar.las -stdout -olaz > lidar.laz\n");
   fprintf(stderr,"laszip -stdin -o lidar.laz < lidar.las\n");
+  fprintf(stderr,"laszip -i lidar.las -o lidar_lod.laz -lod -lod_levels 5 -lod_spacing 7\n");
+  fprintf(stderr,"laszip -i tiles.laz -o lidar_sorted.laz -sort_gps_time\n");
+  fprintf(stderr,"laszip -i tiles.laz -o flightline.laz -split_flightlines\n");
+  fprintf(stderr,"laszip -lof tiles.txt -build_catalog tiles.lac\n");
+  fprintf(stderr,"laszip -catalog tiles.lac -inside 630000 4834000 631000 4835000 -merged -o aoi.laz\n");
+  fprintf(stderr,"laszip -i lidar.laz -clip_polygon boundary.shp -o clipped.laz\n");
+  fprintf(stderr,"laszip -i tiles*.laz -merged -o unique.laz -remove_duplicates\n");
+  fprintf(stderr,"laszip -i flightlines.laz -o unique.laz -remove_duplicates_with_gps_time\n");
+  fprintf(stderr,"laszip -i lidar.las -o lidar.laz -grid dem.bil -grid_step 1.0 -grid_method min mean idw -grid_class 2 9\n");
+  fprintf(stderr,"laszip -i lidar.las -o lidar.laz -trace timeline.json -trace_events 100000\n");
+  fprintf(stderr,"laszip -i lidar.laz -o lidar.las -counters -counters_sample 64\n");
+  fprintf(stderr,"laszip -i lidar.las -o lidar.laz -auto_tune -auto_tune_log tuned.txt\n");
+  fprintf(stderr,"laszip -i lidar.las -o lidar.laz -pipeline -pipeline_threads 2 -stats\n");
+  fprintf(stderr,"laszip -i lidar.las -compare lidar_unzipped.las -compare_report 20\n");
+  fprintf(stderr,"laszip -i tiles*.laz -build_lax -append\n");
   fprintf(stderr,"laszip -h\n");
   if (wait)
   {
@@ -97,6 +118,19 @@ void usage(bool error=false, bool wait=false)
   exit(error);
 }
 
+extern BOOL laszip_trace_start(U32 capacity);
+extern I64 laszip_trace_write(const CHAR* file_name, BOOL verbose);
+extern BOOL laszip_counters_start(U32 sample_interval);
+extern void laszip_counters_report();
+extern I64 laszip_pipeline(LASreader* lasreader, LASwriter* laswriter, const LASpolygon* polygon, LASgrid* lasgrid, LASindex* lasindex, LASpipelineStats* stats, BOOL inventory, I64 number, BOOL threaded, U32 threads);
+extern void laszip_stats_report(const LASpipelineStats* stats, const LASheader* header);
+
+// set by '-trace'. the timeline is written when all processes finish without error
+static const CHAR* trace_name = 0;
+static BOOL trace_verbose = FALSE;
+// set by '-counters' when some process can count
+static BOOL counters = FALSE;
+
 static void byebye(bool error=false, bool wait=false)
 {
   if (wait)
@@ -104,6 +138,14 @@ static void byebye(bool error=false, bool wait=false)
     fprintf(stderr,"<press ENTER>\n");
     getc(stdin);
   }
+  if (counters && !error)
+  {
+    laszip_counters_report();
+  }
+  if (trace_name && !error)
+  {
+    laszip_trace_write(trace_name, trace_verbose);
+  }
   MPI_Finalize();
   exit(error);
 }
@@ -117,6 +159,17 @@ static double taketime()
 extern int laszip_gui(int argc, char *argv[], LASreadOpener* lasreadopener);
 #endif
 
+extern I64 laszip_lod(LASreader* lasreader, LASwriteOpener* laswriteopener, U32 levels, U32 spacing, BOOL verbose);
+extern I64 laszip_sort(LASreader* lasreader, LASwriteOpener* laswriteopener, BOOL split_flightlines, BOOL verbose);
+extern I64 laszip_range(LASreader* lasreader, LASwriteOpener* laswriteopener, BOOL verbose);
+extern I64 laszip_catalog(LASreadOpener* lasreadopener, const CHAR* catalog_name, BOOL verbose);
+extern I64 laszip_compare(LASreadOpener* lasreadopener, const CHAR* other_name, U32 max_report, BOOL verbose);
+extern I64 laszip_index(LASreadOpener* lasreadopener, F32 tile_size, U32 threshold, U32 minimum_points, I32 maximum_intervals, BOOL append, BOOL verbose);
+extern I64 laszip_clip(LASreader* lasreader, LASwriteOpener* laswriteopener, const LASpolygon* polygon, BOOL verbose);
+extern I64 laszip_grid(LASgrid* grid, const CHAR* file_name, BOOL verbose);
+extern I64 laszip_dedupe(LASreader* lasreader, LASwriteOpener* laswriteopener, BOOL use_gps_time, BOOL verbose);
+extern I64 laszip_tune(LASreadOpener* lasreadopener, LASwriteOpener* laswriteopener, const CHAR* log_name, BOOL verbose);
+
 #ifdef COMPILE_WITH_MULTI_CORE
 extern int laszip_multi_core(int argc, char *argv[], GeoProjectionConverter* geoprojectionconverter, LASreadOpener* lasreadopener, LASwriteOpener* laswriteopener, int cores);
 #endif
@@ -149,6 +202,29 @@ int main(int argc, char *argv[])
   U32 threshold = 1000;
   U32 minimum_points = 100000;
   I32 maximum_intervals = -20;
+  BOOL lod = FALSE;
+  U32 lod_levels = 0;
+  U32 lod_spacing = LAS_LOD_SPACING_DEFAULT;
+  BOOL sort_gps_time = FALSE;
+  BOOL split_flightlines = FALSE;
+  CHAR* catalog_name = 0;
+  BOOL remove_duplicates = FALSE;
+  BOOL remove_duplicates_with_gps_time = FALSE;
+  CHAR* grid_name = 0;
+  F32 grid_step = 1.0f;
+  U32 grid_methods = 0;
+  U32 grid_classes[32];
+  U32 grid_class_number = 0;
+  U32 trace_events = LAS_TRACE_CAPACITY_DEFAULT;
+  U32 counters_sample = LAS_COUNTERS_SAMPLE_DEFAULT;
+  BOOL auto_tune = FALSE;
+  const CHAR* auto_tune_log = 0;
+  BOOL pipeline_threaded = FALSE;
+  U32 pipeline_threads = 1;
+  BOOL stats = FALSE;
+  const CHAR* compare_name = 0;
+  U32 compare_report = 10;
+  BOOL build_lax = FALSE;
   double start_time = 0.0;
   double total_start_time = 0;
 
@@ -235,6 +311,224 @@ int main(int argc, char *argv[])
     {
       lax = TRUE;
     }
+    else if (strcmp(argv[i],"-lod") == 0)
+    {
+      lod = TRUE;
+    }
+    else if (strcmp(argv[i],"-lod_levels") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: number\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      lod = TRUE;
+      lod_levels = atoi(argv[i]);
+    }
+    else if (strcmp(argv[i],"-lod_spacing") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: number\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      lod = TRUE;
+      lod_spacing = atoi(argv[i]);
+    }
+    else if (strcmp(argv[i],"-sort_gps_time") == 0)
+    {
+      sort_gps_time = TRUE;
+    }
+    else if (strcmp(argv[i],"-split_flightlines") == 0)
+    {
+      sort_gps_time = TRUE;
+      split_flightlines = TRUE;
+    }
+    else if (strcmp(argv[i],"-remove_duplicates") == 0)
+    {
+      remove_duplicates = TRUE;
+    }
+    else if (strcmp(argv[i],"-remove_duplicates_with_gps_time") == 0)
+    {
+      remove_duplicates = TRUE;
+      remove_duplicates_with_gps_time = TRUE;
+    }
+    else if (strcmp(argv[i],"-trace") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: file_name\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      trace_name = argv[i];
+    }
+    else if (strcmp(argv[i],"-counters") == 0)
+    {
+      counters = TRUE;
+    }
+    else if (strcmp(argv[i],"-counters_sample") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: number\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      counters = TRUE;
+      counters_sample = (U32)atoi(argv[i]);
+      if (counters_sample == 0)
+      {
+        fprintf(stderr,"ERROR: '%s' needs a positive number of points\n", argv[i-1]);
+        usage(true);
+      }
+    }
+    else if (strcmp(argv[i],"-auto_tune") == 0)
+    {
+      auto_tune = TRUE;
+    }
+    else if (strcmp(argv[i],"-auto_tune_log") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: file_name\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      auto_tune = TRUE;
+      auto_tune_log = argv[i];
+    }
+    else if (strcmp(argv[i],"-pipeline") == 0)
+    {
+      pipeline_threaded = TRUE;
+    }
+    else if (strcmp(argv[i],"-pipeline_threads") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: number\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      pipeline_threaded = TRUE;
+      pipeline_threads = (U32)atoi(argv[i]);
+      if (pipeline_threads == 0)
+      {
+        fprintf(stderr,"ERROR: '%s' needs a positive number of threads\n", argv[i-1]);
+        usage(true);
+      }
+    }
+    else if (strcmp(argv[i],"-stats") == 0)
+    {
+      stats = TRUE;
+    }
+    else if (strcmp(argv[i],"-compare") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: file_name\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      compare_name = argv[i];
+    }
+    else if (strcmp(argv[i],"-compare_report") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: number\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      compare_report = (U32)atoi(argv[i]);
+    }
+    else if (strcmp(argv[i],"-build_lax") == 0)
+    {
+      build_lax = TRUE;
+    }
+    else if (strcmp(argv[i],"-trace_events") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: number\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      trace_events = (U32)atoi(argv[i]);
+      if (trace_events == 0)
+      {
+        fprintf(stderr,"ERROR: '%s' needs a positive number of events\n", argv[i-1]);
+        usage(true);
+      }
+    }
+    else if (strcmp(argv[i],"-build_catalog") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: file_name\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      catalog_name = argv[i];
+    }
+    else if (strcmp(argv[i],"-grid") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: file_name\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      grid_name = argv[i];
+    }
+    else if (strcmp(argv[i],"-grid_step") == 0)
+    {
+      if ((i+1) >= argc)
+      {
+        fprintf(stderr,"ERROR: '%s' needs 1 argument: step\n", argv[i]);
+        usage(true);
+      }
+      i++;
+      grid_step = (F32)atof(argv[i]);
+      if (grid_step <= 0.0f)
+      {
+        fprintf(stderr,"ERROR: grid step needs to be positive\n");
+        usage(true);
+      }
+    }
+    else if (strcmp(argv[i],"-grid_method") == 0)
+    {
+      if (((i+1) >= argc) || (LASgrid::parse_method(argv[i+1]) == 0))
+      {
+        fprintf(stderr,"ERROR: '%s' needs at least 1 argument: min, max, mean, count, or idw\n", argv[i]);
+        usage(true);
+      }
+      while (((i+1) < argc) && LASgrid::parse_method(argv[i+1]))
+      {
+        i++;
+        grid_methods |= LASgrid::parse_method(argv[i]);
+      }
+    }
+    else if (strcmp(argv[i],"-grid_class") == 0)
+    {
+      if (((i+1) >= argc) || (argv[i+1][0] < '0') || (argv[i+1][0] > '9'))
+      {
+        fprintf(stderr,"ERROR: '%s' needs at least 1 argument: classification\n", argv[i]);
+        usage(true);
+      }
+      while (((i+1) < argc) && ('0' <= argv[i+1][0]) && (argv[i+1][0] <= '9'))
+      {
+        i++;
+        if ((atoi(argv[i]) > 31) || (grid_class_number == 32))
+        {
+          fprintf(stderr,"ERROR: grid classification '%s' needs to be between 0 and 31\n", argv[i]);
+          usage(true);
+        }
+        grid_classes[grid_class_number++] = atoi(argv[i]);
+      }
+    }
     else if (strcmp(argv[i],"-append") == 0)
     {
       append = TRUE;
@@ -368,6 +662,73 @@ int main(int argc, char *argv[])
     usage(true, argc==1);
   }
 
+  // maybe record a timeline of every process
+
+  if (trace_name)
+  {
+    trace_verbose = verbose;
+    if (!laszip_trace_start(trace_events)) byebye(true, argc==1);
+  }
+
+  // maybe count hardware events of the item coders
+
+  if (counters)
+  {
+    counters = laszip_counters_start(counters_sample);
+  }
+
+  // maybe only catalog the input files
+
+  if (catalog_name)
+  {
+    if (laszip_catalog(&lasreadopener, catalog_name, verbose) < 0) byebye(true, argc==1);
+    byebye(false, argc==1);
+  }
+
+  // maybe only compare the points of the input with those of another file
+
+  if (compare_name)
+  {
+    I64 different = laszip_compare(&lasreadopener, compare_name, compare_report, verbose);
+    byebye(different != 0, argc==1);
+  }
+
+  // maybe only create the spatial index of the input files
+
+  if (build_lax)
+  {
+    if (laszip_index(&lasreadopener, tile_size, threshold, minimum_points, maximum_intervals, append, verbose) < 0) byebye(true, argc==1);
+    byebye(false, argc==1);
+  }
+
+  // maybe grid a DEM or DSM while compressing
+
+  if (grid_name)
+  {
+    if (grid_methods == 0) grid_methods = LAS_GRID_MEAN;
+    if (lasreadopener.get_file_name_number() > 1)
+    {
+      fprintf(stderr,"ERROR: '-grid' needs a single input file\n");
+      byebye(true, argc==1);
+    }
+  }
+
+  // the LOD and the sort modes write all points and would not clip them
+
+  if (lasreadopener.get_clip_polygon() && (lod || sort_gps_time))
+  {
+    fprintf(stderr,"ERROR: '-clip_polygon' cannot be combined with '%s'\n", (lod ? "-lod" : (split_flightlines ? "-split_flightlines" : "-sort_gps_time")));
+    byebye(true, argc==1);
+  }
+
+  // nor would they or clipping remove duplicates
+
+  if (remove_duplicates && (lod || sort_gps_time || lasreadopener.get_clip_polygon()))
+  {
+    fprintf(stderr,"ERROR: '%s' cannot be combined with '%s'\n", (remove_duplicates_with_gps_time ? "-remove_duplicates_with_gps_time" : "-remove_duplicates"), (lod ? "-lod" : (sort_gps_time ? (split_flightlines ? "-split_flightlines" : "-sort_gps_time") : "-clip_polygon")));
+    byebye(true, argc==1);
+  }
+
   // check output
 
   if (laswriteopener.is_piped())
@@ -404,6 +765,24 @@ int main(int argc, char *argv[])
 
   format_not_specified = !laswriteopener.format_was_specified();
 
+  // maybe pick the chunk size and the buffer sizes with a probe run
+
+  if (auto_tune)
+  {
+    if ((lasreadopener.get_file_name_number() != 1) || lasreadopener.is_merged() || lasreadopener.is_piped() || laswriteopener.is_piped())
+    {
+      fprintf(stderr,"WARNING: auto-tuning needs a single input and an output file. ignoring '-auto_tune' ...\n");
+    }
+    else if (!format_not_specified && (laswriteopener.get_format() != LAS_TOOLS_FORMAT_LAZ))
+    {
+      fprintf(stderr,"WARNING: auto-tuning needs LAZ output. ignoring '-auto_tune' ...\n");
+    }
+    else if (laszip_tune(&lasreadopener, &laswriteopener, auto_tune_log, verbose) < 0)
+    {
+      byebye(true, argc==1);
+    }
+  }
+
   if (verbose) total_start_time = taketime();
 
   // loop over multiple input files
@@ -461,6 +840,10 @@ int main(int argc, char *argv[])
     else
     {
       I64 start_of_waveform_data_packet_record = 0;
+      BOOL gridded = FALSE;
+      // the statistics of the points this process writes with a pipeline
+      LASpipelineStats pipeline_stats;
+      BOOL stats_collected = FALSE;
 
       // create output file name if no output was specified 
       if (!laswriteopener.active())
@@ -749,11 +1132,13 @@ int main(int argc, char *argv[])
             lasindex.prepare(lasquadtree, threshold);
   
             // compress points and add to index
-            while (lasreader->read_point())
+            int rank;
+            MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+            if (laszip_pipeline(lasreader, laswriter, 0, 0, &lasindex, ((stats && (rank == 0)) ? &pipeline_stats : 0), FALSE, -1, pipeline_threaded, pipeline_threads) < 0)
             {
-              lasindex.add(lasreader->point.get_x(), lasreader->point.get_y(), (U32)(laswriter->p_count));
-              laswriter->write_point(&lasreader->point);
+              byebye(true, argc==1);
             }
+            stats_collected = stats;
 
             // flush the writer
             bytes_written = laswriter->close();
@@ -792,6 +1177,31 @@ int main(int argc, char *argv[])
               }
               laswriter->update_header(&lasreader->header, TRUE);
             }
+            else if (lod)
+            {
+              bytes_written = laszip_lod(lasreader, &laswriteopener, lod_levels, lod_spacing, verbose);
+              if (bytes_written < 0) byebye(true, argc==1);
+            }
+            else if (sort_gps_time)
+            {
+              bytes_written = laszip_sort(lasreader, &laswriteopener, split_flightlines, verbose);
+              if (bytes_written < 0) byebye(true, argc==1);
+            }
+            else if (lasreadopener.get_clip_polygon())
+            {
+              bytes_written = laszip_clip(lasreader, &laswriteopener, lasreadopener.get_clip_polygon(), verbose);
+              if (bytes_written < 0) byebye(true, argc==1);
+            }
+            else if (remove_duplicates)
+            {
+              bytes_written = laszip_dedupe(lasreader, &laswriteopener, remove_duplicates_with_gps_time, verbose);
+              if (bytes_written < 0) byebye(true, argc==1);
+            }
+            else if (laswriteopener.get_format() > LAS_TOOLS_FORMAT_LAZ) // BIN, QFIT, TXT, or WRL
+            {
+              bytes_written = laszip_range(lasreader, &laswriteopener, verbose);
+              if (bytes_written < 0) byebye(true, argc==1);
+            }
             else // end_of_points <= -1
             {
 // Start of straight las -> laz file conversion case, no waveform, lax, or end_of_points parmaeter
@@ -857,19 +1267,32 @@ int main(int argc, char *argv[])
 
               }
 
+              // **************** Maybe accumulate a DEM or DSM from the points of this process
+              LASgrid* lasgrid = 0;
+              if (grid_name)
+              {
+                lasgrid = new LASgrid();
+                if (!lasgrid->setup(lasreader->header.min_x, lasreader->header.min_y, lasreader->header.max_x, lasreader->header.max_y, grid_step, grid_methods))
+                {
+                  byebye(true, argc==1);
+                }
+                for (U32 c = 0; c < grid_class_number; c++) lasgrid->add_class(grid_classes[c]);
+              }
+
               // **************** First iteration to determine point write offsets
               I64 point_start_offset, point_end_offset;
               point_start_offset = laswriter->get_stream()->tell();
+              I64 point_last = point_end - 1;
+              I64 pass_start = LAStrace::now();
+              lasreader->prefetch(1, &point_start, &point_last);
               lasreader->seek(point_start);
               dbg(3, "rank %i point_start %lli point_end %lli", rank, point_start, point_end);
-              while (lasreader->read_point())
+              if (laszip_pipeline(lasreader, laswriter, 0, lasgrid, 0, (stats ? &pipeline_stats : 0), FALSE, point_end-point_start, pipeline_threaded, pipeline_threads) < 0)
               {
-                laswriter->write_point(&lasreader->point);
-                if(laswriter->p_count == point_end-point_start)
-                {
-                  break;
-                }
+                byebye(true, argc==1);
               }
+              stats_collected = stats;
+              if (LAStrace::is_enabled()) LAStrace::complete("count pass", "phase", pass_start, point_end-point_start);
               MPI_Barrier(MPI_COMM_WORLD);
               if (lasreader->header.laszip == NULL) // las -> laz
               {
@@ -913,16 +1336,15 @@ int main(int argc, char *argv[])
               {
                 laswriter->get_writer()->chunk_start_position = laswriter->get_stream()->tell();
               }
+              pass_start = LAStrace::now();
+              lasreader->prefetch(1, &point_start, &point_last);
               lasreader->seek(point_start);
               dbg(3, "write point loop start, rank %i, point_start %lli, write_point_offset %lli", rank, point_start, write_point_offset);
-              while (lasreader->read_point())
+              if (laszip_pipeline(lasreader, laswriter, 0, 0, 0, 0, FALSE, point_end-point_start, pipeline_threaded, pipeline_threads) < 0)
               {
-                laswriter->write_point(&lasreader->point);
-                if(laswriter->p_count == point_end-point_start)
-                {
-                  break;
-                }
+                byebye(true, argc==1);
               }
+              if (LAStrace::is_enabled()) LAStrace::complete("write pass", "phase", pass_start, point_end-point_start);
               MPI_Barrier(MPI_COMM_WORLD);
               if (lasreader->header.laszip == NULL) // las -> laz
               {
@@ -1008,47 +1430,87 @@ int main(int argc, char *argv[])
                   //laswriter->close();
                 }
               }
+
+              // **** Merge the partial rasters of all processes and write them
+              if (lasgrid)
+              {
+                if (laszip_grid(lasgrid, grid_name, verbose) < 0) byebye(true, argc==1);
+                delete lasgrid;
+                gridded = TRUE;
+              }
             }
             // flush the writer
             // TODO, close things cleanly, some of what goes on in close() happens above
             //bytes_written = laswriter->close();
           }
         }
+        else if (remove_duplicates)
+        {
+          // merged files are divided among the processes by reading up to each share
+          bytes_written = laszip_dedupe(lasreader, &laswriteopener, remove_duplicates_with_gps_time, verbose);
+          if (bytes_written < 0) byebye(true, argc==1);
+        }
         else
         {
+          // without a populated header (e.g. merged files or ASCII) the points cannot
+          // be divided among the processes, so process 0 writes all of them with a
+          // real writer instead of the nil writer of the first iteration
+          int rank;
+          MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+          delete laswriter;
+          laswriteopener.set_use_nil(rank != 0);
+          laswriter = laswriteopener.open(&lasreader->header);
+          if (laswriter == 0)
+          {
+            fprintf(stderr, "ERROR: could not open laswriter\n");
+            byebye(true, argc==1);
+          }
+          if ((rank == 0) && laswriter->get_writer())
+          {
+            // process 0 writes the whole file, so it also writes the chunk table
+            // that is otherwise left to the last process
+            laswriter->get_writer()->rank = 0;
+            laswriter->get_writer()->process_count = 1;
+          }
+
           if (lax && (lasreader->header.min_x < lasreader->header.max_x) && (lasreader->header.min_y < lasreader->header.max_y))
           {
             // setup the quadtree
             LASquadtree* lasquadtree = new LASquadtree;
             lasquadtree->setup(lasreader->header.min_x, lasreader->header.max_x, lasreader->header.min_y, lasreader->header.max_y, tile_size);
 
-            // create lax index
+            // create lax index. only process 0 writes the file, so only it indexes
             LASindex lasindex;
             lasindex.prepare(lasquadtree, threshold);
   
             // compress points and add to index
-            while (lasreader->read_point())
+            if (laszip_pipeline(lasreader, laswriter, 0, 0, (rank == 0 ? &lasindex : 0), ((stats && (rank == 0)) ? &pipeline_stats : 0), TRUE, -1, pipeline_threaded, pipeline_threads) < 0)
             {
-              lasindex.add(lasreader->point.get_x(), lasreader->point.get_y(), (U32)(laswriter->p_count));
-              laswriter->write_point(&lasreader->point);
-              laswriter->update_inventory(&lasreader->point);
+              byebye(true, argc==1);
             }
+            stats_collected = stats;
+
+            // update the header
+            laswriter->update_header(&lasreader->header, TRUE);
 
             // flush the writer
             bytes_written = laswriter->close();
 
-            // adaptive coarsening
-            lasindex.complete(minimum_points, maximum_intervals);
-
-            if (append)
-            {
-              // append lax to file
-              lasindex.append(laswriteopener.get_file_name());
-            }
-            else
+            if (rank == 0)
             {
-              // write lax to file
-              lasindex.write(laswriteopener.get_file_name());
+              // adaptive coarsening
+              lasindex.complete(minimum_points, maximum_intervals);
+
+              if (append)
+              {
+                // append lax to file
+                lasindex.append(laswriteopener.get_file_name());
+              }
+              else
+              {
+                // write lax to file
+                lasindex.write(laswriteopener.get_file_name());
+              }
             }
           }
           else
@@ -1072,19 +1534,20 @@ int main(int argc, char *argv[])
             }
             else
             {
-              while (lasreader->read_point())
+              const LASpolygon* polygon = lasreadopener.get_clip_polygon();
+              if (laszip_pipeline(lasreader, laswriter, polygon, 0, 0, ((stats && (rank == 0)) ? &pipeline_stats : 0), TRUE, -1, pipeline_threaded, pipeline_threads) < 0)
               {
-                laswriter->write_point(&lasreader->point);
-                laswriter->update_inventory(&lasreader->point);
+                byebye(true, argc==1);
               }
+              stats_collected = stats;
             }
-          }
 
-          // update the header
-          laswriter->update_header(&lasreader->header, TRUE);
+            // update the header
+            laswriter->update_header(&lasreader->header, TRUE);
 
-          // flush the writer
-          bytes_written = laswriter->close();
+            // flush the writer
+            bytes_written = laswriter->close();
+          }
         }
       }
 
@@ -1096,6 +1559,23 @@ int main(int argc, char *argv[])
       if (verbose) fprintf(stderr,"%g secs to write %lld bytes for '%s' with %lld points of type %d\n", taketime()-start_time, bytes_written, laswriteopener.get_file_name(), lasreader->p_count, lasreader->header.point_data_format);
 #endif
 
+      if (stats)
+      {
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if (stats_collected)
+          laszip_stats_report(&pipeline_stats, &lasreader->header);
+        else if (rank == 0)
+          fprintf(stderr,"WARNING: no statistics collected. '-stats' only works for plain LAS/LAZ compression or decompression\n");
+      }
+
+      if (grid_name && !gridded)
+      {
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if (rank == 0) fprintf(stderr,"WARNING: no raster written. '-grid' only works for plain LAS/LAZ compression or decompression\n");
+      }
+
       if (start_of_waveform_data_packet_record && !waveform)
       {
         lasreader->close(FALSE);
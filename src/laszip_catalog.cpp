@@ -0,0 +1,156 @@
+/*
+===============================================================================
+
+  FILE:  laszip_catalog.cpp
+
+  CONTENTS:
+
+    Builds a LAScatalog of many LAS/LAZ files with all MPI processes working
+    on it in parallel. Process r peeks at the header (and the LAX file) of
+    every input file i with i modulo the number of processes equal to r. The
+    entries are packed into a buffer and gathered by process 0, which puts
+    them back into the order of the input files and writes the catalog.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-build_catalog' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lasreader.hpp"
+#include "lascatalog.hpp"
+#include "bytestreamin_array.hpp"
+#include "bytestreamout_array.hpp"
+
+#include "mpi.h"
+
+I64 laszip_catalog(LASreadOpener* lasreadopener, const CHAR* catalog_name, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  double start_time = MPI_Wtime();
+
+  // ***** peek at the headers of every process_count-th file
+
+  U32 number_files = lasreadopener->get_file_name_number();
+  LAScatalog local;
+  int failed = 0;
+  for (U32 i = rank; i < number_files; i += process_count)
+  {
+    if (!local.add(lasreadopener->get_file_name(i)))
+    {
+      failed = 1;
+      break;
+    }
+  }
+
+  ByteStreamOutArrayLE* blob = new ByteStreamOutArrayLE();
+  if (!failed && !local.write(blob)) failed = 1;
+
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if (failed)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: cannot build catalog '%s'\n", catalog_name);
+    delete blob;
+    return -1;
+  }
+
+  // ***** gather the packed entries on process 0
+
+  int bytes = (int)blob->getSize();
+  int* recv_counts = 0;
+  int* recv_displs = 0;
+  U8* gathered = 0;
+  if (rank == 0)
+  {
+    recv_counts = (int*)malloc(sizeof(int)*process_count);
+    recv_displs = (int*)malloc(sizeof(int)*process_count);
+  }
+  MPI_Gather(&bytes, 1, MPI_INT, recv_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (rank == 0)
+  {
+    int total = 0;
+    for (int r = 0; r < process_count; r++)
+    {
+      recv_displs[r] = total;
+      total += recv_counts[r];
+    }
+    gathered = (U8*)malloc(total);
+  }
+  U8* data = blob->takeData();
+  delete blob;
+  MPI_Gatherv(data, bytes, MPI_BYTE, gathered, recv_counts, recv_displs, MPI_BYTE, 0, MPI_COMM_WORLD);
+  free(data);
+
+  // ***** put the entries back into file order and write the catalog
+
+  I64 number_of_point_records = 0;
+  if (rank == 0)
+  {
+    LAScatalog* parts = new LAScatalog[process_count];
+    for (int r = 0; r < process_count; r++)
+    {
+      ByteStreamInArrayLE* stream = new ByteStreamInArrayLE(gathered + recv_displs[r], recv_counts[r]);
+      if (!parts[r].read(stream)) failed = 1;
+      delete stream;
+    }
+    LAScatalog catalog;
+    for (U32 i = 0; !failed && (i < number_files); i++)
+    {
+      const LAScatalog* part = parts + (i % process_count);
+      U32 j = i / process_count;
+      if ((j >= part->get_number_entries()) || !catalog.add(part->get_entry(j))) failed = 1;
+    }
+    if (!failed && !catalog.write(catalog_name)) failed = 1;
+    if (!failed && verbose)
+    {
+      U32 indexed = 0;
+      for (U32 i = 0; i < catalog.get_number_entries(); i++)
+      {
+        if (catalog.get_entry(i)->lax_cells) indexed++;
+      }
+#ifdef _WIN32
+      fprintf(stderr,"cataloged %u files (%u with LAX) with %I64d points in %g sec\n", catalog.get_number_entries(), indexed, catalog.get_number_of_point_records(), MPI_Wtime()-start_time);
+#else
+      fprintf(stderr,"cataloged %u files (%u with LAX) with %lld points in %g sec\n", catalog.get_number_entries(), indexed, catalog.get_number_of_point_records(), MPI_Wtime()-start_time);
+#endif
+    }
+    number_of_point_records = catalog.get_number_of_point_records();
+    delete [] parts;
+    free(gathered);
+    free(recv_counts);
+    free(recv_displs);
+  }
+
+  MPI_Bcast(&failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (failed)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: cannot write catalog '%s'\n", catalog_name);
+    return -1;
+  }
+  return number_of_point_records;
+}
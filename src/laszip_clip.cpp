@@ -0,0 +1,242 @@
+/*
+===============================================================================
+
+  FILE:  laszip_clip.cpp
+
+  CONTENTS:
+
+    Clips the points of a LAS/LAZ file to the polygons of a shapefile with
+    all MPI processes working on it in parallel. When the file has a spatial
+    index (LAX) only the intervals of the quadtree cells that are not entirely
+    outside the polygons are read, so whole cells and with them whole chunks
+    are skipped. The candidate points are split evenly among the processes.
+    Each reads its share in batches and keeps the points that are inside,
+    which costs a lookup in the raster of the polygons for most points and
+    an edge test only for points in boundary cells. The kept points of each
+    process are compressed into memory and then written in process order.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-clip_polygon' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "lasreader.hpp"
+#include "laswriter.hpp"
+#include "laslod.hpp"
+#include "laspolygon.hpp"
+#include "lasindex.hpp"
+#include "laswritepoint.hpp"
+#include "bytestreamout_array.hpp"
+
+#include "mpi.h"
+
+#define LAS_CLIP_BATCH 4096
+
+extern I64 laszip_write_blobs(LASheader* header, LASwriteOpener* laswriteopener, LASwritePoint* writer, ByteStreamOutArray* blob, I64 blob_start, BOOL compress, U32 chunk_size);
+extern void laszip_update_header(LASheader* header, const LASinventory* inventory);
+
+// the bounding boxes of the quadtree are single precision, so they are
+// widened by a few units in the last place before they are classified
+
+static BOOL clip_keep_cell(const F32* min, const F32* max, const void* data)
+{
+  const LASpolygon* polygon = (const LASpolygon*)data;
+  F64 eps_x = 1e-6*(fabs(min[0]) + fabs(max[0])) + 1e-6;
+  F64 eps_y = 1e-6*(fabs(min[1]) + fabs(max[1])) + 1e-6;
+  return (polygon->classify(min[0] - eps_x, min[1] - eps_y, max[0] + eps_x, max[1] + eps_y) != LAS_POLYGON_OUTSIDE);
+}
+
+I64 laszip_clip(LASreader* lasreader, LASwriteOpener* laswriteopener, const LASpolygon* polygon, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  U32 i;
+
+  if ((laswriteopener->get_format() != LAS_TOOLS_FORMAT_LAZ) && (laswriteopener->get_format() != LAS_TOOLS_FORMAT_LAS))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: option '-clip_polygon' requires LAS or LAZ output\n");
+    return -1;
+  }
+
+  // a level-of-detail layout does not survive clipping
+
+  lasreader->header.remove_vlr(LAS_LOD_USER_ID, LAS_LOD_RECORD_ID);
+
+  // ***** find the point intervals that may hold points inside the polygons
+
+  vector< pair<I64,I64> > intervals;
+  LASindex* index = lasreader->get_index();
+  if (index)
+  {
+    if (index->intersect_rectangle(polygon->get_min_x(), polygon->get_min_y(), polygon->get_max_x(), polygon->get_max_y(), clip_keep_cell, polygon))
+    {
+      while (index->has_intervals())
+      {
+        intervals.push_back(pair<I64,I64>(index->start, index->end));
+      }
+    }
+    sort(intervals.begin(), intervals.end());
+  }
+  else if ((lasreader->npoints > 0) && (polygon->classify(lasreader->header.min_x, lasreader->header.min_y, lasreader->header.max_x, lasreader->header.max_y) != LAS_POLYGON_OUTSIDE))
+  {
+    intervals.push_back(pair<I64,I64>(0, lasreader->npoints-1));
+  }
+  I64 candidates = 0;
+  for (i = 0; i < intervals.size(); i++)
+  {
+    candidates += intervals[i].second - intervals[i].first + 1;
+  }
+
+  // ***** split the candidates evenly and cut this share out of the intervals
+
+  I64 share_start = (candidates / process_count) * rank;
+  I64 share_end = share_start + candidates / process_count;
+  if (rank == process_count-1) share_end += candidates % process_count;
+
+  vector<I64> starts, ends;
+  I64 before = 0;
+  for (i = 0; i < intervals.size(); i++)
+  {
+    I64 length = intervals[i].second - intervals[i].first + 1;
+    I64 first = (share_start > before ? share_start - before : 0);
+    I64 last = (share_end < before + length ? share_end - before : length);
+    if (first < last)
+    {
+      starts.push_back(intervals[i].first + first);
+      ends.push_back(intervals[i].first + last - 1);
+    }
+    before += length;
+  }
+  if (starts.size()) lasreader->prefetch((U32)starts.size(), &(starts[0]), &(ends[0]));
+
+  // ***** compress or copy the points inside into memory
+
+  LASpoint* point = &lasreader->point;
+  BOOL compress = (laswriteopener->get_format() == LAS_TOOLS_FORMAT_LAZ);
+  U32 chunk_size = laswriteopener->get_chunk_size();
+
+  LASzip laszip;
+  if (compress)
+  {
+    if (!laszip.setup(point->num_items, point->items, LASZIP_COMPRESSOR_CHUNKED) || !laszip.request_version(laswriteopener->get_version()) || !laszip.set_chunk_size(U32_MAX) || !laszip.request_coder(laswriteopener->get_coder()))
+    {
+      fprintf(stderr,"ERROR: rank %d cannot set up LASzip for clipped chunks\n", rank);
+      return -1;
+    }
+  }
+  ByteStreamOutArrayLE* blob = new ByteStreamOutArrayLE();
+  LASwritePoint* writer = new LASwritePoint();
+  if (compress)
+    writer->setup(laszip.num_items, laszip.items, &laszip);
+  else
+    writer->setup(point->num_items, point->items);
+  writer->init(blob);
+  I64 blob_start = blob->tell();
+
+  U32 size = point->total_point_size;
+  U8* batch = (U8*)malloc(LAS_CLIP_BATCH*size);
+  F64* xs = (F64*)malloc(LAS_CLIP_BATCH*sizeof(F64));
+  F64* ys = (F64*)malloc(LAS_CLIP_BATCH*sizeof(F64));
+  U8* inside = (U8*)malloc(LAS_CLIP_BATCH);
+
+  LASinventory inventory;
+  I64 kept = 0;
+  I64 read = 0;
+
+  for (i = 0; i < starts.size(); i++)
+  {
+    lasreader->seek(starts[i]);
+    BOOL more = TRUE;
+    while (more)
+    {
+      // read a batch. a filter may skip points, so the end is found with p_count
+      U32 number = 0;
+      while ((number < LAS_CLIP_BATCH) && (lasreader->p_count <= ends[i]))
+      {
+        if (!lasreader->read_point() || (lasreader->p_count - 1 > ends[i]))
+        {
+          more = FALSE;
+          break;
+        }
+        point->copy_to(batch + number*size);
+        xs[number] = point->get_x();
+        ys[number] = point->get_y();
+        number++;
+      }
+      if (lasreader->p_count > ends[i]) more = FALSE;
+      read += number;
+
+      polygon->inside(number, xs, ys, inside);
+
+      for (U32 j = 0; j < number; j++)
+      {
+        if (!inside[j]) continue;
+        point->copy_from(batch + j*size);
+        if (compress && kept && ((kept % chunk_size) == 0)) writer->chunk();
+        writer->write(point->point);
+        inventory.add(point);
+        kept++;
+      }
+    }
+  }
+  if (compress && kept) writer->chunk();
+
+  free(batch);
+  free(xs);
+  free(ys);
+  free(inside);
+
+  // ***** set count, returns, and bounding box of the header to those of the clipped points
+
+  LASheader* header = &lasreader->header;
+  laszip_update_header(header, &inventory);
+  MPI_Allreduce(MPI_IN_PLACE, &read, 1, MPI_LONG_LONG_INT, MPI_SUM, MPI_COMM_WORLD);
+  dbg(3, "rank %i intervals %u kept %lli", rank, (U32)starts.size(), kept);
+
+  if (verbose && (rank == 0))
+  {
+#ifdef _WIN32
+    fprintf(stderr,"clipped %I64d of %I64d points. read %I64d from %u intervals\n", header->extended_number_of_point_records, lasreader->npoints, read, (U32)intervals.size());
+#else
+    fprintf(stderr,"clipped %lld of %lld points. read %lld from %u intervals\n", header->extended_number_of_point_records, lasreader->npoints, read, (U32)intervals.size());
+#endif
+  }
+
+  // ***** write the kept points of all processes in process order
+
+  I64 bytes_written = laszip_write_blobs(header, laswriteopener, writer, blob, blob_start, compress, chunk_size);
+  delete writer;
+  free(blob->takeData());
+  delete blob;
+  return bytes_written;
+}
@@ -0,0 +1,412 @@
+/*
+===============================================================================
+
+  FILE:  laszip_compare.cpp
+
+  CONTENTS:
+
+    The '-compare' option of p_laszip compares the points of the input with
+    those of another LAS or LAZ file, for example to verify a round trip of
+    compression and decompression. The points are divided among processes
+    on chunk boundaries of the compressed file, so every process decodes
+    whole chunks of both files. A point is first compared with one memcmp()
+    of its 20 byte core (and of GPS time, RGB, wave packet, extra bytes) and
+    only when that differs field by field. Every process keeps the first
+    differences it finds, and process 0 prints the first of all processes
+    in point order together with the number of differences per field.
+
+    Headers are compared by process 0. The point format, the record length,
+    and the number of points must agree. Other differences (version, system
+    identifier, generating software, creation date, VLRs, bounding box) are
+    only reported. If the two files quantize coordinates differently they
+    are compared by value within half of the coarser scale factor.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-compare' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "lasreader.hpp"
+#include "lastrace.hpp"
+
+#include "mpi.h"
+
+#define LAS_COMPARE_X              0
+#define LAS_COMPARE_Y              1
+#define LAS_COMPARE_Z              2
+#define LAS_COMPARE_INTENSITY      3
+#define LAS_COMPARE_RETURN         4
+#define LAS_COMPARE_RETURNS        5
+#define LAS_COMPARE_SCAN_DIRECTION 6
+#define LAS_COMPARE_EDGE           7
+#define LAS_COMPARE_CLASSIFICATION 8
+#define LAS_COMPARE_FLAGS          9
+#define LAS_COMPARE_SCAN_ANGLE     10
+#define LAS_COMPARE_USER_DATA      11
+#define LAS_COMPARE_POINT_SOURCE   12
+#define LAS_COMPARE_GPS_TIME       13
+#define LAS_COMPARE_RGB            14
+#define LAS_COMPARE_WAVEPACKET     15
+#define LAS_COMPARE_EXTRA_BYTES    16
+#define LAS_COMPARE_EXTENDED       17
+#define LAS_COMPARE_FIELDS         18
+
+#define LAS_COMPARE_TEXT           160
+
+static const CHAR* compare_field_names[LAS_COMPARE_FIELDS] = { "X", "Y", "Z", "intensity", "return_number", "number_of_returns", "scan_direction_flag", "edge_of_flight_line", "classification", "flags", "scan_angle", "user_data", "point_source_ID", "gps_time", "RGB", "wavepacket", "extra_bytes", "extended" };
+
+struct LAScompareDifference
+{
+  I64 index;
+  U32 fields;
+  CHAR text[LAS_COMPARE_TEXT];
+};
+
+static BOOL compare_coordinate(const I32 a, const I32 b, const F64 va, const F64 vb, const BOOL by_value, const F64 tolerance)
+{
+  if (by_value) return (fabs(va - vb) <= tolerance);
+  return (a == b);
+}
+
+// returns a bit per field that differs
+
+static U32 compare_fields(const LASpoint* a, const LASpoint* b, const BOOL by_value, const F64 tolerance)
+{
+  U32 fields = 0;
+  if (!compare_coordinate(a->X, b->X, a->get_x(), b->get_x(), by_value, tolerance)) fields |= (1 << LAS_COMPARE_X);
+  if (!compare_coordinate(a->Y, b->Y, a->get_y(), b->get_y(), by_value, tolerance)) fields |= (1 << LAS_COMPARE_Y);
+  if (!compare_coordinate(a->Z, b->Z, a->get_z(), b->get_z(), by_value, tolerance)) fields |= (1 << LAS_COMPARE_Z);
+  if (a->intensity != b->intensity) fields |= (1 << LAS_COMPARE_INTENSITY);
+  if (a->return_number != b->return_number) fields |= (1 << LAS_COMPARE_RETURN);
+  if (a->number_of_returns != b->number_of_returns) fields |= (1 << LAS_COMPARE_RETURNS);
+  if (a->scan_direction_flag != b->scan_direction_flag) fields |= (1 << LAS_COMPARE_SCAN_DIRECTION);
+  if (a->edge_of_flight_line != b->edge_of_flight_line) fields |= (1 << LAS_COMPARE_EDGE);
+  if (a->classification != b->classification) fields |= (1 << LAS_COMPARE_CLASSIFICATION);
+  if ((a->synthetic_flag != b->synthetic_flag) || (a->keypoint_flag != b->keypoint_flag) || (a->withheld_flag != b->withheld_flag)) fields |= (1 << LAS_COMPARE_FLAGS);
+  if (a->scan_angle_rank != b->scan_angle_rank) fields |= (1 << LAS_COMPARE_SCAN_ANGLE);
+  if (a->user_data != b->user_data) fields |= (1 << LAS_COMPARE_USER_DATA);
+  if (a->point_source_ID != b->point_source_ID) fields |= (1 << LAS_COMPARE_POINT_SOURCE);
+  if (a->have_gps_time && (a->gps_time != b->gps_time)) fields |= (1 << LAS_COMPARE_GPS_TIME);
+  if (a->have_rgb && memcmp(a->rgb, b->rgb, sizeof(U16)*(a->have_nir ? 4 : 3))) fields |= (1 << LAS_COMPARE_RGB);
+  if (a->have_wavepacket && memcmp(&a->wavepacket, &b->wavepacket, sizeof(LASwavepacket))) fields |= (1 << LAS_COMPARE_WAVEPACKET);
+  if (a->extra_bytes_number && memcmp(a->extra_bytes, b->extra_bytes, a->extra_bytes_number)) fields |= (1 << LAS_COMPARE_EXTRA_BYTES);
+  if (a->extended_point_type)
+  {
+    if ((a->extended_scan_angle != b->extended_scan_angle) || (a->extended_scanner_channel != b->extended_scanner_channel) ||
+        (a->extended_classification_flags != b->extended_classification_flags) || (a->extended_classification != b->extended_classification) ||
+        (a->extended_return_number != b->extended_return_number) || (a->extended_number_of_returns != b->extended_number_of_returns))
+    {
+      fields |= (1 << LAS_COMPARE_EXTENDED);
+    }
+  }
+  return fields;
+}
+
+// the common case of identical points costs a few memcmp()
+
+static inline BOOL compare_same(const LASpoint* a, const LASpoint* b, const BOOL raw)
+{
+  if (!raw) return FALSE;
+  if (memcmp(a, b, 20)) return FALSE;
+  if (a->have_gps_time && memcmp(&a->gps_time, &b->gps_time, sizeof(F64))) return FALSE;
+  if (a->have_rgb && memcmp(a->rgb, b->rgb, sizeof(U16)*(a->have_nir ? 4 : 3))) return FALSE;
+  if (a->have_wavepacket && memcmp(&a->wavepacket, &b->wavepacket, sizeof(LASwavepacket))) return FALSE;
+  if (a->extra_bytes_number && memcmp(a->extra_bytes, b->extra_bytes, a->extra_bytes_number)) return FALSE;
+  if (a->extended_point_type) return FALSE;
+  return TRUE;
+}
+
+static void compare_describe(LAScompareDifference* difference, const LASpoint* a, const LASpoint* b)
+{
+  U32 f;
+  for (f = 0; f < LAS_COMPARE_FIELDS; f++) if (difference->fields & (1 << f)) break;
+  CHAR values[64] = "";
+  switch (f)
+  {
+  case LAS_COMPARE_X: sprintf(values, "%.10g != %.10g", a->get_x(), b->get_x()); break;
+  case LAS_COMPARE_Y: sprintf(values, "%.10g != %.10g", a->get_y(), b->get_y()); break;
+  case LAS_COMPARE_Z: sprintf(values, "%.10g != %.10g", a->get_z(), b->get_z()); break;
+  case LAS_COMPARE_INTENSITY: sprintf(values, "%u != %u", a->intensity, b->intensity); break;
+  case LAS_COMPARE_RETURN: sprintf(values, "%u != %u", a->return_number, b->return_number); break;
+  case LAS_COMPARE_RETURNS: sprintf(values, "%u != %u", a->number_of_returns, b->number_of_returns); break;
+  case LAS_COMPARE_CLASSIFICATION: sprintf(values, "%u != %u", a->classification, b->classification); break;
+  case LAS_COMPARE_SCAN_ANGLE: sprintf(values, "%d != %d", a->scan_angle_rank, b->scan_angle_rank); break;
+  case LAS_COMPARE_USER_DATA: sprintf(values, "%u != %u", a->user_data, b->user_data); break;
+  case LAS_COMPARE_POINT_SOURCE: sprintf(values, "%u != %u", a->point_source_ID, b->point_source_ID); break;
+  case LAS_COMPARE_GPS_TIME: sprintf(values, "%.17g != %.17g", a->gps_time, b->gps_time); break;
+  }
+  CHAR names[96] = "";
+  for (U32 g = 0; g < LAS_COMPARE_FIELDS; g++)
+  {
+    if ((difference->fields & (1 << g)) && (strlen(names) + strlen(compare_field_names[g]) + 2 < sizeof(names)))
+    {
+      if (names[0]) strcat(names, " ");
+      strcat(names, compare_field_names[g]);
+    }
+  }
+#ifdef _WIN32
+  _snprintf(difference->text, LAS_COMPARE_TEXT, "point %I64d differs in %s%s%s%s", difference->index, names, (values[0] ? " (" : ""), values, (values[0] ? ")" : ""));
+#else
+  snprintf(difference->text, LAS_COMPARE_TEXT, "point %lld differs in %s%s%s%s", difference->index, names, (values[0] ? " (" : ""), values, (values[0] ? ")" : ""));
+#endif
+}
+
+static int compare_differences(const void* a, const void* b)
+{
+  const LAScompareDifference* da = (const LAScompareDifference*)a;
+  const LAScompareDifference* db = (const LAScompareDifference*)b;
+  return (da->index < db->index ? -1 : (da->index > db->index ? 1 : 0));
+}
+
+// prints the header differences. returns FALSE if the points cannot be compared
+
+static BOOL compare_headers(const LASheader* a, const LASheader* b, const I64 npoints_a, const I64 npoints_b)
+{
+  BOOL comparable = TRUE;
+  if (a->point_data_format != b->point_data_format)
+  {
+    fprintf(stderr,"ERROR: point data format %d != %d\n", a->point_data_format, b->point_data_format);
+    comparable = FALSE;
+  }
+  if (a->point_data_record_length != b->point_data_record_length)
+  {
+    fprintf(stderr,"ERROR: point data record length %d != %d\n", a->point_data_record_length, b->point_data_record_length);
+    comparable = FALSE;
+  }
+  if (npoints_a != npoints_b)
+  {
+#ifdef _WIN32
+    fprintf(stderr,"ERROR: number of points %I64d != %I64d\n", npoints_a, npoints_b);
+#else
+    fprintf(stderr,"ERROR: number of points %lld != %lld\n", npoints_a, npoints_b);
+#endif
+    comparable = FALSE;
+  }
+  if ((a->version_major != b->version_major) || (a->version_minor != b->version_minor))
+    fprintf(stderr,"header: version %d.%d != %d.%d\n", a->version_major, a->version_minor, b->version_major, b->version_minor);
+  if (strncmp(a->system_identifier, b->system_identifier, 32))
+    fprintf(stderr,"header: system identifier '%.32s' != '%.32s'\n", a->system_identifier, b->system_identifier);
+  if (strncmp(a->generating_software, b->generating_software, 32))
+    fprintf(stderr,"header: generating software '%.32s' != '%.32s'\n", a->generating_software, b->generating_software);
+  if ((a->file_creation_day != b->file_creation_day) || (a->file_creation_year != b->file_creation_year))
+    fprintf(stderr,"header: file creation %d/%d != %d/%d\n", a->file_creation_day, a->file_creation_year, b->file_creation_day, b->file_creation_year);
+  if (a->number_of_variable_length_records != b->number_of_variable_length_records)
+    fprintf(stderr,"header: number of VLRs %u != %u\n", a->number_of_variable_length_records, b->number_of_variable_length_records);
+  if ((a->x_scale_factor != b->x_scale_factor) || (a->y_scale_factor != b->y_scale_factor) || (a->z_scale_factor != b->z_scale_factor))
+    fprintf(stderr,"header: scale factors %g %g %g != %g %g %g\n", a->x_scale_factor, a->y_scale_factor, a->z_scale_factor, b->x_scale_factor, b->y_scale_factor, b->z_scale_factor);
+  if ((a->x_offset != b->x_offset) || (a->y_offset != b->y_offset) || (a->z_offset != b->z_offset))
+    fprintf(stderr,"header: offsets %g %g %g != %g %g %g\n", a->x_offset, a->y_offset, a->z_offset, b->x_offset, b->y_offset, b->z_offset);
+  if ((a->min_x != b->min_x) || (a->min_y != b->min_y) || (a->min_z != b->min_z) || (a->max_x != b->max_x) || (a->max_y != b->max_y) || (a->max_z != b->max_z))
+    fprintf(stderr,"header: bounding box differs\n");
+  if (memcmp(a->number_of_points_by_return, b->number_of_points_by_return, sizeof(U32)*5))
+    fprintf(stderr,"header: number of points by return differs\n");
+  return comparable;
+}
+
+I64 laszip_compare(LASreadOpener* lasreadopener, const CHAR* other_name, U32 max_report, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  F64 start_time = MPI_Wtime();
+
+  if (lasreadopener->get_file_name_number() != 1)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: '-compare' needs a single input file\n");
+    return -1;
+  }
+
+  // ***** open both files on every process
+
+  LASreadOpener opener_a;
+  opener_a.set_file_name(lasreadopener->get_file_name(0));
+  LASreader* reader_a = opener_a.open();
+  LASreadOpener opener_b;
+  opener_b.set_file_name(other_name);
+  LASreader* reader_b = opener_b.open();
+  int failed = ((reader_a == 0) || (reader_b == 0) ? 1 : 0);
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if (failed)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: cannot open '%s' or '%s' for comparing\n", lasreadopener->get_file_name(0), other_name);
+    if (reader_a) { reader_a->close(); delete reader_a; }
+    if (reader_b) { reader_b->close(); delete reader_b; }
+    return -1;
+  }
+
+  int comparable = 1;
+  if (rank == 0) comparable = (compare_headers(&reader_a->header, &reader_b->header, reader_a->npoints, reader_b->npoints) ? 1 : 0);
+  MPI_Bcast(&comparable, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (!comparable)
+  {
+    reader_a->close(); delete reader_a;
+    reader_b->close(); delete reader_b;
+    return -1;
+  }
+
+  // ***** the same ranges of both files on chunk boundaries of the one
+  // that is compressed (both compressed files usually have the same)
+
+  I64 npoints = reader_a->npoints;
+  I64 chunk_size = 50000;
+  if (reader_a->header.laszip && (reader_a->header.laszip->chunk_size != U32_MAX)) chunk_size = reader_a->header.laszip->chunk_size;
+  else if (reader_b->header.laszip && (reader_b->header.laszip->chunk_size != U32_MAX)) chunk_size = reader_b->header.laszip->chunk_size;
+  I64 chunks = (npoints + chunk_size - 1) / chunk_size;
+  I64 point_start = ((chunks * rank) / process_count) * chunk_size;
+  I64 point_end = ((chunks * (rank + 1)) / process_count) * chunk_size;
+  if (point_start > npoints) point_start = npoints;
+  if (point_end > npoints) point_end = npoints;
+
+  const LASheader* ha = &reader_a->header;
+  const LASheader* hb = &reader_b->header;
+  BOOL by_value = (ha->x_scale_factor != hb->x_scale_factor) || (ha->y_scale_factor != hb->y_scale_factor) || (ha->z_scale_factor != hb->z_scale_factor) ||
+                  (ha->x_offset != hb->x_offset) || (ha->y_offset != hb->y_offset) || (ha->z_offset != hb->z_offset);
+  F64 tolerance = 0.5 * (ha->x_scale_factor > hb->x_scale_factor ? ha->x_scale_factor : hb->x_scale_factor);
+  if (0.5 * ha->y_scale_factor > tolerance) tolerance = 0.5 * ha->y_scale_factor;
+  if (0.5 * hb->y_scale_factor > tolerance) tolerance = 0.5 * hb->y_scale_factor;
+  if (0.5 * ha->z_scale_factor > tolerance) tolerance = 0.5 * ha->z_scale_factor;
+  if (0.5 * hb->z_scale_factor > tolerance) tolerance = 0.5 * hb->z_scale_factor;
+
+  // ***** compare the points of this process
+
+  U64 counts[1 + LAS_COMPARE_FIELDS];
+  memset(counts, 0, sizeof(counts));
+  LAScompareDifference* differences = (LAScompareDifference*)calloc(max_report ? max_report : 1, sizeof(LAScompareDifference));
+  U32 number_differences = 0;
+  I64 compared = 0;
+
+  if (point_end > point_start)
+  {
+    I64 point_last = point_end - 1;
+    reader_a->prefetch(1, &point_start, &point_last);
+    reader_b->prefetch(1, &point_start, &point_last);
+    if (!reader_a->seek(point_start) || !reader_b->seek(point_start)) failed = 1;
+    I64 pass_start = LAStrace::now();
+    while (!failed && (compared < (point_end - point_start)))
+    {
+      BOOL read_a = reader_a->read_point();
+      BOOL read_b = reader_b->read_point();
+      if (!read_a || !read_b)
+      {
+#ifdef _WIN32
+        fprintf(stderr,"ERROR: process %d cannot read point %I64d of '%s'\n", rank, point_start + compared, (read_a ? other_name : lasreadopener->get_file_name(0)));
+#else
+        fprintf(stderr,"ERROR: process %d cannot read point %lld of '%s'\n", rank, point_start + compared, (read_a ? other_name : lasreadopener->get_file_name(0)));
+#endif
+        failed = 1;
+        break;
+      }
+      if (!compare_same(&reader_a->point, &reader_b->point, !by_value))
+      {
+        U32 fields = compare_fields(&reader_a->point, &reader_b->point, by_value, tolerance);
+        if (fields)
+        {
+          counts[0]++;
+          for (U32 f = 0; f < LAS_COMPARE_FIELDS; f++) if (fields & (1 << f)) counts[1 + f]++;
+          if (number_differences < max_report)
+          {
+            differences[number_differences].index = point_start + compared;
+            differences[number_differences].fields = fields;
+            compare_describe(differences + number_differences, &reader_a->point, &reader_b->point);
+            number_differences++;
+          }
+        }
+      }
+      compared++;
+    }
+    if (LAStrace::is_enabled()) LAStrace::complete("compare", "phase", pass_start, compared);
+  }
+  reader_a->close(); delete reader_a;
+  reader_b->close(); delete reader_b;
+
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if (failed)
+  {
+    free(differences);
+    return -1;
+  }
+
+  // ***** reduce the counts and gather the first differences of all processes
+
+  U64 all_counts[1 + LAS_COMPARE_FIELDS];
+  MPI_Reduce(counts, all_counts, 1 + LAS_COMPARE_FIELDS, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+  I64 all_compared = 0;
+  MPI_Reduce(&compared, &all_compared, 1, MPI_LONG_LONG_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+  int bytes = (int)(sizeof(LAScompareDifference)*number_differences);
+  int* recv_counts = 0;
+  int* recv_displs = 0;
+  LAScompareDifference* gathered = 0;
+  if (rank == 0)
+  {
+    recv_counts = (int*)malloc(sizeof(int)*process_count);
+    recv_displs = (int*)malloc(sizeof(int)*process_count);
+  }
+  MPI_Gather(&bytes, 1, MPI_INT, recv_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  int total = 0;
+  if (rank == 0)
+  {
+    for (int r = 0; r < process_count; r++)
+    {
+      recv_displs[r] = total;
+      total += recv_counts[r];
+    }
+    gathered = (LAScompareDifference*)malloc(total ? total : 1);
+  }
+  MPI_Gatherv(differences, bytes, MPI_BYTE, gathered, recv_counts, recv_displs, MPI_BYTE, 0, MPI_COMM_WORLD);
+  free(differences);
+
+  I64 different = 0;
+  if (rank == 0)
+  {
+    U32 number = (U32)(total / sizeof(LAScompareDifference));
+    qsort(gathered, number, sizeof(LAScompareDifference), compare_differences);
+    for (U32 d = 0; (d < number) && (d < max_report); d++) fprintf(stderr,"%s\n", gathered[d].text);
+    different = (I64)all_counts[0];
+#ifdef _WIN32
+    fprintf(stderr,"compared %I64d points with %d processes in %g sec: %I64d differ\n", all_compared, process_count, MPI_Wtime()-start_time, different);
+#else
+    fprintf(stderr,"compared %lld points with %d processes in %g sec: %lld differ\n", all_compared, process_count, MPI_Wtime()-start_time, different);
+#endif
+    for (U32 f = 0; f < LAS_COMPARE_FIELDS; f++)
+    {
+      if (all_counts[1 + f] == 0) continue;
+#ifdef _WIN32
+      fprintf(stderr,"  %-20s %I64u\n", compare_field_names[f], all_counts[1 + f]);
+#else
+      fprintf(stderr,"  %-20s %llu\n", compare_field_names[f], (unsigned long long)all_counts[1 + f]);
+#endif
+    }
+    if (by_value) fprintf(stderr,"coordinates were compared within %g because the quantization differs\n", tolerance);
+    free(recv_counts);
+    free(recv_displs);
+    free(gathered);
+  }
+  MPI_Bcast(&different, 1, MPI_LONG_LONG_INT, 0, MPI_COMM_WORLD);
+  if (verbose && (rank == 0) && (different == 0)) fprintf(stderr,"the points are identical\n");
+  return different;
+}
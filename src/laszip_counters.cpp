@@ -0,0 +1,154 @@
+/*
+===============================================================================
+
+  FILE:  laszip_counters.cpp
+
+  CONTENTS:
+
+    The '-counters' option of p_laszip. Every process counts hardware events
+    with LAScounters for each item coder, for chunk restarts, and for stream
+    I/O. At the end the counts of all processes are summed on process 0,
+    which prints them per point (or per call) for every region next to a
+    line per process, so a process that decodes slower than the others is
+    visible. Events that some process could not count are shown as n/a.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-counters' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lascounters.hpp"
+
+#include "mpi.h"
+
+BOOL laszip_counters_start(U32 sample_interval)
+{
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  int counting = (LAScounters::enable(sample_interval) ? 1 : 0);
+  int all_counting = 0;
+  MPI_Allreduce(&counting, &all_counting, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  if ((rank == 0) && (all_counting == 0))
+  {
+    fprintf(stderr,"WARNING: no performance counters available (perf_event_open). ignoring '-counters' ...\n");
+  }
+  return (all_counting != 0);
+}
+
+static void counters_print(const CHAR* name, U64 number, const U64* counts, const int* available, const CHAR* unit)
+{
+#ifdef _WIN32
+  fprintf(stderr,"%-24s %12I64u", name, number);
+#else
+  fprintf(stderr,"%-24s %12llu", name, (unsigned long long)number);
+#endif
+  for (U32 e = 0; e < LAS_COUNTERS_EVENTS; e++)
+  {
+    if (available[e] && number)
+      fprintf(stderr," %14.1f", (F64)counts[e] / (F64)number);
+    else
+      fprintf(stderr," %14s", "n/a");
+  }
+  fprintf(stderr," per %s\n", unit);
+}
+
+void laszip_counters_report()
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  // an event is shown if every process that counted could count it
+  int available[LAS_COUNTERS_EVENTS];
+  int all_available[LAS_COUNTERS_EVENTS];
+  U32 e, r, region;
+  for (e = 0; e < LAS_COUNTERS_EVENTS; e++)
+  {
+    available[e] = ((LAScounters::has_event(e) || !LAScounters::is_enabled()) ? 1 : 0);
+  }
+  MPI_Allreduce(available, all_available, LAS_COUNTERS_EVENTS, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  LAScounters::disable();
+
+  // the sums over all processes per region
+
+  U64 counts[LAS_COUNTERS_REGIONS*LAS_COUNTERS_EVENTS];
+  U64 numbers[LAS_COUNTERS_REGIONS];
+  for (region = 0; region < LAS_COUNTERS_REGIONS; region++)
+  {
+    memcpy(counts + region*LAS_COUNTERS_EVENTS, LAScounters::get_counts(region), sizeof(U64)*LAS_COUNTERS_EVENTS);
+    numbers[region] = LAScounters::get_number(region);
+  }
+  U64 all_counts[LAS_COUNTERS_REGIONS*LAS_COUNTERS_EVENTS];
+  U64 all_numbers[LAS_COUNTERS_REGIONS];
+  MPI_Reduce(counts, all_counts, LAS_COUNTERS_REGIONS*LAS_COUNTERS_EVENTS, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(numbers, all_numbers, LAS_COUNTERS_REGIONS, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+
+  // the item coders of each process together (the first item is in every point)
+
+  U64 process[1 + LAS_COUNTERS_EVENTS];
+  memset(process, 0, sizeof(process));
+  process[0] = numbers[LAS_COUNTERS_ENCODE] + numbers[LAS_COUNTERS_DECODE];
+  for (region = 0; region < LAS_COUNTERS_CHUNK_RESTART; region++)
+  {
+    for (e = 0; e < LAS_COUNTERS_EVENTS; e++) process[1 + e] += counts[region*LAS_COUNTERS_EVENTS + e];
+  }
+  U64* all_process = 0;
+  if (rank == 0) all_process = (U64*)malloc(sizeof(U64)*(1 + LAS_COUNTERS_EVENTS)*process_count);
+  MPI_Gather(process, 1 + LAS_COUNTERS_EVENTS, MPI_UNSIGNED_LONG_LONG, all_process, 1 + LAS_COUNTERS_EVENTS, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
+
+  if (rank == 0)
+  {
+    fprintf(stderr,"performance counters of %d processes (items measured for every %u-th point):\n", process_count, LAScounters::get_sample_interval());
+    fprintf(stderr,"%-24s %12s", "region", "points/calls");
+    for (e = 0; e < LAS_COUNTERS_EVENTS; e++) fprintf(stderr," %14s", LAScounters::get_event_name(e));
+    fprintf(stderr,"\n");
+    for (region = 0; region < LAS_COUNTERS_REGIONS; region++)
+    {
+      if (all_numbers[region] == 0) continue;
+      counters_print(LAScounters::get_region_name(region), all_numbers[region], all_counts + region*LAS_COUNTERS_EVENTS, all_available, (region < LAS_COUNTERS_CHUNK_RESTART ? "point" : "call"));
+    }
+    for (r = 0; r < (U32)process_count; r++)
+    {
+      const U64* p = all_process + r*(1 + LAS_COUNTERS_EVENTS);
+      if (p[0] == 0) continue;
+      CHAR name[32];
+      sprintf(name, "rank %u all items", r);
+      counters_print(name, p[0], p + 1, all_available, "point");
+    }
+    if (all_available[LAS_COUNTERS_INSTRUCTIONS] && all_available[LAS_COUNTERS_CYCLES])
+    {
+      U64 instructions = 0;
+      U64 cycles = 0;
+      for (region = 0; region < LAS_COUNTERS_CHUNK_RESTART; region++)
+      {
+        instructions += all_counts[region*LAS_COUNTERS_EVENTS + LAS_COUNTERS_INSTRUCTIONS];
+        cycles += all_counts[region*LAS_COUNTERS_EVENTS + LAS_COUNTERS_CYCLES];
+      }
+      if (cycles) fprintf(stderr,"item coders run at %.2f instructions per cycle\n", (F64)instructions / (F64)cycles);
+    }
+    free(all_process);
+  }
+}
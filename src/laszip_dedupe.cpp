@@ -0,0 +1,331 @@
+/*
+===============================================================================
+
+  FILE:  laszip_dedupe.cpp
+
+  CONTENTS:
+
+    Removes duplicate points from a LAS/LAZ file (or from merged files) with
+    all MPI processes working on it in parallel. Two points are duplicates
+    when their integer X, Y, and Z (and optionally their GPS time) are equal.
+    Of every group of duplicates the point that comes first in the input
+    survives, so the result does not depend on the number of processes.
+
+    Every process reads an even share of the points and keeps them in
+    memory. Only a small key record per point (X, Y, Z, GPS time, and the
+    global index) is sent to the process that owns the hash of the key, so
+    that all copies of a point meet at one process. There the records are
+    sorted and the indices of all but the first copy are sent back to the
+    processes that hold those points. The surviving points are compressed
+    into memory and written in process order with counts and bounding box
+    of the header fixed up.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-remove_duplicates' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "lasreader.hpp"
+#include "laswriter.hpp"
+#include "laslod.hpp"
+#include "laswritepoint.hpp"
+#include "bytestreamout_array.hpp"
+
+#include "mpi.h"
+
+extern I64 laszip_write_blobs(LASheader* header, LASwriteOpener* laswriteopener, LASwritePoint* writer, ByteStreamOutArray* blob, I64 blob_start, BOOL compress, U32 chunk_size);
+extern BOOL laszip_any_failed(int failed);
+extern I64 laszip_exchange(const void* send, const I64* counts, size_t size, void** recv);
+extern void laszip_update_header(LASheader* header, const LASinventory* inventory);
+
+// the key of every point travels to the process that owns its hash
+
+struct LASdedupeRecord
+{
+  I32 X;
+  I32 Y;
+  I32 Z;
+  U32 reserved;
+  U64 gps_time;   // the bits of the F64 so that only identical times match
+  I64 index;
+};
+
+static inline bool dedupe_record_less(const LASdedupeRecord& a, const LASdedupeRecord& b)
+{
+  if (a.X != b.X) return a.X < b.X;
+  if (a.Y != b.Y) return a.Y < b.Y;
+  if (a.Z != b.Z) return a.Z < b.Z;
+  if (a.gps_time != b.gps_time) return a.gps_time < b.gps_time;
+  return a.index < b.index;
+}
+
+static inline bool dedupe_record_equal(const LASdedupeRecord& a, const LASdedupeRecord& b)
+{
+  return (a.X == b.X) && (a.Y == b.Y) && (a.Z == b.Z) && (a.gps_time == b.gps_time);
+}
+
+static inline U32 dedupe_owner(const LASdedupeRecord& record, int process_count)
+{
+  U64 h = (U32)record.X;
+  h = h*0x9E3779B97F4A7C15ULL ^ (U32)record.Y;
+  h = h*0x9E3779B97F4A7C15ULL ^ (U32)record.Z;
+  h = h*0x9E3779B97F4A7C15ULL ^ record.gps_time;
+  h ^= h >> 29;
+  h *= 0xBF58476D1CE4E5B9ULL;
+  h ^= h >> 32;
+  return (U32)(h % (U64)process_count);
+}
+
+// the process that read the point with this index
+
+static inline int dedupe_reader(I64 index, I64 npoints, int process_count)
+{
+  I64 share = npoints/process_count;
+  if (share == 0) return process_count-1;
+  I64 r = index/share;
+  return (int)(r < process_count ? r : process_count-1);
+}
+
+I64 laszip_dedupe(LASreader* lasreader, LASwriteOpener* laswriteopener, BOOL use_gps_time, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  I32 r;
+  I64 n;
+
+  if ((laswriteopener->get_format() != LAS_TOOLS_FORMAT_LAZ) && (laswriteopener->get_format() != LAS_TOOLS_FORMAT_LAS))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: option '-remove_duplicates' requires LAS or LAZ output\n");
+    return -1;
+  }
+  if (lasreader->npoints <= 0)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: option '-remove_duplicates' needs to know the number of points\n");
+    return -1;
+  }
+  if (use_gps_time && !lasreader->point.have_gps_time)
+  {
+    if (rank == 0) fprintf(stderr,"WARNING: point type %d has no GPS time. comparing only X, Y, and Z\n", lasreader->header.point_data_format);
+    use_gps_time = FALSE;
+  }
+
+  // a level-of-detail layout does not survive removing points
+
+  lasreader->header.remove_vlr(LAS_LOD_USER_ID, LAS_LOD_RECORD_ID);
+
+  // ***** read an even share of the points into memory
+
+  I64 npoints = lasreader->npoints;
+  I64 point_start = rank*(npoints/process_count);
+  I64 point_end = point_start + npoints/process_count;
+  if (rank == process_count-1) point_end += npoints%process_count;
+  I64 local_points = point_end - point_start;
+
+  LASpoint* point = &lasreader->point;
+  U32 point_size = point->total_point_size;
+  U8* points = (U8*)malloc(point_size*(local_points ? local_points : 1));
+  LASdedupeRecord* records = (LASdedupeRecord*)malloc(sizeof(LASdedupeRecord)*(local_points ? local_points : 1));
+  if (laszip_any_failed((points == 0) || (records == 0)))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: cannot allocate memory for removing duplicates\n");
+    return -1;
+  }
+
+  // merged input cannot seek so it is read up to the start of the share
+  if (local_points && !lasreader->seek(point_start))
+  {
+    while ((lasreader->p_count < point_start) && lasreader->read_point());
+  }
+  n = 0;
+  while ((n < local_points) && lasreader->read_point())
+  {
+    LASdedupeRecord* record = records + n;
+    record->X = point->get_X();
+    record->Y = point->get_Y();
+    record->Z = point->get_Z();
+    record->reserved = 0;
+    record->gps_time = 0;
+    if (use_gps_time) memcpy(&(record->gps_time), &(point->gps_time), sizeof(F64));
+    record->index = point_start + n;
+    point->copy_to(points + n*point_size);
+    n++;
+  }
+  if (n != local_points)
+  {
+#ifdef _WIN32
+    fprintf(stderr,"WARNING: rank %d read only %I64d of %I64d points\n", rank, n, local_points);
+#else
+    fprintf(stderr,"WARNING: rank %d read only %lld of %lld points\n", rank, n, local_points);
+#endif
+    local_points = n;
+  }
+
+  // ***** send every key to the process that owns its hash
+
+  I64* counts = (I64*)calloc(process_count, sizeof(I64));
+  U32* owners = (U32*)malloc(sizeof(U32)*(local_points ? local_points : 1));
+  for (n = 0; n < local_points; n++)
+  {
+    owners[n] = dedupe_owner(records[n], process_count);
+    counts[owners[n]]++;
+  }
+  I64* offsets = (I64*)malloc(sizeof(I64)*process_count);
+  offsets[0] = 0;
+  for (r = 1; r < process_count; r++) offsets[r] = offsets[r-1] + counts[r-1];
+  LASdedupeRecord* send_records = (LASdedupeRecord*)malloc(sizeof(LASdedupeRecord)*(local_points ? local_points : 1));
+  for (n = 0; n < local_points; n++)
+  {
+    send_records[offsets[owners[n]]++] = records[n];
+  }
+  free(owners);
+  free(records);
+
+  LASdedupeRecord* owned = 0;
+  I64 owned_points = laszip_exchange(send_records, counts, sizeof(LASdedupeRecord), (void**)&owned);
+  free(send_records);
+  if (owned_points < 0)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: more than %d bytes of keys per process. use more processes.\n", INT_MAX);
+    free(points);
+    free(counts);
+    free(offsets);
+    return -1;
+  }
+
+  // ***** all copies of a point are now here. all but the first one are duplicates
+
+  sort(owned, owned + owned_points, dedupe_record_less);
+  vector<I64> duplicates;
+  for (n = 1; n < owned_points; n++)
+  {
+    if (dedupe_record_equal(owned[n-1], owned[n])) duplicates.push_back(owned[n].index);
+  }
+  free(owned);
+
+  // ***** return the indices of the duplicates to the processes that hold them
+
+  memset(counts, 0, sizeof(I64)*process_count);
+  for (size_t d = 0; d < duplicates.size(); d++) counts[dedupe_reader(duplicates[d], npoints, process_count)]++;
+  offsets[0] = 0;
+  for (r = 1; r < process_count; r++) offsets[r] = offsets[r-1] + counts[r-1];
+  I64* send_indices = (I64*)malloc(sizeof(I64)*(duplicates.size() ? duplicates.size() : 1));
+  for (size_t d = 0; d < duplicates.size(); d++) send_indices[offsets[dedupe_reader(duplicates[d], npoints, process_count)]++] = duplicates[d];
+  I64 owned_duplicates = (I64)duplicates.size();
+  vector<I64>().swap(duplicates);
+
+  I64* drop = 0;
+  I64 drop_points = laszip_exchange(send_indices, counts, sizeof(I64), (void**)&drop);
+  free(send_indices);
+  free(counts);
+  free(offsets);
+  if (drop_points < 0)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: more than %d bytes of duplicates per process. use more processes.\n", INT_MAX);
+    free(points);
+    return -1;
+  }
+  sort(drop, drop + drop_points);
+
+  dbg(3, "rank %i local_points %lli owned_duplicates %lli drop_points %lli", rank, local_points, owned_duplicates, drop_points);
+
+  // ***** compress or copy the surviving points into memory
+
+  BOOL compress = (laswriteopener->get_format() == LAS_TOOLS_FORMAT_LAZ);
+  U32 chunk_size = laswriteopener->get_chunk_size();
+  if ((chunk_size == 0) || (chunk_size == U32_MAX)) chunk_size = LASZIP_CHUNK_SIZE_DEFAULT;
+
+  LASzip laszip;
+  if (compress)
+  {
+    if (!laszip.setup(point->num_items, point->items, LASZIP_COMPRESSOR_CHUNKED) || !laszip.request_version(laswriteopener->get_version()) || !laszip.set_chunk_size(U32_MAX) || !laszip.request_coder(laswriteopener->get_coder()))
+    {
+      fprintf(stderr,"ERROR: rank %d cannot set up LASzip for deduplicated chunks\n", rank);
+      free(points);
+      free(drop);
+      return -1;
+    }
+  }
+  ByteStreamOutArrayLE* blob = new ByteStreamOutArrayLE();
+  LASwritePoint* writer = new LASwritePoint();
+  if (compress)
+    writer->setup(laszip.num_items, laszip.items, &laszip);
+  else
+    writer->setup(point->num_items, point->items);
+  writer->init(blob);
+  I64 blob_start = blob->tell();
+
+  LASinventory inventory;
+  I64 kept = 0;
+  I64 d = 0;
+  for (n = 0; n < local_points; n++)
+  {
+    if ((d < drop_points) && (drop[d] == point_start + n))
+    {
+      d++;
+      continue;
+    }
+    point->copy_from(points + n*point_size);
+    if (compress && kept && ((kept % chunk_size) == 0)) writer->chunk();
+    writer->write(point->point);
+    inventory.add(point);
+    kept++;
+  }
+  if (compress && kept) writer->chunk();
+  free(points);
+  free(drop);
+
+  // ***** set count, returns, and bounding box of the header to those of the surviving points
+
+  LASheader* header = &lasreader->header;
+  laszip_update_header(header, &inventory);
+  kept = header->extended_number_of_point_records;
+  I64 read_points = local_points;
+  MPI_Allreduce(MPI_IN_PLACE, &read_points, 1, MPI_LONG_LONG_INT, MPI_SUM, MPI_COMM_WORLD);
+
+  if (verbose && (rank == 0))
+  {
+#ifdef _WIN32
+    fprintf(stderr,"removed %I64d duplicates of %I64d points by %s\n", read_points - kept, read_points, (use_gps_time ? "X, Y, Z, and GPS time" : "X, Y, and Z"));
+#else
+    fprintf(stderr,"removed %lld duplicates of %lld points by %s\n", read_points - kept, read_points, (use_gps_time ? "X, Y, Z, and GPS time" : "X, Y, and Z"));
+#endif
+  }
+
+  // ***** write the surviving points of all processes in process order
+
+  I64 bytes_written = laszip_write_blobs(header, laswriteopener, writer, blob, blob_start, compress, chunk_size);
+  delete writer;
+  free(blob->takeData());
+  delete blob;
+  return bytes_written;
+}
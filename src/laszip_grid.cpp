@@ -0,0 +1,136 @@
+/*
+===============================================================================
+
+  FILE:  laszip_grid.cpp
+
+  CONTENTS:
+
+    Merges the partial LASgrid rasters that the MPI processes accumulated
+    from their ranges of points during compression and writes one raster
+    per requested method. A cell near the border of two point ranges gets
+    points from several processes, so the accumulators are combined cell
+    by cell (sums for count, mean, and IDW, minima and maxima for min and
+    max) onto process 0. This is done in blocks of cells to bound the size
+    of the MPI messages. Process 0 then writes the rasters.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-grid' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lasgrid.hpp"
+
+#include "mpi.h"
+
+#define LAS_GRID_REDUCE_BLOCK 1048576
+
+static void grid_reduce(void* data, U32 number, MPI_Datatype type, size_t size, MPI_Op op, int rank)
+{
+  for (U32 done = 0; done < number; done += LAS_GRID_REDUCE_BLOCK)
+  {
+    int block = (int)(number - done < LAS_GRID_REDUCE_BLOCK ? number - done : LAS_GRID_REDUCE_BLOCK);
+    U8* start = (U8*)data + (size_t)done*size;
+    if (rank == 0)
+      MPI_Reduce(MPI_IN_PLACE, start, block, type, op, 0, MPI_COMM_WORLD);
+    else
+      MPI_Reduce(start, 0, block, type, op, 0, MPI_COMM_WORLD);
+  }
+}
+
+// the file name of one method. with several methods the name of the method
+// is put in front of the extension (dem.bil becomes dem_min.bil, dem_max.bil)
+
+static CHAR* grid_file_name(const CHAR* file_name, U32 method, BOOL several)
+{
+  CHAR* name = (CHAR*)malloc(strlen(file_name) + 8);
+  if (!several)
+  {
+    strcpy(name, file_name);
+    return name;
+  }
+  const CHAR* extension = strrchr(file_name, '.');
+  size_t len = (extension ? (size_t)(extension - file_name) : strlen(file_name));
+  memcpy(name, file_name, len);
+  sprintf(name + len, "_%s%s", LASgrid::get_method_name(method), (extension ? extension : ""));
+  return name;
+}
+
+I64 laszip_grid(LASgrid* grid, const CHAR* file_name, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  double start_time = MPI_Wtime();
+
+  // ***** combine the accumulators of all processes cell by cell on process 0
+
+  U32 number_cells = grid->get_number_cells();
+  grid_reduce(grid->get_count(), number_cells, MPI_UNSIGNED, sizeof(U32), MPI_SUM, rank);
+  if (grid->get_min()) grid_reduce(grid->get_min(), number_cells, MPI_FLOAT, sizeof(F32), MPI_MIN, rank);
+  if (grid->get_max()) grid_reduce(grid->get_max(), number_cells, MPI_FLOAT, sizeof(F32), MPI_MAX, rank);
+  if (grid->get_sum()) grid_reduce(grid->get_sum(), number_cells, MPI_DOUBLE, sizeof(F64), MPI_SUM, rank);
+  if (grid->get_idw_sum()) grid_reduce(grid->get_idw_sum(), number_cells, MPI_DOUBLE, sizeof(F64), MPI_SUM, rank);
+  if (grid->get_idw_weight()) grid_reduce(grid->get_idw_weight(), number_cells, MPI_DOUBLE, sizeof(F64), MPI_SUM, rank);
+
+  // ***** process 0 writes one raster per method
+
+  int failed = 0;
+  I64 occupied = 0;
+  if (rank == 0)
+  {
+    U32 methods = grid->get_methods();
+    BOOL several = (methods & (methods - 1)) != 0;
+    for (U32 method = LAS_GRID_MIN; method <= LAS_GRID_IDW; method <<= 1)
+    {
+      if ((methods & method) == 0) continue;
+      CHAR* name = grid_file_name(file_name, method, several);
+      if (!grid->write(name, method)) failed = 1;
+      else if (verbose) fprintf(stderr,"wrote %s raster of %u by %u cells with step %g to '%s'\n", LASgrid::get_method_name(method), grid->get_cols(), grid->get_rows(), grid->get_step(), name);
+      free(name);
+    }
+    const U32* count = grid->get_count();
+    for (U32 i = 0; i < number_cells; i++)
+    {
+      if (count[i]) occupied++;
+    }
+    if (verbose)
+    {
+#ifdef _WIN32
+      fprintf(stderr,"%I64d of %u cells have points. merging and writing took %g sec\n", occupied, number_cells, MPI_Wtime()-start_time);
+#else
+      fprintf(stderr,"%lld of %u cells have points. merging and writing took %g sec\n", occupied, number_cells, MPI_Wtime()-start_time);
+#endif
+    }
+  }
+  MPI_Bcast(&failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (failed)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: cannot write raster '%s'\n", file_name);
+    return -1;
+  }
+  return occupied;
+}
@@ -0,0 +1,310 @@
+/*
+===============================================================================
+
+  FILE:  laszip_index.cpp
+
+  CONTENTS:
+
+    The '-build_lax' option of p_laszip creates the spatial index (LAX) of
+    existing LAS or LAZ files without writing their points again. When
+    there are at least as many files as processes, the files are dealt out
+    to the processes, each of which indexes its files on its own.
+
+    Fewer files are indexed one after the other by all processes together.
+    Every process decodes the same number of whole chunks of the file and
+    computes the quadtree cell of each point, which it keeps as runs of
+    consecutive points in the same cell. Process 0 receives the runs of one
+    process after the other, so that it adds them to the LASinterval in
+    global point order, exactly as a serial read would. The interval lists
+    are therefore merged correctly across process boundaries and the LAX
+    is identical to that of a serial run. Process 0 then coarsens the index
+    and writes the *.lax file or appends it to the file.
+
+    Files that already have a spatial index are skipped.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-build_lax' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lasreader.hpp"
+#include "lasindex.hpp"
+#include "lasquadtree.hpp"
+#include "lasinterval.hpp"
+#include "lastrace.hpp"
+
+#include "mpi.h"
+
+#define LAS_INDEX_RUNS_TAG 7
+
+struct LASindexSettings
+{
+  F32 tile_size;
+  U32 threshold;
+  U32 minimum_points;
+  I32 maximum_intervals;
+  BOOL append;
+  BOOL verbose;
+};
+
+// consecutive points that fall into the same cell
+
+struct LASindexRun
+{
+  I32 cell;
+  U32 start;
+  U32 number;
+};
+
+static LASreader* index_open(const CHAR* file_name)
+{
+  LASreadOpener lasreadopener;
+  lasreadopener.set_file_name(file_name);
+  return lasreadopener.open();
+}
+
+static BOOL index_finish(LASindex* lasindex, const CHAR* file_name, const LASindexSettings* settings)
+{
+  lasindex->complete(settings->minimum_points, settings->maximum_intervals, settings->verbose);
+  if (settings->append) return lasindex->append(file_name);
+  return lasindex->write(file_name);
+}
+
+// 1 if indexed, 0 if skipped, -1 on error
+
+static I32 index_file_alone(const CHAR* file_name, const LASindexSettings* settings)
+{
+  LASreader* lasreader = index_open(file_name);
+  if (lasreader == 0)
+  {
+    fprintf(stderr,"ERROR: cannot open '%s' for indexing\n", file_name);
+    return -1;
+  }
+  if (lasreader->get_index())
+  {
+    if (settings->verbose) fprintf(stderr,"skipping '%s' that is already indexed\n", file_name);
+    lasreader->close();
+    delete lasreader;
+    return 0;
+  }
+  LASquadtree* lasquadtree = new LASquadtree;
+  lasquadtree->setup(lasreader->header.min_x, lasreader->header.max_x, lasreader->header.min_y, lasreader->header.max_y, settings->tile_size);
+  LASindex lasindex;
+  lasindex.prepare(lasquadtree, settings->threshold);
+  U32 p_index = 0;
+  while (lasreader->read_point())
+  {
+    lasindex.add(lasreader->point.get_x(), lasreader->point.get_y(), p_index);
+    p_index++;
+  }
+  lasreader->close();
+  delete lasreader;
+  return (index_finish(&lasindex, file_name, settings) ? 1 : -1);
+}
+
+static I32 index_file_together(const CHAR* file_name, const LASindexSettings* settings)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  LASreader* lasreader = index_open(file_name);
+  int state = (lasreader == 0 ? -1 : (lasreader->get_index() ? 0 : 1));
+  MPI_Allreduce(MPI_IN_PLACE, &state, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  if (state <= 0)
+  {
+    if (rank == 0)
+    {
+      if (state < 0) fprintf(stderr,"ERROR: cannot open '%s' for indexing\n", file_name);
+      else if (settings->verbose) fprintf(stderr,"skipping '%s' that is already indexed\n", file_name);
+    }
+    if (lasreader) { lasreader->close(); delete lasreader; }
+    return state;
+  }
+
+  // the same whole chunks of the file for every process
+
+  I64 npoints = lasreader->npoints;
+  I64 chunk_size = 50000;
+  if (lasreader->header.laszip && (lasreader->header.laszip->chunk_size != U32_MAX)) chunk_size = lasreader->header.laszip->chunk_size;
+  I64 chunks = (npoints + chunk_size - 1) / chunk_size;
+  I64 point_start = ((chunks * rank) / process_count) * chunk_size;
+  I64 point_end = ((chunks * (rank + 1)) / process_count) * chunk_size;
+  if (point_start > npoints) point_start = npoints;
+  if (point_end > npoints) point_end = npoints;
+
+  LASquadtree* lasquadtree = new LASquadtree;
+  lasquadtree->setup(lasreader->header.min_x, lasreader->header.max_x, lasreader->header.min_y, lasreader->header.max_y, settings->tile_size);
+
+  // ***** the cells of the points of this process as runs
+
+  U32 alloc = 1024;
+  U32 number_runs = 0;
+  LASindexRun* runs = (LASindexRun*)malloc(sizeof(LASindexRun)*alloc);
+  int failed = 0;
+  I64 pass_start = LAStrace::now();
+  if (point_end > point_start)
+  {
+    I64 point_last = point_end - 1;
+    lasreader->prefetch(1, &point_start, &point_last);
+    if (!lasreader->seek(point_start)) failed = 1;
+    U32 p_index = (U32)point_start;
+    while (!failed && (p_index < (U32)point_end))
+    {
+      if (!lasreader->read_point())
+      {
+        fprintf(stderr,"ERROR: process %d cannot read point %u of '%s'\n", rank, p_index, file_name);
+        failed = 1;
+        break;
+      }
+      I32 cell = (I32)lasquadtree->get_cell_index(lasreader->point.get_x(), lasreader->point.get_y());
+      if (number_runs && (runs[number_runs-1].cell == cell))
+      {
+        runs[number_runs-1].number++;
+      }
+      else
+      {
+        if (number_runs == alloc)
+        {
+          alloc *= 2;
+          runs = (LASindexRun*)realloc(runs, sizeof(LASindexRun)*alloc);
+        }
+        runs[number_runs].cell = cell;
+        runs[number_runs].start = p_index;
+        runs[number_runs].number = 1;
+        number_runs++;
+      }
+      p_index++;
+    }
+  }
+  if (LAStrace::is_enabled()) LAStrace::complete("index cells", "phase", pass_start, point_end - point_start);
+  lasreader->close();
+  delete lasreader;
+
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if (failed)
+  {
+    free(runs);
+    delete lasquadtree;
+    return -1;
+  }
+
+  // ***** process 0 adds the runs of one process after the other
+
+  I32 result = 1;
+  if (rank == 0)
+  {
+    LASindex lasindex;
+    lasindex.prepare(lasquadtree, settings->threshold);
+    LASinterval* interval = lasindex.get_interval();
+    for (int r = 0; r < process_count; r++)
+    {
+      if (r)
+      {
+        U32 number;
+        MPI_Recv(&number, 1, MPI_UNSIGNED, r, LAS_INDEX_RUNS_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        if (number > alloc)
+        {
+          alloc = number;
+          runs = (LASindexRun*)realloc(runs, sizeof(LASindexRun)*alloc);
+        }
+        MPI_Recv(runs, (int)(sizeof(LASindexRun)*number), MPI_BYTE, r, LAS_INDEX_RUNS_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        number_runs = number;
+      }
+      for (U32 i = 0; i < number_runs; i++)
+      {
+        U32 end = runs[i].start + runs[i].number;
+        for (U32 p_index = runs[i].start; p_index < end; p_index++)
+        {
+          interval->add(p_index, runs[i].cell);
+        }
+      }
+    }
+    result = (index_finish(&lasindex, file_name, settings) ? 1 : -1);
+  }
+  else
+  {
+    MPI_Send(&number_runs, 1, MPI_UNSIGNED, 0, LAS_INDEX_RUNS_TAG, MPI_COMM_WORLD);
+    MPI_Send(runs, (int)(sizeof(LASindexRun)*number_runs), MPI_BYTE, 0, LAS_INDEX_RUNS_TAG, MPI_COMM_WORLD);
+    delete lasquadtree;
+  }
+  free(runs);
+  MPI_Bcast(&result, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  return result;
+}
+
+I64 laszip_index(LASreadOpener* lasreadopener, F32 tile_size, U32 threshold, U32 minimum_points, I32 maximum_intervals, BOOL append, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  F64 start_time = MPI_Wtime();
+
+  LASindexSettings settings;
+  settings.tile_size = tile_size;
+  settings.threshold = threshold;
+  settings.minimum_points = minimum_points;
+  settings.maximum_intervals = maximum_intervals;
+  settings.append = append;
+  settings.verbose = verbose && (rank == 0);
+
+  U32 number_files = lasreadopener->get_file_name_number();
+  if (number_files == 0)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: no input files to index\n");
+    return -1;
+  }
+
+  I64 counts[3] = { 0, 0, 0 }; // indexed, skipped, failed
+  if (number_files >= (U32)process_count)
+  {
+    settings.verbose = verbose;
+    for (U32 i = rank; i < number_files; i += process_count)
+    {
+      I32 result = index_file_alone(lasreadopener->get_file_name(i), &settings);
+      counts[result == 1 ? 0 : (result == 0 ? 1 : 2)]++;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, counts, 3, MPI_LONG_LONG_INT, MPI_SUM, MPI_COMM_WORLD);
+  }
+  else
+  {
+    for (U32 i = 0; i < number_files; i++)
+    {
+      I32 result = index_file_together(lasreadopener->get_file_name(i), &settings);
+      counts[result == 1 ? 0 : (result == 0 ? 1 : 2)]++;
+    }
+  }
+
+  if (rank == 0)
+  {
+#ifdef _WIN32
+    if (verbose || counts[2]) fprintf(stderr,"indexed %I64d of %u files (%I64d already indexed, %I64d failed) with %d processes in %g sec\n", counts[0], number_files, counts[1], counts[2], process_count, MPI_Wtime()-start_time);
+#else
+    if (verbose || counts[2]) fprintf(stderr,"indexed %lld of %u files (%lld already indexed, %lld failed) with %d processes in %g sec\n", counts[0], number_files, counts[1], counts[2], process_count, MPI_Wtime()-start_time);
+#endif
+  }
+  return (counts[2] ? -1 : counts[0]);
+}
@@ -0,0 +1,543 @@
+/*
+===============================================================================
+
+  FILE:  laszip_lod.cpp
+
+  CONTENTS:
+
+    Writes a LAZ file whose points are arranged as a coarse-to-fine level-of-
+    detail (LOD) hierarchy (see laslod.hpp) with all MPI processes working on
+    it in parallel:
+
+    1. every process reads an even share of the input points
+    2. the points are redistributed by their quadtree subtree at a split level
+       that is no deeper than the sampling spacing, so that all decisions for
+       one sampling cell are made by a single process in input order
+    3. every process assigns its points to levels and nodes, the points of the
+       levels above the split level are gathered to the first process
+    4. every process compresses its nodes into an in-memory buffer with one
+       variable-sized chunk per node
+    5. the buffers are written level by level (and within a level in process
+       order) to the output file and the last process writes the chunk table
+
+    The result is identical for any number of processes. All points are held
+    in memory during the build.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-lod' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <set>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "lasreader.hpp"
+#include "laswriter.hpp"
+#include "laslod.hpp"
+#include "laswritepoint.hpp"
+#include "bytestreamout_array.hpp"
+
+#include "mpi.h"
+
+extern BOOL laszip_any_failed(int failed);
+extern I64 laszip_exchange(const void* send, const I64* counts, size_t size, void** recv);
+
+// every point travels between processes as this header followed by its raw bytes
+
+struct LASlodRecord
+{
+  I64 index;
+  U32 deep;
+  U32 level;
+};
+
+struct LASlodOrder
+{
+  U32 level;
+  U32 node;
+  I64 index;
+  const U8* record;
+};
+
+static bool lod_order_less(const LASlodOrder& a, const LASlodOrder& b)
+{
+  if (a.level != b.level) return a.level < b.level;
+  if (a.node != b.node) return a.node < b.node;
+  return a.index < b.index;
+}
+
+I64 laszip_lod(LASreader* lasreader, LASwriteOpener* laswriteopener, U32 levels, U32 spacing, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  I32 r;
+  U32 l;
+
+  if (laswriteopener->get_format() != LAS_TOOLS_FORMAT_LAZ)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: option '-lod' requires LAZ output\n");
+    return -1;
+  }
+
+  I64 npoints = lasreader->npoints;
+  if (levels == 0) levels = LASlod::auto_levels(npoints, spacing);
+
+  LASlod lod;
+  if (!lod.setup(lasreader->header.min_x, lasreader->header.max_x, lasreader->header.min_y, lasreader->header.max_y, levels, spacing))
+  {
+    return -1;
+  }
+
+  // ***** read an even share of the points
+
+  I64 point_start = rank*(npoints/process_count);
+  I64 point_end = point_start + npoints/process_count;
+  if (rank == process_count-1) point_end += npoints%process_count;
+
+  LASpoint* point = &lasreader->point;
+  U32 record_size = sizeof(LASlodRecord) + point->total_point_size;
+  I64 local_points = point_end - point_start;
+  U8* records = (U8*)malloc(record_size*(local_points ? local_points : 1));
+  if (laszip_any_failed(records == 0))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: cannot allocate memory for LOD points\n");
+    return -1;
+  }
+
+  LASlodRecord record;
+  I64 n = 0;
+  lasreader->seek(point_start);
+  while ((n < local_points) && lasreader->read_point())
+  {
+    U8* rec = records + n*record_size;
+    record.index = point_start + n;
+    record.deep = lod.get_deep_index(point->get_x(), point->get_y());
+    record.level = 0;
+    memcpy(rec, &record, sizeof(LASlodRecord));
+    point->copy_to(rec + sizeof(LASlodRecord));
+    n++;
+  }
+  if (n != local_points)
+  {
+#ifdef _WIN32
+    fprintf(stderr,"WARNING: rank %d read only %I64d of %I64d points\n", rank, n, local_points);
+#else
+    fprintf(stderr,"WARNING: rank %d read only %lld of %lld points\n", rank, n, local_points);
+#endif
+    local_points = n;
+  }
+  dbg(3, "rank %i point_start %lli local_points %lli", rank, point_start, local_points);
+
+  // ***** choose the split level and balance the subtrees across the processes
+
+  U32 split = 0;
+  while ((((I64)1) << (2*split)) < 4*(I64)process_count && (split < spacing) && (split < levels-1)) split++;
+  U32 subtrees = ((U32)1) << (2*split);
+
+  I64* subtree_counts = (I64*)calloc(subtrees, sizeof(I64));
+  for (n = 0; n < local_points; n++)
+  {
+    memcpy(&record, records + n*record_size, sizeof(LASlodRecord));
+    subtree_counts[lod.get_node_index(record.deep, split)]++;
+  }
+  MPI_Allreduce(MPI_IN_PLACE, subtree_counts, subtrees, MPI_LONG_LONG_INT, MPI_SUM, MPI_COMM_WORLD);
+
+  I64 total_points = 0;
+  U32 s;
+  for (s = 0; s < subtrees; s++) total_points += subtree_counts[s];
+
+  int* subtree_owner = (int*)malloc(sizeof(int)*subtrees);
+  I64 cumulative = 0;
+  r = 0;
+  for (s = 0; s < subtrees; s++)
+  {
+    subtree_owner[s] = r;
+    cumulative += subtree_counts[s];
+    while ((r < process_count-1) && (cumulative*process_count >= total_points*(r+1))) r++;
+  }
+  free(subtree_counts);
+
+  // ***** send every point to the process owning its subtree
+
+  I64* send_points = (I64*)calloc(process_count, sizeof(I64));
+
+  for (n = 0; n < local_points; n++)
+  {
+    memcpy(&record, records + n*record_size, sizeof(LASlodRecord));
+    send_points[subtree_owner[lod.get_node_index(record.deep, split)]]++;
+  }
+
+  U8* send_buffer = (U8*)malloc(local_points ? local_points*record_size : 1);
+  I64* send_position = (I64*)malloc(sizeof(I64)*process_count);
+  send_position[0] = 0;
+  for (r = 1; r < process_count; r++) send_position[r] = send_position[r-1] + send_points[r-1]*record_size;
+  for (n = 0; n < local_points; n++)
+  {
+    memcpy(&record, records + n*record_size, sizeof(LASlodRecord));
+    r = subtree_owner[lod.get_node_index(record.deep, split)];
+    memcpy(send_buffer + send_position[r], records + n*record_size, record_size);
+    send_position[r] += record_size;
+  }
+  free(records);
+  free(send_position);
+
+  U8* recv_buffer = 0;
+  I64 received_points = laszip_exchange(send_buffer, send_points, record_size, (void**)&recv_buffer);
+  free(send_buffer);
+  free(send_points);
+  free(subtree_owner);
+  if (received_points < 0)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: more than %d bytes of LOD points per process. use more processes.\n", INT_MAX);
+    return -1;
+  }
+
+  // ***** assign levels. points arrive in input order because each process sent its share in order
+
+  I64 upper_points = 0;
+  set<U64> occupied;
+  for (n = 0; n < received_points; n++)
+  {
+    U8* rec = recv_buffer + n*record_size;
+    memcpy(&record, rec, sizeof(LASlodRecord));
+    for (l = 0; l < levels-1; l++)
+    {
+      if (occupied.insert((((U64)l) << 32) | lod.get_sample_index(record.deep, l)).second) break;
+    }
+    record.level = l;
+    memcpy(rec, &record, sizeof(LASlodRecord));
+    if (l < split) upper_points++;
+  }
+  occupied.clear();
+
+  // ***** the nodes above the split level span several processes and go to the first one
+
+  int upper_bytes = (int)(upper_points*record_size);
+  if (laszip_any_failed((upper_points*record_size) > INT_MAX))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: more than %d bytes of LOD points above split level %u\n", INT_MAX, split);
+    return -1;
+  }
+  U8* upper_buffer = (U8*)malloc(upper_bytes ? upper_bytes : 1);
+  I64 upper_position = 0;
+  for (n = 0; n < received_points; n++)
+  {
+    U8* rec = recv_buffer + n*record_size;
+    memcpy(&record, rec, sizeof(LASlodRecord));
+    if (record.level < split)
+    {
+      memcpy(upper_buffer + upper_position, rec, record_size);
+      upper_position += record_size;
+    }
+  }
+
+  int* gather_counts = (int*)malloc(sizeof(int)*process_count);
+  int* gather_displs = (int*)malloc(sizeof(int)*process_count);
+  MPI_Gather(&upper_bytes, 1, MPI_INT, gather_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  int too_large = 0;
+  I64 gathered_total = 0;
+  if (rank == 0)
+  {
+    for (r = 0; r < process_count; r++)
+    {
+      if ((gathered_total + gather_counts[r]) > INT_MAX) too_large = 1;
+      gather_displs[r] = (int)gathered_total;
+      gathered_total += gather_counts[r];
+    }
+  }
+  if (laszip_any_failed(too_large))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: more than %d bytes of LOD points above split level %u\n", INT_MAX, split);
+    return -1;
+  }
+  U8* gathered_buffer = (U8*)malloc(gathered_total ? gathered_total : 1);
+  MPI_Gatherv(upper_buffer, upper_bytes, MPI_BYTE, gathered_buffer, gather_counts, gather_displs, MPI_BYTE, 0, MPI_COMM_WORLD);
+  free(upper_buffer);
+  free(gather_counts);
+  free(gather_displs);
+
+  // ***** order the points by level and node
+
+  vector<LASlodOrder> order;
+  LASlodOrder entry;
+  for (n = 0; n < received_points; n++)
+  {
+    entry.record = recv_buffer + n*record_size;
+    memcpy(&record, entry.record, sizeof(LASlodRecord));
+    if (record.level < split) continue;
+    entry.level = record.level;
+    entry.node = lod.get_node_index(record.deep, record.level);
+    entry.index = record.index;
+    order.push_back(entry);
+  }
+  for (n = 0; n < gathered_total/record_size; n++)
+  {
+    entry.record = gathered_buffer + n*record_size;
+    memcpy(&record, entry.record, sizeof(LASlodRecord));
+    entry.level = record.level;
+    entry.node = lod.get_node_index(record.deep, record.level);
+    entry.index = record.index;
+    order.push_back(entry);
+  }
+  sort(order.begin(), order.end(), lod_order_less);
+
+  // ***** compress every node into its own variable-sized chunk
+
+  LASzip laszip;
+  if (!laszip.setup(point->num_items, point->items, LASZIP_COMPRESSOR_CHUNKED) || !laszip.request_version(laswriteopener->get_version()) || !laszip.set_chunk_size(U32_MAX) || !laszip.request_coder(laswriteopener->get_coder()))
+  {
+    fprintf(stderr,"ERROR: rank %d cannot set up LASzip for LOD chunks\n", rank);
+    return -1;
+  }
+  ByteStreamOutArrayLE* blob = new ByteStreamOutArrayLE();
+  LASwritePoint* writer = new LASwritePoint();
+  writer->setup(laszip.num_items, laszip.items, &laszip);
+  writer->init(blob);
+  I64 blob_start = blob->tell();
+
+  vector<U32> chunk_levels;
+  vector<U32> chunk_nodes;
+  size_t o;
+  for (o = 0; o < order.size(); o++)
+  {
+    if (o && ((order[o].level != order[o-1].level) || (order[o].node != order[o-1].node)))
+    {
+      writer->chunk();
+      chunk_levels.push_back(order[o-1].level);
+      chunk_nodes.push_back(order[o-1].node);
+    }
+    point->copy_from(order[o].record + sizeof(LASlodRecord));
+    writer->write(point->point);
+  }
+  if (o)
+  {
+    writer->chunk();
+    chunk_levels.push_back(order[o-1].level);
+    chunk_nodes.push_back(order[o-1].node);
+  }
+  order.clear();
+  free(recv_buffer);
+  free(gathered_buffer);
+
+  U32 number_chunks = (U32)chunk_levels.size();
+  I64* level_bytes = (I64*)calloc(levels, sizeof(I64));
+  U32* level_chunks = (U32*)calloc(levels, sizeof(U32));
+  I64* level_points = (I64*)calloc(levels, sizeof(I64));
+  U32 c;
+  for (c = 0; c < number_chunks; c++)
+  {
+    level_bytes[chunk_levels[c]] += writer->chunk_bytes[c];
+    level_chunks[chunk_levels[c]]++;
+    level_points[chunk_levels[c]] += writer->chunk_sizes[c];
+  }
+
+  I64* all_level_bytes = (I64*)malloc(sizeof(I64)*levels*process_count);
+  U32* all_level_chunks = (U32*)malloc(sizeof(U32)*levels*process_count);
+  MPI_Allgather(level_bytes, levels, MPI_LONG_LONG_INT, all_level_bytes, levels, MPI_LONG_LONG_INT, MPI_COMM_WORLD);
+  MPI_Allgather(level_chunks, levels, MPI_UNSIGNED, all_level_chunks, levels, MPI_UNSIGNED, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, level_points, levels, MPI_LONG_LONG_INT, MPI_SUM, MPI_COMM_WORLD);
+
+  // ***** the first process describes the hierarchy in a VLR
+
+  int* chunk_counts = (int*)calloc(process_count, sizeof(int));
+  int* chunk_displs = (int*)malloc(sizeof(int)*process_count);
+  U32 total_chunks = 0;
+  for (r = 0; r < process_count; r++)
+  {
+    for (l = 0; l < levels; l++) chunk_counts[r] += all_level_chunks[r*levels+l];
+    chunk_displs[r] = total_chunks;
+    total_chunks += chunk_counts[r];
+  }
+
+  U32* gathered_nodes = (U32*)malloc(sizeof(U32)*(total_chunks ? total_chunks : 1));
+  MPI_Gatherv((number_chunks ? &(chunk_nodes[0]) : 0), number_chunks, MPI_UNSIGNED, gathered_nodes, chunk_counts, chunk_displs, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+
+  U8* vlr_data = 0;
+  U16 vlr_length = 0;
+  int vlr_size = 0;
+  if (rank == 0)
+  {
+    U32* nodes = (U32*)malloc(sizeof(U32)*(total_chunks ? total_chunks : 1));
+    for (l = 0; l < levels; l++)
+    {
+      U32 number_nodes = 0;
+      for (r = 0; r < process_count; r++)
+      {
+        U32 first = chunk_displs[r];
+        for (U32 k = 0; k < l; k++) first += all_level_chunks[r*levels+k];
+        memcpy(nodes + number_nodes, gathered_nodes + first, sizeof(U32)*all_level_chunks[r*levels+l]);
+        number_nodes += all_level_chunks[r*levels+l];
+      }
+      lod.add_level(l, number_nodes, nodes, level_points[l]);
+    }
+    free(nodes);
+    if (lod.pack(&vlr_data, &vlr_length)) vlr_size = vlr_length;
+  }
+  free(gathered_nodes);
+
+  MPI_Bcast(&vlr_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (vlr_size == 0)
+  {
+    return -1;
+  }
+  vlr_length = (U16)vlr_size;
+  if (rank != 0) vlr_data = new U8[vlr_length];
+  MPI_Bcast(vlr_data, vlr_length, MPI_BYTE, 0, MPI_COMM_WORLD);
+  lasreader->header.add_vlr(LAS_LOD_USER_ID, LAS_LOD_RECORD_ID, vlr_length, vlr_data);
+
+  if (verbose && (rank == 0))
+  {
+    fprintf(stderr,"LOD with %u levels, spacing %u, split level %u\n", levels, spacing, split);
+    for (l = 0; l < levels; l++)
+    {
+#ifdef _WIN32
+      fprintf(stderr,"  level %u: %u nodes with %I64d points\n", l, lod.get_number_of_nodes(l), level_points[l]);
+#else
+      fprintf(stderr,"  level %u: %u nodes with %lld points\n", l, lod.get_number_of_nodes(l), level_points[l]);
+#endif
+    }
+  }
+
+  // ***** open the output with variable-sized chunks and write the chunks level by level
+
+  U32 chunk_size = laswriteopener->get_chunk_size();
+  laswriteopener->set_use_nil(FALSE);
+  laswriteopener->set_chunk_size(U32_MAX);
+  LASwriter* laswriter = laswriteopener->open(&lasreader->header);
+  laswriteopener->set_chunk_size(chunk_size);
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (laszip_any_failed(laswriter == 0 || laswriter->get_stream() == 0))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: could not open LOD output '%s'\n", laswriteopener->get_file_name());
+    return -1;
+  }
+  ByteStreamOut* stream = laswriter->get_stream();
+
+  I64 data_start = stream->tell();
+  I64 data_end = data_start;
+  I64* write_offsets = (I64*)malloc(sizeof(I64)*levels);
+  for (l = 0; l < levels; l++)
+  {
+    for (r = 0; r < process_count; r++)
+    {
+      if (r == rank) write_offsets[l] = data_end;
+      data_end += all_level_bytes[r*levels+l];
+    }
+  }
+
+  const U8* data = blob->getData() + blob_start;
+  for (l = 0; l < levels; l++)
+  {
+    if (level_bytes[l] == 0) continue;
+    stream->seek(write_offsets[l]);
+    I64 remaining = level_bytes[l];
+    while (remaining)
+    {
+      U32 bytes = (remaining > (1 << 30) ? (1 << 30) : (U32)remaining);
+      stream->putBytes(data, bytes);
+      data += bytes;
+      remaining -= bytes;
+    }
+  }
+  dbg(3, "rank %i number_chunks %u data_start %lli data_end %lli", rank, number_chunks, data_start, data_end);
+
+  // ***** gather the chunk table in file order to the last process
+
+  U32* gathered_sizes = 0;
+  U32* gathered_bytes = 0;
+  if (rank == process_count-1)
+  {
+    gathered_sizes = (U32*)malloc(sizeof(U32)*(total_chunks ? total_chunks : 1));
+    gathered_bytes = (U32*)malloc(sizeof(U32)*(total_chunks ? total_chunks : 1));
+  }
+  MPI_Gatherv(writer->chunk_sizes, number_chunks, MPI_UNSIGNED, gathered_sizes, chunk_counts, chunk_displs, MPI_UNSIGNED, process_count-1, MPI_COMM_WORLD);
+  MPI_Gatherv(writer->chunk_bytes, number_chunks, MPI_UNSIGNED, gathered_bytes, chunk_counts, chunk_displs, MPI_UNSIGNED, process_count-1, MPI_COMM_WORLD);
+
+  U32* table_sizes = 0;
+  U32* table_bytes = 0;
+  if (rank == process_count-1)
+  {
+    table_sizes = (U32*)malloc(sizeof(U32)*(total_chunks ? total_chunks : 1));
+    table_bytes = (U32*)malloc(sizeof(U32)*(total_chunks ? total_chunks : 1));
+    c = 0;
+    for (l = 0; l < levels; l++)
+    {
+      for (r = 0; r < process_count; r++)
+      {
+        U32 first = chunk_displs[r];
+        for (U32 k = 0; k < l; k++) first += all_level_chunks[r*levels+k];
+        memcpy(table_sizes + c, gathered_sizes + first, sizeof(U32)*all_level_chunks[r*levels+l]);
+        memcpy(table_bytes + c, gathered_bytes + first, sizeof(U32)*all_level_chunks[r*levels+l]);
+        c += all_level_chunks[r*levels+l];
+      }
+    }
+    free(gathered_sizes);
+    free(gathered_bytes);
+  }
+
+  // ***** everybody else flushes first so the last process has the final word on the chunk table pointer
+
+  I64 bytes_written = 0;
+  laswriter->p_count = laswriter->npoints;
+  if (rank != process_count-1)
+  {
+    bytes_written = laswriter->close(FALSE);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (rank == process_count-1)
+  {
+    LASwritePoint* file_writer = laswriter->get_writer();
+    if (file_writer->chunk_sizes) free(file_writer->chunk_sizes);
+    if (file_writer->chunk_bytes) free(file_writer->chunk_bytes);
+    file_writer->number_chunks = total_chunks;
+    file_writer->alloced_chunks = total_chunks;
+    file_writer->chunk_sizes = table_sizes;
+    file_writer->chunk_bytes = table_bytes;
+    stream->seek(data_end);
+    bytes_written = laswriter->close();
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  delete laswriter;
+  delete writer;
+  free(blob->takeData());
+  delete blob;
+  free(write_offsets);
+  free(chunk_counts);
+  free(chunk_displs);
+  free(all_level_bytes);
+  free(all_level_chunks);
+  free(level_bytes);
+  free(level_chunks);
+  free(level_points);
+
+  return bytes_written;
+}
@@ -0,0 +1,107 @@
+/*
+===============================================================================
+
+  FILE:  laszip_pipeline.cpp
+
+  CONTENTS:
+
+    Runs the point loops of p_laszip through a LASpipeline, so that the
+    passes of the MPI path and the loop of the single writer path share
+    the same stages: clip, grid, index, stats, and write. With '-pipeline'
+    each stage runs on its own thread, and '-pipeline_threads' gives the
+    stages that can run on several threads (clip and stats) that many.
+
+    The '-stats' option collects the number of points, the returns, the
+    classifications, and the bounding box of the points that are written.
+    The statistics of all processes are reduced onto process 0, which
+    prints them.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-pipeline' and '-stats' options
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lasreader.hpp"
+#include "laswriter.hpp"
+#include "laspipeline.hpp"
+
+#include "mpi.h"
+
+I64 laszip_pipeline(LASreader* lasreader, LASwriter* laswriter, const LASpolygon* polygon, LASgrid* lasgrid, LASindex* lasindex, LASpipelineStats* stats, BOOL inventory, I64 number, BOOL threaded, U32 threads)
+{
+  LASpipeline pipeline;
+  pipeline.set_threaded(threaded);
+  if (polygon) pipeline.add(new LASpipelineClip(polygon), threads);
+  LASpipelineStats* pass_stats = 0;
+  if (stats)
+  {
+    pass_stats = new LASpipelineStats();
+    pipeline.add(pass_stats, threads);
+  }
+  if (lasgrid) pipeline.add(new LASpipelineGrid(lasgrid));
+  if (lasindex) pipeline.add(new LASpipelineIndex(lasindex));
+  pipeline.add(new LASpipelineWriter(laswriter, inventory));
+
+  I64 read = pipeline.run(lasreader, number);
+  if (read < 0)
+  {
+    fprintf(stderr, "ERROR: pipeline: %s\n", pipeline.get_error());
+    return -1;
+  }
+  if (stats) stats->merge(pass_stats);
+  return read;
+}
+
+void laszip_stats_report(const LASpipelineStats* stats, const LASheader* header)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  LASpipelineStats all;
+  I64 counts[1 + 16 + 256];
+  I64 all_counts[1 + 16 + 256];
+  counts[0] = stats->number_of_point_records;
+  memcpy(counts + 1, stats->number_of_points_by_return, sizeof(I64)*16);
+  memcpy(counts + 1 + 16, stats->classification, sizeof(I64)*256);
+  I32 mins[3] = { stats->min_X, stats->min_Y, stats->min_Z };
+  I32 maxs[3] = { stats->max_X, stats->max_Y, stats->max_Z };
+  I32 all_mins[3], all_maxs[3];
+  MPI_Reduce(counts, all_counts, 1 + 16 + 256, MPI_LONG_LONG_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(mins, all_mins, 3, MPI_INT, MPI_MIN, 0, MPI_COMM_WORLD);
+  MPI_Reduce(maxs, all_maxs, 3, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+
+  if (rank == 0)
+  {
+    all.number_of_point_records = all_counts[0];
+    memcpy(all.number_of_points_by_return, all_counts + 1, sizeof(I64)*16);
+    memcpy(all.classification, all_counts + 1 + 16, sizeof(I64)*256);
+    all.min_X = all_mins[0]; all.min_Y = all_mins[1]; all.min_Z = all_mins[2];
+    all.max_X = all_maxs[0]; all.max_Y = all_maxs[1]; all.max_Z = all_maxs[2];
+    fprintf(stderr,"statistics of the points written by %d processes:\n", process_count);
+    all.print(stderr, header);
+  }
+}
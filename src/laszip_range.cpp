@@ -0,0 +1,232 @@
+/*
+===============================================================================
+
+  FILE:  laszip_range.cpp
+
+  CONTENTS:
+
+    Writes the BIN, QFIT, TXT, and WRL formats with all MPI processes working
+    on it in parallel. Every process writes an even share of the points with
+    the usual writer into a temporary file. The writer reports where its bytes
+    switch between pieces that are shared by all processes (the header and the
+    trailer, or the text that separates the coordinates and the colors of WRL)
+    and pieces that hold the points of this process. Process 0 creates the
+    output file and writes the shared pieces together with its own points and
+    then every other process copies its points to an offset that is the prefix
+    sum of the point bytes of all processes before it.
+
+    The fixed-size records of BIN and QFIT make these offsets the same as the
+    ones computed from the point index, whereas the variable-length lines of
+    TXT and WRL need the prefix sum.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for parallel output of non-LAS formats in p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lasreader.hpp"
+#include "laswriter.hpp"
+#include "bytestreamin_file.hpp"
+#include "bytestreamout_file.hpp"
+
+#include "mpi.h"
+
+#define LAS_RANGE_COPY_BUFFER_SIZE 1048576
+
+extern BOOL laszip_any_failed(int failed);
+
+static BOOL range_copy(ByteStreamIn* from, I64 from_offset, ByteStreamOut* to, I64 to_offset, I64 bytes, U8* buffer)
+{
+  if (bytes == 0) return TRUE;
+  if (!from->seek(from_offset) || !to->seek(to_offset)) return FALSE;
+  while (bytes)
+  {
+    U32 size = (bytes < LAS_RANGE_COPY_BUFFER_SIZE ? (U32)bytes : LAS_RANGE_COPY_BUFFER_SIZE);
+    try { from->getBytes(buffer, size); } catch (...) { return FALSE; }
+    if (!to->putBytes(buffer, size)) return FALSE;
+    bytes -= size;
+  }
+  return TRUE;
+}
+
+I64 laszip_range(LASreader* lasreader, LASwriteOpener* laswriteopener, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  I32 r;
+  U32 i;
+
+  const CHAR* file_name = laswriteopener->get_file_name();
+  if (file_name == 0)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: parallel output of format '%s' needs a file name\n", laswriteopener->get_format_name());
+    return -1;
+  }
+
+  // ***** write an even share of the points into a temporary file
+
+  I64 npoints = lasreader->npoints;
+  I64 point_start = rank*(npoints/process_count);
+  I64 point_end = point_start + npoints/process_count;
+  if (rank == process_count-1) point_end += npoints%process_count;
+
+  FILE* range_file = tmpfile();
+  if (laszip_any_failed(range_file == 0))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: cannot create temporary files for parallel output\n");
+    if (range_file) fclose(range_file);
+    return -1;
+  }
+
+  laswriteopener->set_use_nil(FALSE);
+  laswriteopener->set_range_file(range_file);
+  LASwriter* laswriter = laswriteopener->open(&lasreader->header);
+  laswriteopener->set_range_file(0);
+  if (laszip_any_failed(laswriter == 0))
+  {
+    if (laswriter) delete laswriter;
+    fclose(range_file);
+    return -1;
+  }
+
+  laswriter->set_range_start(point_start);
+  lasreader->seek(point_start);
+  while ((laswriter->p_count < (point_end - point_start)) && lasreader->read_point())
+  {
+    laswriter->write_point(&lasreader->point);
+  }
+  I64 local_points = laswriter->p_count;
+  laswriter->close(FALSE);
+
+  const I64* marks = 0;
+  U32 number_marks = laswriter->get_range_marks(&marks);
+
+  // piece i of the temporary file spans [bounds[i], bounds[i+1]). even pieces
+  // are shared and odd pieces hold the points of this process.
+
+  I64 bounds[6];
+  bounds[0] = 0;
+  for (i = 0; i < number_marks; i++) bounds[i+1] = marks[i];
+  fflush(range_file);
+  fseek(range_file, 0, SEEK_END);
+  bounds[number_marks+1] = (I64)ftell(range_file);
+  delete laswriter;
+
+  int number_min = number_marks, number_max = number_marks;
+  MPI_Allreduce(MPI_IN_PLACE, &number_min, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &number_max, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if ((number_min != number_max) || (number_marks == 0) || (number_marks > 4) || (number_marks & 1) || (local_points != (point_end - point_start)))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: writer for format '%s' does not support parallel output\n", laswriteopener->get_format_name());
+    fclose(range_file);
+    return -1;
+  }
+
+  U32 number_ranged = number_marks/2;
+  I64 ranged_bytes[2];
+  for (i = 0; i < number_ranged; i++) ranged_bytes[i] = bounds[2*i+2] - bounds[2*i+1];
+  I64* all_ranged_bytes = (I64*)malloc(sizeof(I64)*number_ranged*process_count);
+  MPI_Allgather(ranged_bytes, number_ranged, MPI_LONG_LONG_INT, all_ranged_bytes, number_ranged, MPI_LONG_LONG_INT, MPI_COMM_WORLD);
+
+  // ***** where each piece of this process goes in the output file
+
+  I64 offsets[5];
+  I64 offset = 0;
+  for (i = 0; i <= number_marks; i++)
+  {
+    if (i & 1)
+    {
+      U32 k = i/2;
+      offsets[i] = offset;
+      for (r = 0; r < rank; r++) offsets[i] += all_ranged_bytes[r*number_ranged+k];
+      for (r = 0; r < process_count; r++) offset += all_ranged_bytes[r*number_ranged+k];
+    }
+    else
+    {
+      offsets[i] = offset;
+      offset += bounds[i+1] - bounds[i];
+    }
+  }
+  I64 bytes_written = offset;
+  free(all_ranged_bytes);
+
+  dbg(3, "rank %i point_start %lli point_end %lli ranged pieces %u bytes_written %lli", rank, point_start, point_end, number_ranged, bytes_written);
+
+  // ***** process 0 creates the file with all shared pieces, then the others add their points
+
+  U8* buffer = (U8*)malloc(LAS_RANGE_COPY_BUFFER_SIZE);
+  BOOL failed = (buffer == 0);
+  ByteStreamIn* stream_in = new ByteStreamInFileLE(range_file);
+
+  for (r = 0; r < 2; r++)
+  {
+    if ((r == 0) == (rank == 0))
+    {
+      FILE* file = (failed ? 0 : fopen(file_name, (rank == 0 ? "wb" : "r+b")));
+      if (file == 0)
+      {
+        if (!failed) fprintf(stderr,"ERROR: cannot open file '%s' for parallel output\n", file_name);
+        failed = TRUE;
+      }
+      else
+      {
+        ByteStreamOut* stream_out = new ByteStreamOutFileLE(file);
+        for (i = 0; i <= number_marks; i++)
+        {
+          if ((rank != 0) && !(i & 1)) continue;
+          if (!range_copy(stream_in, bounds[i], stream_out, offsets[i], bounds[i+1] - bounds[i], buffer))
+          {
+            fprintf(stderr,"ERROR: cannot write %lld bytes at offset %lld of '%s'\n", bounds[i+1] - bounds[i], offsets[i], file_name);
+            failed = TRUE;
+            break;
+          }
+        }
+        delete stream_out;
+        if (fclose(file)) failed = TRUE;
+      }
+    }
+    if (laszip_any_failed(failed)) break;
+  }
+
+  delete stream_in;
+  fclose(range_file);
+  if (buffer) free(buffer);
+
+  if (laszip_any_failed(failed)) return -1;
+
+  if (verbose && (rank == 0))
+  {
+#ifdef _WIN32
+    fprintf(stderr, "wrote %I64d points to '%s' with %d processes\n", npoints, file_name, process_count);
+#else
+    fprintf(stderr, "wrote %lld points to '%s' with %d processes\n", npoints, file_name, process_count);
+#endif
+  }
+
+  return bytes_written;
+}
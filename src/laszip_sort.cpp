@@ -0,0 +1,552 @@
+/*
+===============================================================================
+
+  FILE:  laszip_sort.cpp
+
+  CONTENTS:
+
+    Sorts the points into acquisition order by GPS time (ties broken by the
+    return number and then by the input order) with all MPI processes working
+    on it in parallel. This is a sample sort:
+
+    1. every process reads an even share of the input points and sorts them
+    2. regular samples of all processes determine one splitter per process
+    3. the points are exchanged so that every process holds one contiguous
+       GPS time range, which it sorts again
+    4. every process compresses its points into an in-memory buffer and the
+       buffers are written in process order to the output file
+
+    LAZ output uses variable-sized chunks of up to chunk_size points since the
+    number of points per process is arbitrary. Optionally there is one output
+    file per flightline (point source ID) named <output>_<id>.<ext>. All points
+    are held in memory during the sort.
+
+    The helpers that the other modes of p_laszip which exchange points or
+    write per-process buffers share (failure agreement, the all-to-all
+    exchange, the header update, and the writing of the buffers) are here.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- shared helpers for exchanging points and fixing the header
+    18 October 2026 -- created for the '-sort_gps_time' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "lasreader.hpp"
+#include "laswriter.hpp"
+#include "laslod.hpp"
+#include "laswritepoint.hpp"
+#include "bytestreamout_array.hpp"
+
+#include "mpi.h"
+
+// every point travels between processes as this header followed by its raw bytes
+
+struct LASsortRecord
+{
+  F64 gps_time;
+  I64 index;
+  U16 point_source_ID;
+  U8 return_number;
+  U8 reserved[5];
+};
+
+static inline bool sort_key_less(const LASsortRecord* a, const LASsortRecord* b)
+{
+  if (a->gps_time != b->gps_time) return a->gps_time < b->gps_time;
+  if (a->return_number != b->return_number) return a->return_number < b->return_number;
+  return a->index < b->index;
+}
+
+static bool sort_record_less(const U8* a, const U8* b)
+{
+  return sort_key_less((const LASsortRecord*)a, (const LASsortRecord*)b);
+}
+
+// returns TRUE on all processes if any one of them reports a failure
+
+BOOL laszip_any_failed(int failed)
+{
+  MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  return (failed != 0);
+}
+
+// sends 'counts[r]' items of 'size' bytes from 'send' to every process r and
+// returns how many items were received into the newly allocated 'recv'. MPI
+// counts are int, so if any process would send or receive more than INT_MAX
+// bytes nothing is exchanged and all processes return -1
+
+I64 laszip_exchange(const void* send, const I64* counts, size_t size, void** recv)
+{
+  int process_count;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+
+  int* send_counts = (int*)malloc(sizeof(int)*process_count);
+  int* send_displs = (int*)malloc(sizeof(int)*process_count);
+  int* recv_counts = (int*)malloc(sizeof(int)*process_count);
+  int* recv_displs = (int*)malloc(sizeof(int)*process_count);
+  int r, too_large = 0;
+  I64 send_total = 0;
+  for (r = 0; r < process_count; r++)
+  {
+    if ((send_total + counts[r]*(I64)size) > INT_MAX) too_large = 1;
+    send_displs[r] = (int)send_total;
+    send_counts[r] = (int)(counts[r]*size);
+    send_total += counts[r]*size;
+  }
+  MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, MPI_COMM_WORLD);
+  I64 recv_total = 0;
+  for (r = 0; r < process_count; r++)
+  {
+    if ((recv_total + recv_counts[r]) > INT_MAX) too_large = 1;
+    recv_displs[r] = (int)recv_total;
+    recv_total += recv_counts[r];
+  }
+  I64 received = -1;
+  *recv = 0;
+  if (!laszip_any_failed(too_large))
+  {
+    *recv = malloc(recv_total ? recv_total : 1);
+    MPI_Alltoallv((void*)send, send_counts, send_displs, MPI_BYTE, *recv, recv_counts, recv_displs, MPI_BYTE, MPI_COMM_WORLD);
+    received = recv_total/size;
+  }
+  free(send_counts);
+  free(send_displs);
+  free(recv_counts);
+  free(recv_displs);
+  return received;
+}
+
+// sets count, returns, and bounding box of the header to those of the points
+// that all processes added to their inventories. the bounding box is kept if
+// there are no points at all
+
+void laszip_update_header(LASheader* header, const LASinventory* inventory)
+{
+  U32 i;
+  I64 counts[17];
+  counts[0] = inventory->extended_number_of_point_records;
+  memcpy(counts + 1, inventory->extended_number_of_points_by_return, sizeof(I64)*16);
+  I32 min[3] = { I32_MAX, I32_MAX, I32_MAX };
+  I32 max[3] = { I32_MIN, I32_MIN, I32_MIN };
+  if (inventory->active())
+  {
+    min[0] = inventory->min_X; min[1] = inventory->min_Y; min[2] = inventory->min_Z;
+    max[0] = inventory->max_X; max[1] = inventory->max_Y; max[2] = inventory->max_Z;
+  }
+  MPI_Allreduce(MPI_IN_PLACE, counts, 17, MPI_LONG_LONG_INT, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, min, 3, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, max, 3, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+  // counts[1] holds the points with return number 0
+  header->number_of_point_records = (counts[0] > U32_MAX ? 0 : (U32)counts[0]);
+  header->extended_number_of_point_records = counts[0];
+  for (i = 0; i < 5; i++)
+  {
+    header->number_of_points_by_return[i] = (counts[i+2] > U32_MAX ? 0 : (U32)counts[i+2]);
+  }
+  for (i = 0; i < 15; i++)
+  {
+    header->extended_number_of_points_by_return[i] = counts[i+2];
+  }
+  if (counts[0])
+  {
+    header->min_x = header->get_x(min[0]); header->max_x = header->get_x(max[0]);
+    header->min_y = header->get_y(min[1]); header->max_y = header->get_y(max[1]);
+    header->min_z = header->get_z(min[2]); header->max_z = header->get_z(max[2]);
+  }
+}
+
+// writes what every process has compressed (or copied) into its blob in
+// process order into one file. the last process writes the chunk table
+
+I64 laszip_write_blobs(LASheader* header, LASwriteOpener* laswriteopener, LASwritePoint* writer, ByteStreamOutArray* blob, I64 blob_start, BOOL compress, U32 chunk_size)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  I32 r;
+
+  I64 bytes = blob->tell() - blob_start;
+  U32 number_chunks = writer->number_chunks;
+
+  I64* all_bytes = (I64*)malloc(sizeof(I64)*process_count);
+  int* chunk_counts = (int*)malloc(sizeof(int)*process_count);
+  int* chunk_displs = (int*)malloc(sizeof(int)*process_count);
+  MPI_Allgather(&bytes, 1, MPI_LONG_LONG_INT, all_bytes, 1, MPI_LONG_LONG_INT, MPI_COMM_WORLD);
+  MPI_Allgather(&number_chunks, 1, MPI_UNSIGNED, chunk_counts, 1, MPI_UNSIGNED, MPI_COMM_WORLD);
+  U32 total_chunks = 0;
+  for (r = 0; r < process_count; r++)
+  {
+    chunk_displs[r] = total_chunks;
+    total_chunks += chunk_counts[r];
+  }
+
+  // ***** open the output and write the buffers in process order
+
+  laswriteopener->set_use_nil(FALSE);
+  if (compress) laswriteopener->set_chunk_size(U32_MAX);
+  LASwriter* laswriter = laswriteopener->open(header);
+  laswriteopener->set_chunk_size(chunk_size);
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (laszip_any_failed(laswriter == 0 || laswriter->get_stream() == 0))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: could not open sorted output '%s'\n", laswriteopener->get_file_name());
+    return -1;
+  }
+  ByteStreamOut* stream = laswriter->get_stream();
+
+  I64 data_start = stream->tell();
+  I64 write_offset = data_start;
+  I64 data_end = data_start;
+  for (r = 0; r < process_count; r++)
+  {
+    if (r == rank) write_offset = data_end;
+    data_end += all_bytes[r];
+  }
+
+  if (bytes)
+  {
+    const U8* data = blob->getData() + blob_start;
+    I64 remaining = bytes;
+    stream->seek(write_offset);
+    while (remaining)
+    {
+      U32 put = (remaining > (1 << 30) ? (1 << 30) : (U32)remaining);
+      stream->putBytes(data, put);
+      data += put;
+      remaining -= put;
+    }
+  }
+  dbg(3, "rank %i bytes %lli write_offset %lli", rank, bytes, write_offset);
+
+  // ***** gather the chunk table to the last process
+
+  U32* table_sizes = 0;
+  U32* table_bytes = 0;
+  if (compress)
+  {
+    if (rank == process_count-1)
+    {
+      table_sizes = (U32*)malloc(sizeof(U32)*(total_chunks ? total_chunks : 1));
+      table_bytes = (U32*)malloc(sizeof(U32)*(total_chunks ? total_chunks : 1));
+    }
+    MPI_Gatherv(writer->chunk_sizes, number_chunks, MPI_UNSIGNED, table_sizes, chunk_counts, chunk_displs, MPI_UNSIGNED, process_count-1, MPI_COMM_WORLD);
+    MPI_Gatherv(writer->chunk_bytes, number_chunks, MPI_UNSIGNED, table_bytes, chunk_counts, chunk_displs, MPI_UNSIGNED, process_count-1, MPI_COMM_WORLD);
+  }
+
+  // ***** everybody else flushes first so the last process has the final word on the chunk table pointer
+
+  I64 bytes_written = 0;
+  laswriter->p_count = laswriter->npoints;
+  if (rank != process_count-1)
+  {
+    bytes_written = laswriter->close(FALSE);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (rank == process_count-1)
+  {
+    if (compress)
+    {
+      LASwritePoint* file_writer = laswriter->get_writer();
+      if (file_writer->chunk_sizes) free(file_writer->chunk_sizes);
+      if (file_writer->chunk_bytes) free(file_writer->chunk_bytes);
+      file_writer->number_chunks = total_chunks;
+      file_writer->alloced_chunks = total_chunks;
+      file_writer->chunk_sizes = table_sizes;
+      file_writer->chunk_bytes = table_bytes;
+    }
+    stream->seek(data_end);
+    bytes_written = laswriter->close();
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  delete laswriter;
+  free(all_bytes);
+  free(chunk_counts);
+  free(chunk_displs);
+
+  return bytes_written;
+}
+
+// writes the sorted points of all processes in process order into one file
+
+static I64 sort_write(LASreader* lasreader, LASwriteOpener* laswriteopener, const vector<U8*>& sorted, U32 chunk_size)
+{
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  LASpoint* point = &lasreader->point;
+  BOOL compress = (laswriteopener->get_format() == LAS_TOOLS_FORMAT_LAZ);
+
+  // ***** compress or copy the points of this process into memory
+
+  LASzip laszip;
+  if (compress)
+  {
+    if (!laszip.setup(point->num_items, point->items, LASZIP_COMPRESSOR_CHUNKED) || !laszip.request_version(laswriteopener->get_version()) || !laszip.set_chunk_size(U32_MAX) || !laszip.request_coder(laswriteopener->get_coder()))
+    {
+      fprintf(stderr,"ERROR: rank %d cannot set up LASzip for sorted chunks\n", rank);
+      return -1;
+    }
+  }
+  ByteStreamOutArrayLE* blob = new ByteStreamOutArrayLE();
+  LASwritePoint* writer = new LASwritePoint();
+  if (compress)
+    writer->setup(laszip.num_items, laszip.items, &laszip);
+  else
+    writer->setup(point->num_items, point->items);
+  writer->init(blob);
+  I64 blob_start = blob->tell();
+
+  size_t o;
+  for (o = 0; o < sorted.size(); o++)
+  {
+    if (compress && o && ((o % chunk_size) == 0)) writer->chunk();
+    point->copy_from(sorted[o] + sizeof(LASsortRecord));
+    writer->write(point->point);
+  }
+  if (compress && o) writer->chunk();
+
+  I64 bytes_written = laszip_write_blobs(&lasreader->header, laswriteopener, writer, blob, blob_start, compress, chunk_size);
+  delete writer;
+  free(blob->takeData());
+  delete blob;
+  return bytes_written;
+}
+
+// sets count, returns and bounding box of the header to those of one flightline
+
+static void sort_update_header(LASheader* header, LASpoint* point, const vector<U8*>& records)
+{
+  LASinventory inventory;
+  for (size_t o = 0; o < records.size(); o++)
+  {
+    point->copy_from(records[o] + sizeof(LASsortRecord));
+    inventory.add(point);
+  }
+  laszip_update_header(header, &inventory);
+}
+
+I64 laszip_sort(LASreader* lasreader, LASwriteOpener* laswriteopener, BOOL split_flightlines, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  I32 r;
+
+  if (!lasreader->point.have_gps_time)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: point type %d has no GPS time to sort by\n", lasreader->header.point_data_format);
+    return -1;
+  }
+  if ((laswriteopener->get_format() != LAS_TOOLS_FORMAT_LAZ) && (laswriteopener->get_format() != LAS_TOOLS_FORMAT_LAS))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: option '-sort_gps_time' requires LAS or LAZ output\n");
+    return -1;
+  }
+
+  // a level-of-detail layout does not survive reordering
+
+  lasreader->header.remove_vlr(LAS_LOD_USER_ID, LAS_LOD_RECORD_ID);
+
+  // ***** read an even share of the points and sort them locally
+
+  I64 npoints = lasreader->npoints;
+  I64 point_start = rank*(npoints/process_count);
+  I64 point_end = point_start + npoints/process_count;
+  if (rank == process_count-1) point_end += npoints%process_count;
+
+  LASpoint* point = &lasreader->point;
+  U32 record_size = sizeof(LASsortRecord) + point->total_point_size;
+  I64 local_points = point_end - point_start;
+  U8* records = (U8*)malloc(record_size*(local_points ? local_points : 1));
+  if (laszip_any_failed(records == 0))
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: cannot allocate memory for sorting points\n");
+    return -1;
+  }
+
+  LASsortRecord record;
+  memset(&record, 0, sizeof(LASsortRecord));
+  I64 n = 0;
+  lasreader->seek(point_start);
+  while ((n < local_points) && lasreader->read_point())
+  {
+    U8* rec = records + n*record_size;
+    record.gps_time = point->gps_time;
+    record.index = point_start + n;
+    record.point_source_ID = point->point_source_ID;
+    record.return_number = point->return_number;
+    memcpy(rec, &record, sizeof(LASsortRecord));
+    point->copy_to(rec + sizeof(LASsortRecord));
+    n++;
+  }
+  if (n != local_points)
+  {
+#ifdef _WIN32
+    fprintf(stderr,"WARNING: rank %d read only %I64d of %I64d points\n", rank, n, local_points);
+#else
+    fprintf(stderr,"WARNING: rank %d read only %lld of %lld points\n", rank, n, local_points);
+#endif
+    local_points = n;
+  }
+
+  vector<U8*> sorted(local_points);
+  for (n = 0; n < local_points; n++) sorted[n] = records + n*record_size;
+  sort(sorted.begin(), sorted.end(), sort_record_less);
+
+  // ***** pick regular samples and from those one splitter per process
+
+  int samples = (local_points < process_count ? (int)local_points : process_count);
+  LASsortRecord* local_samples = (LASsortRecord*)malloc(sizeof(LASsortRecord)*(samples ? samples : 1));
+  for (int k = 0; k < samples; k++)
+  {
+    memcpy(&(local_samples[k]), sorted[(size_t)((k*local_points)/samples)], sizeof(LASsortRecord));
+  }
+  int* sample_counts = (int*)malloc(sizeof(int)*process_count);
+  int* sample_displs = (int*)malloc(sizeof(int)*process_count);
+  int sample_bytes = samples*sizeof(LASsortRecord);
+  MPI_Allgather(&sample_bytes, 1, MPI_INT, sample_counts, 1, MPI_INT, MPI_COMM_WORLD);
+  int total_sample_bytes = 0;
+  for (r = 0; r < process_count; r++)
+  {
+    sample_displs[r] = total_sample_bytes;
+    total_sample_bytes += sample_counts[r];
+  }
+  int total_samples = total_sample_bytes/sizeof(LASsortRecord);
+  LASsortRecord* all_samples = (LASsortRecord*)malloc(total_sample_bytes ? total_sample_bytes : 1);
+  MPI_Allgatherv(local_samples, sample_bytes, MPI_BYTE, all_samples, sample_counts, sample_displs, MPI_BYTE, MPI_COMM_WORLD);
+  free(local_samples);
+  free(sample_counts);
+  free(sample_displs);
+
+  vector<const LASsortRecord*> ordered_samples(total_samples);
+  for (int k = 0; k < total_samples; k++) ordered_samples[k] = &(all_samples[k]);
+  sort(ordered_samples.begin(), ordered_samples.end(), sort_key_less);
+  // process r receives all points that are not smaller than splitter r-1 and smaller than splitter r
+  vector<const LASsortRecord*> splitters;
+  if (total_samples)
+  {
+    for (r = 1; r < process_count; r++) splitters.push_back(ordered_samples[(size_t)(((I64)r*total_samples)/process_count)]);
+  }
+
+  // ***** exchange the points so that every process holds one contiguous range
+
+  I64* send_points = (I64*)calloc(process_count, sizeof(I64));
+
+  // the local points are sorted so the destinations never decrease
+  r = 0;
+  for (n = 0; n < local_points; n++)
+  {
+    while ((r < (I32)splitters.size()) && !sort_key_less((const LASsortRecord*)sorted[n], splitters[r])) r++;
+    send_points[r]++;
+  }
+
+  U8* send_buffer = (U8*)malloc(local_points ? local_points*record_size : 1);
+  for (n = 0; n < local_points; n++)
+  {
+    memcpy(send_buffer + n*record_size, sorted[n], record_size);
+  }
+  free(records);
+  free(all_samples);
+
+  U8* recv_buffer = 0;
+  I64 received_points = laszip_exchange(send_buffer, send_points, record_size, (void**)&recv_buffer);
+  free(send_buffer);
+  free(send_points);
+  if (received_points < 0)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: more than %d bytes of sorted points per process. use more processes.\n", INT_MAX);
+    return -1;
+  }
+  sorted.resize(received_points);
+  for (n = 0; n < received_points; n++) sorted[n] = recv_buffer + n*record_size;
+  sort(sorted.begin(), sorted.end(), sort_record_less);
+
+  dbg(3, "rank %i local_points %lli received_points %lli", rank, local_points, received_points);
+
+  // ***** write one file or one file per flightline
+
+  I64 bytes_written = 0;
+  U32 chunk_size = laswriteopener->get_chunk_size();
+  if ((chunk_size == 0) || (chunk_size == U32_MAX)) chunk_size = LASZIP_CHUNK_SIZE_DEFAULT;
+
+  if (split_flightlines)
+  {
+    U8* present = (U8*)calloc(U16_MAX_PLUS_ONE, sizeof(U8));
+    for (n = 0; n < received_points; n++) present[((LASsortRecord*)sorted[n])->point_source_ID] = 1;
+    MPI_Allreduce(MPI_IN_PLACE, present, U16_MAX_PLUS_ONE, MPI_UNSIGNED_CHAR, MPI_MAX, MPI_COMM_WORLD);
+
+    CHAR* file_name = (laswriteopener->get_file_name() ? strdup(laswriteopener->get_file_name()) : 0);
+    CHAR* file_name_base = laswriteopener->get_file_name_base();
+    if (file_name_base == 0) file_name_base = strdup("flightline");
+    CHAR* flightline_name = (CHAR*)malloc(strlen(file_name_base) + 16);
+    vector<U8*> flightline;
+    U32 flightlines = 0;
+    for (U32 id = 0; id < U16_MAX_PLUS_ONE; id++)
+    {
+      if (!present[id]) continue;
+      flightline.clear();
+      for (n = 0; n < received_points; n++)
+      {
+        if (((LASsortRecord*)sorted[n])->point_source_ID == id) flightline.push_back(sorted[n]);
+      }
+      sort_update_header(&lasreader->header, point, flightline);
+      sprintf(flightline_name, "%s_%u.%s", file_name_base, id, (laswriteopener->get_format() == LAS_TOOLS_FORMAT_LAZ ? "laz" : "las"));
+      laswriteopener->set_file_name(flightline_name);
+      I64 bytes = sort_write(lasreader, laswriteopener, flightline, chunk_size);
+      if (bytes < 0)
+      {
+        bytes_written = -1;
+        break;
+      }
+      if (verbose && (rank == 0)) fprintf(stderr,"wrote flightline %u to '%s'\n", id, flightline_name);
+      bytes_written += bytes;
+      flightlines++;
+    }
+    if (verbose && (rank == 0)) fprintf(stderr,"split into %u flightlines\n", flightlines);
+    laswriteopener->set_file_name(file_name);
+    if (file_name) free(file_name);
+    free(file_name_base);
+    free(flightline_name);
+    free(present);
+  }
+  else
+  {
+    bytes_written = sort_write(lasreader, laswriteopener, sorted, chunk_size);
+  }
+
+  free(recv_buffer);
+
+  return bytes_written;
+}
@@ -0,0 +1,256 @@
+/*
+===============================================================================
+
+  FILE:  laszip_trace.cpp
+
+  CONTENTS:
+
+    The '-trace' option of p_laszip. Every process records the encoding and
+    decoding of its chunks, its seeks, and how long it spent in each MPI
+    collective with the LAStrace rings. At the end process 0 collects the
+    events of all processes and writes them as one Chrome trace JSON file
+    where each process is a row (pid) and each of its threads a lane (tid).
+
+    The collectives are timed through the MPI profiling interface: the
+    MPI_Xxx functions defined here record an event around the PMPI_Xxx
+    call, so no call site needs to change. Without '-trace' they cost one
+    test of a flag. The clocks of the processes are aligned by starting
+    them right after a barrier.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-trace' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "lastrace.hpp"
+
+#include "mpi.h"
+
+#if defined(MPI_VERSION) && (MPI_VERSION >= 3)
+#define LAS_MPI_CONST const
+#else
+#define LAS_MPI_CONST
+#endif
+
+// ***** the collectives (and the point-to-point calls) used by p_laszip
+
+int MPI_Barrier(MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Barrier", "mpi");
+  return PMPI_Barrier(comm);
+}
+
+int MPI_Bcast(void* buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Bcast", "mpi", count);
+  return PMPI_Bcast(buffer, count, datatype, root, comm);
+}
+
+int MPI_Reduce(LAS_MPI_CONST void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Reduce", "mpi", count);
+  return PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+}
+
+int MPI_Allreduce(LAS_MPI_CONST void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Allreduce", "mpi", count);
+  return PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+}
+
+int MPI_Gather(LAS_MPI_CONST void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Gather", "mpi", sendcount);
+  return PMPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+}
+
+int MPI_Gatherv(LAS_MPI_CONST void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, LAS_MPI_CONST int recvcounts[], LAS_MPI_CONST int displs[], MPI_Datatype recvtype, int root, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Gatherv", "mpi", sendcount);
+  return PMPI_Gatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm);
+}
+
+int MPI_Allgather(LAS_MPI_CONST void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Allgather", "mpi", sendcount);
+  return PMPI_Allgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+}
+
+int MPI_Allgatherv(LAS_MPI_CONST void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, LAS_MPI_CONST int recvcounts[], LAS_MPI_CONST int displs[], MPI_Datatype recvtype, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Allgatherv", "mpi", sendcount);
+  return PMPI_Allgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, comm);
+}
+
+int MPI_Alltoall(LAS_MPI_CONST void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount, MPI_Datatype recvtype, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Alltoall", "mpi", sendcount);
+  return PMPI_Alltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+}
+
+int MPI_Alltoallv(LAS_MPI_CONST void* sendbuf, LAS_MPI_CONST int sendcounts[], LAS_MPI_CONST int sdispls[], MPI_Datatype sendtype, void* recvbuf, LAS_MPI_CONST int recvcounts[], LAS_MPI_CONST int rdispls[], MPI_Datatype recvtype, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Alltoallv", "mpi");
+  return PMPI_Alltoallv(sendbuf, sendcounts, sdispls, sendtype, recvbuf, recvcounts, rdispls, recvtype, comm);
+}
+
+int MPI_Send(LAS_MPI_CONST void* buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm)
+{
+  LAStraceScope scope("MPI_Send", "mpi", count);
+  return PMPI_Send(buf, count, datatype, dest, tag, comm);
+}
+
+int MPI_Recv(void* buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status* status)
+{
+  LAStraceScope scope("MPI_Recv", "mpi", count);
+  return PMPI_Recv(buf, count, datatype, source, tag, comm, status);
+}
+
+// ***** start and write the trace
+
+BOOL laszip_trace_start(U32 capacity)
+{
+  // all processes start their clocks together
+  PMPI_Barrier(MPI_COMM_WORLD);
+  return LAStrace::enable(capacity);
+}
+
+#define LAS_TRACE_TAG 4242
+// the events of the other processes are sent to process 0 in pieces of this size
+#define LAS_TRACE_PIECE (1 << 20)
+
+static void trace_send(const CHAR* json, I64 length)
+{
+  I64 sent = 0;
+  PMPI_Send(&length, 1, MPI_LONG_LONG_INT, 0, LAS_TRACE_TAG, MPI_COMM_WORLD);
+  while (sent < length)
+  {
+    int piece = (int)((length - sent) < LAS_TRACE_PIECE ? (length - sent) : LAS_TRACE_PIECE);
+    PMPI_Send((void*)(json + sent), piece, MPI_CHAR, 0, LAS_TRACE_TAG, MPI_COMM_WORLD);
+    sent += piece;
+  }
+}
+
+// all pieces are received even when they cannot be written so no sender is blocked
+
+static BOOL trace_receive(FILE* file, CHAR* piece_buffer, int source)
+{
+  I64 length = 0;
+  I64 received = 0;
+  BOOL ok = (file != 0);
+  PMPI_Recv(&length, 1, MPI_LONG_LONG_INT, source, LAS_TRACE_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  if (ok && length) fprintf(file, ",\012");
+  while (received < length)
+  {
+    int piece = (int)((length - received) < LAS_TRACE_PIECE ? (length - received) : LAS_TRACE_PIECE);
+    PMPI_Recv(piece_buffer, piece, MPI_CHAR, source, LAS_TRACE_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    if (ok) ok = (fwrite(piece_buffer, 1, piece, file) == (size_t)piece);
+    received += piece;
+  }
+  return ok;
+}
+
+I64 laszip_trace_write(const CHAR* file_name, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  // stop recording so that collecting the trace is not traced
+  I64 events = LAStrace::get_number_events();
+  I64 dropped = LAStrace::get_number_dropped();
+  CHAR* json = 0;
+  I64 length = LAStrace::get_json(&json, rank);
+  LAStrace::disable();
+
+  I64 all_events = 0;
+  I64 all_dropped = 0;
+  PMPI_Reduce(&events, &all_events, 1, MPI_LONG_LONG_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  PMPI_Reduce(&dropped, &all_dropped, 1, MPI_LONG_LONG_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+  // process 0 writes its events and then those of every other process
+  int failed = 0;
+  if (rank == 0)
+  {
+    FILE* file = fopen(file_name, "w");
+    if (file == 0)
+    {
+      fprintf(stderr,"ERROR: cannot open trace file '%s'\n", file_name);
+      failed = 1;
+    }
+    else
+    {
+      fprintf(file, "{\"traceEvents\":[\012");
+      for (int r = 0; r < process_count; r++)
+      {
+        fprintf(file, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"rank %d\"}}", (r ? ",\012" : ""), r, r);
+      }
+      if (length)
+      {
+        fprintf(file, ",\012");
+        fwrite(json, 1, (size_t)length, file);
+      }
+    }
+    CHAR* piece_buffer = (CHAR*)malloc(LAS_TRACE_PIECE);
+    for (int r = 1; r < process_count; r++)
+    {
+      if (!trace_receive(file, piece_buffer, r)) failed = 1;
+    }
+    free(piece_buffer);
+    if (file)
+    {
+#ifdef _WIN32
+      fprintf(file, "\012],\"displayTimeUnit\":\"ms\",\"otherData\":{\"processes\":%d,\"dropped\":%I64d}}\012", process_count, all_dropped);
+#else
+      fprintf(file, "\012],\"displayTimeUnit\":\"ms\",\"otherData\":{\"processes\":%d,\"dropped\":%lld}}\012", process_count, all_dropped);
+#endif
+      if (ferror(file)) failed = 1;
+      fclose(file);
+    }
+    if (failed)
+    {
+      fprintf(stderr,"ERROR: cannot write trace file '%s'\n", file_name);
+    }
+    else if (verbose)
+    {
+#ifdef _WIN32
+      fprintf(stderr,"wrote %I64d events of %d processes to '%s' (%I64d dropped)\n", all_events, process_count, file_name, all_dropped);
+#else
+      fprintf(stderr,"wrote %lld events of %d processes to '%s' (%lld dropped)\n", all_events, process_count, file_name, all_dropped);
+#endif
+    }
+  }
+  else
+  {
+    trace_send(json, length);
+  }
+  if (json) free(json);
+
+  PMPI_Bcast(&failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (failed) return -1;
+  return all_events;
+}
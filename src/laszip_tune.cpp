@@ -0,0 +1,404 @@
+/*
+===============================================================================
+
+  FILE:  laszip_tune.cpp
+
+  CONTENTS:
+
+    The '-auto_tune' option of p_laszip. Before compressing a LAS file every
+    process takes a sample of the points at the start of its share, keeps it
+    in memory, and compresses it to nowhere once for every candidate chunk
+    size. This measures the encoding speed and the compressed size for each
+    chunk size. Then all processes read their sample from the file and write
+    a scratch file at the same time with every candidate buffer size, which
+    measures the input and output bandwidth under contention.
+
+    For every chunk size that still gives each process at least one chunk
+    the time of the full run is estimated for the process with the most
+    points: p_laszip reads and encodes its points twice (once to count the
+    bytes and once to write them) and writes the compressed bytes once. The
+    chunk size with the smallest estimate and the buffer sizes with the
+    highest bandwidth are used for the run. They are printed, and appended
+    to a log file as a line of options that can be given to later runs.
+
+    The number of processes is fixed by mpirun. Only a suggestion is made:
+    the compute part of the estimate shrinks with more processes while the
+    bandwidth measured for all processes together does not grow.
+
+  PROGRAMMERS:
+
+    jwendel
+
+  COPYRIGHT:
+
+    (c) 2007-2015, martin isenburg, rapidlasso - fast tools to catch reality
+
+    This is free software; you can redistribute and/or modify it under the
+    terms of the GNU Lesser General Licence as published by the Free Software
+    Foundation. See the LICENSE.txt file for more information.
+
+    This software is distributed WITHOUT ANY WARRANTY and without even the
+    implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+  CHANGE HISTORY:
+
+    18 October 2026 -- created for the '-auto_tune' option of p_laszip
+
+===============================================================================
+*/
+
+#include "debug.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lasreader.hpp"
+#include "laswriter.hpp"
+#include "laswriter_las.hpp"
+#include "bytestreamout.hpp"
+#include "lastrace.hpp"
+
+#include "mpi.h"
+
+// the most points each process compresses per candidate
+#define LAS_TUNE_SAMPLE_POINTS 100000
+// each candidate is timed this often and the fastest time counts
+#define LAS_TUNE_REPEATS 2
+// the arithmetic coder hands its output to the stream in pieces of this size
+#define LAS_TUNE_PIECE 1024
+
+#define LAS_TUNE_CHUNK_SIZES 6
+static const U32 tune_chunk_sizes[LAS_TUNE_CHUNK_SIZES] = { 5000, 10000, 25000, 50000, 100000, 250000 };
+
+#define LAS_TUNE_BUFFER_SIZES 4
+static const I32 tune_buffer_sizes[LAS_TUNE_BUFFER_SIZES] = { 65536, 262144, 1048576, 4194304 };
+
+// the points of the process with the most points when the las -> laz
+// conversion of laszip.cpp divides them on chunk boundaries or -1 when
+// some process would get no chunk
+
+static I64 tune_most_points(const I64 npoints, const I64 chunk_size, const int process_count)
+{
+  I64 chunks = npoints / chunk_size;
+  if (chunks < process_count) return -1;
+  I64 most = ((chunks + process_count - 1) / process_count) * chunk_size;
+  I64 last = (chunks / process_count) * chunk_size + (npoints % chunk_size);
+  return (last > most ? last : most);
+}
+
+static BOOL tune_encode(LASreader* lasreader, const U8* sample, const I64 sample_points, const U32 chunk_size, const U16 version, const U16 coder, F64* seconds, I64* bytes)
+{
+  LASwriterLAS* laswriterlas = new LASwriterLAS();
+  laswriterlas->set_coder(coder);
+  if (!laswriterlas->open(&lasreader->header, LASZIP_COMPRESSOR_CHUNKED, version, chunk_size))
+  {
+    fprintf(stderr,"ERROR: cannot open laswriterlas to NULL\n");
+    delete laswriterlas;
+    return FALSE;
+  }
+  laswriterlas->npoints = sample_points;
+  I64 header_bytes = laswriterlas->get_stream()->tell();
+  U32 point_size = lasreader->point.total_point_size;
+  F64 start = MPI_Wtime();
+  for (I64 p = 0; p < sample_points; p++)
+  {
+    lasreader->point.copy_from(sample + p*point_size);
+    laswriterlas->write_point(&lasreader->point);
+  }
+  *bytes = laswriterlas->close(FALSE) - header_bytes;
+  *seconds = MPI_Wtime() - start;
+  delete laswriterlas;
+  return TRUE;
+}
+
+// bytes per second for reading the raw sample the way LASreaderLAS does
+
+static F64 tune_read(const CHAR* file_name, const I64 offset, const I64 size, const U32 record_length, const I32 buffer_size, U8* scratch)
+{
+  FILE* file = fopen(file_name, "rb");
+  if (file == 0) return 0.0;
+  if (setvbuf(file, NULL, _IOFBF, buffer_size) != 0)
+  {
+    fclose(file);
+    return 0.0;
+  }
+  F64 start = MPI_Wtime();
+#if defined _WIN32 && ! defined (__MINGW32__)
+  BOOL ok = !_fseeki64(file, offset, SEEK_SET);
+#else
+  BOOL ok = !fseeko(file, (off_t)offset, SEEK_SET);
+#endif
+  for (I64 done = 0; ok && (done < size); done += record_length)
+  {
+    ok = (fread(scratch, 1, record_length, file) == record_length);
+  }
+  F64 seconds = MPI_Wtime() - start;
+  fclose(file);
+  if (!ok || (seconds <= 0.0)) return 0.0;
+  return size / seconds;
+}
+
+// bytes per second for writing (and closing) a scratch file the way LASwriterLAS does
+
+static F64 tune_write(const CHAR* file_name, const I64 size, const I32 buffer_size, const U8* data)
+{
+  FILE* file = fopen(file_name, "wb");
+  if (file == 0) return 0.0;
+  if (setvbuf(file, NULL, _IOFBF, buffer_size) != 0)
+  {
+    fclose(file);
+    remove(file_name);
+    return 0.0;
+  }
+  BOOL ok = TRUE;
+  F64 start = MPI_Wtime();
+  for (I64 done = 0; ok && (done < size); done += LAS_TUNE_PIECE)
+  {
+    ok = (fwrite(data, 1, LAS_TUNE_PIECE, file) == LAS_TUNE_PIECE);
+  }
+  if (fclose(file) != 0) ok = FALSE;
+  F64 seconds = MPI_Wtime() - start;
+  remove(file_name);
+  if (!ok || (seconds <= 0.0)) return 0.0;
+  return size / seconds;
+}
+
+// the buffer size with the highest bandwidth of the slowest process
+
+static I32 tune_best_buffer(F64* bandwidths, F64* best_bandwidth)
+{
+  F64 slowest[LAS_TUNE_BUFFER_SIZES];
+  MPI_Allreduce(bandwidths, slowest, LAS_TUNE_BUFFER_SIZES, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+  memcpy(bandwidths, slowest, sizeof(slowest));
+  I32 best = -1;
+  for (I32 b = 0; b < LAS_TUNE_BUFFER_SIZES; b++)
+  {
+    if ((slowest[b] > 0.0) && ((best == -1) || (slowest[b] > slowest[best]))) best = b;
+  }
+  *best_bandwidth = (best == -1 ? 0.0 : slowest[best]);
+  return best;
+}
+
+I64 laszip_tune(LASreadOpener* lasreadopener, LASwriteOpener* laswriteopener, const CHAR* log_name, BOOL verbose)
+{
+  int process_count, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  I64 tune_start = LAStrace::now();
+
+  LASreader* lasreader = lasreadopener->open();
+  if (lasreader == 0)
+  {
+    fprintf(stderr,"ERROR: could not open lasreader\n");
+    return -1;
+  }
+
+  CHAR* file_name = strdup(lasreadopener->get_file_name());
+  I64 npoints = lasreader->npoints;
+  I64 share = npoints / process_count;
+  I64 sample_points = (share < LAS_TUNE_SAMPLE_POINTS ? share : LAS_TUNE_SAMPLE_POINTS);
+
+  if (lasreader->header.laszip || (sample_points == 0))
+  {
+    if (rank == 0) fprintf(stderr,"WARNING: %s. ignoring '-auto_tune' ...\n", (lasreader->header.laszip ? "input is already compressed" : "too few points"));
+    lasreader->close();
+    delete lasreader;
+    lasreadopener->reset();
+    free(file_name);
+    return 0;
+  }
+
+  // every process keeps the sample at the start of its share in memory
+
+  U32 point_size = lasreader->point.total_point_size;
+  U32 record_length = lasreader->header.point_data_record_length;
+  U8* sample = (U8*)malloc((size_t)(sample_points*point_size + LAS_TUNE_PIECE));
+  int failed = (sample == 0 ? 1 : 0);
+  I64 sample_start = rank*share;
+  I64 read_offset = lasreader->header.offset_to_point_data + sample_start*record_length;
+  if (!failed)
+  {
+    lasreader->seek(sample_start);
+    for (I64 p = 0; p < sample_points; p++)
+    {
+      if (!lasreader->read_point())
+      {
+        failed = 1;
+        break;
+      }
+      lasreader->point.copy_to(sample + p*point_size);
+    }
+  }
+
+  // every chunk size that gives each process a chunk is timed
+
+  U16 version = laswriteopener->get_version();
+  U16 coder = laswriteopener->get_coder();
+  F64 seconds[LAS_TUNE_CHUNK_SIZES];
+  F64 counts[2*LAS_TUNE_CHUNK_SIZES];
+  I32 c, b;
+  for (c = 0; c < LAS_TUNE_CHUNK_SIZES; c++)
+  {
+    seconds[c] = 0.0;
+    counts[2*c] = 0.0;
+    counts[2*c+1] = 0.0;
+    if (failed || (tune_most_points(npoints, tune_chunk_sizes[c], process_count) < 0)) continue;
+    for (I32 r = 0; r < LAS_TUNE_REPEATS; r++)
+    {
+      F64 secs;
+      I64 bytes;
+      if (!tune_encode(lasreader, sample, sample_points, tune_chunk_sizes[c], version, coder, &secs, &bytes))
+      {
+        failed = 1;
+        break;
+      }
+      if ((r == 0) || (secs < seconds[c])) seconds[c] = secs;
+      counts[2*c+1] = (F64)bytes;
+    }
+    seconds[c] /= sample_points;
+    counts[2*c] = (F64)sample_points;
+  }
+  lasreader->close();
+  delete lasreader;
+  lasreadopener->reset();
+
+  int all_failed = 0;
+  MPI_Allreduce(&failed, &all_failed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if (all_failed)
+  {
+    if (rank == 0) fprintf(stderr,"ERROR: auto-tuning failed\n");
+    if (sample) free(sample);
+    free(file_name);
+    return -1;
+  }
+
+  // the slowest process sets the encoding speed, all samples the size
+
+  F64 slowest[LAS_TUNE_CHUNK_SIZES];
+  F64 all_counts[2*LAS_TUNE_CHUNK_SIZES];
+  MPI_Allreduce(seconds, slowest, LAS_TUNE_CHUNK_SIZES, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(counts, all_counts, 2*LAS_TUNE_CHUNK_SIZES, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+  // all processes read their sample and write a scratch file at once
+
+  F64 read_bandwidths[LAS_TUNE_BUFFER_SIZES];
+  F64 write_bandwidths[LAS_TUNE_BUFFER_SIZES];
+  const CHAR* base_name = (laswriteopener->get_file_name() ? laswriteopener->get_file_name() : file_name);
+  CHAR* scratch_name = (CHAR*)malloc(strlen(base_name) + 32);
+  sprintf(scratch_name, "%s.tune%d", base_name, rank);
+  I64 write_size = 0;
+  for (c = 0; c < LAS_TUNE_CHUNK_SIZES; c++)
+  {
+    if (counts[2*c] > 0.0)
+    {
+      write_size = (I64)counts[2*c+1];
+      break;
+    }
+  }
+  for (b = 0; b < LAS_TUNE_BUFFER_SIZES; b++)
+  {
+    MPI_Barrier(MPI_COMM_WORLD);
+    read_bandwidths[b] = tune_read(file_name, read_offset, sample_points*record_length, record_length, tune_buffer_sizes[b], sample);
+    MPI_Barrier(MPI_COMM_WORLD);
+    write_bandwidths[b] = tune_write(scratch_name, write_size, tune_buffer_sizes[b], sample);
+  }
+  free(scratch_name);
+  free(sample);
+  F64 read_bandwidth, write_bandwidth;
+  I32 best_ibuffer = tune_best_buffer(read_bandwidths, &read_bandwidth);
+  I32 best_obuffer = tune_best_buffer(write_bandwidths, &write_bandwidth);
+
+  // the chunk size with the fastest estimated run
+
+  F64 estimates[LAS_TUNE_CHUNK_SIZES];
+  F64 compute[LAS_TUNE_CHUNK_SIZES];
+  I32 best = -1;
+  for (c = 0; c < LAS_TUNE_CHUNK_SIZES; c++)
+  {
+    estimates[c] = 0.0;
+    if (all_counts[2*c] == 0.0) continue;
+    I64 most = tune_most_points(npoints, tune_chunk_sizes[c], process_count);
+    F64 read_seconds = (read_bandwidth > 0.0 ? record_length / read_bandwidth : 0.0);
+    F64 bytes_per_point = all_counts[2*c+1] / all_counts[2*c];
+    compute[c] = 2.0 * most * (read_seconds + slowest[c]);
+    estimates[c] = compute[c] + (write_bandwidth > 0.0 ? most * bytes_per_point / write_bandwidth : 0.0);
+    if ((best == -1) || (estimates[c] < estimates[best])) best = c;
+  }
+
+  // process 0 decides so that all processes use the same settings
+
+  I32 settings[3];
+  settings[0] = (best == -1 ? -1 : (I32)tune_chunk_sizes[best]);
+  settings[1] = (best_ibuffer == -1 ? lasreadopener->get_io_ibuffer_size() : tune_buffer_sizes[best_ibuffer]);
+  settings[2] = (best_obuffer == -1 ? laswriteopener->get_io_obuffer_size() : tune_buffer_sizes[best_obuffer]);
+  MPI_Bcast(settings, 3, MPI_INT, 0, MPI_COMM_WORLD);
+  lasreadopener->set_io_ibuffer_size(settings[1]);
+  laswriteopener->set_io_obuffer_size(settings[2]);
+  if (settings[0] > 0) laswriteopener->set_chunk_size((U32)settings[0]);
+
+  if (LAStrace::is_enabled()) LAStrace::complete("auto-tune", "phase", tune_start, sample_points);
+
+  if (rank == 0)
+  {
+    // fewer processes when the bandwidth cannot keep up, more while it can
+    I64 suggested = process_count;
+    if (best != -1)
+    {
+      F64 io = estimates[best] - compute[best];
+      I64 chunks = npoints / tune_chunk_sizes[best];
+      if (io > 0.0) suggested = (I64)(process_count * compute[best] / io + 0.5);
+      if (suggested < 1) suggested = 1;
+      if (suggested > chunks) suggested = chunks;
+    }
+
+    FILE* log_file = 0;
+    if (log_name)
+    {
+      log_file = fopen(log_name, "a");
+      if (log_file == 0) fprintf(stderr,"WARNING: cannot open auto-tune log '%s'\n", log_name);
+    }
+    for (I32 f = 0; f < 2; f++)
+    {
+      FILE* out = (f == 0 ? (verbose ? stderr : 0) : log_file);
+      if (out == 0) continue;
+#ifdef _WIN32
+      fprintf(out, "# auto-tune of '%s' with %I64d points on %d processes (%I64d points sampled each)\n", file_name, npoints, process_count, sample_points);
+#else
+      fprintf(out, "# auto-tune of '%s' with %lld points on %d processes (%lld points sampled each)\n", file_name, npoints, process_count, sample_points);
+#endif
+      fprintf(out, "# %10s %12s %12s %12s\n", "chunk_size", "usec/point", "bytes/point", "est. secs");
+      for (c = 0; c < LAS_TUNE_CHUNK_SIZES; c++)
+      {
+        if (all_counts[2*c] == 0.0)
+          fprintf(out, "# %10u %12s %12s %12s\n", tune_chunk_sizes[c], "-", "-", "too few chunks");
+        else
+          fprintf(out, "# %10u %12.3f %12.3f %12.3f\n", tune_chunk_sizes[c], slowest[c]*1.0e6, all_counts[2*c+1] / all_counts[2*c], estimates[c]);
+      }
+      fprintf(out, "# %10s %12s %12s\n", "buffer", "read MB/s", "write MB/s");
+      for (b = 0; b < LAS_TUNE_BUFFER_SIZES; b++)
+      {
+        fprintf(out, "# %10d %12.1f %12.1f\n", tune_buffer_sizes[b], read_bandwidths[b]/1.0e6, write_bandwidths[b]/1.0e6);
+      }
+#ifdef _WIN32
+      fprintf(out, "# an estimated %I64d processes would balance computing and I/O\n", suggested);
+#else
+      fprintf(out, "# an estimated %lld processes would balance computing and I/O\n", suggested);
+#endif
+    }
+    if (settings[0] > 0)
+      fprintf(stderr, "auto-tuned: -chunk_size %d -io_ibuffer %d -io_obuffer %d\n", settings[0], settings[1], settings[2]);
+    else
+      fprintf(stderr, "WARNING: no chunk size gives each of %d processes a chunk. auto-tuned: -io_ibuffer %d -io_obuffer %d\n", process_count, settings[1], settings[2]);
+    if (log_file)
+    {
+      if (settings[0] > 0) fprintf(log_file, "-chunk_size %d ", settings[0]);
+      fprintf(log_file, "-io_ibuffer %d -io_obuffer %d\n", settings[1], settings[2]);
+      fclose(log_file);
+    }
+  }
+
+  free(file_name);
+  return (settings[0] > 0 ? settings[0] : 0);
+}